@@ -15,6 +15,7 @@ SOURCES += \
         qtconcurrentfilter.cpp \
         qtconcurrentmap.cpp \
         qtconcurrentrun.cpp \
+        qtconcurrentsort.cpp \
         qtconcurrentthreadengine.cpp \
         qtconcurrentiteratekernel.cpp \
 
@@ -32,6 +33,7 @@ HEADERS += \
         qtconcurrentreducekernel.h \
         qtconcurrentrun.h \
         qtconcurrentrunbase.h \
+        qtconcurrentsort.h \
         qtconcurrentstoredfunctioncall.h \
         qtconcurrentthreadengine.h
 
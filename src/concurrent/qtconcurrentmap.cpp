@@ -63,8 +63,16 @@
     \value OrderedReduce Reduction is done in the order of the
     original sequence.
     \value SequentialReduce Reduction is done sequentially: only one
-    thread will enter the reduce function at a time. (Parallel reduction
-    might be supported in a future version of Qt Concurrent.)
+    thread will enter the reduce function at a time.
+    \value ParallelReduce Reduction is done in parallel: each thread reduces
+    the results into a partial result of its own, and the partial results
+    are merged pairwise by calling the reduce function with another partial
+    result as the intermediate result. The reduce function must be
+    associative and may be called by several threads at a time, and the
+    order of the reduction is undefined. Parallel reduction is only done when
+    the map or filter function returns the type of the final result;
+    otherwise reduction is done sequentially. This value was introduced in
+    Qt 5.1.
 */
 
 /*!
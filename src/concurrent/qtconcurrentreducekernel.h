@@ -52,6 +52,7 @@
 #include <QtCore/qmutex.h>
 #include <QtCore/qthread.h>
 #include <QtCore/qthreadpool.h>
+#include <QtCore/qtypetraits.h>
 #include <QtCore/qvector.h>
 
 QT_BEGIN_HEADER
@@ -90,14 +91,129 @@ public:
 enum ReduceOption {
     UnorderedReduce = 0x1,
     OrderedReduce = 0x2,
-    SequentialReduce = 0x4
-    // ParallelReduce = 0x8
+    SequentialReduce = 0x4,
+    ParallelReduce = 0x8
 };
 Q_DECLARE_FLAGS(ReduceOptions, ReduceOption)
 Q_DECLARE_OPERATORS_FOR_FLAGS(ReduceOptions)
 
 #ifndef qdoc
 
+// Reduces the intermediate results into partial results, one for each
+// thread running the reduce function, and merges the partial results
+// pairwise. The reduce function is used to merge two partial results, which
+// requires the result of the map or filter function to have the type of the
+// final result; otherwise runReduce() returns false and the ReduceKernel
+// falls back to sequential reduction.
+template <typename ReduceFunctor, typename ReduceResultType, typename T,
+          bool Mergeable = QtPrivate::is_same<ReduceResultType, T>::value>
+class ParallelReducer
+{
+public:
+    bool runReduce(ReduceFunctor &, const IntermediateResults<T> &)
+    { return false; }
+    void finish(ReduceFunctor &, ReduceResultType &)
+    { }
+};
+
+template <typename ReduceFunctor, typename ReduceResultType, typename T>
+class ParallelReducer<ReduceFunctor, ReduceResultType, T, true>
+{
+    struct PartialResult
+    {
+        PartialResult() : value(), valid(false) { }
+        ReduceResultType value;
+        bool valid;
+    };
+
+    QMutex mutex;
+    // partial results that no thread is reducing into
+    QList<PartialResult *> idle;
+    QList<PartialResult *> all;
+
+    static void merge(ReduceFunctor &reduce, PartialResult *r, PartialResult *other)
+    {
+        if (!other->valid)
+            return;
+        if (r->valid) {
+            reduce(r->value, other->value);
+        } else {
+            r->value = other->value;
+            r->valid = true;
+        }
+        other->valid = false;
+    }
+
+public:
+    ~ParallelReducer()
+    {
+        qDeleteAll(all);
+    }
+
+    bool runReduce(ReduceFunctor &reduce, const IntermediateResults<T> &result)
+    {
+        PartialResult *partial;
+        {
+            QMutexLocker locker(&mutex);
+            if (idle.isEmpty()) {
+                partial = new PartialResult;
+                all.append(partial);
+            } else {
+                partial = idle.takeLast();
+            }
+        }
+
+        // the first element of a block starts a partial result, so that the
+        // default constructed value does not have to be an identity element
+        int i = 0;
+        if (!partial->valid && !result.vector.isEmpty()) {
+            partial->value = result.vector.at(0);
+            partial->valid = true;
+            i = 1;
+        }
+        for (; i < result.vector.size(); ++i)
+            reduce(partial->value, result.vector.at(i));
+
+        // merge the partial results of the threads that are not reducing,
+        // so that the partial results get merged in a tree while the
+        // threads are still running
+        for (;;) {
+            PartialResult *other;
+            {
+                QMutexLocker locker(&mutex);
+                if (idle.isEmpty()) {
+                    idle.append(partial);
+                    return true;
+                }
+                other = idle.takeLast();
+            }
+            merge(reduce, partial, other);
+
+            QMutexLocker locker(&mutex);
+            all.removeOne(other);
+            locker.unlock();
+            delete other;
+        }
+    }
+
+    // final reduction, only called when no other thread is reducing
+    void finish(ReduceFunctor &reduce, ReduceResultType &r)
+    {
+        QList<PartialResult *> results;
+        for (int i = 0; i < all.count(); ++i) {
+            if (all.at(i)->valid)
+                results.append(all.at(i));
+        }
+        // merge pairwise, in log2(n) rounds
+        for (int step = 1; step < results.count(); step *= 2) {
+            for (int i = 0; i + step < results.count(); i += 2 * step)
+                merge(reduce, results.at(i), results.at(i + step));
+        }
+        if (!results.isEmpty())
+            reduce(r, results.first()->value);
+    }
+};
+
 // supports both ordered and out-of-order reduction
 template <typename ReduceFunctor, typename ReduceResultType, typename T>
 class ReduceKernel
@@ -109,6 +225,7 @@ class ReduceKernel
     QMutex mutex;
     int progress, resultsMapSize, threadCount;
     ResultsMap resultsMap;
+    ParallelReducer<ReduceFunctor, ReduceResultType, T> parallelReducer;
 
     bool canReduce(int begin) const
     {
@@ -148,6 +265,9 @@ public:
                    ReduceResultType &r,
                    const IntermediateResults<T> &result)
     {
+        if ((reduceOptions & ParallelReduce) && parallelReducer.runReduce(reduce, result))
+            return;
+
         QMutexLocker locker(&mutex);
         if (!canReduce(result.begin)) {
             ++resultsMapSize;
@@ -207,6 +327,8 @@ public:
     void finish(ReduceFunctor &reduce, ReduceResultType &r)
     {
         reduceResults(reduce, r, resultsMap);
+        if (reduceOptions & ParallelReduce)
+            parallelReducer.finish(reduce, r);
     }
 
     inline bool shouldThrottle()
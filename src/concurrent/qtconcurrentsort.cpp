@@ -0,0 +1,287 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qtconcurrentsort.h"
+
+#ifndef QT_NO_CONCURRENT
+
+#include <QtCore/qmutex.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qwaitcondition.h>
+
+/*!
+    \headerfile <QtConcurrentSort>
+    \title Concurrent Sort and Merge
+    \ingroup thread
+    \since 5.1
+
+    \brief The <QtConcurrentSort> header provides parallel sorting and
+    merging.
+
+    These functions are a part of the \l {Concurrent Programming}{Qt Concurrent} framework.
+
+    QtConcurrent::blockingSort() and QtConcurrent::blockingStableSort() sort
+    a range of items using all threads of the global QThreadPool. They
+    take the same arguments as qSort() and qStableSort(), work on the
+    iterators of QVector, QList and plain arrays, and block until the
+    range is sorted:
+
+    \snippet code/src_concurrent_qtconcurrentsort.cpp 0
+
+    The range is divided into chunks which are sorted in parallel, and
+    the sorted chunks are then merged pairwise, each merge itself being
+    split across the threads. This needs a temporary buffer the size of
+    the range, so the value type must be default-constructible and
+    assignable, like any value stored in a Qt container.
+
+    QtConcurrent::blockingMerge() merges two sorted ranges into a third
+    one in parallel:
+
+    \snippet code/src_concurrent_qtconcurrentsort.cpp 1
+
+    Ranges of fewer than 16384 items are sorted or merged by the calling
+    thread alone, as splitting them would cost more than it saves. The
+    calling thread always takes part in the work, so the functions make
+    progress even when all threads of the pool are busy, including when
+    they are called from a thread of the pool.
+
+    The \a lessThan function, if given, may be called by several threads
+    at the same time.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan)
+
+    Sorts the items in range [\a begin, \a end) in ascending order
+    according to \a lessThan, using several threads. The order of equal
+    items is not preserved.
+
+    \note This function will block until the range is sorted.
+
+    \sa blockingStableSort(), qSort()
+*/
+
+/*!
+    \fn void QtConcurrent::blockingSort(RandomAccessIterator begin, RandomAccessIterator end)
+    \overload
+
+    Sorts the items in range [\a begin, \a end) in ascending order using
+    their \c{operator<()}.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingSort(Container &container)
+    \overload
+
+    Sorts the items of \a container in ascending order using their
+    \c{operator<()}.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingStableSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan)
+
+    Sorts the items in range [\a begin, \a end) in ascending order
+    according to \a lessThan, using several threads. Items that compare
+    equal keep their relative order.
+
+    \note This function will block until the range is sorted.
+
+    \sa blockingSort(), qStableSort()
+*/
+
+/*!
+    \fn void QtConcurrent::blockingStableSort(RandomAccessIterator begin, RandomAccessIterator end)
+    \overload
+
+    Sorts the items in range [\a begin, \a end) in ascending order using
+    their \c{operator<()}, keeping the relative order of equal items.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingStableSort(Container &container)
+    \overload
+
+    Sorts the items of \a container in ascending order using their
+    \c{operator<()}, keeping the relative order of equal items.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingMerge(InputIterator begin1, InputIterator end1, InputIterator begin2, InputIterator end2, OutputIterator result, LessThan lessThan)
+
+    Merges the ranges [\a begin1, \a end1) and [\a begin2, \a end2), which
+    must both be sorted according to \a lessThan, into the range starting
+    at \a result, using several threads. When items of both ranges compare
+    equal, those of the first range come first.
+
+    All iterators must be random access iterators, and the output range
+    must not overlap the input ranges.
+
+    \note This function will block until the ranges are merged.
+*/
+
+/*!
+    \fn void QtConcurrent::blockingMerge(InputIterator begin1, InputIterator end1, InputIterator begin2, InputIterator end2, OutputIterator result)
+    \overload
+
+    Merges the ranges [\a begin1, \a end1) and [\a begin2, \a end2), which
+    must both be sorted by \c{operator<()}, into the range starting at
+    \a result.
+*/
+
+QT_BEGIN_NAMESPACE
+
+namespace QtConcurrent {
+
+// Shared by the calling thread and the helpers it started. Helpers that
+// only get to run once all jobs are taken may outlive the call, so the
+// state is reference counted; the jobs themselves are only touched while
+// the caller waits for them.
+class ParallelJobsState
+{
+public:
+    ParallelJobsState(ParallelJobs *jobs, int jobCount)
+        : ref(1), nextJob(0), jobCount(jobCount), finishedJobs(0), jobs(jobs)
+    {}
+
+    void work()
+    {
+        forever {
+            const int job = nextJob.fetchAndAddRelaxed(1);
+            if (job >= jobCount)
+                return;
+            runJob(job);
+        }
+    }
+
+    void waitForJobs()
+    {
+        QMutexLocker locker(&mutex);
+        while (finishedJobs < jobCount)
+            finished.wait(&mutex);
+    }
+
+    QAtomicInt ref;
+
+private:
+    void runJob(int job);
+
+    QAtomicInt nextJob;
+    const int jobCount;
+    int finishedJobs;
+    ParallelJobs *jobs;
+    QMutex mutex;
+    QWaitCondition finished;
+};
+
+class ParallelJobsRunner : public QRunnable
+{
+public:
+    explicit ParallelJobsRunner(ParallelJobsState *state)
+        : state(state)
+    {}
+
+    void run()
+    {
+        state->work();
+        if (!state->ref.deref())
+            delete state;
+    }
+
+private:
+    ParallelJobsState *state;
+};
+
+void ParallelJobsState::runJob(int job)
+{
+    jobs->runJob(job);
+
+    QMutexLocker locker(&mutex);
+    if (++finishedJobs == jobCount)
+        finished.wakeAll();
+}
+
+/*!
+    \internal
+
+    Returns how many jobs can usefully run at the same time.
+*/
+int ParallelJobs::idealJobCount()
+{
+    return QThreadPool::globalInstance()->maxThreadCount();
+}
+
+/*!
+    \internal
+
+    Runs jobs 0 to \a jobCount - 1 on the calling thread and on as many
+    idle threads of the global pool as are useful, and returns once all of
+    them have finished. No helper is queued behind busy threads: if none
+    is available, the calling thread runs all jobs by itself.
+*/
+void ParallelJobs::run(int jobCount)
+{
+    if (jobCount <= 0)
+        return;
+
+    ParallelJobsState *state = new ParallelJobsState(this, jobCount);
+    QThreadPool *pool = QThreadPool::globalInstance();
+    for (int i = 1; i < jobCount; ++i) {
+        state->ref.ref();
+        ParallelJobsRunner *runner = new ParallelJobsRunner(state);
+        if (!pool->tryStart(runner)) {
+            state->ref.deref();
+            delete runner;
+            break;
+        }
+    }
+
+    state->work();
+    state->waitForJobs();
+    if (!state->ref.deref())
+        delete state;
+}
+
+} // namespace QtConcurrent
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_CONCURRENT
@@ -0,0 +1,390 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QTCONCURRENT_SORT_H
+#define QTCONCURRENT_SORT_H
+
+#include <QtConcurrent/qtconcurrent_global.h>
+
+#ifndef QT_NO_CONCURRENT
+
+#include <QtCore/qalgorithms.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_HEADER
+QT_BEGIN_NAMESPACE
+
+
+#ifdef qdoc
+
+namespace QtConcurrent {
+
+    void blockingSort(Container &container);
+    void blockingSort(RandomAccessIterator begin, RandomAccessIterator end);
+    void blockingSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan);
+
+    void blockingStableSort(Container &container);
+    void blockingStableSort(RandomAccessIterator begin, RandomAccessIterator end);
+    void blockingStableSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan);
+
+    void blockingMerge(InputIterator begin1, InputIterator end1,
+                       InputIterator begin2, InputIterator end2,
+                       OutputIterator result);
+    void blockingMerge(InputIterator begin1, InputIterator end1,
+                       InputIterator begin2, InputIterator end2,
+                       OutputIterator result, LessThan lessThan);
+
+} // namespace QtConcurrent
+
+#else
+
+namespace QtConcurrent {
+
+enum {
+    // Ranges shorter than this are sorted by the calling thread alone.
+    SortSerialThreshold = 16384,
+    // Sorting is split into chunks of at least this many items.
+    SortMinimumChunkSize = 4096
+};
+
+// Runs runJob(0) to runJob(jobCount - 1) on the global thread pool and the
+// calling thread, returning once all of them are done. The calling thread
+// takes jobs too, so this makes progress even if the pool is busy.
+class Q_CONCURRENT_EXPORT ParallelJobs
+{
+public:
+    virtual ~ParallelJobs() {}
+
+    void run(int jobCount);
+    static int idealJobCount();
+
+protected:
+    virtual void runJob(int index) = 0;
+
+private:
+    friend class ParallelJobsState;
+};
+
+template <typename RandomAccessIterator, typename LessThan>
+class SortChunkJobs : public ParallelJobs
+{
+public:
+    SortChunkJobs(RandomAccessIterator begin, const QVector<int> &bounds,
+                  LessThan lessThan, bool stable)
+        : begin(begin), bounds(bounds), lessThan(lessThan), stable(stable)
+    {}
+
+protected:
+    void runJob(int index)
+    {
+        if (stable)
+            qStableSort(begin + bounds.at(index), begin + bounds.at(index + 1), lessThan);
+        else
+            qSort(begin + bounds.at(index), begin + bounds.at(index + 1), lessThan);
+    }
+
+private:
+    RandomAccessIterator begin;
+    const QVector<int> &bounds;
+    LessThan lessThan;
+    bool stable;
+};
+
+// Merges two sorted ranges; on ties, items of the first range go first.
+template <typename InputIterator, typename OutputIterator, typename LessThan>
+void serialMerge(InputIterator begin1, InputIterator end1,
+                 InputIterator begin2, InputIterator end2,
+                 OutputIterator result, LessThan lessThan)
+{
+    while (begin1 != end1 && begin2 != end2) {
+        if (lessThan(*begin2, *begin1))
+            *result = *begin2++;
+        else
+            *result = *begin1++;
+        ++result;
+    }
+    for (; begin1 != end1; ++begin1, ++result)
+        *result = *begin1;
+    for (; begin2 != end2; ++begin2, ++result)
+        *result = *begin2;
+}
+
+// Splits merges into pieces that can run independently. A piece boundary
+// is placed at an item of the longer range, and the other range is split
+// where that item would be inserted, on the side that keeps the merge
+// stable.
+template <typename InputIterator, typename OutputIterator, typename LessThan>
+class MergeJobs : public ParallelJobs
+{
+public:
+    explicit MergeJobs(LessThan lessThan)
+        : lessThan(lessThan)
+    {}
+
+    void addMerge(InputIterator begin1, InputIterator end1,
+                  InputIterator begin2, InputIterator end2,
+                  OutputIterator result, int pieceCount)
+    {
+        const int size1 = end1 - begin1;
+        const int size2 = end2 - begin2;
+        pieceCount = qMax(1, qMin(pieceCount, qMax(size1, size2)));
+
+        InputIterator split1 = begin1;
+        InputIterator split2 = begin2;
+        for (int i = 1; i <= pieceCount; ++i) {
+            InputIterator next1 = end1;
+            InputIterator next2 = end2;
+            if (i < pieceCount) {
+                if (size1 >= size2) {
+                    next1 = begin1 + int(qint64(size1) * i / pieceCount);
+                    next2 = qLowerBound(split2, end2, *next1, lessThan);
+                } else {
+                    next2 = begin2 + int(qint64(size2) * i / pieceCount);
+                    next1 = qUpperBound(split1, end1, *next2, lessThan);
+                }
+            }
+
+            Piece piece;
+            piece.begin1 = split1;
+            piece.end1 = next1;
+            piece.begin2 = split2;
+            piece.end2 = next2;
+            piece.result = result + ((split1 - begin1) + (split2 - begin2));
+            pieces.append(piece);
+
+            split1 = next1;
+            split2 = next2;
+        }
+    }
+
+    void run()
+    {
+        ParallelJobs::run(pieces.size());
+    }
+
+protected:
+    void runJob(int index)
+    {
+        const Piece &piece = pieces.at(index);
+        serialMerge(piece.begin1, piece.end1, piece.begin2, piece.end2, piece.result, lessThan);
+    }
+
+private:
+    struct Piece
+    {
+        InputIterator begin1;
+        InputIterator end1;
+        InputIterator begin2;
+        InputIterator end2;
+        OutputIterator result;
+    };
+
+    QVector<Piece> pieces;
+    LessThan lessThan;
+};
+
+// Merges the neighboring runs of width chunks from input into output.
+template <typename InputIterator, typename OutputIterator, typename LessThan>
+void mergeRuns(InputIterator input, OutputIterator output, const QVector<int> &bounds,
+               int width, LessThan lessThan)
+{
+    const int chunkCount = bounds.size() - 1;
+    const int size = bounds.last();
+
+    MergeJobs<InputIterator, OutputIterator, LessThan> jobs(lessThan);
+    for (int i = 0; i < chunkCount; i += 2 * width) {
+        const int begin = bounds.at(i);
+        const int middle = bounds.at(qMin(i + width, chunkCount));
+        const int end = bounds.at(qMin(i + 2 * width, chunkCount));
+        jobs.addMerge(input + begin, input + middle, input + middle, input + end,
+                      output + begin, int(qint64(chunkCount) * (end - begin) / size));
+    }
+    jobs.run();
+}
+
+template <typename RandomAccessIterator, typename T, typename LessThan>
+void parallelSortHelper(RandomAccessIterator begin, RandomAccessIterator end,
+                        const T &, LessThan lessThan, bool stable)
+{
+    const int size = end - begin;
+    const int jobCount = ParallelJobs::idealJobCount();
+    if (size < SortSerialThreshold || jobCount < 2) {
+        if (stable)
+            qStableSort(begin, end, lessThan);
+        else
+            qSort(begin, end, lessThan);
+        return;
+    }
+
+    // Sort chunks independently, then merge them pairwise, going back and
+    // forth between the range and a buffer.
+    int chunkCount = 1;
+    while (chunkCount < 4 * jobCount && size / (2 * chunkCount) >= SortMinimumChunkSize)
+        chunkCount *= 2;
+
+    QVector<int> bounds(chunkCount + 1);
+    for (int i = 0; i <= chunkCount; ++i)
+        bounds[i] = int(qint64(size) * i / chunkCount);
+
+    SortChunkJobs<RandomAccessIterator, LessThan> sortJobs(begin, bounds, lessThan, stable);
+    sortJobs.run(chunkCount);
+
+    QVector<T> buffer(size);
+    T *data = buffer.data();
+    bool inBuffer = false;
+    for (int width = 1; width < chunkCount; width *= 2) {
+        if (inBuffer)
+            mergeRuns(data, begin, bounds, width, lessThan);
+        else
+            mergeRuns(begin, data, bounds, width, lessThan);
+        inBuffer = !inBuffer;
+    }
+
+    // Merging a run with an empty one copies it.
+    if (inBuffer)
+        mergeRuns(data, begin, bounds, chunkCount, lessThan);
+}
+
+template <typename RandomAccessIterator, typename T>
+inline void parallelSortHelper(RandomAccessIterator begin, RandomAccessIterator end,
+                               const T &dummy, bool stable)
+{
+    parallelSortHelper(begin, end, dummy, qLess<T>(), stable);
+}
+
+template <typename InputIterator, typename OutputIterator, typename T, typename LessThan>
+void parallelMergeHelper(InputIterator begin1, InputIterator end1,
+                         InputIterator begin2, InputIterator end2,
+                         OutputIterator result, const T &, LessThan lessThan)
+{
+    const int size = (end1 - begin1) + (end2 - begin2);
+    const int jobCount = ParallelJobs::idealJobCount();
+    if (size < SortSerialThreshold || jobCount < 2) {
+        serialMerge(begin1, end1, begin2, end2, result, lessThan);
+        return;
+    }
+
+    MergeJobs<InputIterator, OutputIterator, LessThan> jobs(lessThan);
+    jobs.addMerge(begin1, end1, begin2, end2, result,
+                  qMin(4 * jobCount, size / SortMinimumChunkSize));
+    jobs.run();
+}
+
+template <typename RandomAccessIterator>
+void blockingSort(RandomAccessIterator begin, RandomAccessIterator end)
+{
+    if (begin != end)
+        parallelSortHelper(begin, end, *begin, false);
+}
+
+template <typename RandomAccessIterator, typename LessThan>
+void blockingSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan)
+{
+    if (begin != end)
+        parallelSortHelper(begin, end, *begin, lessThan, false);
+}
+
+template <typename Container>
+void blockingSort(Container &container)
+{
+    if (!container.isEmpty())
+        parallelSortHelper(container.begin(), container.end(), *container.begin(), false);
+}
+
+template <typename RandomAccessIterator>
+void blockingStableSort(RandomAccessIterator begin, RandomAccessIterator end)
+{
+    if (begin != end)
+        parallelSortHelper(begin, end, *begin, true);
+}
+
+template <typename RandomAccessIterator, typename LessThan>
+void blockingStableSort(RandomAccessIterator begin, RandomAccessIterator end, LessThan lessThan)
+{
+    if (begin != end)
+        parallelSortHelper(begin, end, *begin, lessThan, true);
+}
+
+template <typename Container>
+void blockingStableSort(Container &container)
+{
+    if (!container.isEmpty())
+        parallelSortHelper(container.begin(), container.end(), *container.begin(), true);
+}
+
+template <typename InputIterator, typename OutputIterator, typename LessThan>
+void blockingMerge(InputIterator begin1, InputIterator end1,
+                   InputIterator begin2, InputIterator end2,
+                   OutputIterator result, LessThan lessThan)
+{
+    if (begin1 != end1 || begin2 != end2)
+        parallelMergeHelper(begin1, end1, begin2, end2, result,
+                            begin1 != end1 ? *begin1 : *begin2, lessThan);
+}
+
+template <typename InputIterator, typename OutputIterator, typename T>
+inline void blockingMergeHelper(InputIterator begin1, InputIterator end1,
+                                InputIterator begin2, InputIterator end2,
+                                OutputIterator result, const T &dummy)
+{
+    parallelMergeHelper(begin1, end1, begin2, end2, result, dummy, qLess<T>());
+}
+
+template <typename InputIterator, typename OutputIterator>
+void blockingMerge(InputIterator begin1, InputIterator end1,
+                   InputIterator begin2, InputIterator end2,
+                   OutputIterator result)
+{
+    if (begin1 != end1 || begin2 != end2)
+        blockingMergeHelper(begin1, end1, begin2, end2, result,
+                            begin1 != end1 ? *begin1 : *begin2);
+}
+
+} // namespace QtConcurrent
+
+#endif // qdoc
+
+QT_END_NAMESPACE
+QT_END_HEADER
+
+#endif // QT_NO_CONCURRENT
+
+#endif
@@ -15,6 +15,8 @@ SOURCES += \
     codecs/qtsciicodec.cpp \
     codecs/qutfcodec.cpp
 
+AVX2_SOURCES += codecs/qutfcodec_avx2.cpp
+
 contains(QT_CONFIG,icu) {
     HEADERS += \
         codecs/qicucodec_p.h
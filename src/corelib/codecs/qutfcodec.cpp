@@ -43,11 +43,93 @@
 #include "qlist.h"
 #include "qendian.h"
 #include "qchar.h"
+#include "private/qsimd_p.h"
 
 QT_BEGIN_NAMESPACE
 
 enum { Endian = 0, Data = 1 };
 
+#if defined(QT_COMPILER_SUPPORTS_AVX2) && !defined(QT_BOOTSTRAPPED)
+// in qutfcodec_avx2.cpp
+extern void qt_utf8_encodeAscii_avx2(uchar *&dst, const ushort *&src, const ushort *end);
+extern void qt_utf8_decodeAscii_avx2(ushort *&dst, const uchar *&src, const uchar *end);
+#endif
+
+/*
+    Converts the run of ASCII characters starting at \a src to UTF-8 in
+    blocks. Stops at the first non-ASCII character or when fewer than one
+    block of characters is left, leaving the rest to the caller. Up to 16
+    bytes may be written to \a dst past the characters converted.
+*/
+static inline void simdEncodeAscii(uchar *&dst, const ushort *&src, const ushort *end)
+{
+#if defined(QT_COMPILER_SUPPORTS_AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (end - src >= 32 && qCpuHasFeature(AVX2))
+        qt_utf8_encodeAscii_avx2(dst, src, end);
+#endif
+#if defined(__SSE2__)
+    const __m128i nonAsciiMask = _mm_set1_epi16(short(0xff80));
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; end - src >= 16; src += 16, dst += 16) {
+        const __m128i data1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i data2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 8));
+
+        // two bits set for each ASCII character
+        const uint ascii = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(data1, nonAsciiMask), zero))
+                | (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(data2, nonAsciiMask), zero)) << 16);
+
+        // the packed bytes are correct for all ASCII characters
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_packus_epi16(data1, data2));
+        if (ascii != 0xffffffffU) {
+            const uint n = qCountTrailingZeroBits(~ascii) / 2;
+            src += n;
+            dst += n;
+            return;
+        }
+    }
+#else
+    Q_UNUSED(dst);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+#endif
+}
+
+/*
+    Converts the run of ASCII bytes starting at \a src to UTF-16 in blocks.
+    Stops at the first non-ASCII byte or when fewer than one block of bytes
+    is left. Up to 16 characters may be written to \a dst past the bytes
+    converted.
+*/
+static inline void simdDecodeAscii(ushort *&dst, const uchar *&src, const uchar *end)
+{
+#if defined(QT_COMPILER_SUPPORTS_AVX2) && !defined(QT_BOOTSTRAPPED)
+    if (end - src >= 32 && qCpuHasFeature(AVX2))
+        qt_utf8_decodeAscii_avx2(dst, src, end);
+#endif
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; end - src >= 16; src += 16, dst += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+
+        // one bit set for each non-ASCII byte
+        const uint nonAscii = _mm_movemask_epi8(data);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi8(data, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 8), _mm_unpackhi_epi8(data, zero));
+        if (nonAscii) {
+            const uint n = qCountTrailingZeroBits(nonAscii);
+            src += n;
+            dst += n;
+            return;
+        }
+    }
+#else
+    Q_UNUSED(dst);
+    Q_UNUSED(src);
+    Q_UNUSED(end);
+#endif
+}
+
 QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len, QTextCodec::ConverterState *state)
 {
     uchar replacement = '?';
@@ -102,6 +184,13 @@ QByteArray QUtf8::convertFromUnicode(const QChar *uc, int len, QTextCodec::Conve
 
         if (u < 0x80) {
             *cursor++ = (uchar)u;
+            ++ch;
+
+            // most text is mostly ASCII, convert the rest of the run in blocks
+            const ushort *src = reinterpret_cast<const ushort *>(ch);
+            simdEncodeAscii(cursor, src, reinterpret_cast<const ushort *>(end));
+            ch = reinterpret_cast<const QChar *>(src);
+            continue;
         } else {
             if (u < 0x0800) {
                 *cursor++ = 0xc0 | ((uchar) (u >> 6));
@@ -171,6 +260,7 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
     ushort *qch = (ushort *)result.unicode();
     uchar ch;
     int invalid = 0;
+    const uchar *end = reinterpret_cast<const uchar *>(chars) + len;
 
     for (int i = 0; i < len; ++i) {
         ch = chars[i];
@@ -209,7 +299,42 @@ QString QUtf8::convertToUnicode(const char *chars, int len, QTextCodec::Converte
             if (ch < 128) {
                 *qch++ = ushort(ch);
                 headerdone = true;
-            } else if ((ch & 0xe0) == 0xc0) {
+
+                // most text is mostly ASCII, convert the rest of the run in blocks
+                const uchar *src = reinterpret_cast<const uchar *>(chars) + i + 1;
+                simdDecodeAscii(qch, src, end);
+                i = src - reinterpret_cast<const uchar *>(chars) - 1;
+                continue;
+            }
+
+            // decode complete two and three byte sequences directly, and
+            // leave the error handling and sequences that continue in the
+            // next chunk to the state machine below
+            if ((ch & 0xe0) == 0xc0 && i + 1 < len) {
+                const uchar ch1 = chars[i + 1];
+                uc = ((ch & 0x1f) << 6) | (ch1 & 0x3f);
+                if ((ch1 & 0xc0) == 0x80 && uc >= 0x80) {
+                    *qch++ = uc;
+                    headerdone = true;
+                    ++i;
+                    continue;
+                }
+            } else if ((ch & 0xf0) == 0xe0 && i + 2 < len) {
+                const uchar ch1 = chars[i + 1];
+                const uchar ch2 = chars[i + 2];
+                uc = ((ch & 0x0f) << 12) | ((ch1 & 0x3f) << 6) | (ch2 & 0x3f);
+                if ((ch1 & 0xc0) == 0x80 && (ch2 & 0xc0) == 0x80 && uc >= 0x800
+                        && !QChar::isSurrogate(uc) && !QChar::isNonCharacter(uc)) {
+                    // utf-8 bom composes into 0xfeff code point
+                    if (headerdone || uc != 0xfeff)
+                        *qch++ = uc;
+                    headerdone = true;
+                    i += 2;
+                    continue;
+                }
+            }
+
+            if ((ch & 0xe0) == 0xc0) {
                 uc = ch & 0x1f;
                 need = 1;
                 error = i;
@@ -0,0 +1,87 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <private/qsimd_p.h>
+
+QT_BEGIN_NAMESPACE
+
+#ifdef QT_COMPILER_SUPPORTS_AVX2
+
+#ifndef __AVX2__
+#error "AVX2 not enabled in this file, cannot proceed"
+#endif
+
+// These convert 32 characters at a time, and stop at the first block that
+// is not entirely ASCII; the SSE2 code in qutfcodec.cpp takes it from there.
+
+void qt_utf8_encodeAscii_avx2(uchar *&dst, const ushort *&src, const ushort *end)
+{
+    const __m256i nonAsciiMask = _mm256_set1_epi16(short(0xff80));
+    for ( ; end - src >= 32; src += 32, dst += 32) {
+        const __m256i data1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        const __m256i data2 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 16));
+        if (!_mm256_testz_si256(_mm256_or_si256(data1, data2), nonAsciiMask))
+            return;
+
+        // packing works on each 128-bit lane separately, put the quadwords
+        // back in order
+        const __m256i packed = _mm256_packus_epi16(data1, data2);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_permute4x64_epi64(packed, 0xd8));
+    }
+}
+
+void qt_utf8_decodeAscii_avx2(ushort *&dst, const uchar *&src, const uchar *end)
+{
+    for ( ; end - src >= 32; src += 32, dst += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+        if (_mm256_movemask_epi8(data))
+            return;
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),
+                            _mm256_cvtepu8_epi16(_mm256_castsi256_si128(data)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 16),
+                            _mm256_cvtepu8_epi16(_mm256_extracti128_si256(data, 1)));
+    }
+}
+
+#endif
+
+QT_END_NAMESPACE
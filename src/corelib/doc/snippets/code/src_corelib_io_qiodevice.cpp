@@ -97,3 +97,18 @@ bool isExeFile(QFile *file)
     return file->peek(2) == "MZ";
 }
 //! [5]
+
+
+//! [6]
+quint32 checksum(QIODevice *device)
+{
+    quint32 sum = 0;
+    qint64 size;
+    while (const char *data = device->peekView(&size)) {
+        for (qint64 i = 0; i < size; ++i)
+            sum += uchar(data[i]);
+        device->skip(size);
+    }
+    return sum;
+}
+//! [6]
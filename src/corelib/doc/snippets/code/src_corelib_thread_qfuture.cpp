@@ -62,3 +62,12 @@ i.toBack();
 while (i.hasPrevious())
     qDebug() << i.previous();
 //! [2]
+
+
+//! [3]
+QImage scale(const QImage &image);
+QByteArray compress(const QImage &image);
+
+QFuture<QImage> future = QtConcurrent::run(loadImage, fileName);
+QFuture<QByteArray> compressed = future.then(scale).then(compress);
+//! [3]
@@ -60,3 +60,11 @@
     QLatin1String world("world");
     QString message =  hello % el % world % QChar('!');
 //! [5]
+
+//! [6]
+    int line = 42;
+    double elapsed = 0.125;
+    QString message = fileName % QLatin1Char(':') % QStringNumber(line)
+                      % QLatin1String(" took ") % QStringNumber(elapsed, 'f', 3)
+                      % QLatin1String(" s");
+//! [6]
@@ -3,6 +3,7 @@
 HEADERS +=  \
         io/qabstractfileengine_p.h \
         io/qbuffer.h \
+        io/qcompressiondevice.h \
         io/qdatastream.h \
         io/qdatastream_p.h \
         io/qdataurl_p.h \
@@ -47,6 +48,7 @@ HEADERS +=  \
 SOURCES += \
         io/qabstractfileengine.cpp \
         io/qbuffer.cpp \
+        io/qcompressiondevice.cpp \
         io/qdatastream.cpp \
         io/qdataurl.cpp \
         io/qtldurl.cpp \
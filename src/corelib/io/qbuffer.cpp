@@ -65,6 +65,8 @@ public:
 
     virtual qint64 peek(char *data, qint64 maxSize);
     virtual QByteArray peek(qint64 maxSize);
+    virtual const char *peekView(qint64 *size);
+    virtual qint64 skip(qint64 maxSize);
 
 #ifndef QT_NO_QOBJECT
     // private slots
@@ -102,6 +104,23 @@ QByteArray QBufferPrivate::peek(qint64 maxSize)
     return QByteArray(buf->constData() + pos, readBytes);
 }
 
+const char *QBufferPrivate::peekView(qint64 *size)
+{
+    // The read buffer only ever holds a copy of the byte array, so the data
+    // can be handed out directly.
+    *size = qMax(qint64(0), static_cast<qint64>(buf->size()) - pos);
+    return *size ? buf->constData() + pos : 0;
+}
+
+qint64 QBufferPrivate::skip(qint64 maxSize)
+{
+    Q_Q(QBuffer);
+    const qint64 skipped = qBound(qint64(0), maxSize, static_cast<qint64>(buf->size()) - pos);
+    if (skipped > 0 && !q->seek(pos + skipped))
+        return qint64(-1);
+    return skipped;
+}
+
 /*!
     \class QBuffer
     \inmodule QtCore
@@ -0,0 +1,613 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qcompressiondevice.h"
+
+#ifndef QT_NO_COMPRESS
+
+#include "qbuffer.h"
+#include "private/qiodevice_p.h"
+
+#include <zlib.h>
+
+QT_BEGIN_NAMESPACE
+
+enum {
+    DefaultBufferSize = 64 * 1024,
+    MinimumBufferSize = 64,
+    // zlib counts in uInt; keep single calls well inside that range
+    MaximumChunkSize = 1 << 30
+};
+
+/** QCompressionDevicePrivate **/
+class QCompressionDevicePrivate : public QIODevicePrivate
+{
+    Q_DECLARE_PUBLIC(QCompressionDevice)
+
+public:
+    QCompressionDevicePrivate()
+        : device(0), format(QCompressionDevice::GzipFormat), compressionLevel(-1),
+          bufferSize(DefaultBufferSize), streamInitialized(false), inputEnded(false),
+          streamEnded(false), failed(false)
+    {
+        memset(&zstream, 0, sizeof(zstream));
+    }
+
+    int windowBits() const;
+    bool initStream(QIODevice::OpenMode mode);
+    void endStream();
+    bool fillInput();
+    bool deflateBuffered(int flush);
+    void setZlibError(const QString &what, int ret);
+
+    QIODevice *device;
+    QCompressionDevice::Format format;
+    int compressionLevel;
+    int bufferSize;
+
+    z_stream zstream;
+    QByteArray buffer;
+    bool streamInitialized;
+    bool inputEnded;
+    bool streamEnded;
+    bool failed;
+};
+
+int QCompressionDevicePrivate::windowBits() const
+{
+    switch (format) {
+    case QCompressionDevice::ZlibFormat:
+        return MAX_WBITS;
+    case QCompressionDevice::GzipFormat:
+        return MAX_WBITS + 16;  // gzip header and trailer
+    case QCompressionDevice::RawDeflateFormat:
+        break;
+    }
+    return -MAX_WBITS;          // no header at all
+}
+
+bool QCompressionDevicePrivate::initStream(QIODevice::OpenMode mode)
+{
+    memset(&zstream, 0, sizeof(zstream));
+    buffer.resize(bufferSize);
+    inputEnded = streamEnded = failed = false;
+
+    int ret;
+    if (mode & QIODevice::ReadOnly) {
+        ret = inflateInit2(&zstream, windowBits());
+    } else {
+        ret = deflateInit2(&zstream, compressionLevel, Z_DEFLATED, windowBits(),
+                           8, Z_DEFAULT_STRATEGY);
+    }
+    if (ret != Z_OK) {
+        setZlibError(QCompressionDevice::tr("Cannot initialize compression stream"), ret);
+        buffer.clear();
+        return false;
+    }
+    streamInitialized = true;
+    return true;
+}
+
+void QCompressionDevicePrivate::endStream()
+{
+    if (!streamInitialized)
+        return;
+    if (openMode & QIODevice::ReadOnly)
+        inflateEnd(&zstream);
+    else
+        deflateEnd(&zstream);
+    streamInitialized = false;
+    buffer.clear();
+}
+
+/*!
+    \internal
+
+    Refills the input buffer from the underlying device. Returns false
+    if no compressed data is available at the moment; inputEnded is set
+    when the device will not deliver any more.
+*/
+bool QCompressionDevicePrivate::fillInput()
+{
+    if (inputEnded)
+        return false;
+    const qint64 n = device->read(buffer.data(), buffer.size());
+    if (n > 0) {
+        zstream.next_in = reinterpret_cast<Bytef *>(buffer.data());
+        zstream.avail_in = uInt(n);
+        return true;
+    }
+    if (n < 0 || !device->isSequential() || !device->isOpen())
+        inputEnded = true;
+    return false;
+}
+
+/*!
+    \internal
+
+    Runs deflate() on the pending input with \a flush and writes every
+    produced byte to the underlying device.
+*/
+bool QCompressionDevicePrivate::deflateBuffered(int flush)
+{
+    Q_Q(QCompressionDevice);
+    do {
+        zstream.next_out = reinterpret_cast<Bytef *>(buffer.data());
+        zstream.avail_out = uInt(buffer.size());
+        const int ret = deflate(&zstream, flush);
+        if (ret == Z_STREAM_ERROR) {
+            setZlibError(QCompressionDevice::tr("Compression failed"), ret);
+            return false;
+        }
+        const qint64 produced = buffer.size() - zstream.avail_out;
+        if (produced && device->write(buffer.constData(), produced) != produced) {
+            failed = true;
+            q->setErrorString(QCompressionDevice::tr("Cannot write compressed data: %1")
+                              .arg(device->errorString()));
+            return false;
+        }
+    } while (zstream.avail_out == 0);
+    return true;
+}
+
+void QCompressionDevicePrivate::setZlibError(const QString &what, int ret)
+{
+    Q_Q(QCompressionDevice);
+    failed = true;
+    QString reason;
+    if (zstream.msg)
+        reason = QString::fromLatin1(zstream.msg);
+    else if (ret == Z_MEM_ERROR)
+        reason = QCompressionDevice::tr("out of memory");
+    else
+        reason = QCompressionDevice::tr("zlib error %1").arg(ret);
+    q->setErrorString(QString::fromLatin1("%1: %2").arg(what, reason));
+}
+
+/*!
+    \class QCompressionDevice
+    \inmodule QtCore
+    \reentrant
+    \since 5.1
+    \brief The QCompressionDevice class compresses or decompresses a
+    stream of data on top of another QIODevice.
+
+    \ingroup io
+
+    QCompressionDevice wraps another QIODevice and runs everything that
+    passes through it through zlib. Opened with QIODevice::WriteOnly,
+    the data written to it is compressed and written to the underlying
+    device; opened with QIODevice::ReadOnly, the compressed data read
+    from the underlying device is decompressed and handed out by read().
+    Only one direction can be used at a time.
+
+    Unlike qCompress() and qUncompress(), which need the whole data in
+    memory, the device works on streams of any length with a bounded
+    amount of memory: a working buffer of bufferSize() bytes plus the
+    zlib state. It also understands the formats used by other tools:
+
+    \table
+    \header \li Format \li Description
+    \row \li ZlibFormat \li The zlib format (RFC 1950) produced by
+        qCompress(), without the four byte length prefix qCompress() adds.
+    \row \li GzipFormat \li The gzip format (RFC 1952) used by the gzip
+        tool and by HTTP's \c{Content-Encoding: gzip}. When reading,
+        concatenated gzip members are decompressed as one stream.
+    \row \li RawDeflateFormat \li A raw deflate stream (RFC 1951), as
+        found inside ZIP archives.
+    \endtable
+
+    Writing a gzip file:
+
+    \snippet code/src_corelib_io_qcompressiondevice.cpp 0
+
+    Reading it back line by line:
+
+    \snippet code/src_corelib_io_qcompressiondevice.cpp 1
+
+    The underlying device must already be open in the matching mode
+    when open() is called, and it remains open after close(), which
+    writes the end of the compressed stream. The device is always
+    sequential; seeking is not supported.
+
+    If the compressed data is corrupt or ends prematurely, read()
+    returns -1 and errorString() describes the problem. For sequential
+    underlying devices, such as sockets, QCompressionDevice cannot tell
+    a stream that ended prematurely from one that has not fully arrived
+    yet; atEnd() only returns true once the end of the compressed stream
+    has been seen.
+
+    For data that is already in memory, the static compressData() and
+    decompressData() functions are convenient shortcuts.
+
+    \sa qCompress(), qUncompress(), QBuffer
+*/
+
+/*!
+    \enum QCompressionDevice::Format
+
+    This enum describes the framing of the compressed data.
+
+    \value ZlibFormat Deflate data with a zlib header and checksum.
+    \value GzipFormat Deflate data with a gzip header and trailer.
+    \value RawDeflateFormat Deflate data without header or checksum.
+*/
+
+/*!
+    Constructs a QCompressionDevice that compresses into or decompresses
+    from \a device, using the given \a format. The \a parent is passed
+    to QObject's constructor.
+
+    The \a device is not owned by the QCompressionDevice.
+*/
+QCompressionDevice::QCompressionDevice(QIODevice *device, Format format, QObject *parent)
+    : QIODevice(*new QCompressionDevicePrivate, parent)
+{
+    Q_D(QCompressionDevice);
+    d->device = device;
+    d->format = format;
+}
+
+/*!
+    Destroys the QCompressionDevice, calling close() first if the
+    device is still open.
+*/
+QCompressionDevice::~QCompressionDevice()
+{
+    if (isOpen())
+        close();
+}
+
+/*!
+    Returns the device the compressed data is read from or written to.
+*/
+QIODevice *QCompressionDevice::device() const
+{
+    Q_D(const QCompressionDevice);
+    return d->device;
+}
+
+/*!
+    Returns the format of the compressed data.
+*/
+QCompressionDevice::Format QCompressionDevice::format() const
+{
+    Q_D(const QCompressionDevice);
+    return d->format;
+}
+
+/*!
+    Sets the compression level used when writing to \a level, which
+    ranges from 0 (no compression) to 9 (best compression). The default
+    value is -1, which specifies zlib's default compression.
+
+    The level takes effect the next time the device is opened for
+    writing.
+
+    \sa compressionLevel()
+*/
+void QCompressionDevice::setCompressionLevel(int level)
+{
+    Q_D(QCompressionDevice);
+    d->compressionLevel = qBound(-1, level, 9);
+}
+
+/*!
+    Returns the compression level used when writing.
+
+    \sa setCompressionLevel()
+*/
+int QCompressionDevice::compressionLevel() const
+{
+    Q_D(const QCompressionDevice);
+    return d->compressionLevel;
+}
+
+/*!
+    Sets the size of the working buffer to \a size bytes. This is the
+    largest chunk the device reads from, or writes to, the underlying
+    device at once. The default is 64 KB; larger buffers mean fewer
+    calls into the underlying device, smaller ones less memory.
+
+    The size takes effect the next time the device is opened.
+
+    \sa bufferSize()
+*/
+void QCompressionDevice::setBufferSize(int size)
+{
+    Q_D(QCompressionDevice);
+    d->bufferSize = qBound(int(MinimumBufferSize), size, int(MaximumChunkSize));
+}
+
+/*!
+    Returns the size of the working buffer in bytes.
+
+    \sa setBufferSize()
+*/
+int QCompressionDevice::bufferSize() const
+{
+    Q_D(const QCompressionDevice);
+    return d->bufferSize;
+}
+
+/*!
+    \reimp
+
+    Opens the device in \a mode, which must contain exactly one of
+    QIODevice::ReadOnly (to decompress) and QIODevice::WriteOnly (to
+    compress). The underlying device must already be open for reading
+    or writing, respectively.
+*/
+bool QCompressionDevice::open(OpenMode mode)
+{
+    Q_D(QCompressionDevice);
+    if (isOpen()) {
+        qWarning("QCompressionDevice::open: Device already open");
+        return false;
+    }
+    if ((mode & ReadWrite) == ReadWrite || !(mode & ReadWrite)) {
+        qWarning("QCompressionDevice::open: Device must be opened either ReadOnly or WriteOnly");
+        return false;
+    }
+    if (!d->device || !(d->device->openMode() & mode & ReadWrite)) {
+        qWarning("QCompressionDevice::open: Underlying device is not open in a compatible mode");
+        return false;
+    }
+    mode &= ~(Append | Truncate | Text);
+    if (!d->initStream(mode))
+        return false;
+
+    if (mode & ReadOnly)
+        connect(d->device, SIGNAL(readyRead()), this, SIGNAL(readyRead()));
+    return QIODevice::open(mode);
+}
+
+/*!
+    \reimp
+
+    When writing, finishes the compressed stream and writes it to the
+    underlying device. The underlying device itself is not closed.
+*/
+void QCompressionDevice::close()
+{
+    Q_D(QCompressionDevice);
+    if (!isOpen())
+        return;
+    if ((openMode() & WriteOnly) && d->streamInitialized && !d->failed) {
+        d->zstream.next_in = 0;
+        d->zstream.avail_in = 0;
+        d->deflateBuffered(Z_FINISH);
+    }
+    if (openMode() & ReadOnly)
+        disconnect(d->device, SIGNAL(readyRead()), this, SIGNAL(readyRead()));
+    d->endStream();
+    QIODevice::close();
+}
+
+/*!
+    Writes all data compressed so far to the underlying device, aligned
+    to a byte boundary so that a reader can decompress everything
+    written up to this point. Flushing too often degrades compression.
+
+    Returns true on success; otherwise returns false. Does nothing if
+    the device is not open for writing.
+*/
+bool QCompressionDevice::flush()
+{
+    Q_D(QCompressionDevice);
+    if (!(openMode() & WriteOnly) || !d->streamInitialized || d->failed)
+        return false;
+    d->zstream.next_in = 0;
+    d->zstream.avail_in = 0;
+    return d->deflateBuffered(Z_SYNC_FLUSH);
+}
+
+/*!
+    \reimp
+
+    Always returns true.
+*/
+bool QCompressionDevice::isSequential() const
+{
+    return true;
+}
+
+/*!
+    \reimp
+
+    Returns true once the end of the compressed stream has been reached
+    and all decompressed data has been read, or after an error.
+*/
+bool QCompressionDevice::atEnd() const
+{
+    Q_D(const QCompressionDevice);
+    if (!(openMode() & ReadOnly))
+        return true;
+    return (d->streamEnded || d->failed) && QIODevice::bytesAvailable() == 0;
+}
+
+/*!
+    \reimp
+
+    The decompressed size of the pending data is not known in advance;
+    besides the bytes already decompressed, this function reports the
+    number of compressed bytes waiting to be decompressed.
+*/
+qint64 QCompressionDevice::bytesAvailable() const
+{
+    Q_D(const QCompressionDevice);
+    qint64 available = QIODevice::bytesAvailable();
+    if ((openMode() & ReadOnly) && !d->streamEnded && !d->failed)
+        available += d->zstream.avail_in + d->device->bytesAvailable();
+    return available;
+}
+
+/*!
+    \reimp
+*/
+qint64 QCompressionDevice::readData(char *data, qint64 maxSize)
+{
+    Q_D(QCompressionDevice);
+    if (d->failed)
+        return -1;
+    if (d->streamEnded || maxSize <= 0)
+        return 0;
+
+    d->zstream.next_out = reinterpret_cast<Bytef *>(data);
+    d->zstream.avail_out = uInt(qMin(maxSize, qint64(MaximumChunkSize)));
+    const uInt requested = d->zstream.avail_out;
+
+    while (d->zstream.avail_out) {
+        if (!d->zstream.avail_in && !d->fillInput())
+            break;
+        const int ret = inflate(&d->zstream, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END) {
+            // gzip files may consist of several members back to back
+            if (d->format == GzipFormat && (d->zstream.avail_in || d->fillInput())) {
+                inflateReset(&d->zstream);
+                continue;
+            }
+            d->streamEnded = true;
+            break;
+        }
+        if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            d->setZlibError(tr("Cannot decompress data"), ret);
+            break;
+        }
+    }
+
+    const qint64 produced = requested - d->zstream.avail_out;
+    if (produced)
+        return produced;
+    if (d->failed)
+        return -1;
+    if (d->inputEnded && !d->streamEnded) {
+        d->failed = true;
+        setErrorString(tr("Unexpected end of compressed data"));
+        return -1;
+    }
+    return 0;
+}
+
+/*!
+    \reimp
+*/
+qint64 QCompressionDevice::writeData(const char *data, qint64 size)
+{
+    Q_D(QCompressionDevice);
+    if (d->failed)
+        return -1;
+
+    qint64 remaining = size;
+    while (remaining > 0) {
+        const qint64 chunk = qMin(remaining, qint64(MaximumChunkSize));
+        d->zstream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        d->zstream.avail_in = uInt(chunk);
+        if (!d->deflateBuffered(Z_NO_FLUSH))
+            return -1;
+        data += chunk;
+        remaining -= chunk;
+    }
+    return size;
+}
+
+/*!
+    Compresses \a data into the given \a format using \a compressionLevel
+    and returns the result. Unlike qCompress(), no length prefix is
+    added, so the result of compressing with GzipFormat is a valid gzip
+    file.
+
+    \sa decompressData(), qCompress()
+*/
+QByteArray QCompressionDevice::compressData(const QByteArray &data, Format format,
+                                            int compressionLevel)
+{
+    QByteArray result;
+    QBuffer buffer(&result);
+    buffer.open(QIODevice::WriteOnly);
+    QCompressionDevice device(&buffer, format);
+    device.setCompressionLevel(compressionLevel);
+    device.setBufferSize(qBound(int(MinimumBufferSize), data.size() / 2 + 64,
+                                int(DefaultBufferSize)));
+    if (!device.open(QIODevice::WriteOnly)
+        || device.write(data) != data.size())
+        return QByteArray();
+    device.close();
+    return result;
+}
+
+/*!
+    Decompresses \a data, which must be complete compressed data in the
+    given \a format, and returns the result. Returns an empty
+    QByteArray if the data is corrupt or truncated.
+
+    \sa compressData(), qUncompress()
+*/
+QByteArray QCompressionDevice::decompressData(const QByteArray &data, Format format)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QCompressionDevice device(&buffer, format);
+    if (!device.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    QByteArray result;
+    qint64 size = 0;
+    qint64 n;
+    result.resize(qBound(256, data.size() * 4, int(DefaultBufferSize)));
+    forever {
+        if (size == result.size())
+            result.resize(result.size() * 2);
+        n = device.read(result.data() + size, result.size() - size);
+        if (n <= 0)
+            break;
+        size += n;
+    }
+    if (n < 0 || !device.atEnd())
+        return QByteArray();
+    result.resize(size);
+    return result;
+}
+
+QT_END_NAMESPACE
+
+#endif // QT_NO_COMPRESS
@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QCOMPRESSIONDEVICE_H
+#define QCOMPRESSIONDEVICE_H
+
+#include <QtCore/qiodevice.h>
+
+QT_BEGIN_HEADER
+
+QT_BEGIN_NAMESPACE
+
+
+#ifndef QT_NO_COMPRESS
+
+class QCompressionDevicePrivate;
+
+class Q_CORE_EXPORT QCompressionDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    enum Format {
+        ZlibFormat,
+        GzipFormat,
+        RawDeflateFormat
+    };
+
+    explicit QCompressionDevice(QIODevice *device, Format format = GzipFormat,
+                                QObject *parent = 0);
+    ~QCompressionDevice();
+
+    QIODevice *device() const;
+    Format format() const;
+
+    void setCompressionLevel(int level);
+    int compressionLevel() const;
+
+    void setBufferSize(int size);
+    int bufferSize() const;
+
+    bool open(OpenMode mode);
+    void close();
+    bool flush();
+
+    bool isSequential() const;
+    bool atEnd() const;
+    qint64 bytesAvailable() const;
+
+    static QByteArray compressData(const QByteArray &data, Format format = GzipFormat,
+                               int compressionLevel = -1);
+    static QByteArray decompressData(const QByteArray &data, Format format = GzipFormat);
+
+protected:
+    qint64 readData(char *data, qint64 maxSize);
+    qint64 writeData(const char *data, qint64 size);
+
+private:
+    Q_DECLARE_PRIVATE(QCompressionDevice)
+    Q_DISABLE_COPY(QCompressionDevice)
+};
+
+#endif // QT_NO_COMPRESS
+
+QT_END_NAMESPACE
+
+QT_END_HEADER
+
+#endif // QCOMPRESSIONDEVICE_H
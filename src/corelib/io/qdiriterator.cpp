@@ -85,6 +85,14 @@
     enables iterating through all subdirectories of the assigned path,
     following all symbolic links. Symbolic link loops (e.g., "link" => "." or
     "link" => "..") are automatically detected and ignored.
+
+    \value ParallelTraversal When combined with Subdirectories, the
+    directory tree is read by several threads of the global QThreadPool
+    while the caller consumes the entries, one task per subdirectory.
+    Entries are then returned in no particular order, and entries of
+    different directories are interleaved. The flag is ignored for paths
+    handled by a QAbstractFileEngine, such as resources. This value was
+    introduced in Qt 5.1.
 */
 
 #include "qdiriterator.h"
@@ -101,6 +109,14 @@
 #include <QtCore/private/qfilesystemengine_p.h>
 #include <QtCore/private/qfileinfo_p.h>
 
+#if !defined(QT_NO_FILESYSTEMITERATOR) && !defined(QT_NO_THREAD) && !defined(QT_BOOTSTRAPPED)
+#  define QT_DIRITERATOR_PARALLEL
+#  include <QtCore/qqueue.h>
+#  include <QtCore/qmutex.h>
+#  include <QtCore/qwaitcondition.h>
+#  include <QtCore/qthreadpool.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 template <class Iterator>
@@ -113,6 +129,10 @@ public:
     }
 };
 
+#ifdef QT_DIRITERATOR_PARALLEL
+class QDirIteratorParallelWalker;
+#endif
+
 class QDirIteratorPrivate
 {
 public:
@@ -124,6 +144,7 @@ public:
     bool entryMatches(const QString & fileName, const QFileInfo &fileInfo);
     void pushDirectory(const QFileInfo &fileInfo);
     void checkAndPushDirectory(const QFileInfo &);
+    bool shouldDescendInto(const QFileInfo &fileInfo) const;
     bool matchesFilters(const QString &fileName, const QFileInfo &fi) const;
 
     QScopedPointer<QAbstractFileEngine> engine;
@@ -147,8 +168,199 @@ public:
 
     // Loop protection
     QSet<QString> visitedLinks;
+
+#ifdef QT_DIRITERATOR_PARALLEL
+    // Declared last, so that the worker threads are gone before
+    // anything they use is destroyed
+    QScopedPointer<QDirIteratorParallelWalker> walker;
+    bool walkerHasNext;
+#endif
 };
 
+#ifdef QT_DIRITERATOR_PARALLEL
+/*!
+    \internal
+
+    Reads a directory tree on the thread that iterates and on idle threads
+    of the global thread pool, one directory at a time, and hands the
+    matching entries to the thread that iterates. Entries are passed on in
+    batches to keep the lock traffic low.
+
+    Helpers are only started on idle pool threads, and the iterating thread
+    scans queued directories itself while it waits for entries, so the walk
+    also completes when the pool is busy or when it runs on a pool thread.
+*/
+class QDirIteratorParallelWalker
+{
+public:
+    explicit QDirIteratorParallelWalker(QDirIteratorPrivate *d)
+        : d(d), activeScans(0), helpers(0)
+    { }
+    ~QDirIteratorParallelWalker();
+
+    void start(const QFileSystemEntry &root) { schedule(root); }
+    bool takeNext(QFileInfo *fileInfo);
+
+    void work();
+
+private:
+    enum { BatchSize = 256 };
+
+    void schedule(const QFileSystemEntry &directory);
+    bool scanQueuedDirectory(QMutexLocker *locker);
+    void scan(const QFileSystemEntry &directory);
+    void publish(QList<QFileInfo> *batch);
+
+    QDirIteratorPrivate *d;
+
+    QMutex mutex;
+    QWaitCondition changed;
+    QQueue<QFileSystemEntry> directories;
+    QQueue<QFileInfo> results;
+    int activeScans;
+    int helpers;
+    QAtomicInt cancelled;
+};
+
+class QDirIteratorScanTask : public QRunnable
+{
+public:
+    explicit QDirIteratorScanTask(QDirIteratorParallelWalker *walker)
+        : walker(walker)
+    { }
+
+    void run() { walker->work(); }
+
+private:
+    QDirIteratorParallelWalker *walker;
+};
+
+QDirIteratorParallelWalker::~QDirIteratorParallelWalker()
+{
+    cancelled.store(1);
+    QMutexLocker locker(&mutex);
+    directories.clear();
+    while (helpers)
+        changed.wait(&mutex);
+}
+
+void QDirIteratorParallelWalker::schedule(const QFileSystemEntry &directory)
+{
+    QMutexLocker locker(&mutex);
+    directories.enqueue(directory);
+    changed.wakeAll();
+    if (helpers >= QThreadPool::globalInstance()->maxThreadCount())
+        return;
+    ++helpers;
+    locker.unlock();
+
+    // never queue a helper behind busy threads; it might never run
+    QDirIteratorScanTask *task = new QDirIteratorScanTask(this);
+    if (!QThreadPool::globalInstance()->tryStart(task)) {
+        delete task;
+        locker.relock();
+        --helpers;
+        changed.wakeAll();
+    }
+}
+
+/*!
+    \internal
+
+    Scans the next queued directory, if any, with \a locker unlocked
+    during the scan. Returns false if there was nothing to scan.
+*/
+bool QDirIteratorParallelWalker::scanQueuedDirectory(QMutexLocker *locker)
+{
+    if (cancelled.load() || directories.isEmpty())
+        return false;
+    const QFileSystemEntry directory = directories.dequeue();
+    ++activeScans;
+    locker->unlock();
+    scan(directory);
+    locker->relock();
+    --activeScans;
+    changed.wakeAll();
+    return true;
+}
+
+void QDirIteratorParallelWalker::work()
+{
+    QMutexLocker locker(&mutex);
+    while (scanQueuedDirectory(&locker))
+        ;
+    --helpers;
+    changed.wakeAll();
+}
+
+void QDirIteratorParallelWalker::publish(QList<QFileInfo> *batch)
+{
+    if (batch->isEmpty())
+        return;
+    QMutexLocker locker(&mutex);
+    results += *batch;
+    batch->clear();
+    changed.wakeAll();
+}
+
+bool QDirIteratorParallelWalker::takeNext(QFileInfo *fileInfo)
+{
+    QMutexLocker locker(&mutex);
+    forever {
+        if (!results.isEmpty()) {
+            *fileInfo = results.dequeue();
+            return true;
+        }
+        if (scanQueuedDirectory(&locker))
+            continue;
+        if (!activeScans)
+            return false;
+        changed.wait(&mutex);
+    }
+}
+
+void QDirIteratorParallelWalker::scan(const QFileSystemEntry &directory)
+{
+    QFileSystemIterator it(directory, d->filters, d->nameFilters, d->iteratorFlags);
+    QFileSystemEntry entry;
+    QFileSystemMetaData metaData;
+    QList<QFileInfo> batch;
+
+    while (!cancelled.load() && it.advance(entry, metaData)) {
+        QFileInfo info(new QFileInfoPrivate(entry, metaData));
+
+        if (d->shouldDescendInto(info)) {
+            bool descend = true;
+            if (d->iteratorFlags & QDirIterator::FollowSymlinks) {
+                // Stop link loops; the set is shared by all scans
+                const QString canonicalPath = info.canonicalFilePath();
+                QMutexLocker locker(&mutex);
+                if (d->visitedLinks.contains(canonicalPath))
+                    descend = false;
+                else
+                    d->visitedLinks.insert(canonicalPath);
+            }
+            if (descend) {
+#ifdef Q_OS_WIN
+                if (info.isSymLink()) {
+                    schedule(QFileSystemEntry(info.canonicalFilePath()));
+                } else
+#endif
+                schedule(entry);
+            }
+        }
+
+        if (d->matchesFilters(entry.fileName(), info)) {
+            batch.append(info);
+            if (batch.size() >= BatchSize)
+                publish(&batch);
+        }
+    }
+
+    publish(&batch);
+}
+#endif // QT_DIRITERATOR_PARALLEL
+
 /*!
     \internal
 */
@@ -172,6 +384,19 @@ QDirIteratorPrivate::QDirIteratorPrivate(const QFileSystemEntry &entry, const QS
         engine.reset(QFileSystemEngine::resolveEntryAndCreateLegacyEngine(dirEntry, metaData));
     QFileInfo fileInfo(new QFileInfoPrivate(dirEntry, metaData));
 
+#ifdef QT_DIRITERATOR_PARALLEL
+    walkerHasNext = false;
+    if (!engine && (flags & QDirIterator::ParallelTraversal)
+        && (flags & QDirIterator::Subdirectories)) {
+        if (iteratorFlags & QDirIterator::FollowSymlinks)
+            visitedLinks << fileInfo.canonicalFilePath();
+        walker.reset(new QDirIteratorParallelWalker(this));
+        walker->start(fileInfo.d_ptr->fileEntry);
+        advance();
+        return;
+    }
+#endif
+
     // Populate fields for hasNext() and next()
     pushDirectory(fileInfo);
     advance();
@@ -230,6 +455,16 @@ inline bool QDirIteratorPrivate::entryMatches(const QString & fileName, const QF
 */
 void QDirIteratorPrivate::advance()
 {
+#ifdef QT_DIRITERATOR_PARALLEL
+    if (walker) {
+        QFileInfo fileInfo;
+        walkerHasNext = walker->takeNext(&fileInfo);
+        currentFileInfo = nextFileInfo;
+        nextFileInfo = fileInfo;
+        return;
+    }
+#endif
+
     if (engine) {
         while (!fileEngineIterators.isEmpty()) {
             // Find the next valid iterator that matches the filters.
@@ -272,34 +507,48 @@ void QDirIteratorPrivate::advance()
     \internal
  */
 void QDirIteratorPrivate::checkAndPushDirectory(const QFileInfo &fileInfo)
+{
+    if (!shouldDescendInto(fileInfo))
+        return;
+
+    // Stop link loops
+    if (!visitedLinks.isEmpty() &&
+        visitedLinks.contains(fileInfo.canonicalFilePath()))
+        return;
+
+    pushDirectory(fileInfo);
+}
+
+/*!
+    \internal
+
+    Returns true if the iteration should continue inside the directory
+    \a fileInfo, not taking symbolic link loops into account.
+ */
+bool QDirIteratorPrivate::shouldDescendInto(const QFileInfo &fileInfo) const
 {
     // If we're doing flat iteration, we're done.
     if (!(iteratorFlags & QDirIterator::Subdirectories))
-        return;
+        return false;
 
     // Never follow non-directory entries
     if (!fileInfo.isDir())
-        return;
+        return false;
 
     // Follow symlinks only when asked
     if (!(iteratorFlags & QDirIterator::FollowSymlinks) && fileInfo.isSymLink())
-        return;
+        return false;
 
     // Never follow . and ..
     QString fileName = fileInfo.fileName();
     if (QLatin1String(".") == fileName || QLatin1String("..") == fileName)
-        return;
+        return false;
 
     // No hidden directories unless requested
     if (!(filters & QDir::AllDirs) && !(filters & QDir::Hidden) && fileInfo.isHidden())
-        return;
-
-    // Stop link loops
-    if (!visitedLinks.isEmpty() &&
-        visitedLinks.contains(fileInfo.canonicalFilePath()))
-        return;
+        return false;
 
-    pushDirectory(fileInfo);
+    return true;
 }
 
 /*!
@@ -498,6 +747,10 @@ QString QDirIterator::next()
 */
 bool QDirIterator::hasNext() const
 {
+#ifdef QT_DIRITERATOR_PARALLEL
+    if (d->walker)
+        return d->walkerHasNext;
+#endif
     if (d->engine)
         return !d->fileEngineIterators.isEmpty();
     else
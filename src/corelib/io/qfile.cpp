@@ -49,6 +49,7 @@
 #include "private/qiodevice_p.h"
 #include "private/qfile_p.h"
 #include "private/qsystemerror_p.h"
+#include "private/qfilesystemengine_p.h"
 #if defined(QT_BUILD_CORE_LIB)
 # include "qcoreapplication.h"
 #endif
@@ -737,19 +738,11 @@ QFile::copy(const QString &newName)
                     close();
                     d->setError(QFile::CopyError, tr("Cannot open for output"));
                 } else {
-                    char block[4096];
-                    qint64 totalRead = 0;
-                    while(!atEnd()) {
-                        qint64 in = read(block, sizeof(block));
-                        if (in <= 0)
-                            break;
-                        totalRead += in;
-                        if(in != out.write(block, in)) {
-                            close();
-                            d->setError(QFile::CopyError, tr("Failure to write block"));
-                            error = true;
-                            break;
-                        }
+                    const qint64 totalRead = copyRange(this, &out, size());
+                    if (totalRead < 0 && out.error() != QFile::NoError) {
+                        close();
+                        d->setError(QFile::CopyError, tr("Failure to write block"));
+                        error = true;
                     }
 
                     if (totalRead != size()) {
@@ -800,6 +793,78 @@ QFile::copy(const QString &fileName, const QString &newName)
     return QFile(fileName).copy(newName);
 }
 
+/*!
+    \since 5.1
+
+    Copies up to \a length bytes from the current position of \a source
+    to the current position of \a destination, and advances both
+    positions by the number of bytes copied. Returns that number, which is
+    less than \a length if \a source ends first, or -1 if an error
+    occurred; the error is then reported by the device it occurred on.
+
+    \a source must be open for reading and \a destination for writing.
+    Where the operating system supports it, the data is copied by the
+    kernel without passing through the application: on Linux with
+    copy_file_range() or sendfile(), sharing the data between both files
+    on filesystems that support reflinks when a whole file is copied
+    into an empty one. Otherwise the data is read and written in blocks.
+
+    \sa copy()
+*/
+qint64 QFile::copyRange(QFileDevice *source, QFileDevice *destination, qint64 length)
+{
+    if (!source || !destination) {
+        qWarning("QFile::copyRange: Null device");
+        return -1;
+    }
+    if (!source->isReadable()) {
+        qWarning("QFile::copyRange: Source device not open for reading");
+        return -1;
+    }
+    if (!destination->isWritable()) {
+        qWarning("QFile::copyRange: Destination device not open for writing");
+        return -1;
+    }
+    if (length <= 0)
+        return 0;
+    if (!destination->flush())
+        return -1;
+
+    qint64 copied = 0;
+#ifdef Q_OS_UNIX
+    const int srcfd = source->handle();
+    const int dstfd = destination->handle();
+    if (srcfd != -1 && dstfd != -1 && !source->isSequential() && !destination->isSequential()
+        && !(destination->openMode() & QIODevice::Append)) {
+        const qint64 srcPos = source->pos();
+        const qint64 dstPos = destination->pos();
+        copied = QFileSystemEngine::copyFileData(srcfd, srcPos, dstfd, dstPos, length);
+        if (copied > 0) {
+            // also drops what the devices have buffered
+            source->seek(srcPos + copied);
+            destination->seek(dstPos + copied);
+        }
+    }
+#endif
+
+    if (copied == length)
+        return copied;
+
+    // whatever the kernel could not do
+    QByteArray block(int(qMin(length - copied, qint64(64 * 1024))), Qt::Uninitialized);
+    while (copied < length) {
+        const qint64 in = source->read(block.data(), qMin(length - copied, qint64(block.size())));
+        if (in < 0)
+            return -1;
+        if (in == 0)
+            break;
+        if (destination->write(block.constData(), in) != in)
+            return -1;
+        copied += in;
+    }
+    return copied;
+}
+
 /*!
     Opens the file using OpenMode \a mode, returning true if successful;
     otherwise false.
@@ -125,6 +125,7 @@ public:
 
     bool copy(const QString &newName);
     static bool copy(const QString &fileName, const QString &newName);
+    static qint64 copyRange(QFileDevice *source, QFileDevice *destination, qint64 length);
 
     bool open(OpenMode flags);
     bool open(FILE *f, OpenMode ioFlags, FileHandleFlags handleFlags=DontCloseHandle);
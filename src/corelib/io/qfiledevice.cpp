@@ -51,11 +51,15 @@
 QT_BEGIN_NAMESPACE
 
 static const int QFILE_WRITEBUFFER_SIZE = 16384;
+// peekView() maps files in windows of this size, but only if at least
+// QFILE_MINIMUM_VIEW_SIZE bytes remain; shorter tails go through the read buffer.
+static const qint64 QFILE_VIEW_SIZE = sizeof(void *) == 8 ? Q_INT64_C(1) << 30 : Q_INT64_C(1) << 26;
+static const qint64 QFILE_MINIMUM_VIEW_SIZE = 65536;
 
 QFileDevicePrivate::QFileDevicePrivate()
     : fileEngine(0), lastWasWrite(false),
-      writeBuffer(QFILE_WRITEBUFFER_SIZE), error(QFile::NoError),
-      cachedSize(0)
+      writeBuffer(QFILE_WRITEBUFFER_SIZE), viewMap(0), viewMapOffset(0), viewMapSize(0),
+      error(QFile::NoError), cachedSize(0)
 {
 }
 
@@ -65,6 +69,72 @@ QFileDevicePrivate::~QFileDevicePrivate()
     fileEngine = 0;
 }
 
+/*!
+    \internal
+
+    Hands out the file contents from a memory mapping when possible, so that
+    reading a local file through peekView() and skip() does not copy.
+*/
+const char *QFileDevicePrivate::peekView(qint64 *size)
+{
+    Q_Q(QFileDevice);
+    if (!buffer.isEmpty() || isSequential() || !ensureFlushed())
+        return QIODevicePrivate::peekView(size);
+
+    if (!viewMap || pos < viewMapOffset || pos >= viewMapOffset + viewMapSize) {
+        unmapView();
+        const qint64 remaining = q->size() - pos;
+        if (remaining < QFILE_MINIMUM_VIEW_SIZE
+                || !engine()->supportsExtension(QAbstractFileEngine::MapExtension))
+            return QIODevicePrivate::peekView(size);
+
+        // Failing to map is not an error; the read buffer takes over.
+        const qint64 length = qMin(remaining, QFILE_VIEW_SIZE);
+        viewMap = fileEngine->map(pos, length, QFileDevice::NoOptions);
+        if (!viewMap)
+            return QIODevicePrivate::peekView(size);
+        viewMapOffset = pos;
+        viewMapSize = length;
+    }
+
+    *size = viewMapOffset + viewMapSize - pos;
+    return reinterpret_cast<const char *>(viewMap) + (pos - viewMapOffset);
+}
+
+/*!
+    \internal
+*/
+qint64 QFileDevicePrivate::skip(qint64 maxSize)
+{
+    if (!viewMap || !buffer.isEmpty() || lastWasWrite
+            || pos < viewMapOffset || pos >= viewMapOffset + viewMapSize)
+        return QIODevicePrivate::skip(maxSize);
+
+    // Inside the mapped window the file position catches up lazily on the
+    // next read() or write(), which compare pos with devicePos.
+    const qint64 skipped = qMin(maxSize, viewMapOffset + viewMapSize - pos);
+    pos += skipped;
+    if (skipped < maxSize) {
+        const qint64 more = QIODevicePrivate::skip(maxSize - skipped);
+        if (more > 0)
+            return skipped + more;
+    }
+    return skipped;
+}
+
+/*!
+    \internal
+*/
+void QFileDevicePrivate::unmapView()
+{
+    if (viewMap) {
+        fileEngine->unmap(viewMap);
+        viewMap = 0;
+        viewMapOffset = 0;
+        viewMapSize = 0;
+    }
+}
+
 QAbstractFileEngine * QFileDevicePrivate::engine() const
 {
     if (!fileEngine)
@@ -329,6 +399,7 @@ void QFileDevice::close()
     if (!isOpen())
         return;
     bool flushed = flush();
+    d->unmapView();
     QIODevice::close();
 
     // reset write buffer
@@ -630,6 +701,7 @@ bool QFileDevice::resize(qint64 sz)
     if (!d->ensureFlushed())
         return false;
     d->engine();
+    d->unmapView();
     if (isOpen() && d->fileEngine->pos() > sz)
         seek(sz);
     if (d->fileEngine->setSize(sz)) {
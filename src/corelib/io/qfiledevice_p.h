@@ -79,6 +79,14 @@ protected:
 
     bool putCharHelper(char c);
 
+    const char *peekView(qint64 *size);
+    qint64 skip(qint64 maxSize);
+    void unmapView();
+    // memory-mapped window of the file handed out by peekView()
+    uchar *viewMap;
+    qint64 viewMapOffset;
+    qint64 viewMapSize;
+
     QFileDevice::FileError error;
     void setError(QFileDevice::FileError err);
     void setError(QFileDevice::FileError err, const QString &errorString);
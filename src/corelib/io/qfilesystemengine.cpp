@@ -333,9 +333,23 @@ void QFileSystemMetaData::fillFromDirEnt(const QT_DIRENT &entry)
     }
 #elif defined(_DIRENT_HAVE_D_TYPE) || defined(Q_OS_BSD4)
     // BSD4 includes Mac OS X
+    fillFromDirEntType(entry.d_type);
+#else
+    Q_UNUSED(entry)
+#endif
+}
+
+/*!
+    \internal
 
+    Fills in what the d_type field of a directory entry tells about it,
+    for iterators that do not go through readdir().
+*/
+void QFileSystemMetaData::fillFromDirEntType(unsigned char type)
+{
+#if defined(_DIRENT_HAVE_D_TYPE) || defined(Q_OS_BSD4)
     // ### This will clear all entry flags and knownFlagsMask
-    switch (entry.d_type)
+    switch (type)
     {
     case DT_DIR:
         knownFlagsMask = QFileSystemMetaData::LinkType
@@ -390,7 +404,8 @@ void QFileSystemMetaData::fillFromDirEnt(const QT_DIRENT &entry)
         clear();
     }
 #else
-    Q_UNUSED(entry)
+    Q_UNUSED(type)
+    clear();
 #endif
 }
 
@@ -117,6 +117,9 @@ public:
     static bool createLink(const QFileSystemEntry &source, const QFileSystemEntry &target, QSystemError &error);
 
     static bool copyFile(const QFileSystemEntry &source, const QFileSystemEntry &target, QSystemError &error);
+#if defined(Q_OS_UNIX)
+    static qint64 copyFileData(int srcfd, qint64 srcOffset, int dstfd, qint64 dstOffset, qint64 length);
+#endif
     static bool renameFile(const QFileSystemEntry &source, const QFileSystemEntry &target, QSystemError &error);
     static bool removeFile(const QFileSystemEntry &entry, QSystemError &error);
 
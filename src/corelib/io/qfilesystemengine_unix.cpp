@@ -55,6 +55,16 @@
 # include <QtCore/private/qcore_mac_p.h>
 #endif
 
+#if defined(Q_OS_LINUX)
+# include <QtCore/private/qcore_unix_p.h>
+# include <sys/ioctl.h>
+# include <sys/sendfile.h>
+# include <sys/syscall.h>
+# ifndef FICLONE
+#  define FICLONE _IOW(0x94, 9, int)
+# endif
+#endif
+
 QT_BEGIN_NAMESPACE
 
 #if defined(Q_OS_MAC) && !defined(Q_OS_IOS)
@@ -548,6 +558,90 @@ bool QFileSystemEngine::copyFile(const QFileSystemEntry &source, const QFileSyst
     return false;
 }
 
+/*!
+    \internal
+
+    Copies up to \a length bytes from offset \a srcOffset of \a srcfd to
+    offset \a dstOffset of \a dstfd without passing the data through user
+    space. Neither file position is used, but the one of \a dstfd may change.
+
+    Returns the number of bytes copied. That is less than \a length if the
+    source ends first, or if the kernel cannot copy (all of) the data
+    between these two files; the caller is expected to copy the rest
+    itself, which also reports any error properly.
+*/
+//static
+qint64 QFileSystemEngine::copyFileData(int srcfd, qint64 srcOffset, int dstfd, qint64 dstOffset,
+                                       qint64 length)
+{
+#if defined(Q_OS_LINUX)
+    QT_STATBUF srcStat, dstStat;
+    if (QT_FSTAT(srcfd, &srcStat) != 0 || QT_FSTAT(dstfd, &dstStat) != 0
+        || !S_ISREG(srcStat.st_mode) || !S_ISREG(dstStat.st_mode))
+        return 0;
+
+    // files in /proc and /sys report a size of 0; leave those to read()
+    length = qMin(length, qint64(srcStat.st_size) - srcOffset);
+    if (length <= 0)
+        return 0;
+
+    // A whole file into an empty one: on filesystems that support it
+    // (btrfs, XFS, ...) both share the data until one is modified
+    if (srcOffset == 0 && dstOffset == 0 && length == srcStat.st_size
+        && dstStat.st_size == 0 && ::ioctl(dstfd, FICLONE, srcfd) == 0)
+        return length;
+
+    // never ask for more than a 32-bit ssize_t can report
+    const qint64 maxChunk = 0x40000000;
+    qint64 copied = 0;
+
+#if defined(SYS_copy_file_range)
+    // copies within the filesystem (or inside the storage device) where possible
+    while (copied < length) {
+        // the kernel writes back 64-bit offsets, whatever QT_OFF_T is
+        loff_t in = srcOffset + copied;
+        loff_t out = dstOffset + copied;
+        qint64 n;
+        EINTR_LOOP(n, ::syscall(SYS_copy_file_range, srcfd, &in, dstfd, &out,
+                                size_t(qMin(length - copied, maxChunk)), 0u));
+        if (n == 0)
+            return copied;  // the source was truncated meanwhile
+        if (n < 0)
+            break;          // e.g. not supported, or not across these filesystems
+        copied += n;
+    }
+    if (copied == length)
+        return copied;
+#endif
+
+    // sendfile() writes at the current position of the output
+    if (QT_LSEEK(dstfd, dstOffset + copied, SEEK_SET) < 0)
+        return copied;
+    while (copied < length) {
+#if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+        off64_t in = srcOffset + copied;
+        qint64 n;
+        EINTR_LOOP(n, ::sendfile64(dstfd, srcfd, &in, size_t(qMin(length - copied, maxChunk))));
+#else
+        off_t in = srcOffset + copied;
+        qint64 n;
+        EINTR_LOOP(n, ::sendfile(dstfd, srcfd, &in, size_t(qMin(length - copied, maxChunk))));
+#endif
+        if (n <= 0)
+            break;
+        copied += n;
+    }
+    return copied;
+#else
+    Q_UNUSED(srcfd);
+    Q_UNUSED(srcOffset);
+    Q_UNUSED(dstfd);
+    Q_UNUSED(dstOffset);
+    Q_UNUSED(length);
+    return 0;
+#endif
+}
+
 //static
 bool QFileSystemEngine::renameFile(const QFileSystemEntry &source, const QFileSystemEntry &target, QSystemError &error)
 {
@@ -69,6 +69,10 @@
 #include <QtCore/qscopedpointer.h>
 #endif
 
+#if defined(Q_OS_LINUX) && !defined(QT_NO_GETDENTS)
+#  define QT_FILESYSTEMITERATOR_GETDENTS
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QFileSystemIterator
@@ -92,6 +96,13 @@ private:
     bool uncFallback;
     int uncShareIndex;
     bool onlyDirs;
+#elif defined(QT_FILESYSTEMITERATOR_GETDENTS)
+    // reads entries in large batches straight from the kernel
+    int dirFd;
+    QScopedPointer<char, QScopedPointerPodDeleter> entryBuffer;
+    int entryBufferPos;
+    int entryBufferEnd;
+    int lastError;
 #else
     QT_DIR *dir;
     QT_DIRENT *dirEntry;
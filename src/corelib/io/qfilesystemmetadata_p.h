@@ -214,6 +214,7 @@ public:
 #ifdef Q_OS_UNIX
     void fillFromStatBuf(const QT_STATBUF &statBuffer);
     void fillFromDirEnt(const QT_DIRENT &statBuffer);
+    void fillFromDirEntType(unsigned char type);
 #endif
 
 #if defined(Q_OS_WIN)
@@ -47,10 +47,14 @@
 #include <qdatetime.h>
 #include <qdebug.h>
 #include <qdir.h>
+#include <qdiriterator.h>
 #include <qfileinfo.h>
 #include <qset.h>
 #include <qtimer.h>
 
+#include "private/qfilesystemengine_p.h"
+#include "private/qfilesystemiterator_p.h"
+
 #if defined(Q_OS_LINUX) || (defined(Q_OS_QNX) && !defined(QT_NO_INOTIFY))
 #define USE_INOTIFY
 #endif
@@ -82,7 +86,7 @@ QFileSystemWatcherEngine *QFileSystemWatcherPrivate::createNativeEngine(QObject
 }
 
 QFileSystemWatcherPrivate::QFileSystemWatcherPrivate()
-    : native(0), poller(0)
+    : native(0), poller(0), latency(0), latencyTimer(0), pendingOverflow(false)
 {
 }
 
@@ -99,6 +103,10 @@ void QFileSystemWatcherPrivate::init()
                          SIGNAL(directoryChanged(QString,bool)),
                          q,
                          SLOT(_q_directoryChanged(QString,bool)));
+        QObject::connect(native,
+                         SIGNAL(queueOverflowed()),
+                         q,
+                         SLOT(_q_queueOverflowed()));
     }
 }
 
@@ -119,28 +127,320 @@ void QFileSystemWatcherPrivate::initPollerEngine()
                      SLOT(_q_directoryChanged(QString,bool)));
 }
 
-void QFileSystemWatcherPrivate::_q_fileChanged(const QString &path, bool removed)
+QFileSystemWatcherEngine *QFileSystemWatcherPrivate::engineForNewPaths()
 {
     Q_Q(QFileSystemWatcher);
-    if (!files.contains(path)) {
+    if(!q->objectName().startsWith(QLatin1String("_qt_autotest_force_engine_"))) {
+        // Normal runtime case - search intelligently for best engine
+        if(native)
+            return native;
+        initPollerEngine();
+        return poller;
+    }
+
+    // Autotest override case - use the explicitly selected engine only
+    QString forceName = q->objectName().mid(26);
+    if(forceName == QLatin1String("poller")) {
+        qDebug() << "QFileSystemWatcher: skipping native engine, using only polling engine";
+        initPollerEngine();
+        return poller;
+    } else if(forceName == QLatin1String("native")) {
+        qDebug() << "QFileSystemWatcher: skipping polling engine, using only native engine";
+        return native;
+    }
+    return 0;
+}
+
+void QFileSystemWatcherPrivate::compactWatchLists()
+{
+    if (removedPaths.isEmpty())
+        return;
+
+    QStringList *lists[] = { &files, &directories };
+    for (int i = 0; i < 2; ++i) {
+        QStringList kept;
+        kept.reserve(lists[i]->size());
+        foreach (const QString &path, *lists[i]) {
+            if (!removedPaths.contains(path))
+                kept.append(path);
+        }
+        *lists[i] = kept;
+    }
+    removedPaths.clear();
+}
+
+bool QFileSystemWatcherPrivate::isWatched(const QStringList &list, const QString &path) const
+{
+    return !removedPaths.contains(path) && list.contains(path);
+}
+
+// Appends the subdirectories of \a directory to \a subdirectories, without
+// following symbolic links.
+static void listSubdirectories(const QString &directory, QStringList *subdirectories)
+{
+#ifndef QT_NO_FILESYSTEMITERATOR
+    // QDirIterator's file engine and QFileInfo overhead is several times the
+    // cost of reading the directory, which adds up over large trees.
+    QFileSystemIterator it(QFileSystemEntry(directory), QDir::Dirs, QStringList());
+    QFileSystemEntry entry;
+    QFileSystemMetaData metaData;
+    const QFileSystemMetaData::MetaDataFlags typeFlags =
+            QFileSystemMetaData::LinkType | QFileSystemMetaData::DirectoryType;
+    while (it.advance(entry, metaData)) {
+        if (!metaData.hasFlags(typeFlags))
+            QFileSystemEngine::fillMetaData(entry, metaData, typeFlags);
+        if (!metaData.isDirectory() || metaData.isLink())
+            continue;
+        const QString fileName = entry.fileName();
+        if (fileName == QLatin1String(".") || fileName == QLatin1String(".."))
+            continue;
+        subdirectories->append(entry.filePath());
+    }
+#else
+    QDirIterator it(directory, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System
+                    | QDir::NoSymLinks);
+    while (it.hasNext())
+        subdirectories->append(it.next());
+#endif
+}
+
+// Watches \a roots, which are subdirectories of \a parent (or new roots if
+// \a parent is empty), and every directory below them. The directories that
+// are now watched are appended to \a added.
+void QFileSystemWatcherPrivate::watchRecursively(const QStringList &roots, const QString &parent,
+                                                 QStringList *added)
+{
+    QFileSystemWatcherEngine *engine = engineForNewPaths();
+    if (!engine)
+        return;
+
+    // Collect the whole tree first so that the engine gets a single batch.
+    QStringList tree;
+    foreach (const QString &root, roots) {
+        if (recursiveDirectories.contains(root))
+            continue;
+        recursiveDirectories[root].parent = parent;
+        if (!parent.isEmpty())
+            recursiveDirectories[parent].children.insert(root);
+        tree.append(root);
+    }
+    QStringList subdirectories;
+    for (int i = 0; i < tree.size(); ++i) {
+        const QString directory = tree.at(i);
+        subdirectories.clear();
+        listSubdirectories(directory, &subdirectories);
+        foreach (const QString &child, subdirectories) {
+            if (recursiveDirectories.contains(child))
+                continue;
+            recursiveDirectories[child].parent = directory;
+            recursiveDirectories[directory].children.insert(child);
+            tree.append(child);
+        }
+    }
+    if (tree.isEmpty())
+        return;
+
+    compactWatchLists();
+    const QStringList failed = engine->addPaths(tree, &files, &directories);
+    if (!failed.isEmpty()) {
+        // Paths that were already watched on their own are fine; drop the
+        // others together with whatever was watched below them.
+        const QSet<QString> watched = directories.toSet();
+        QStringList unwatch;
+        foreach (const QString &path, failed) {
+            if (!watched.contains(path))
+                forgetRecursiveDirectory(path, &unwatch);
+        }
+        unwatchDirectories(unwatch);
+    }
+
+    foreach (const QString &path, tree) {
+        if (recursiveDirectories.contains(path))
+            added->append(path);
+    }
+}
+
+// Brings the subdirectories recorded for \a directory in line with the disk.
+void QFileSystemWatcherPrivate::rescanRecursiveDirectory(const QString &directory, QStringList *added)
+{
+    if (!recursiveDirectories.contains(directory))
+        return;
+
+    QStringList subdirectories;
+    listSubdirectories(directory, &subdirectories);
+    const QSet<QString> current = subdirectories.toSet();
+
+    const QSet<QString> known = recursiveDirectories.value(directory).children;
+    QStringList unwatch;
+    foreach (const QString &child, known) {
+        // moved away, or deleted before its own notification arrived
+        if (!current.contains(child))
+            forgetRecursiveDirectory(child, &unwatch);
+    }
+    unwatchDirectories(unwatch);
+
+    QStringList appeared;
+    foreach (const QString &child, current) {
+        if (!known.contains(child))
+            appeared.append(child);
+    }
+    if (!appeared.isEmpty())
+        watchRecursively(appeared, directory, added);
+}
+
+// Removes \a directory and everything below it from the recursive watch
+// bookkeeping, appending the directories to \a unwatch.
+void QFileSystemWatcherPrivate::forgetRecursiveDirectory(const QString &directory, QStringList *unwatch)
+{
+    QHash<QString, RecursiveDirectory>::iterator it = recursiveDirectories.find(directory);
+    if (it == recursiveDirectories.end())
+        return;
+
+    QHash<QString, RecursiveDirectory>::iterator parentIt = recursiveDirectories.find(it->parent);
+    if (parentIt != recursiveDirectories.end())
+        parentIt->children.remove(directory);
+    recursiveRoots.removeAll(directory);
+
+    QStringList stack(directory);
+    while (!stack.isEmpty()) {
+        const QString path = stack.takeLast();
+        const RecursiveDirectory entry = recursiveDirectories.take(path);
+        unwatch->append(path);
+        foreach (const QString &child, entry.children)
+            stack.append(child);
+    }
+}
+
+void QFileSystemWatcherPrivate::unwatchDirectories(const QStringList &paths)
+{
+    if (paths.isEmpty())
+        return;
+
+    QStringList p = paths;
+    if (native)
+        p = native->removePaths(p, &files, &directories);
+    if (poller && !p.isEmpty())
+        poller->removePaths(p, &files, &directories);
+
+    dropPendingChanges(paths.toSet());
+}
+
+// Forgets queued changes for \a paths, which are no longer watched.
+void QFileSystemWatcherPrivate::dropPendingChanges(const QSet<QString> &paths)
+{
+    QStringList *lists[] = { &pendingFiles, &pendingDirectories };
+    for (int i = 0; i < 2; ++i) {
+        QStringList pending;
+        foreach (const QString &path, *lists[i]) {
+            if (!paths.contains(path))
+                pending.append(path);
+        }
+        *lists[i] = pending;
+    }
+    pendingFileSet.subtract(paths);
+    pendingDirectorySet.subtract(paths);
+    pendingRescans.subtract(paths);
+}
+
+void QFileSystemWatcherPrivate::queueChange(const QString &path, bool isDirectory)
+{
+    QSet<QString> &pendingSet = isDirectory ? pendingDirectorySet : pendingFileSet;
+    if (!pendingSet.contains(path)) {
+        pendingSet.insert(path);
+        (isDirectory ? pendingDirectories : pendingFiles).append(path);
+    }
+
+    if (latency <= 0)
+        _q_emitPendingChanges();
+    else if (!latencyTimer->isActive())
+        latencyTimer->start();
+}
+
+void QFileSystemWatcherPrivate::_q_fileChanged(const QString &path, bool removed)
+{
+    if (!isWatched(files, path)) {
         // the path was removed after a change was detected, but before we delivered the signal
         return;
     }
     if (removed)
-        files.removeAll(path);
-    emit q->fileChanged(path, QFileSystemWatcher::QPrivateSignal());
+        removedPaths.insert(path);
+    queueChange(path, false);
 }
 
 void QFileSystemWatcherPrivate::_q_directoryChanged(const QString &path, bool removed)
 {
-    Q_Q(QFileSystemWatcher);
-    if (!directories.contains(path)) {
+    const bool recursive = recursiveDirectories.contains(path);
+    if (!recursive && !isWatched(directories, path)) {
         // perhaps the path was removed after a change was detected, but before we delivered the signal
         return;
     }
-    if (removed)
-        directories.removeAll(path);
-    emit q->directoryChanged(path, QFileSystemWatcher::QPrivateSignal());
+    if (removed) {
+        removedPaths.insert(path);
+        if (recursive) {
+            QStringList unwatch;
+            forgetRecursiveDirectory(path, &unwatch);
+            // the engine has already dropped the directory itself
+            unwatch.removeOne(path);
+            unwatchDirectories(unwatch);
+        }
+    } else if (recursive) {
+        pendingRescans.insert(path);
+    }
+    queueChange(path, true);
+}
+
+void QFileSystemWatcherPrivate::_q_queueOverflowed()
+{
+    // Events were lost, so every recursive directory may be out of date.
+    pendingOverflow = true;
+    for (QHash<QString, RecursiveDirectory>::const_iterator it = recursiveDirectories.constBegin();
+         it != recursiveDirectories.constEnd(); ++it) {
+        pendingRescans.insert(it.key());
+    }
+
+    if (latency <= 0)
+        _q_emitPendingChanges();
+    else if (!latencyTimer->isActive())
+        latencyTimer->start();
+}
+
+void QFileSystemWatcherPrivate::_q_emitPendingChanges()
+{
+    Q_Q(QFileSystemWatcher);
+    if (latencyTimer)
+        latencyTimer->stop();
+
+    // Update the recursive watches first, so that new directories are
+    // watched by the time the changes are reported.
+    QStringList added;
+    const QSet<QString> rescans = pendingRescans;
+    pendingRescans.clear();
+    foreach (const QString &directory, rescans)
+        rescanRecursiveDirectory(directory, &added);
+    foreach (const QString &directory, added) {
+        if (!pendingDirectorySet.contains(directory))
+            pendingDirectories.append(directory);
+    }
+
+    const QStringList changedFiles = pendingFiles;
+    const QStringList changedDirectories = pendingDirectories;
+    const bool overflowed = pendingOverflow;
+    pendingFiles.clear();
+    pendingDirectories.clear();
+    pendingFileSet.clear();
+    pendingDirectorySet.clear();
+    pendingOverflow = false;
+
+    if (overflowed)
+        emit q->queueOverflowed(QFileSystemWatcher::QPrivateSignal());
+    foreach (const QString &path, changedDirectories)
+        emit q->directoryChanged(path, QFileSystemWatcher::QPrivateSignal());
+    foreach (const QString &path, changedFiles)
+        emit q->fileChanged(path, QFileSystemWatcher::QPrivateSignal());
+    if (!changedDirectories.isEmpty())
+        emit q->directoriesChanged(changedDirectories, QFileSystemWatcher::QPrivateSignal());
+    if (!changedFiles.isEmpty())
+        emit q->filesChanged(changedFiles, QFileSystemWatcher::QPrivateSignal());
 }
 
 
@@ -191,6 +491,11 @@ void QFileSystemWatcherPrivate::_q_directoryChanged(const QString &path, bool re
     the total. Mac OS X 10.5 and up use a different backend and do not
     suffer from this issue.
 
+    To watch a whole directory tree, use addRecursivePath(). When many
+    changes happen in a short time, setLatency() coalesces them into one
+    notification per path, followed by filesChanged() and
+    directoriesChanged() with the complete batch.
+
 
     \sa QFile, QDir
 */
@@ -297,32 +602,11 @@ QStringList QFileSystemWatcher::addPaths(const QStringList &paths)
         return QStringList();
     }
 
-    QFileSystemWatcherEngine *engine = 0;
-
-    if(!objectName().startsWith(QLatin1String("_qt_autotest_force_engine_"))) {
-        // Normal runtime case - search intelligently for best engine
-        if(d->native) {
-            engine = d->native;
-        } else {
-            d_func()->initPollerEngine();
-            engine = d->poller;
-        }
-
-    } else {
-        // Autotest override case - use the explicitly selected engine only
-        QString forceName = objectName().mid(26);
-        if(forceName == QLatin1String("poller")) {
-            qDebug() << "QFileSystemWatcher: skipping native engine, using only polling engine";
-            d_func()->initPollerEngine();
-            engine = d->poller;
-        } else if(forceName == QLatin1String("native")) {
-            qDebug() << "QFileSystemWatcher: skipping polling engine, using only native engine";
-            engine = d->native;
-        }
-    }
-
-    if(engine)
+    QFileSystemWatcherEngine *engine = d->engineForNewPaths();
+    if(engine) {
+        d->compactWatchLists();
         p = engine->addPaths(p, &d->files, &d->directories);
+    }
 
     return p;
 }
@@ -377,12 +661,31 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
         return QStringList();
     }
 
+    // Recursive watches go as a whole; their subdirectories cannot be
+    // removed on their own.
+    QStringList unwatch, refused;
+    it.toFront();
+    while (it.hasNext()) {
+        const QString &path = it.next();
+        if (d->recursiveRoots.contains(path)) {
+            d->forgetRecursiveDirectory(path, &unwatch);
+            it.remove();
+        } else if (d->recursiveDirectories.contains(path)) {
+            refused.append(path);
+            it.remove();
+        }
+    }
+    d->unwatchDirectories(unwatch);
+
+    const QSet<QString> requested = p.toSet();
     if (d->native)
         p = d->native->removePaths(p, &d->files, &d->directories);
     if (d->poller)
         p = d->poller->removePaths(p, &d->files, &d->directories);
+    if (!d->pendingFiles.isEmpty() || !d->pendingDirectories.isEmpty())
+        d->dropPendingChanges(requested - p.toSet());
 
-    return p;
+    return p + refused;
 }
 
 /*!
@@ -426,15 +729,158 @@ QStringList QFileSystemWatcher::removePaths(const QStringList &paths)
 QStringList QFileSystemWatcher::directories() const
 {
     Q_D(const QFileSystemWatcher);
+    const_cast<QFileSystemWatcherPrivate *>(d)->compactWatchLists();
     return d->directories;
 }
 
 QStringList QFileSystemWatcher::files() const
 {
     Q_D(const QFileSystemWatcher);
+    const_cast<QFileSystemWatcherPrivate *>(d)->compactWatchLists();
     return d->files;
 }
 
+/*!
+    \since 5.1
+
+    Watches the directory \a directory and every directory below it.
+    Returns true if \a directory is now watched; otherwise returns false,
+    for example if it does not exist or is already part of a recursive
+    watch.
+
+    Subdirectories that are created or moved into the tree later are
+    watched automatically, and subdirectories that are deleted or moved
+    away are dropped. Newly watched directories are reported through
+    directoryChanged() and directoriesChanged(), since files may have
+    appeared in them before the watch was in place. Symbolic links to
+    directories are not followed.
+
+    All watched directories are listed by directories(). Passing
+    \a directory to removePath() removes the whole tree; its subdirectories
+    cannot be removed on their own.
+
+    Combine recursive watches with setLatency() when large trees change in
+    bulk, so that the directory listings the watcher needs to keep the tree
+    up to date are done once per window rather than once per change.
+
+    \note Each directory in the tree counts against the system limit on the
+    number of watches. If the limit is reached, the directories that could
+    not be watched are left out.
+
+    \sa recursivePaths(), addPath(), setLatency()
+*/
+bool QFileSystemWatcher::addRecursivePath(const QString &directory)
+{
+    Q_D(QFileSystemWatcher);
+    if (directory.isEmpty()) {
+        qWarning("QFileSystemWatcher::addRecursivePath: path is empty");
+        return false;
+    }
+    if (d->recursiveDirectories.contains(directory) || !QFileInfo(directory).isDir())
+        return false;
+
+    QStringList added;
+    d->watchRecursively(QStringList(directory), QString(), &added);
+    if (!d->recursiveDirectories.contains(directory))
+        return false;
+    d->recursiveRoots.append(directory);
+    return true;
+}
+
+/*!
+    \since 5.1
+
+    Returns the directories that were added with addRecursivePath().
+
+    \sa directories()
+*/
+QStringList QFileSystemWatcher::recursivePaths() const
+{
+    Q_D(const QFileSystemWatcher);
+    return d->recursiveRoots;
+}
+
+/*!
+    \since 5.1
+
+    Sets the coalescing window to \a msecs milliseconds.
+
+    With a latency of 0, the default, every change is reported as soon as
+    it is detected. With a positive latency, the first change starts a
+    window of \a msecs milliseconds; all changes detected until the window
+    ends are reported together, and each path is reported only once per
+    window, no matter how many times it changed.
+
+    \sa latency(), filesChanged(), directoriesChanged()
+*/
+void QFileSystemWatcher::setLatency(int msecs)
+{
+    Q_D(QFileSystemWatcher);
+    d->latency = qMax(0, msecs);
+    if (d->latency > 0) {
+        if (!d->latencyTimer) {
+            d->latencyTimer = new QTimer(this);
+            d->latencyTimer->setSingleShot(true);
+            connect(d->latencyTimer, SIGNAL(timeout()), SLOT(_q_emitPendingChanges()));
+        }
+        d->latencyTimer->setInterval(d->latency);
+    } else if (d->latencyTimer && d->latencyTimer->isActive()) {
+        d->_q_emitPendingChanges();
+    }
+}
+
+/*!
+    \since 5.1
+
+    Returns the coalescing window in milliseconds.
+
+    \sa setLatency()
+*/
+int QFileSystemWatcher::latency() const
+{
+    Q_D(const QFileSystemWatcher);
+    return d->latency;
+}
+
+/*!
+    \fn void QFileSystemWatcher::filesChanged(const QStringList &paths)
+    \since 5.1
+
+    This signal is emitted with the \a paths of all files that were
+    modified, renamed or removed during one latency window, after
+    fileChanged() has been emitted for each of them. If the latency is 0,
+    it is emitted for every change.
+
+    \sa setLatency(), directoriesChanged()
+*/
+
+/*!
+    \fn void QFileSystemWatcher::directoriesChanged(const QStringList &paths)
+    \since 5.1
+
+    This signal is emitted with the \a paths of all directories that were
+    modified or removed during one latency window, after directoryChanged()
+    has been emitted for each of them. If the latency is 0, it is emitted
+    for every change.
+
+    \sa setLatency(), filesChanged()
+*/
+
+/*!
+    \fn void QFileSystemWatcher::queueOverflowed()
+    \since 5.1
+
+    This signal is emitted when the operating system dropped change
+    notifications because too many arrived at once. Any watched path may
+    have changed without being reported, so applications that mirror the
+    watched state should rescan it. Recursive watches are brought up to
+    date before this signal is emitted.
+
+    Only the inotify backend on Linux reports overflows.
+
+    \sa addRecursivePath()
+*/
+
 QT_END_NAMESPACE
 
 #include "moc_qfilesystemwatcher.cpp"
@@ -71,6 +71,12 @@ public:
     QStringList files() const;
     QStringList directories() const;
 
+    bool addRecursivePath(const QString &directory);
+    QStringList recursivePaths() const;
+
+    void setLatency(int msecs);
+    int latency() const;
+
 Q_SIGNALS:
     void fileChanged(const QString &path
 #if !defined(qdoc)
@@ -80,12 +86,29 @@ Q_SIGNALS:
     void directoryChanged(const QString &path
 #if !defined(qdoc)
         , QPrivateSignal
+#endif
+    );
+    void filesChanged(const QStringList &paths
+#if !defined(qdoc)
+        , QPrivateSignal
+#endif
+    );
+    void directoriesChanged(const QStringList &paths
+#if !defined(qdoc)
+        , QPrivateSignal
+#endif
+    );
+    void queueOverflowed(
+#if !defined(qdoc)
+        QPrivateSignal
 #endif
     );
 
 private:
     Q_PRIVATE_SLOT(d_func(), void _q_fileChanged(const QString &path, bool removed))
     Q_PRIVATE_SLOT(d_func(), void _q_directoryChanged(const QString &path, bool removed))
+    Q_PRIVATE_SLOT(d_func(), void _q_queueOverflowed())
+    Q_PRIVATE_SLOT(d_func(), void _q_emitPendingChanges())
 };
 
 QT_END_NAMESPACE
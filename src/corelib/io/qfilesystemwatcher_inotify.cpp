@@ -49,6 +49,7 @@
 #include <qdebug.h>
 #include <qfile.h>
 #include <qfileinfo.h>
+#include <qset.h>
 #include <qsocketnotifier.h>
 #include <qvarlengtharray.h>
 
@@ -258,15 +259,12 @@ QStringList QInotifyFileSystemWatcherEngine::addPaths(const QStringList &paths,
     QMutableListIterator<QString> it(p);
     while (it.hasNext()) {
         QString path = it.next();
+        // every path this engine watches is in pathToID; looking it up
+        // there keeps adding large trees linear
+        if (pathToID.contains(path))
+            continue;
         QFileInfo fi(path);
         bool isDir = fi.isDir();
-        if (isDir) {
-            if (directories->contains(path))
-                continue;
-        } else {
-            if (files->contains(path))
-                continue;
-        }
 
         int wd = inotify_add_watch(inotifyFd,
                                    QFile::encodeName(path),
@@ -293,6 +291,15 @@ QStringList QInotifyFileSystemWatcherEngine::addPaths(const QStringList &paths,
         it.remove();
 
         int id = isDir ? -wd : wd;
+        // the kernel returns the existing watch for an inode that is already
+        // watched under another path; that path was renamed, so it is no
+        // longer watched by its old name
+        const QString previousPath = idToPath.value(id);
+        if (!previousPath.isEmpty()) {
+            pathToID.remove(previousPath);
+            (id < 0 ? directories : files)->removeAll(previousPath);
+        }
+
         if (id < 0) {
             directories->append(path);
         } else {
@@ -306,18 +313,37 @@ QStringList QInotifyFileSystemWatcherEngine::addPaths(const QStringList &paths,
     return p;
 }
 
+static void removeFromList(QStringList *list, const QSet<QString> &paths)
+{
+    if (paths.isEmpty())
+        return;
+    if (paths.size() == 1) {
+        list->removeAll(*paths.constBegin());
+        return;
+    }
+    QStringList kept;
+    kept.reserve(list->size());
+    foreach (const QString &path, *list) {
+        if (!paths.contains(path))
+            kept.append(path);
+    }
+    *list = kept;
+}
+
 QStringList QInotifyFileSystemWatcherEngine::removePaths(const QStringList &paths,
                                                          QStringList *files,
                                                          QStringList *directories)
 {
     QStringList p = paths;
+    QSet<QString> removedFiles, removedDirectories;
     QMutableListIterator<QString> it(p);
     while (it.hasNext()) {
         QString path = it.next();
-        int id = pathToID.take(path);
-        QString x = idToPath.take(id);
-        if (x.isEmpty() || x != path)
+        int id = pathToID.value(path);
+        if (!id || idToPath.value(id) != path)
             continue;
+        pathToID.remove(path);
+        idToPath.remove(id);
 
         int wd = id < 0 ? -id : id;
         // qDebug() << "removing watch for path" << path << "wd" << wd;
@@ -325,12 +351,16 @@ QStringList QInotifyFileSystemWatcherEngine::removePaths(const QStringList &path
 
         it.remove();
         if (id < 0) {
-            directories->removeAll(path);
+            removedDirectories.insert(path);
         } else {
-            files->removeAll(path);
+            removedFiles.insert(path);
         }
     }
 
+    // one pass over each list, however many paths were removed
+    removeFromList(files, removedFiles);
+    removeFromList(directories, removedDirectories);
+
     return p;
 }
 
@@ -346,13 +376,18 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
     char * const end = at + buffSize;
 
     QHash<int, inotify_event *> eventForId;
+    bool overflowed = false;
     while (at < end) {
         inotify_event *event = reinterpret_cast<inotify_event *>(at);
 
-        if (eventForId.contains(event->wd))
+        if (event->mask & IN_Q_OVERFLOW) {
+            // not tied to a watch; its wd of -1 must not be taken for a directory
+            overflowed = true;
+        } else if (eventForId.contains(event->wd)) {
             eventForId[event->wd]->mask |= event->mask;
-        else
+        } else {
             eventForId.insert(event->wd, event);
+        }
 
         at += sizeof(inotify_event) + event->len;
     }
@@ -392,6 +427,9 @@ void QInotifyFileSystemWatcherEngine::readFromInotify()
                 emit fileChanged(path, false);
         }
     }
+
+    if (overflowed)
+        emit queueOverflowed();
 }
 
 QT_END_NAMESPACE
@@ -59,10 +59,14 @@
 
 #include <private/qobject_p.h>
 
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
 #include <QtCore/qstringlist.h>
 
 QT_BEGIN_NAMESPACE
 
+class QTimer;
+
 class QFileSystemWatcherEngine : public QObject
 {
     Q_OBJECT
@@ -89,6 +93,8 @@ public:
 Q_SIGNALS:
     void fileChanged(const QString &path, bool removed);
     void directoryChanged(const QString &path, bool removed);
+    // the engine dropped events; anything may have changed
+    void queueOverflowed();
 };
 
 class QFileSystemWatcherPrivate : public QObjectPrivate
@@ -101,13 +107,46 @@ public:
     QFileSystemWatcherPrivate();
     void init();
     void initPollerEngine();
+    QFileSystemWatcherEngine *engineForNewPaths();
 
     QFileSystemWatcherEngine *native, *poller;
     QStringList files, directories;
 
+    // Paths reported as removed are dropped from files and directories
+    // lazily, so that removing a large tree is not quadratic.
+    QSet<QString> removedPaths;
+    void compactWatchLists();
+    bool isWatched(const QStringList &list, const QString &path) const;
+
+    // Recursive watches: every directory below a root added with
+    // addRecursivePath() is watched and linked to its parent.
+    struct RecursiveDirectory
+    {
+        QString parent;
+        QSet<QString> children;
+    };
+    QHash<QString, RecursiveDirectory> recursiveDirectories;
+    QStringList recursiveRoots;
+    void watchRecursively(const QStringList &roots, const QString &parent, QStringList *added);
+    void rescanRecursiveDirectory(const QString &directory, QStringList *added);
+    void forgetRecursiveDirectory(const QString &directory, QStringList *unwatch);
+    void unwatchDirectories(const QStringList &paths);
+
+    // Coalescing: with a latency, changes are collected and reported
+    // once per window.
+    int latency;
+    QTimer *latencyTimer;
+    QStringList pendingFiles, pendingDirectories;
+    QSet<QString> pendingFileSet, pendingDirectorySet, pendingRescans;
+    bool pendingOverflow;
+    void queueChange(const QString &path, bool isDirectory);
+    void dropPendingChanges(const QSet<QString> &paths);
+
     // private slots
     void _q_fileChanged(const QString &path, bool removed);
     void _q_directoryChanged(const QString &path, bool removed);
+    void _q_queueOverflowed();
+    void _q_emitPendingChanges();
 };
 
 
@@ -567,6 +567,7 @@ void QIODevice::close()
     d->openMode = NotOpen;
     d->errorString.clear();
     d->pos = 0;
+    d->devicePos = 0;
     d->seqDumpPos = 0;
     d->buffer.clear();
     d->firstRead = true;
@@ -1471,6 +1472,101 @@ QByteArray QIODevicePrivate::peek(qint64 maxSize)
     return result;
 }
 
+/*!
+    \internal
+
+    Sets up the position pointers the way the first read() does. Returns
+    false if the device is not readable.
+*/
+bool QIODevicePrivate::prepareFirstRead()
+{
+    if (firstRead) {
+        if ((openMode & QIODevice::ReadOnly) == 0)
+            return false;
+        firstRead = false;
+        if (isSequential()) {
+            pPos = &seqDumpPos;
+            pDevicePos = &seqDumpPos;
+        }
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    Returns the contents of the read buffer, filling it from the device
+    first if it is empty. Subclasses that can expose their storage directly
+    reimplement this function.
+*/
+const char *QIODevicePrivate::peekView(qint64 *size)
+{
+    Q_Q(QIODevice);
+    *size = 0;
+    if (buffer.isEmpty()) {
+        if (!prepareFirstRead())
+            return 0;
+
+        // Make sure the device is positioned correctly.
+        if (pos != devicePos && !isSequential() && !q->seek(pos))
+            return 0;
+        char *writePointer = buffer.reserve(QIODEVICE_BUFFERSIZE);
+        qint64 readFromDevice = q->readData(writePointer, QIODEVICE_BUFFERSIZE);
+        buffer.chop(QIODEVICE_BUFFERSIZE - (readFromDevice < 0 ? 0 : int(readFromDevice)));
+        if (readFromDevice <= 0)
+            return 0;
+        *pDevicePos += readFromDevice;
+    }
+
+    *size = buffer.size();
+    return buffer.readPointer();
+}
+
+/*!
+    \internal
+*/
+qint64 QIODevicePrivate::skip(qint64 maxSize)
+{
+    Q_Q(QIODevice);
+    if (!prepareFirstRead())
+        return -1;
+
+    // Consume buffered data first.
+    qint64 skipped = qMin(maxSize, qint64(buffer.size()));
+    if (skipped > 0) {
+        buffer.skip(int(skipped));
+        *pPos += skipped;
+        maxSize -= skipped;
+        if (buffer.isEmpty())
+            q->readData(0, 0);
+    }
+    if (maxSize == 0)
+        return skipped;
+
+    if (!isSequential()) {
+        const qint64 remaining = q->size() - pos;
+        if (remaining > 0) {
+            const qint64 advance = qMin(maxSize, remaining);
+            if (!q->seek(pos + advance))
+                return skipped ? skipped : qint64(-1);
+            skipped += advance;
+        }
+        return skipped;
+    }
+
+    // Sequential devices have to deliver the data; read it into scratch
+    // space and drop it.
+    char scratch[4096];
+    while (maxSize > 0) {
+        const qint64 readBytes = q->read(scratch, qMin<qint64>(maxSize, sizeof scratch));
+        if (readBytes <= 0)
+            return skipped ? skipped : readBytes;
+        skipped += readBytes;
+        maxSize -= readBytes;
+    }
+    return skipped;
+}
+
 /*! \fn bool QIODevice::getChar(char *c)
 
     Reads one character from the device and stores it in \a c. If \a c
@@ -1530,6 +1626,64 @@ QByteArray QIODevice::peek(qint64 maxSize)
     return d_func()->peek(maxSize);
 }
 
+/*!
+    \since 5.1
+
+    Returns a pointer to the data that the next read() would return, and
+    stores the number of bytes available at that address in \a size, without
+    copying and without changing pos().
+
+    The pointer refers either to the device's own storage (for example, the
+    QByteArray of a QBuffer or a memory mapping of a QFile) or to QIODevice's
+    internal read buffer, which is filled from the device if it is empty.
+    The returned block may be shorter than the remaining data; call skip()
+    to consume it and peekView() again to obtain the next block.
+
+    The pointer remains valid until the next call to a non-const function
+    of the device, including read(), skip(), seek() and close().
+
+    If no data is available, an error occurs, the device is not open for
+    reading or it is opened in \l Text mode, this function returns 0 and
+    sets \a size to 0.
+
+    Example:
+
+    \snippet code/src_corelib_io_qiodevice.cpp 6
+
+    \sa skip(), peek(), read()
+*/
+const char *QIODevice::peekView(qint64 *size)
+{
+    Q_D(QIODevice);
+    *size = 0;
+    if (d->openMode & Text)
+        return 0;
+    CHECK_READABLE(peekView, 0);
+    return d->peekView(size);
+}
+
+/*!
+    \since 5.1
+
+    Skips at most \a maxSize bytes of the device's data without copying them
+    to the caller, and returns the number of bytes skipped, or -1 if an
+    error occurred. Bytes are counted as they are stored in the device, so
+    in \l Text mode carriage returns are skipped but counted.
+
+    For random-access devices this is equivalent to advancing pos(), but it
+    never moves past the end of the device. Sequential devices read and
+    discard the data.
+
+    \sa peekView(), read()
+*/
+qint64 QIODevice::skip(qint64 maxSize)
+{
+    Q_D(QIODevice);
+    CHECK_MAXLEN(skip, qint64(-1));
+    CHECK_READABLE(skip, qint64(-1));
+    return d->skip(maxSize);
+}
+
 /*!
     Blocks until new data is available for reading and the readyRead()
     signal has been emitted, or until \a msecs milliseconds have
@@ -90,6 +90,9 @@ public:
     bool isEmpty() const {
         return len == 0;
     }
+    const char *readPointer() const {
+        return first;
+    }
     void skip(int n) {
         if (n >= len) {
             clear();
@@ -241,6 +244,9 @@ public:
 
     virtual qint64 peek(char *data, qint64 maxSize);
     virtual QByteArray peek(qint64 maxSize);
+    virtual const char *peekView(qint64 *size);
+    virtual qint64 skip(qint64 maxSize);
+    bool prepareFirstRead();
 
 #ifdef QT_NO_QOBJECT
     QIODevice *q_ptr;
@@ -1784,6 +1784,11 @@ void QProcess::setProcessState(ProcessState state)
     execution, your workaround is to emit finished() and then call
     exit().
 
+    \note Where the platform supports it, QProcess starts programs with
+    \e posix_spawn() instead of \e fork(), which is much faster for processes
+    that use a lot of memory. This is not done for subclasses of QProcess, so
+    that a reimplementation of this function is always called.
+
     \warning This function is called by QProcess on Unix and Mac OS X
     only. On Windows and QNX, it is not called.
 */
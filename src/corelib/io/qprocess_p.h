@@ -306,6 +306,8 @@ public:
     void startProcess();
 #if defined(Q_OS_UNIX) && !defined(Q_OS_QNX)
     void execChild(const char *workingDirectory, char **path, char **argv, char **envp);
+    bool spawnChildProcess(const char *workingDirectory, char **path, char **argv, char **envp,
+                           pid_t *pid);
 #elif defined(Q_OS_QNX)
     pid_t spawnChild(const char *workingDirectory, char **argv, char **envp);
 #endif
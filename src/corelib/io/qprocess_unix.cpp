@@ -113,6 +113,19 @@ QT_END_NAMESPACE
 #include <sys/neutrino.h>
 #endif
 
+// posix_spawn() avoids copying the parent's page tables, but it can only replace
+// fork() where it reports exec() failures to the caller and where we can tell
+// whether setupChildProcess() has been reimplemented.
+#if !defined(Q_OS_QNX) && !defined(QT_NO_RTTI) && (!defined(Q_CC_GNU) || defined(__GXX_RTTI)) \
+    && (defined(Q_OS_MAC) || (defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 24))))
+#define QPROCESS_USE_SPAWN
+#include <spawn.h>
+#include <typeinfo>
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+#define QPROCESS_SPAWN_CHDIR
+#endif
+#endif
+
 QT_BEGIN_NAMESPACE
 
 // POSIX requires PIPE_BUF to be 512 or larger
@@ -647,8 +660,16 @@ void QProcessPrivate::startProcess()
 #if defined(Q_OS_QNX)
     pid_t childPid = spawnChild(workingDirPtr, argv, envp);
 #else
-    pid_t childPid = fork();
-    int lastForkErrno = errno;
+    pid_t childPid = -1;
+    int lastForkErrno = 0;
+    bool spawned = false;
+#ifdef QPROCESS_USE_SPAWN
+    spawned = spawnChildProcess(workingDirPtr, path, argv, envp, &childPid);
+#endif
+    if (!spawned) {
+        childPid = fork();
+        lastForkErrno = errno;
+    }
 #endif
     if (childPid != 0) {
         // Clean up duplicated memory.
@@ -828,6 +849,92 @@ pid_t QProcessPrivate::spawnChild(const char *workingDir, char **argv, char **en
 
 #else
 
+#ifdef QPROCESS_USE_SPAWN
+/*
+    Starts the child with posix_spawn(), which does not duplicate the address
+    space of the parent and so does not get slower as the parent grows. This
+    is only possible when no code has to run in the child before exec(), i.e.
+    when setupChildProcess() is not reimplemented.
+
+    Returns false if the child was not started; the caller then forks and
+    lets execChild() report the error through childStartedPipe, as before.
+*/
+bool QProcessPrivate::spawnChildProcess(const char *workingDir, char **path, char **argv,
+                                        char **envp, pid_t *childPid)
+{
+    Q_Q(QProcess);
+    if (typeid(*q) != typeid(QProcess))
+        return false;
+#ifndef QPROCESS_SPAWN_CHDIR
+    if (workingDir)
+        return false;
+#endif
+
+    posix_spawn_file_actions_t fileActions;
+    if (posix_spawn_file_actions_init(&fileActions) != 0)
+        return false;
+    posix_spawnattr_t attributes;
+    if (posix_spawnattr_init(&attributes) != 0) {
+        posix_spawn_file_actions_destroy(&fileActions);
+        return false;
+    }
+
+    // the same redirections as execChild(); all other descriptors we own are
+    // close-on-exec
+    int ret = posix_spawn_file_actions_adddup2(&fileActions, stdinChannel.pipe[0], STDIN_FILENO);
+    if (ret == 0 && processChannelMode != QProcess::ForwardedChannels) {
+        ret = posix_spawn_file_actions_adddup2(&fileActions, stdoutChannel.pipe[1], STDOUT_FILENO);
+        if (ret == 0) {
+            if (processChannelMode == QProcess::MergedChannels)
+                ret = posix_spawn_file_actions_adddup2(&fileActions, STDOUT_FILENO, STDERR_FILENO);
+            else
+                ret = posix_spawn_file_actions_adddup2(&fileActions, stderrChannel.pipe[1], STDERR_FILENO);
+        }
+    }
+#ifdef QPROCESS_SPAWN_CHDIR
+    if (ret == 0 && workingDir)
+        ret = posix_spawn_file_actions_addchdir_np(&fileActions, workingDir);
+#endif
+
+    // reset the signal that we ignored
+    sigset_t defaultSignals;
+    sigemptyset(&defaultSignals);
+    sigaddset(&defaultSignals, SIGPIPE);
+    if (ret == 0)
+        ret = posix_spawnattr_setsigdefault(&attributes, &defaultSignals);
+    if (ret == 0)
+        ret = posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGDEF);
+
+    if (ret == 0) {
+        if (!envp) {
+            ret = posix_spawnp(childPid, argv[0], &fileActions, &attributes, argv, environ);
+        } else if (path) {
+            char *programName = argv[0];
+            for (char **arg = path; *arg; ++arg) {
+                argv[0] = *arg;
+#if defined (QPROCESS_DEBUG)
+                qDebug("QProcessPrivate::spawnChildProcess() searching / starting %s", argv[0]);
+#endif
+                ret = posix_spawn(childPid, argv[0], &fileActions, &attributes, argv, envp);
+                if (ret == 0)
+                    break;
+            }
+            argv[0] = programName;
+        } else {
+            ret = posix_spawn(childPid, argv[0], &fileActions, &attributes, argv, envp);
+        }
+    }
+
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&fileActions);
+#if defined (QPROCESS_DEBUG)
+    if (ret != 0)
+        qDebug("QProcessPrivate::spawnChildProcess() failed (%s)", qPrintable(qt_error_string(ret)));
+#endif
+    return ret == 0;
+}
+#endif
+
 void QProcessPrivate::execChild(const char *workingDir, char **path, char **argv, char **envp)
 {
     ::signal(SIGPIPE, SIG_DFL);         // reset the signal that we ignored
@@ -53,6 +53,7 @@
 #endif
 
 #include <stdlib.h>
+#include <limits.h>
 
 #ifdef Q_OS_MAC
 #include <mach/mach_time.h>
@@ -103,4 +104,43 @@ int qt_safe_select(int nfds, fd_set *fdread, fd_set *fdwrite, fd_set *fdexcept,
     }
 }
 
+#if QT_UNIX_SUPPORTS_EPOLL
+static inline int timeval_to_msecs(const struct timeval &tv)
+{
+    // round up, so that we never wake up before the timeout expired
+    if (tv.tv_sec >= INT_MAX / 1000 - 1)
+        return INT_MAX;
+    return int(tv.tv_sec * 1000 + (tv.tv_usec + 999) / 1000);
+}
+
+int qt_safe_epoll_wait(int epfd, struct epoll_event *events, int maxevents,
+                       const struct timeval *orig_timeout)
+{
+    if (!orig_timeout) {
+        // no timeout -> block forever
+        register int ret;
+        EINTR_LOOP(ret, ::epoll_wait(epfd, events, maxevents, -1));
+        return ret;
+    }
+
+    timeval start = qt_gettime();
+    timeval timeout = *orig_timeout;
+
+    // loop and recalculate the timeout as needed
+    int ret;
+    forever {
+        ret = ::epoll_wait(epfd, events, maxevents, timeval_to_msecs(timeout));
+        if (ret != -1 || errno != EINTR)
+            return ret;
+
+        // recalculate the timeout
+        if (!time_update(&timeout, start, *orig_timeout)) {
+            // timeout during update
+            // or clock reset, fake timeout error
+            return 0;
+        }
+    }
+}
+#endif
+
 QT_END_NAMESPACE
@@ -93,6 +93,13 @@ using namespace QT_PREPEND_NAMESPACE(QtLibcSupplement);
 # define QT_UNIX_SUPPORTS_THREADSAFE_CLOEXEC 0
 #endif
 
+#if defined(Q_OS_LINUX) && !defined(QT_NO_EPOLL)
+# include <sys/epoll.h>
+# define QT_UNIX_SUPPORTS_EPOLL 1
+#else
+# define QT_UNIX_SUPPORTS_EPOLL 0
+#endif
+
 #define EINTR_LOOP(var, cmd)                    \
     do {                                        \
         var = cmd;                              \
@@ -330,6 +337,26 @@ static inline pid_t qt_safe_waitpid(pid_t pid, int *status, int options)
 }
 #endif // Q_OS_VXWORKS
 
+#if QT_UNIX_SUPPORTS_EPOLL
+// don't call epoll_create1 directly:
+// the kernel or the C library may predate it
+static inline int qt_safe_epoll_create()
+{
+    register int fd;
+#ifdef EPOLL_CLOEXEC
+    fd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (fd != -1 || errno != ENOSYS)
+        return fd;
+#endif
+
+    // the size argument is only a hint and ignored by current kernels
+    fd = ::epoll_create(64);
+    if (fd != -1)
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+#endif
+
 #if !defined(_POSIX_MONOTONIC_CLOCK)
 #  define _POSIX_MONOTONIC_CLOCK -1
 #endif
@@ -340,6 +367,10 @@ void qt_nanosleep(timespec amount);
 
 Q_CORE_EXPORT int qt_safe_select(int nfds, fd_set *fdread, fd_set *fdwrite, fd_set *fdexcept,
                                  const struct timeval *tv);
+#if QT_UNIX_SUPPORTS_EPOLL
+Q_CORE_EXPORT int qt_safe_epoll_wait(int epfd, struct epoll_event *events, int maxevents,
+                                     const struct timeval *tv);
+#endif
 
 // according to X/OPEN we have to define semun ourselves
 // we use prefix as on some systems sem.h will have it
@@ -240,7 +240,7 @@ static bool qt_locale_initialized = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
-    return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
+    return currentThreadData->postEventList.pendingEventCount();
 }
 
 QCoreApplication *QCoreApplication::self = 0;
@@ -361,6 +361,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         QMutexLocker locker(&threadData->postEventList.mutex);
+        threadData->postEventList.takeQueuedEvents();
         for (int i = 0; i < threadData->postEventList.size(); ++i) {
             const QPostEvent &pe = threadData->postEventList.at(i);
             if (pe.event) {
@@ -1120,6 +1121,31 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    // events that are never compressed can be queued without locking, as
+    // long as the receiver is not being moved to another thread meanwhile
+    // (see QObject::moveToThread())
+    if (priority == Qt::NormalEventPriority
+        && (event->type() == QEvent::MetaCall || event->type() >= QEvent::User)) {
+        data->postEventList.queueingThreads.fetchAndAddOrdered(1);
+        if (data == *pdata) {
+            QScopedPointer<QEvent> eventDeleter(event);
+            event->posted = true;
+            data->postEventList.queueEvent(receiver, event);
+            eventDeleter.take();
+            data->canWait = false;
+            if (data->eventDispatcher)
+                data->eventDispatcher->wakeUp();
+            data->postEventList.queueingThreads.fetchAndAddRelease(-1);
+            return;
+        }
+        data->postEventList.queueingThreads.fetchAndAddRelease(-1);
+        data = *pdata;
+        if (!data) {
+            delete event;
+            return;
+        }
+    }
+
     // lock the post event mutex
     data->postEventList.mutex.lock();
 
@@ -1139,6 +1165,9 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
 
     QMutexUnlocker locker(&data->postEventList.mutex);
 
+    // keep the events queued so far ahead of this one
+    data->postEventList.takeQueuedEvents();
+
     // if this is one of the compressible events, do compression
     if (receiver->d_func()->postedEvents
         && self && self->compressEvent(event, receiver, &data->postEventList)) {
@@ -1158,6 +1187,7 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
     eventDeleter.take();
     event->posted = true;
     ++receiver->d_func()->postedEvents;
+    data->postEventList.insertedCount.ref();
     data->canWait = false;
     locker.unlock();
 
@@ -1165,6 +1195,62 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         data->eventDispatcher->wakeUp();
 }
 
+/*!
+  \internal
+  Moves the events that QCoreApplication::postEvent() queued without
+  locking into the list, in the order in which they were posted. Must be
+  called with the mutex locked.
+
+  While QObject::moveToThread() runs, events for receivers that have
+  already been moved to \a target are added to the list of \a target,
+  whose mutex must be locked as well. Returns the number of events added
+  to the list of \a target.
+*/
+int QPostEventList::takeQueuedEvents(QThreadData *target)
+{
+    QQueuedPostEvent *node = queuedEvents.fetchAndStoreAcquire(0);
+    if (!node)
+        return 0;
+
+    // the stack holds the newest event first
+    QQueuedPostEvent *first = 0;
+    while (node) {
+        QQueuedPostEvent *next = node->next;
+        node->next = first;
+        first = node;
+        node = next;
+    }
+
+    int movedToTarget = 0;
+    while (first) {
+        node = first;
+        first = node->next;
+
+        QPostEventList *list = this;
+        if (target && QObjectPrivate::get(node->receiver)->threadData == target) {
+            list = &target->postEventList;
+            ++movedToTarget;
+        }
+        list->addEvent(QPostEvent(node->receiver, node->event, Qt::NormalEventPriority));
+        ++QObjectPrivate::get(node->receiver)->postedEvents;
+        takenCount.ref();
+        delete node;
+    }
+    return movedToTarget;
+}
+
+/*!
+  \internal
+  Returns the counters of the posted events of \a thread, or of the
+  current thread if \a thread is 0.
+*/
+QPostEventStatistics QCoreApplicationPrivate::postEventStatistics(QThread *thread)
+{
+    QThreadData *data = thread ? QThreadData::get2(thread) : QThreadData::current();
+    QMutexLocker locker(&data->postEventList.mutex);
+    return data->postEventList.statistics();
+}
+
 /*!
   \internal
   Returns true if \a event was compressed away (possibly deleted) and should not be added to the list.
@@ -1245,6 +1331,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->postEventList.takeQueuedEvents();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
@@ -1281,6 +1368,10 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
                 data->canWait = false;
             }
 
+            // events queued while we were sending need another pass as well
+            if (data->postEventList.hasQueuedEvents())
+                data->canWait = false;
+
             --data->postEventList.recursion;
             if (!data->postEventList.recursion && !data->canWait && data->eventDispatcher)
                 data->eventDispatcher->wakeUp();
@@ -1351,6 +1442,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
 
         --r->d_func()->postedEvents;
         Q_ASSERT(r->d_func()->postedEvents >= 0);
+        data->postEventList.deliveredCount.ref();
 
         // next, update the data structure so that we're ready
         // for the next event.
@@ -1399,6 +1491,7 @@ void QCoreApplication::removePostedEvents(QObject *receiver, int eventType)
 {
     QThreadData *data = receiver ? receiver->d_func()->threadData : QThreadData::current();
     QMutexLocker locker(&data->postEventList.mutex);
+    data->postEventList.takeQueuedEvents();
 
     // the QObject destructor calls this function directly.  this can
     // happen while the event loop is in the middle of posting events,
@@ -1464,6 +1557,7 @@ void QCoreApplicationPrivate::removePostedEvent(QEvent * event)
     QThreadData *data = QThreadData::current();
 
     QMutexLocker locker(&data->postEventList.mutex);
+    data->postEventList.takeQueuedEvents();
 
     if (data->postEventList.size() == 0) {
 #if defined(QT_DEBUG)
@@ -63,6 +63,7 @@ QT_BEGIN_NAMESPACE
 typedef QList<QTranslator*> QTranslatorList;
 
 class QAbstractEventDispatcher;
+struct QPostEventStatistics;
 
 class Q_CORE_EXPORT QCoreApplicationPrivate : public QObjectPrivate
 {
@@ -106,6 +107,7 @@ public:
     static QThread *mainThread();
     static bool checkInstance(const char *method);
     static void sendPostedEvents(QObject *receiver, int event_type, QThreadData *data);
+    static QPostEventStatistics postEventStatistics(QThread *thread = 0);
 
 #if !defined (QT_NO_DEBUG) || defined (QT_MAC_FRAMEWORK_BUILD)
     void checkReceiverThread(QObject *receiver);
@@ -139,6 +139,34 @@ QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
     sn_highest = -1;
 
     interrupt = false;
+
+#if QT_UNIX_SUPPORTS_EPOLL
+    // epoll scales with the number of ready file descriptors instead of the
+    // highest one and is not limited by FD_SETSIZE; it can be disabled by
+    // setting QT_NO_EPOLL in the environment
+    epollFd = -1;
+    epollEventCount = -1;
+    epollSelecting = false;
+    if (qEnvironmentVariableIsEmpty("QT_NO_EPOLL")) {
+        epollFd = qt_safe_epoll_create();
+        // doEpoll() passes the epoll descriptor to select()
+        if (epollFd != -1 && unsigned(epollFd) >= FD_SETSIZE) {
+            qt_safe_close(epollFd);
+            epollFd = -1;
+        }
+        if (epollFd != -1) {
+            epoll_event ev;
+            memset(&ev, 0, sizeof(ev));
+            ev.events = EPOLLIN;
+            ev.data.fd = thread_pipe[0];
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, thread_pipe[0], &ev) == -1) {
+                perror("QEventDispatcherUNIXPrivate(): Unable to watch thread pipe, using select()");
+                qt_safe_close(epollFd);
+                epollFd = -1;
+            }
+        }
+    }
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
@@ -158,8 +186,22 @@ QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
     close(thread_pipe[1]);
 #endif
 
-    // cleanup timers
-    qDeleteAll(timerList);
+#if QT_UNIX_SUPPORTS_EPOLL
+    if (epollFd != -1) {
+        qt_safe_close(epollFd);
+        QHash<int, QSockNotSet>::const_iterator it = epollNotifiers.constBegin();
+        for ( ; it != epollNotifiers.constEnd(); ++it) {
+            for (int type = 0; type < 3; ++type) {
+                QSockNot *sn = it->notifiers[type];
+                while (sn) {
+                    QSockNot *next = sn->next;
+                    delete sn;
+                    sn = next;
+                }
+            }
+        }
+    }
+#endif
 }
 
 int QEventDispatcherUNIXPrivate::doSelect(QEventLoop::ProcessEventsFlags flags, timeval *timeout)
@@ -256,13 +298,162 @@ int QEventDispatcherUNIXPrivate::doSelect(QEventLoop::ProcessEventsFlags flags,
             for (int j = 0; j < list.size(); ++j) {
                 QSockNot *sn = list[j];
                 if (FD_ISSET(sn->fd, &sn_vec[i].select_fds))
-                    q->setSocketNotifierPending(sn->obj);
+                    markPending(sn);
             }
         }
     }
     return (nevents + q->activateSocketNotifiers());
 }
 
+#if QT_UNIX_SUPPORTS_EPOLL
+static inline void markPendingList(QEventDispatcherUNIXPrivate *d, QSockNot *sn)
+{
+    for ( ; sn; sn = sn->next)
+        d->markPending(sn);
+}
+
+int QEventDispatcherUNIXPrivate::doEpoll(timeval *timeout)
+{
+    Q_Q(QEventDispatcherUNIX);
+
+    // don't block while there are descriptors epoll cannot watch
+    timeval zero_tm = { 0l, 0l };
+    if (!epollAlwaysReady.isEmpty())
+        timeout = &zero_tm;
+
+    // wait in select() for the epoll descriptor to become readable
+    fd_set readfds;
+    int nsel;
+    epollEventCount = -1;
+    do {
+        FD_ZERO(&readfds);
+        FD_SET(epollFd, &readfds);
+        epollSelecting = true;
+        nsel = q->select(epollFd + 1, &readfds, 0, 0, timeout);
+        epollSelecting = false;
+    } while (nsel == -1 && (errno == EINTR || errno == EAGAIN));
+
+    int nevents = 0;
+    if (nsel == -1) {
+        perror("select");
+    } else if (epollEventCount == -1 && nsel > 0 && FD_ISSET(epollFd, &readfds)) {
+        // select() was reimplemented and did not collect the events;
+        // level-triggered, so whatever does not fit is reported again next time
+        epollEventCount = qt_safe_epoll_wait(epollFd, epollEvents, MaxEpollEvents, &zero_tm);
+        if (epollEventCount == -1)
+            perror("epoll_wait");
+    }
+
+    for (int i = 0; i < epollEventCount; ++i) {
+        const int fd = epollEvents[i].data.fd;
+        const quint32 revents = epollEvents[i].events;
+        if (fd == thread_pipe[0]) {
+            nevents += consumeThreadWakeUp();
+            continue;
+        }
+
+        QHash<int, QSockNotSet>::const_iterator it = epollNotifiers.constFind(fd);
+        if (it == epollNotifiers.constEnd())
+            continue;
+
+        // report errors and hang-ups the same way select() does
+        if (revents & (EPOLLIN | EPOLLHUP | EPOLLERR))
+            markPendingList(this, it->notifiers[0]);
+        if (revents & (EPOLLOUT | EPOLLERR))
+            markPendingList(this, it->notifiers[1]);
+        if (revents & EPOLLPRI)
+            markPendingList(this, it->notifiers[2]);
+    }
+    epollEventCount = -1;
+
+    for (int i = 0; i < epollAlwaysReady.size(); ++i) {
+        const QSockNotSet &set = epollNotifiers.value(epollAlwaysReady.at(i));
+        markPendingList(this, set.notifiers[0]);
+        markPendingList(this, set.notifiers[1]);
+    }
+
+    return nevents + q->activateSocketNotifiers();
+}
+
+/*
+    The default QEventDispatcherUNIX::select() when called from doEpoll():
+    waits with epoll_wait() directly and keeps the events, unless a
+    reimplementation passed other descriptors on.
+*/
+int QEventDispatcherUNIXPrivate::epollSelect(int nfds, fd_set *readfds, fd_set *writefds,
+                                             fd_set *exceptfds, timeval *timeout)
+{
+    bool onlyEpollFd = nfds == epollFd + 1 && readfds && FD_ISSET(epollFd, readfds)
+                       && !writefds && !exceptfds;
+    for (int fd = 0; onlyEpollFd && fd < epollFd; ++fd)
+        onlyEpollFd = !FD_ISSET(fd, readfds);
+    if (!onlyEpollFd)
+        return qt_safe_select(nfds, readfds, writefds, exceptfds, timeout);
+
+    // level-triggered: whatever does not fit is reported again next time
+    epollEventCount = qt_safe_epoll_wait(epollFd, epollEvents, MaxEpollEvents, timeout);
+    if (epollEventCount == -1) {
+        const int error = errno;
+        epollEventCount = 0;
+        errno = error;
+        return -1;
+    }
+    if (epollEventCount == 0)
+        FD_CLR(epollFd, readfds);
+    return epollEventCount > 0 ? 1 : 0;
+}
+
+bool QEventDispatcherUNIXPrivate::updateEpoll(int fd, QSockNotSet &set)
+{
+    static const quint32 typeEvents[] = { EPOLLIN, EPOLLOUT, EPOLLPRI };
+    quint32 wanted = 0;
+    for (int type = 0; type < 3; ++type) {
+        if (set.notifiers[type])
+            wanted |= typeEvents[type];
+    }
+    if (wanted == set.events)
+        return true;
+
+    if (set.alwaysReady) {
+        if (!wanted) {
+            epollAlwaysReady.removeAll(fd);
+            set.alwaysReady = false;
+        }
+        set.events = wanted;
+        return true;
+    }
+
+    epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = wanted;
+    ev.data.fd = fd;
+
+    int ret;
+    if (!wanted) {
+        // the kernel drops closed descriptors on its own, so ignore errors
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, &ev);
+        ret = 0;
+    } else if (!set.events) {
+        ret = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        if (ret == -1 && errno == EPERM) {
+            set.alwaysReady = true;
+            epollAlwaysReady.append(fd);
+            ret = 0;
+        }
+    } else {
+        ret = epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+        // the descriptor was closed and reused behind our back
+        if (ret == -1 && errno == ENOENT)
+            ret = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+    if (ret == -1)
+        return false;
+
+    set.events = wanted;
+    return true;
+}
+#endif
+
 int QEventDispatcherUNIXPrivate::initThreadWakeUp()
 {
     FD_SET(thread_pipe[0], &sn_vec[0].select_fds);
@@ -271,25 +462,48 @@ int QEventDispatcherUNIXPrivate::initThreadWakeUp()
 
 int QEventDispatcherUNIXPrivate::processThreadWakeUp(int nsel)
 {
-    if (nsel > 0 && FD_ISSET(thread_pipe[0], &sn_vec[0].select_fds)) {
-        // some other thread woke us up... consume the data on the thread pipe so that
-        // select doesn't immediately return next time
+    if (nsel > 0 && FD_ISSET(thread_pipe[0], &sn_vec[0].select_fds))
+        return consumeThreadWakeUp();
+    return 0;
+}
+
+int QEventDispatcherUNIXPrivate::consumeThreadWakeUp()
+{
+    // some other thread woke us up... consume the data on the thread pipe so that
+    // select doesn't immediately return next time
 #if defined(Q_OS_VXWORKS)
-        char c[16];
-        ::read(thread_pipe[0], c, sizeof(c));
-        ::ioctl(thread_pipe[0], FIOFLUSH, 0);
+    char c[16];
+    ::read(thread_pipe[0], c, sizeof(c));
+    ::ioctl(thread_pipe[0], FIOFLUSH, 0);
 #else
-        char c[16];
-        while (::read(thread_pipe[0], c, sizeof(c)) > 0)
-            ;
+    char c[16];
+    while (::read(thread_pipe[0], c, sizeof(c)) > 0)
+        ;
 #endif
-        if (!wakeUps.testAndSetRelease(1, 0)) {
-            // hopefully, this is dead code
-            qWarning("QEventDispatcherUNIX: internal error, wakeUps.testAndSetRelease(1, 0) failed!");
+    if (!wakeUps.testAndSetRelease(1, 0)) {
+        // hopefully, this is dead code
+        qWarning("QEventDispatcherUNIX: internal error, wakeUps.testAndSetRelease(1, 0) failed!");
+    }
+    return 1;
+}
+
+void QEventDispatcherUNIXPrivate::markPending(QSockNot *sn)
+{
+    // We choose a random activation order to be more fair under high load.
+    // If a constant order is used and a peer early in the list can
+    // saturate the IO, it might grab our attention completely.
+    // Also, if we're using a straight list, the callback routines may
+    // delete other entries from the list before those other entries are
+    // processed.
+    if (!sn->pending) {
+        if (sn_pending_list.isEmpty()) {
+            sn_pending_list.append(sn);
+        } else {
+            sn_pending_list.insert((qrand() & 0xff) %
+                                   (sn_pending_list.size()+1), sn);
         }
-        return 1;
+        sn->pending = true;
     }
-    return 0;
 }
 
 QEventDispatcherUNIX::QEventDispatcherUNIX(QObject *parent)
@@ -309,6 +523,13 @@ QEventDispatcherUNIX::~QEventDispatcherUNIX()
 int QEventDispatcherUNIX::select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
                                  timeval *timeout)
 {
+#if QT_UNIX_SUPPORTS_EPOLL
+    Q_D(QEventDispatcherUNIX);
+    if (d->epollSelecting) {
+        d->epollSelecting = false;
+        return d->epollSelect(nfds, readfds, writefds, exceptfds, timeout);
+    }
+#endif
     return qt_safe_select(nfds, readfds, writefds, exceptfds, timeout);
 }
 
@@ -388,7 +609,6 @@ QSockNotType::QSockNotType()
 {
     FD_ZERO(&select_fds);
     FD_ZERO(&enabled_fds);
-    FD_ZERO(&pending_fds);
 }
 
 QSockNotType::~QSockNotType()
@@ -404,11 +624,12 @@ QSockNotType::~QSockNotType()
 void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
 {
     Q_ASSERT(notifier);
+    Q_D(QEventDispatcherUNIX);
     int sockfd = notifier->socket();
     int type = notifier->type();
 #ifndef QT_NO_DEBUG
     if (sockfd < 0
-        || unsigned(sockfd) >= FD_SETSIZE) {
+        || (!d->usesEpoll() && unsigned(sockfd) >= FD_SETSIZE)) {
         qWarning("QSocketNotifier: Internal error");
         return;
     } else if (notifier->thread() != thread()
@@ -418,15 +639,45 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
     }
 #endif
 
-    Q_D(QEventDispatcherUNIX);
-    QSockNotType::List &list = d->sn_vec[type].list;
-    fd_set *fds  = &d->sn_vec[type].enabled_fds;
     QSockNot *sn;
 
     sn = new QSockNot;
     sn->obj = notifier;
     sn->fd = sockfd;
-    sn->queue = &d->sn_vec[type].pending_fds;
+    sn->pending = false;
+
+#if QT_UNIX_SUPPORTS_EPOLL
+    sn->next = 0;
+    if (d->usesEpoll()) {
+        QSockNotSet &set = d->epollNotifiers[sockfd];
+        QSockNot *head = set.notifiers[type];
+        if (head) {
+            static const char *t[] = { "Read", "Write", "Exception" };
+            qWarning("QSocketNotifier: Multiple socket notifiers for "
+                      "same socket %d and type %s", sockfd, t[type]);
+            // the descriptor is already watched for this type
+            QSockNot *last = head;
+            while (last->next)
+                last = last->next;
+            last->next = sn;
+            return;
+        }
+        set.notifiers[type] = sn;
+        if (!d->updateEpoll(sockfd, set)) {
+            static const char *t[] = { "Read", "Write", "Exception" };
+            qWarning("QSocketNotifier: Invalid socket %d and type '%s', disabling...",
+                     sockfd, t[type]);
+            set.notifiers[type] = 0;
+            delete sn;
+            if (!set.events)
+                d->epollNotifiers.remove(sockfd);
+        }
+        return;
+    }
+#endif
+
+    QSockNotType::List &list = d->sn_vec[type].list;
+    fd_set *fds  = &d->sn_vec[type].enabled_fds;
 
     int i;
     for (i = 0; i < list.size(); ++i) {
@@ -448,11 +699,12 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
 {
     Q_ASSERT(notifier);
+    Q_D(QEventDispatcherUNIX);
     int sockfd = notifier->socket();
     int type = notifier->type();
 #ifndef QT_NO_DEBUG
     if (sockfd < 0
-        || unsigned(sockfd) >= FD_SETSIZE) {
+        || (!d->usesEpoll() && unsigned(sockfd) >= FD_SETSIZE)) {
         qWarning("QSocketNotifier: Internal error");
         return;
     } else if (notifier->thread() != thread()
@@ -462,7 +714,32 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
     }
 #endif
 
-    Q_D(QEventDispatcherUNIX);
+#if QT_UNIX_SUPPORTS_EPOLL
+    if (d->usesEpoll()) {
+        QHash<int, QSockNotSet>::iterator it = d->epollNotifiers.find(sockfd);
+        if (it == d->epollNotifiers.end())
+            return;
+        QSockNot **link = &it->notifiers[type];
+        while (*link && (*link)->obj != notifier)
+            link = &(*link)->next;
+        QSockNot *sn = *link;
+        if (!sn) // not found
+            return;
+
+        d->sn_pending_list.removeAll(sn);
+        *link = sn->next;
+        delete sn;
+
+        // only the last notifier of this type changes what epoll watches
+        if (!it->notifiers[type]) {
+            d->updateEpoll(sockfd, *it);
+            if (!it->events)
+                d->epollNotifiers.erase(it);
+        }
+        return;
+    }
+#endif
+
     QSockNotType::List &list = d->sn_vec[type].list;
     fd_set *fds  =  &d->sn_vec[type].enabled_fds;
     QSockNot *sn = 0;
@@ -475,12 +752,15 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
     if (i == list.size()) // not found
         return;
 
-    FD_CLR(sockfd, fds);                        // clear fd bit
-    FD_CLR(sockfd, sn->queue);
     d->sn_pending_list.removeAll(sn);                // remove from activation list
     list.removeAt(i);                                // remove notifier found above
     delete sn;
 
+    // keep the fd bit for other notifiers of the same socket (list is fd-sorted)
+    if ((i >= list.size() || list[i]->fd != sockfd)
+        && (i == 0 || list[i - 1]->fd != sockfd))
+        FD_CLR(sockfd, fds);                        // clear fd bit
+
     if (d->sn_highest == sockfd) {                // find highest fd
         d->sn_highest = -1;
         for (int i=0; i<3; i++) {
@@ -494,18 +774,33 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
 void QEventDispatcherUNIX::setSocketNotifierPending(QSocketNotifier *notifier)
 {
     Q_ASSERT(notifier);
+    Q_D(QEventDispatcherUNIX);
     int sockfd = notifier->socket();
     int type = notifier->type();
 #ifndef QT_NO_DEBUG
     if (sockfd < 0
-        || unsigned(sockfd) >= FD_SETSIZE) {
+        || (!d->usesEpoll() && unsigned(sockfd) >= FD_SETSIZE)) {
         qWarning("QSocketNotifier: Internal error");
         return;
     }
     Q_ASSERT(notifier->thread() == thread() && thread() == QThread::currentThread());
 #endif
 
-    Q_D(QEventDispatcherUNIX);
+#if QT_UNIX_SUPPORTS_EPOLL
+    if (d->usesEpoll()) {
+        QHash<int, QSockNotSet>::const_iterator it = d->epollNotifiers.constFind(sockfd);
+        if (it != d->epollNotifiers.constEnd()) {
+            for (QSockNot *sn = it->notifiers[type]; sn; sn = sn->next) {
+                if (sn->obj == notifier) {
+                    d->markPending(sn);
+                    break;
+                }
+            }
+        }
+        return;
+    }
+#endif
+
     QSockNotType::List &list = d->sn_vec[type].list;
     QSockNot *sn = 0;
     int i;
@@ -517,21 +812,7 @@ void QEventDispatcherUNIX::setSocketNotifierPending(QSocketNotifier *notifier)
     if (i == list.size()) // not found
         return;
 
-    // We choose a random activation order to be more fair under high load.
-    // If a constant order is used and a peer early in the list can
-    // saturate the IO, it might grab our attention completely.
-    // Also, if we're using a straight list, the callback routines may
-    // delete other entries from the list before those other entries are
-    // processed.
-    if (! FD_ISSET(sn->fd, sn->queue)) {
-        if (d->sn_pending_list.isEmpty()) {
-            d->sn_pending_list.append(sn);
-        } else {
-            d->sn_pending_list.insert((qrand() & 0xff) %
-                                      (d->sn_pending_list.size()+1), sn);
-        }
-        FD_SET(sn->fd, sn->queue);
-    }
+    d->markPending(sn);
 }
 
 int QEventDispatcherUNIX::activateTimers()
@@ -552,8 +833,8 @@ int QEventDispatcherUNIX::activateSocketNotifiers()
     QEvent event(QEvent::SockAct);
     while (!d->sn_pending_list.isEmpty()) {
         QSockNot *sn = d->sn_pending_list.takeFirst();
-        if (FD_ISSET(sn->fd, sn->queue)) {
-            FD_CLR(sn->fd, sn->queue);
+        if (sn->pending) {
+            sn->pending = false;
             QCoreApplication::sendEvent(sn->obj, &event);
             ++n_act;
         }
@@ -596,7 +877,13 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
             tm->tv_usec = 0l;
         }
 
-        nevents = d->doSelect(flags, tm);
+#if QT_UNIX_SUPPORTS_EPOLL
+        // with socket notifiers excluded, select() only waits for the thread pipe
+        if (d->usesEpoll() && !(flags & QEventLoop::ExcludeSocketNotifiers))
+            nevents = d->doEpoll(tm);
+        else
+#endif
+            nevents = d->doSelect(flags, tm);
 
         // activate timers
         if (! (flags & QEventLoop::X11ExcludeTimers)) {
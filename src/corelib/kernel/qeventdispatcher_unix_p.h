@@ -55,6 +55,7 @@
 
 #include "QtCore/qabstracteventdispatcher.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qhash.h"
 #include "private/qabstracteventdispatcher_p.h"
 #include "private/qcore_unix_p.h"
 #include "private/qpodlist_p.h"
@@ -76,7 +77,11 @@ struct QSockNot
 {
     QSocketNotifier *obj;
     int fd;
-    fd_set *queue;
+    bool pending;
+#if QT_UNIX_SUPPORTS_EPOLL
+    // more notifiers for the same descriptor and type
+    QSockNot *next;
+#endif
 };
 
 class QSockNotType
@@ -90,10 +95,21 @@ public:
     List list;
     fd_set select_fds;
     fd_set enabled_fds;
-    fd_set pending_fds;
 
 };
 
+#if QT_UNIX_SUPPORTS_EPOLL
+// the read, write and exception notifiers registered for one file descriptor,
+// each the head of a list linked through QSockNot::next
+struct QSockNotSet
+{
+    QSockNot *notifiers[3];
+    quint32 events;
+    // regular files cannot be watched with epoll, select() reports them as always ready
+    bool alwaysReady;
+};
+#endif
+
 class QEventDispatcherUNIXPrivate;
 
 class Q_CORE_EXPORT QEventDispatcherUNIX : public QAbstractEventDispatcher
@@ -146,6 +162,25 @@ public:
     int doSelect(QEventLoop::ProcessEventsFlags flags, timeval *timeout);
     virtual int initThreadWakeUp();
     virtual int processThreadWakeUp(int nsel);
+    int consumeThreadWakeUp();
+
+    void markPending(QSockNot *sn);
+
+    inline bool usesEpoll() const
+    {
+#if QT_UNIX_SUPPORTS_EPOLL
+        return epollFd != -1;
+#else
+        return false;
+#endif
+    }
+
+#if QT_UNIX_SUPPORTS_EPOLL
+    int doEpoll(timeval *timeout);
+    int epollSelect(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
+                    timeval *timeout);
+    bool updateEpoll(int fd, QSockNotSet &set);
+#endif
 
     bool mainThread;
     int thread_pipe[2];
@@ -160,6 +195,21 @@ public:
     // pending socket notifiers list
     QSockNotType::List sn_pending_list;
 
+#if QT_UNIX_SUPPORTS_EPOLL
+    // when valid, socket notifiers are watched with epoll instead of select()
+    int epollFd;
+    QHash<int, QSockNotSet> epollNotifiers;
+    QPodList<int, 4> epollAlwaysReady;
+
+    // doEpoll() waits in select() on epollFd, so that reimplementations of
+    // select() are still called; the default implementation collects the
+    // events right away instead
+    enum { MaxEpollEvents = 256 };
+    epoll_event epollEvents[MaxEpollEvents];
+    int epollEventCount; // -1 while select() has not collected them
+    bool epollSelecting;
+#endif
+
     QAtomicInt wakeUps;
     bool interrupt;
 };
@@ -125,7 +125,15 @@ static int *queuedConnectionTypes(const QArgumentType *argumentTypes, int argc)
     return types.take();
 }
 
-static QBasicMutex _q_ObjectMutexPool[131];
+// Each mutex of the pool lives on its own cache line, so that threads
+// connecting or emitting on unrelated objects do not contend on it.
+struct QObjectMutexPoolEntry
+{
+    QBasicMutex mutex;
+    char padding[64 - sizeof(QBasicMutex)];
+};
+enum { ObjectMutexPoolShift = 8 };
+static QObjectMutexPoolEntry _q_ObjectMutexPool[1 << ObjectMutexPoolShift];
 
 /**
  * \internal
@@ -133,8 +141,10 @@ static QBasicMutex _q_ObjectMutexPool[131];
  */
 static inline QMutex *signalSlotLock(const QObject *o)
 {
-    return static_cast<QMutex *>(&_q_ObjectMutexPool[
-        uint(quintptr(o)) % sizeof(_q_ObjectMutexPool)/sizeof(QBasicMutex)]);
+    // objects are allocated on the heap with a large alignment, so use a
+    // multiplicative hash to spread neighbouring objects over the pool
+    const quint32 h = quint32(quintptr(o) >> 3) * 2654435769u;
+    return static_cast<QMutex *>(&_q_ObjectMutexPool[h >> (32 - ObjectMutexPoolShift)].mutex);
 }
 
 extern "C" Q_CORE_EXPORT void qt_addObject(QObject *)
@@ -224,7 +234,7 @@ QObjectPrivate::~QObjectPrivate()
             QAbstractEventDispatcherPrivate::releaseTimerId(extraData->runningTimers.at(i));
     }
 
-    if (postedEvents)
+    if (postedEvents || threadData->postEventList.hasQueuedEvents())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     threadData->deref();
@@ -264,29 +274,122 @@ static void computeOffsets(const QMetaObject *metaobject, int *signalOffset, int
     QObjectPrivate::signalIndex (not QMetaObject::indexOfSignal).
     Negative index means connections to all signals.
 
-    This vector is protected by the object mutex (signalSlotMutexes())
+    This vector is modified under the object mutex (signalSlotMutexes()),
+    but QMetaObject::activate() reads it without locking: emission takes a
+    reference on inUse, loads the current storage and walks the lists from
+    that snapshot. Therefore nothing an emission may still see is freed
+    while inUse is non zero:
+    - disconnected connections only get their receiver reset and stay in
+      the lists until cleanConnectionLists() can claim the vector;
+    - growing the vector publishes a new storage and retires the old one,
+      which is released together with the disconnected connections.
 
     Each Connection is also part of a 'senders' linked list. The mutex
     of the receiver must be locked when touching the pointers of this
     linked list.
 */
-class QObjectConnectionListVector : public QVector<QObjectPrivate::ConnectionList>
+class QObjectConnectionListVector
 {
 public:
+    struct Storage
+    {
+        explicit Storage(int count)
+            : count(count), lists(new QObjectPrivate::ConnectionList[count]), retired(0)
+        { }
+        ~Storage() { delete [] lists; }
+
+        int count;
+        QObjectPrivate::ConnectionList *lists;
+        Storage *retired; // next storage waiting to be released
+    private:
+        Q_DISABLE_COPY(Storage)
+    };
+
+    // value of inUse while cleanConnectionLists() has exclusive access
+    enum { Claimed = -0x40000000 };
+
     bool orphaned; //the QObject owner of this vector has been destroyed while the vector was inUse
     bool dirty; //some Connection have been disconnected (their receiver is 0) but not removed from the list yet
-    int inUse; //number of functions that are currently accessing this object or its connections
+    QAtomicInt inUse; //number of functions that are currently accessing this object or its connections
     QObjectPrivate::ConnectionList allsignals;
+    QAtomicPointer<Storage> storage;
+    Storage *retired;
 
     QObjectConnectionListVector()
-        : QVector<QObjectPrivate::ConnectionList>(), orphaned(false), dirty(false), inUse(0)
+        : orphaned(false), dirty(false), inUse(0), storage(0), retired(0)
     { }
 
+    ~QObjectConnectionListVector()
+    {
+        delete storage.load();
+        releaseRetired();
+    }
+
+    int count() const
+    {
+        Storage *s = storage.load();
+        return s ? s->count : 0;
+    }
+
+    const QObjectPrivate::ConnectionList &at(int at) const
+    {
+        if (at < 0)
+            return allsignals;
+        return storage.load()->lists[at];
+    }
+
     QObjectPrivate::ConnectionList &operator[](int at)
     {
         if (at < 0)
             return allsignals;
-        return QVector<QObjectPrivate::ConnectionList>::operator[](at);
+        return storage.load()->lists[at];
+    }
+
+    // must be called with the object mutex locked
+    void resize(int count)
+    {
+        Storage *old = storage.load();
+        Storage *s = new Storage(count);
+        for (int i = 0; old && i < old->count; ++i) {
+            s->lists[i].first.store(old->lists[i].first.load());
+            s->lists[i].last.store(old->lists[i].last.load());
+        }
+        storage.storeRelease(s);
+        if (old) {
+            old->retired = retired;
+            retired = old;
+        }
+    }
+
+    void releaseRetired()
+    {
+        while (Storage *s = retired) {
+            retired = s->retired;
+            delete s;
+        }
+    }
+
+    // Takes a reference for an unlocked emission. Fails while
+    // cleanConnectionLists() owns the vector; the caller must then retry
+    // with the object mutex locked.
+    bool tryRef()
+    {
+        if (inUse.fetchAndAddAcquire(1) >= 0)
+            return true;
+        inUse.deref();
+        return false;
+    }
+
+    // Returns true if the lists can be cleaned, in which case release() must
+    // be called afterwards. Must be called with the object mutex locked.
+    bool claim()
+    {
+        return inUse.testAndSetAcquire(0, Claimed);
+    }
+
+    void release()
+    {
+        inUse.fetchAndAddRelease(-Claimed);
     }
 };
 
@@ -298,15 +401,15 @@ bool QObjectPrivate::isSender(const QObject *receiver, const char *signal) const
     if (signal_index < 0)
         return false;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
+    if (QObjectConnectionListVector *connectionLists = this->connectionLists.load()) {
         if (signal_index < connectionLists->count()) {
             const QObjectPrivate::Connection *c =
-                connectionLists->at(signal_index).first;
+                connectionLists->at(signal_index).first.load();
 
             while (c) {
-                if (c->receiver == receiver)
+                if (c->receiver.load() == receiver)
                     return true;
-                c = c->nextConnectionList;
+                c = c->nextConnectionList.load();
             }
         }
     }
@@ -322,14 +425,14 @@ QObjectList QObjectPrivate::receiverList(const char *signal) const
     if (signal_index < 0)
         return returnValue;
     QMutexLocker locker(signalSlotLock(q));
-    if (connectionLists) {
+    if (QObjectConnectionListVector *connectionLists = this->connectionLists.load()) {
         if (signal_index < connectionLists->count()) {
-            const QObjectPrivate::Connection *c = connectionLists->at(signal_index).first;
+            const QObjectPrivate::Connection *c = connectionLists->at(signal_index).first.load();
 
             while (c) {
-                if (c->receiver)
-                    returnValue << c->receiver;
-                c = c->nextConnectionList;
+                if (QObject *receiver = c->receiver.load())
+                    returnValue << receiver;
+                c = c->nextConnectionList.load();
             }
         }
     }
@@ -359,22 +462,31 @@ QObjectList QObjectPrivate::senderList() const
 void QObjectPrivate::addConnection(int signal, Connection *c)
 {
     Q_ASSERT(c->sender == q_ptr);
-    if (!connectionLists)
+    QObjectConnectionListVector *connectionLists = this->connectionLists.load();
+    if (!connectionLists) {
         connectionLists = new QObjectConnectionListVector();
+        this->connectionLists.storeRelease(connectionLists);
+    }
     if (signal >= connectionLists->count())
         connectionLists->resize(signal + 1);
 
+    QThreadData *receiverThreadData = QObjectPrivate::get(c->receiver.load())->threadData;
+    receiverThreadData->ref();
+    c->receiverThreadData.store(receiverThreadData);
+
+    // the release stores publish the fully initialized connection to
+    // emissions walking the list without the lock
     ConnectionList &connectionList = (*connectionLists)[signal];
-    if (connectionList.last) {
-        connectionList.last->nextConnectionList = c;
+    if (Connection *last = connectionList.last.load()) {
+        last->nextConnectionList.storeRelease(c);
     } else {
-        connectionList.first = c;
+        connectionList.first.storeRelease(c);
     }
-    connectionList.last = c;
+    connectionList.last.storeRelease(c);
 
     cleanConnectionLists();
 
-    c->prev = &(QObjectPrivate::get(c->receiver)->senders);
+    c->prev = &(QObjectPrivate::get(c->receiver.load())->senders);
     c->next = *c->prev;
     *c->prev = c;
     if (c->next)
@@ -389,7 +501,15 @@ void QObjectPrivate::addConnection(int signal, Connection *c)
 
 void QObjectPrivate::cleanConnectionLists()
 {
-    if (connectionLists->dirty && !connectionLists->inUse) {
+    QObjectConnectionListVector *connectionLists = this->connectionLists.load();
+    if ((connectionLists->dirty || connectionLists->retired) && connectionLists->claim()) {
+        // no emission can see the lists anymore, release the old storage
+        connectionLists->releaseRetired();
+        if (!connectionLists->dirty) {
+            connectionLists->release();
+            return;
+        }
+
         // remove broken connections
         for (int signal = -1; signal < connectionLists->count(); ++signal) {
             QObjectPrivate::ConnectionList &connectionList =
@@ -400,16 +520,16 @@ void QObjectPrivate::cleanConnectionLists()
             // at the end of the cleanup.
             QObjectPrivate::Connection *last = 0;
 
-            QObjectPrivate::Connection **prev = &connectionList.first;
-            QObjectPrivate::Connection *c = *prev;
+            QAtomicPointer<QObjectPrivate::Connection> *prev = &connectionList.first;
+            QObjectPrivate::Connection *c = prev->load();
             while (c) {
-                if (c->receiver) {
+                if (c->receiver.load()) {
                     last = c;
                     prev = &c->nextConnectionList;
-                    c = *prev;
+                    c = prev->load();
                 } else {
-                    QObjectPrivate::Connection *next = c->nextConnectionList;
-                    *prev = next;
+                    QObjectPrivate::Connection *next = c->nextConnectionList.load();
+                    prev->store(next);
                     c->deref();
                     c = next;
                 }
@@ -417,9 +537,10 @@ void QObjectPrivate::cleanConnectionLists()
 
             // Correct the connection list's last pointer.
             // As conectionList.last could equal last, this could be a noop
-            connectionList.last = last;
+            connectionList.last.store(last);
         }
         connectionLists->dirty = false;
+        connectionLists->release();
     }
 }
 
@@ -785,47 +906,47 @@ QObject::~QObject()
         d->currentSender->ref = 0;
     d->currentSender = 0;
 
-    if (d->connectionLists || d->senders) {
+    if (d->connectionLists.load() || d->senders) {
         QMutex *signalSlotMutex = signalSlotLock(this);
         QMutexLocker locker(signalSlotMutex);
 
         // disconnect all receivers
-        if (d->connectionLists) {
-            ++d->connectionLists->inUse;
-            int connectionListsCount = d->connectionLists->count();
+        if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+            connectionLists->inUse.ref();
+            int connectionListsCount = connectionLists->count();
             for (int signal = -1; signal < connectionListsCount; ++signal) {
                 QObjectPrivate::ConnectionList &connectionList =
-                    (*d->connectionLists)[signal];
+                    (*connectionLists)[signal];
 
-                while (QObjectPrivate::Connection *c = connectionList.first) {
-                    if (!c->receiver) {
-                        connectionList.first = c->nextConnectionList;
+                while (QObjectPrivate::Connection *c = connectionList.first.load()) {
+                    if (!c->receiver.load()) {
+                        connectionList.first.store(c->nextConnectionList.load());
                         c->deref();
                         continue;
                     }
 
-                    QMutex *m = signalSlotLock(c->receiver);
+                    QMutex *m = signalSlotLock(c->receiver.load());
                     bool needToUnlock = QOrderedMutexLocker::relock(signalSlotMutex, m);
 
-                    if (c->receiver) {
+                    if (c->receiver.load()) {
                         *c->prev = c->next;
                         if (c->next) c->next->prev = c->prev;
                     }
-                    c->receiver = 0;
+                    c->receiver.store(0);
                     if (needToUnlock)
                         m->unlock();
 
-                    connectionList.first = c->nextConnectionList;
+                    connectionList.first.store(c->nextConnectionList.load());
                     c->deref();
                 }
             }
 
-            if (!--d->connectionLists->inUse) {
-                delete d->connectionLists;
-            } else {
-                d->connectionLists->orphaned = true;
-            }
-            d->connectionLists = 0;
+            // set before dropping our reference, so that whoever drops the
+            // last one deletes the vector
+            connectionLists->orphaned = true;
+            if (!connectionLists->inUse.deref())
+                delete connectionLists;
+            d->connectionLists.store(0);
         }
 
         // disconnect all senders
@@ -840,8 +961,8 @@ QObject::~QObject()
                 m->unlock();
                 continue;
             }
-            node->receiver = 0;
-            QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists;
+            node->receiver.store(0);
+            QObjectConnectionListVector *senderLists = sender->d_func()->connectionLists.load();
             if (senderLists)
                 senderLists->dirty = true;
 
@@ -871,6 +992,8 @@ QObjectPrivate::Connection::~Connection()
     }
     if (isSlotObject)
         slotObj->destroyIfLastRef();
+    if (QThreadData *threadData = receiverThreadData.load())
+        threadData->deref();
 }
 
 
@@ -1237,6 +1360,14 @@ QThread *QObject::thread() const
     return d_func()->threadData->thread;
 }
 
+static void collectSignalSlotLocks(const QObject *object, QVarLengthArray<QMutex *, 16> *locks)
+{
+    locks->append(signalSlotLock(object));
+    const QObjectList &children = object->children();
+    for (int i = 0; i < children.size(); ++i)
+        collectSignalSlotLocks(children.at(i), locks);
+}
+
 /*!
     Changes the thread affinity for this object and its children. The
     object cannot be moved if it has a parent. Event processing will
@@ -1311,6 +1442,16 @@ void QObject::moveToThread(QThread *targetThread)
     // prepare to move
     d->moveToThread_helper();
 
+    // setThreadData_helper() updates the connections to the moved objects;
+    // lock them before the event lists, in the order emissions do
+    QVarLengthArray<QMutex *, 16> connectionLocks;
+    collectSignalSlotLocks(this, &connectionLocks);
+    qSort(connectionLocks.begin(), connectionLocks.end());
+    for (int i = 0; i < connectionLocks.size(); ++i) {
+        if (i == 0 || connectionLocks.at(i) != connectionLocks.at(i - 1))
+            connectionLocks.at(i)->lock();
+    }
+
     QOrderedMutexLocker locker(&currentData->postEventList.mutex,
                                &targetData->postEventList.mutex);
 
@@ -1318,9 +1459,27 @@ void QObject::moveToThread(QThread *targetThread)
     currentData->ref();
 
     // move the object
+    currentData->postEventList.takeQueuedEvents();
     d_func()->setThreadData_helper(currentData, targetData);
 
+#ifndef QT_NO_THREAD
+    // postEvent() may still be queueing events for the objects we moved
+    // into currentData's list, make sure they end up in targetData's
+    while (currentData->postEventList.queueingThreads.fetchAndAddOrdered(0))
+        QThread::yieldCurrentThread();
+    if (currentData->postEventList.takeQueuedEvents(targetData) > 0
+        && targetData->eventDispatcher) {
+        // like setThreadData_helper(), wake up the target for these events
+        targetData->canWait = false;
+        targetData->eventDispatcher->wakeUp();
+    }
+#endif
+
     locker.unlock();
+    for (int i = connectionLocks.size() - 1; i >= 0; --i) {
+        if (i == 0 || connectionLocks.at(i) != connectionLocks.at(i - 1))
+            connectionLocks.at(i)->unlock();
+    }
 
     // now currentData can commit suicide if it wants to
     currentData->deref();
@@ -1369,6 +1528,14 @@ void QObjectPrivate::setThreadData_helper(QThreadData *currentData, QThreadData
     threadData->deref();
     threadData = targetData;
 
+    // emissions pick the delivery type from the connections; the caller
+    // holds our signalSlotLock()
+    for (Connection *c = senders; c; c = c->next) {
+        targetData->ref();
+        if (QThreadData *previous = c->receiverThreadData.fetchAndStoreOrdered(targetData))
+            previous->deref();
+    }
+
     for (int i = 0; i < children.size(); ++i) {
         QObject *child = children.at(i);
         child->d_func()->setThreadData_helper(currentData, targetData);
@@ -2217,13 +2384,13 @@ int QObject::receivers(const char *signal) const
         }
 
         QMutexLocker locker(signalSlotLock(this));
-        if (d->connectionLists) {
-            if (signal_index < d->connectionLists->count()) {
+        if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+            if (signal_index < connectionLists->count()) {
                 const QObjectPrivate::Connection *c =
-                    d->connectionLists->at(signal_index).first;
+                    connectionLists->at(signal_index).first.load();
                 while (c) {
-                    receivers += c->receiver ? 1 : 0;
-                    c = c->nextConnectionList;
+                    receivers += c->receiver.load() ? 1 : 0;
+                    c = c->nextConnectionList.load();
                 }
             }
         }
@@ -2268,14 +2435,14 @@ bool QObject::isSignalConnected(const QMetaMethod &signal) const
         return d->isSignalConnected(signalIndex);
 
     QMutexLocker locker(signalSlotLock(this));
-    if (d->connectionLists) {
-        if (signalIndex < uint(d->connectionLists->count())) {
+    if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        if (signalIndex < uint(connectionLists->count())) {
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signalIndex).first;
+                connectionLists->at(signalIndex).first.load();
             while (c) {
-                if (c->receiver)
+                if (c->receiver.load())
                     return true;
-                c = c->nextConnectionList;
+                c = c->nextConnectionList.load();
             }
         }
     }
@@ -3032,17 +3199,17 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
                                signalSlotLock(receiver));
 
     if (type & Qt::UniqueConnection) {
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
         if (connectionLists && connectionLists->count() > signal_index) {
             const QObjectPrivate::Connection *c2 =
-                (*connectionLists)[signal_index].first;
+                (*connectionLists)[signal_index].first.load();
 
             int method_index_absolute = method_index + method_offset;
 
             while (c2) {
-                if (c2->receiver == receiver && c2->method() == method_index_absolute)
+                if (c2->receiver.load() == receiver && c2->method() == method_index_absolute)
                     return 0;
-                c2 = c2->nextConnectionList;
+                c2 = c2->nextConnectionList.load();
             }
         }
         type &= Qt::UniqueConnection - 1;
@@ -3051,13 +3218,13 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     QScopedPointer<QObjectPrivate::Connection> c(new QObjectPrivate::Connection);
     c->sender = s;
     c->signal_index = signal_index;
-    c->receiver = r;
+    c->receiver.store(r);
     c->method_relative = method_index;
     c->method_offset = method_offset;
     c->connectionType = type;
     c->isSlotObject = false;
     c->argumentTypes.store(types);
-    c->nextConnectionList = 0;
+    c->nextConnectionList.store(0);
     c->callFunction = callFunction;
 
     QObjectPrivate::get(s)->addConnection(signal_index, c.data());
@@ -3109,18 +3276,18 @@ bool QMetaObjectPrivate::disconnectHelper(QObjectPrivate::Connection *c,
 {
     bool success = false;
     while (c) {
-        if (c->receiver
-            && (receiver == 0 || (c->receiver == receiver
+        if (c->receiver.load()
+            && (receiver == 0 || (c->receiver.load() == receiver
                            && (method_index < 0 || c->method() == method_index)
                            && (slot == 0 || (c->isSlotObject && c->slotObj->compare(slot)))))) {
             bool needToUnlock = false;
             QMutex *receiverMutex = 0;
             if (!receiver) {
-                receiverMutex = signalSlotLock(c->receiver);
+                receiverMutex = signalSlotLock(c->receiver.load());
                 // need to relock this receiver and sender in the correct order
                 needToUnlock = QOrderedMutexLocker::relock(senderMutex, receiverMutex);
             }
-            if (c->receiver) {
+            if (c->receiver.load()) {
                 *c->prev = c->next;
                 if (c->next)
                     c->next->prev = c->prev;
@@ -3129,14 +3296,14 @@ bool QMetaObjectPrivate::disconnectHelper(QObjectPrivate::Connection *c,
             if (needToUnlock)
                 receiverMutex->unlock();
 
-            c->receiver = 0;
+            c->receiver.store(0);
 
             success = true;
 
             if (disconnectType == DisconnectOne)
                 return success;
         }
-        c = c->nextConnectionList;
+        c = c->nextConnectionList.load();
     }
     return success;
 }
@@ -3159,19 +3326,19 @@ bool QMetaObjectPrivate::disconnect(const QObject *sender,
     QMutex *receiverMutex = receiver ? signalSlotLock(receiver) : 0;
     QOrderedMutexLocker locker(senderMutex, receiverMutex);
 
-    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
     if (!connectionLists)
         return false;
 
     // prevent incoming connections changing the connectionLists while unlocked
-    ++connectionLists->inUse;
+    connectionLists->inUse.ref();
 
     bool success = false;
     if (signal_index < 0) {
         // remove from all connection lists
         for (int sig_index = -1; sig_index < connectionLists->count(); ++sig_index) {
             QObjectPrivate::Connection *c =
-                (*connectionLists)[sig_index].first;
+                (*connectionLists)[sig_index].first.load();
             if (disconnectHelper(c, receiver, method_index, slot, senderMutex, disconnectType)) {
                 success = true;
                 connectionLists->dirty = true;
@@ -3179,16 +3346,14 @@ bool QMetaObjectPrivate::disconnect(const QObject *sender,
         }
     } else if (signal_index < connectionLists->count()) {
         QObjectPrivate::Connection *c =
-            (*connectionLists)[signal_index].first;
+            (*connectionLists)[signal_index].first.load();
         if (disconnectHelper(c, receiver, method_index, slot, senderMutex, disconnectType)) {
             success = true;
             connectionLists->dirty = true;
         }
     }
 
-    --connectionLists->inUse;
-    Q_ASSERT(connectionLists->inUse >= 0);
-    if (connectionLists->orphaned && !connectionLists->inUse)
+    if (!connectionLists->inUse.deref() && connectionLists->orphaned)
         delete connectionLists;
 
     locker.unlock();
@@ -3304,7 +3469,7 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     QMetaCallEvent *ev = c->isSlotObject ?
         new QMetaCallEvent(c->slotObj, sender, signal, nargs, types, args) :
         new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal, nargs, types, args);
-    QCoreApplication::postEvent(c->receiver, ev);
+    QCoreApplication::postEvent(c->receiver.load(), ev);
 }
 
 /*!
@@ -3339,69 +3504,78 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
                                                          argv ? argv : empty_argv);
     }
 
-    Qt::HANDLE currentThreadId = QThread::currentThreadId();
-
     {
-    QMutexLocker locker(signalSlotLock(sender));
+    // The connection lists are walked without holding the sender's mutex:
+    // the reference on inUse keeps every connection and list storage seen
+    // from here alive until the emission is done (see QObjectConnectionListVector).
     struct ConnectionListsRef {
         QObjectConnectionListVector *connectionLists;
-        ConnectionListsRef(QObjectConnectionListVector *connectionLists) : connectionLists(connectionLists)
+        ConnectionListsRef(QObject *sender) : connectionLists(0)
         {
+            QObjectPrivate *d = QObjectPrivate::get(sender);
+            connectionLists = d->connectionLists.loadAcquire();
+            if (!connectionLists || connectionLists->tryRef())
+                return;
+            // the lists are being cleaned, wait for it to finish
+            QMutexLocker locker(signalSlotLock(sender));
+            connectionLists = d->connectionLists.load();
             if (connectionLists)
-                ++connectionLists->inUse;
+                connectionLists->inUse.ref();
         }
         ~ConnectionListsRef()
         {
             if (!connectionLists)
                 return;
 
-            --connectionLists->inUse;
-            Q_ASSERT(connectionLists->inUse >= 0);
-            if (connectionLists->orphaned) {
-                if (!connectionLists->inUse)
-                    delete connectionLists;
-            }
+            if (!connectionLists->inUse.deref() && connectionLists->orphaned)
+                delete connectionLists;
         }
 
         QObjectConnectionListVector *operator->() const { return connectionLists; }
     };
-    ConnectionListsRef connectionLists = sender->d_func()->connectionLists;
+    ConnectionListsRef connectionLists(sender);
     if (!connectionLists.connectionLists) {
-        locker.unlock();
         if (qt_signal_spy_callback_set.signal_end_callback != 0)
             qt_signal_spy_callback_set.signal_end_callback(sender, signal_index);
         return;
     }
 
+    Qt::HANDLE currentThreadId = QThread::currentThreadId();
+
+    const QObjectConnectionListVector::Storage *storage = connectionLists->storage.loadAcquire();
     const QObjectPrivate::ConnectionList *list;
-    if (signal_index < connectionLists->count())
-        list = &connectionLists->at(signal_index);
+    if (storage && signal_index < storage->count)
+        list = &storage->lists[signal_index];
     else
         list = &connectionLists->allsignals;
 
     do {
-        QObjectPrivate::Connection *c = list->first;
+        QObjectPrivate::Connection *c = list->first.loadAcquire();
         if (!c) continue;
         // We need to check against last here to ensure that signals added
         // during the signal emission are not emitted in this emission.
-        QObjectPrivate::Connection *last = list->last;
+        QObjectPrivate::Connection *last = list->last.loadAcquire();
 
         do {
-            if (!c->receiver)
+            QObject * const receiver = c->receiver.load();
+            if (!receiver)
                 continue;
 
-            QObject * const receiver = c->receiver;
-            const bool receiverInSameThread = currentThreadId == receiver->d_func()->threadData->threadId;
+            // the connection keeps the receiver's thread data alive
+            const bool receiverInSameThread = currentThreadId == c->receiverThreadData.load()->threadId;
 
             // determine if this connection should be sent immediately or
             // put into the event queue
             if ((c->connectionType == Qt::AutoConnection && !receiverInSameThread)
                 || (c->connectionType == Qt::QueuedConnection)) {
-                queued_activate(sender, signal_index, c, argv ? argv : empty_argv);
+                // the receiver may be destroyed by its own thread at any
+                // time, only the sender's mutex keeps it alive while posting
+                QMutexLocker locker(signalSlotLock(sender));
+                if (c->receiver.load())
+                    queued_activate(sender, signal_index, c, argv ? argv : empty_argv);
                 continue;
 #ifndef QT_NO_THREAD
             } else if (c->connectionType == Qt::BlockingQueuedConnection) {
-                locker.unlock();
                 if (receiverInSameThread) {
                     qWarning("Qt: Dead lock detected while activating a BlockingQueuedConnection: "
                     "Sender is %s(%p), receiver is %s(%p)",
@@ -3409,12 +3583,16 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
                     receiver->metaObject()->className(), receiver);
                 }
                 QSemaphore semaphore;
-                QMetaCallEvent *ev = c->isSlotObject ?
-                    new QMetaCallEvent(c->slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
-                    new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore);
-                QCoreApplication::postEvent(receiver, ev);
+                {
+                    QMutexLocker locker(signalSlotLock(sender));
+                    if (!c->receiver.load())
+                        continue;
+                    QMetaCallEvent *ev = c->isSlotObject ?
+                        new QMetaCallEvent(c->slotObj, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore) :
+                        new QMetaCallEvent(c->method_offset, c->method_relative, c->callFunction, sender, signal_index, 0, 0, argv ? argv : empty_argv, &semaphore);
+                    QCoreApplication::postEvent(receiver, ev);
+                }
                 semaphore.acquire();
-                locker.relock();
                 continue;
 #endif
             }
@@ -3429,12 +3607,9 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
             if (c->isSlotObject) {
                 c->slotObj->ref();
                 const QScopedPointer<QtPrivate::QSlotObjectBase, QSlotObjectBaseDeleter> obj(c->slotObj);
-                locker.unlock();
                 obj->call(receiver, argv ? argv : empty_argv);
-                locker.relock();
             } else if (callFunction && c->method_offset <= receiver->metaObject()->methodOffset()) {
                 //we compare the vtable to make sure we are not in the destructor of the object.
-                locker.unlock();
                 if (qt_signal_spy_callback_set.slot_begin_callback != 0)
                     qt_signal_spy_callback_set.slot_begin_callback(receiver, c->method(), argv ? argv : empty_argv);
 
@@ -3442,10 +3617,8 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
 
                 if (qt_signal_spy_callback_set.slot_end_callback != 0)
                     qt_signal_spy_callback_set.slot_end_callback(receiver, c->method());
-                locker.relock();
             } else {
                 const int method = method_relative + c->method_offset;
-                locker.unlock();
 
                 if (qt_signal_spy_callback_set.slot_begin_callback != 0) {
                     qt_signal_spy_callback_set.slot_begin_callback(receiver,
@@ -3457,13 +3630,11 @@ void QMetaObject::activate(QObject *sender, int signalOffset, int local_signal_i
 
                 if (qt_signal_spy_callback_set.slot_end_callback != 0)
                     qt_signal_spy_callback_set.slot_end_callback(receiver, method);
-
-                locker.relock();
             }
 
             if (connectionLists->orphaned)
                 break;
-        } while (c != last && (c = c->nextConnectionList) != 0);
+        } while (c != last && (c = c->nextConnectionList.loadAcquire()) != 0);
 
         if (connectionLists->orphaned)
             break;
@@ -3734,27 +3905,28 @@ void QObject::dumpObjectInfo()
     // first, look for connections where this object is the sender
     qDebug("  SIGNALS OUT");
 
-    if (d->connectionLists) {
-        for (int signal_index = 0; signal_index < d->connectionLists->count(); ++signal_index) {
+    if (QObjectConnectionListVector *connectionLists = d->connectionLists.load()) {
+        for (int signal_index = 0; signal_index < connectionLists->count(); ++signal_index) {
             const QMetaMethod signal = QMetaObjectPrivate::signal(metaObject(), signal_index);
             qDebug("        signal: %s", signal.methodSignature().constData());
 
             // receivers
             const QObjectPrivate::Connection *c =
-                d->connectionLists->at(signal_index).first;
+                connectionLists->at(signal_index).first.load();
             while (c) {
-                if (!c->receiver) {
+                const QObject *receiver = c->receiver.load();
+                if (!receiver) {
                     qDebug("          <Disconnected receiver>");
-                    c = c->nextConnectionList;
+                    c = c->nextConnectionList.load();
                     continue;
                 }
-                const QMetaObject *receiverMetaObject = c->receiver->metaObject();
+                const QMetaObject *receiverMetaObject = receiver->metaObject();
                 const QMetaMethod method = receiverMetaObject->method(c->method());
                 qDebug("          --> %s::%s %s",
                        receiverMetaObject->className(),
-                       c->receiver->objectName().isEmpty() ? "unnamed" : qPrintable(c->receiver->objectName()),
+                       receiver->objectName().isEmpty() ? "unnamed" : qPrintable(receiver->objectName()),
                        method.methodSignature().constData());
-                c = c->nextConnectionList;
+                c = c->nextConnectionList.load();
             }
         }
     } else {
@@ -4227,17 +4399,17 @@ QMetaObject::Connection QObject::connectImpl(const QObject *sender, void **signa
                                signalSlotLock(receiver));
 
     if (type & Qt::UniqueConnection) {
-        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists;
+        QObjectConnectionListVector *connectionLists = QObjectPrivate::get(s)->connectionLists.load();
         if (connectionLists && connectionLists->count() > signal_index) {
             const QObjectPrivate::Connection *c2 =
-                (*connectionLists)[signal_index].first;
+                (*connectionLists)[signal_index].first.load();
 
             while (c2) {
-                if (c2->receiver == receiver && c2->isSlotObject && c2->slotObj->compare(slot)) {
+                if (c2->receiver.load() == receiver && c2->isSlotObject && c2->slotObj->compare(slot)) {
                     slotObj->destroyIfLastRef();
                     return QMetaObject::Connection();
                 }
-                c2 = c2->nextConnectionList;
+                c2 = c2->nextConnectionList.load();
             }
         }
         type = static_cast<Qt::ConnectionType>(type ^ Qt::UniqueConnection);
@@ -4246,7 +4418,7 @@ QMetaObject::Connection QObject::connectImpl(const QObject *sender, void **signa
     QScopedPointer<QObjectPrivate::Connection> c(new QObjectPrivate::Connection);
     c->sender = s;
     c->signal_index = signal_index;
-    c->receiver = r;
+    c->receiver.store(r);
     c->slotObj = slotObj;
     c->connectionType = type;
     c->isSlotObject = true;
@@ -4278,21 +4450,21 @@ bool QObject::disconnect(const QMetaObject::Connection &connection)
 {
     QObjectPrivate::Connection *c = static_cast<QObjectPrivate::Connection *>(connection.d_ptr);
 
-    if (!c || !c->receiver)
+    if (!c || !c->receiver.load())
         return false;
 
     QMutex *senderMutex = signalSlotLock(c->sender);
-    QMutex *receiverMutex = signalSlotLock(c->receiver);
+    QMutex *receiverMutex = signalSlotLock(c->receiver.load());
     QOrderedMutexLocker locker(senderMutex, receiverMutex);
 
-    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(c->sender)->connectionLists;
+    QObjectConnectionListVector *connectionLists = QObjectPrivate::get(c->sender)->connectionLists.load();
     Q_ASSERT(connectionLists);
     connectionLists->dirty = true;
 
     *c->prev = c->next;
     if (c->next)
         c->next->prev = c->prev;
-    c->receiver = 0;
+    c->receiver.store(0);
     // disconnectNotify() not called (the signal index is unknown).
 
     return true;
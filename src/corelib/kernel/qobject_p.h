@@ -117,17 +117,21 @@ public:
     struct Connection
     {
         QObject *sender;
-        QObject *receiver;
+        // cleared on disconnect; read by emissions that do not hold the sender's lock
+        QAtomicPointer<QObject> receiver;
         union {
             StaticMetaCallFunction callFunction;
             QtPrivate::QSlotObjectBase *slotObj;
         };
         // The next pointer for the singly-linked ConnectionList
-        Connection *nextConnectionList;
+        QAtomicPointer<Connection> nextConnectionList;
         //senders linked list
         Connection *next;
         Connection **prev;
         QAtomicPointer<const int> argumentTypes;
+        // thread data of the receiver, so that emission does not need to touch the
+        // receiver; the connection holds a reference on it
+        QAtomicPointer<QThreadData> receiverThreadData;
         QAtomicInt ref_;
         ushort method_offset;
         ushort method_relative;
@@ -143,7 +147,7 @@ public:
         void ref() { ref_.ref(); }
         void deref() {
             if (!ref_.deref()) {
-                Q_ASSERT(!receiver);
+                Q_ASSERT(!receiver.load());
                 delete this;
             }
         }
@@ -151,8 +155,8 @@ public:
     // ConnectionList is a singly-linked list
     struct ConnectionList {
         ConnectionList() : first(0), last(0) {}
-        Connection *first;
-        Connection *last;
+        QAtomicPointer<Connection> first;
+        QAtomicPointer<Connection> last;
     };
 
     struct Sender
@@ -202,7 +206,7 @@ public:
     ExtraData *extraData;    // extra data set by the user
     QThreadData *threadData; // id of the thread that owns the object
 
-    QObjectConnectionListVector *connectionLists;
+    QAtomicPointer<QObjectConnectionListVector> connectionLists;
 
     Connection *senders;     // linked list of connections connected to this object
     Sender *currentSender;   // object currently activating the object
@@ -46,6 +46,7 @@
 #include "private/qtimerinfo_unix_p.h"
 #include "private/qobject_p.h"
 #include "private/qabstracteventdispatcher_p.h"
+#include "private/qsimd_p.h"
 
 #ifdef QTIMERINFO_DEBUG
 #  include <QDebug>
@@ -53,16 +54,293 @@
 #endif
 
 #include <sys/times.h>
+#include <string.h>
 
 QT_BEGIN_NAMESPACE
 
 Q_CORE_EXPORT bool qt_disable_lowpriority_timers=false;
 
 /*
- * Internal functions for manipulating timer data structures.  The
- * timerBitVec array is used for keeping track of timer identifiers.
+ * Internal functions for manipulating timer data structures.
+ *
+ * Pending timers are kept in a hierarchical timing wheel with a
+ * resolution of one millisecond, so that registering, unregistering and
+ * expiring a timer costs O(1) regardless of how many timers a thread
+ * has.  The root level has one slot per millisecond for the next 256 ms
+ * and each slot is kept sorted by the exact timeout.  Each of the upper
+ * levels covers 64 times the range of the level below it; their slots
+ * are unsorted and get redistributed ("cascaded") into the lower levels
+ * when the wheel reaches them.  The upper levels together span 2^32 ms.
  */
 
+enum {
+    WheelRootBits = 8,
+    WheelLevelBits = 6,
+    WheelLevels = 5,
+    WheelRootSize = 1 << WheelRootBits,
+    WheelRootMask = WheelRootSize - 1,
+    WheelLevelSize = 1 << WheelLevelBits,
+    WheelLevelMask = WheelLevelSize - 1,
+    WheelSlots = WheelRootSize + (WheelLevels - 1) * WheelLevelSize
+};
+
+static inline qint64 toTick(const timeval &tv)
+{
+    return qint64(tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+static inline void linkInit(QTimerInfoLink *head)
+{
+    head->prev = head->next = head;
+}
+
+static inline bool linkIsEmpty(const QTimerInfoLink *head)
+{
+    return head->next == head;
+}
+
+static inline void linkInsertBefore(QTimerInfoLink *pos, QTimerInfoLink *l)
+{
+    l->next = pos;
+    l->prev = pos->prev;
+    pos->prev->next = l;
+    pos->prev = l;
+}
+
+static inline void linkRemove(QTimerInfoLink *l)
+{
+    l->prev->next = l->next;
+    l->next->prev = l->prev;
+}
+
+// returns the first bit set in [from, to), or -1 if there is none
+static int nextOccupied(const quint32 *bits, int from, int to)
+{
+    while (from < to) {
+        quint32 word = bits[from >> 5] >> (from & 31);
+        if (word) {
+            from += qCountTrailingZeroBits(word);
+            return from < to ? from : -1;
+        }
+        from = (from | 31) + 1;
+    }
+    return -1;
+}
+
+struct QTimerWheel
+{
+    qint64 tick;     // no timer in the wheel expires before this millisecond
+    int count;       // number of timers in the wheel
+    quint32 occupied[WheelSlots / 32];
+    QTimerInfoLink slotHeads[WheelSlots];
+
+    QTimerWheel(qint64 currentTick);
+
+    void insert(QTimerInfo *t);
+    void remove(QTimerInfo *t);
+    void cascade();
+    void advance(const timeval &currentTime, QTimerInfoLink *expired);
+    bool nextTimeout(timeval *tv) const;
+
+    static inline int levelShift(int level)
+    { return WheelRootBits + (level - 1) * WheelLevelBits; }
+    static inline int levelOffset(int level)
+    { return WheelRootSize + (level - 1) * WheelLevelSize; }
+
+    inline void setOccupied(int slot)
+    { occupied[slot >> 5] |= 1u << (slot & 31); }
+    inline void clearOccupied(int slot)
+    { occupied[slot >> 5] &= ~(1u << (slot & 31)); }
+};
+
+QTimerWheel::QTimerWheel(qint64 currentTick)
+    : tick(currentTick), count(0)
+{
+    memset(occupied, 0, sizeof(occupied));
+    for (int i = 0; i < WheelSlots; ++i)
+        linkInit(&slotHeads[i]);
+}
+
+void QTimerWheel::insert(QTimerInfo *t)
+{
+    qint64 expires = qMax(toTick(t->timeout), tick);
+    quint64 delta = quint64(expires - tick);
+    int slot;
+
+    if (delta < WheelRootSize) {
+        slot = int(expires & WheelRootMask);
+
+        // keep the root slots sorted, equal timeouts fire in insertion order
+        QTimerInfoLink *pos = &slotHeads[slot];
+        while (pos->prev != &slotHeads[slot]
+               && t->timeout < static_cast<QTimerInfo *>(pos->prev)->timeout)
+            pos = pos->prev;
+        linkInsertBefore(pos, t);
+    } else {
+        if (delta > Q_UINT64_C(0xffffffff)) {
+            // out of range: park it at the far end, it is reinserted when cascaded
+            expires = tick + Q_INT64_C(0xffffffff);
+            delta = Q_UINT64_C(0xffffffff);
+        }
+        int level = 1;
+        while (delta >> (levelShift(level) + WheelLevelBits))
+            ++level;
+        slot = levelOffset(level) + int((expires >> levelShift(level)) & WheelLevelMask);
+        linkInsertBefore(&slotHeads[slot], t);
+    }
+
+    t->wheelSlot = slot;
+    setOccupied(slot);
+    ++count;
+}
+
+void QTimerWheel::remove(QTimerInfo *t)
+{
+    Q_ASSERT(t->wheelSlot >= 0);
+    linkRemove(t);
+    if (linkIsEmpty(&slotHeads[t->wheelSlot]))
+        clearOccupied(t->wheelSlot);
+    t->wheelSlot = -1;
+    --count;
+}
+
+/*
+  Called whenever tick enters a new turn of the root level: moves the
+  timers of the upper level slots that the wheel has reached down.
+*/
+void QTimerWheel::cascade()
+{
+    for (int level = 1; level < WheelLevels; ++level) {
+        const int index = int((tick >> levelShift(level)) & WheelLevelMask);
+        const int slot = levelOffset(level) + index;
+        QTimerInfoLink *head = &slotHeads[slot];
+        if (!linkIsEmpty(head)) {
+            QTimerInfoLink pending;
+            linkInit(&pending);
+            pending.next = head->next;
+            pending.prev = head->prev;
+            pending.next->prev = &pending;
+            pending.prev->next = &pending;
+            linkInit(head);
+            clearOccupied(slot);
+
+            while (!linkIsEmpty(&pending)) {
+                QTimerInfo *t = static_cast<QTimerInfo *>(pending.next);
+                linkRemove(t);
+                --count;
+                insert(t);
+            }
+        }
+        if (index)
+            break;
+    }
+}
+
+/*
+  Moves all timers that expired at or before currentTime to the end of
+  the expired list, in the order of their timeouts.
+*/
+void QTimerWheel::advance(const timeval &currentTime, QTimerInfoLink *expired)
+{
+    const qint64 currentTick = toTick(currentTime);
+
+    while (tick <= currentTick) {
+        if (!count) {
+            tick = currentTick;
+            return;
+        }
+
+        const int from = int(tick & WheelRootMask);
+        const int slot = nextOccupied(occupied, from, WheelRootSize);
+        if (slot < 0) {
+            // nothing left in this turn of the root level
+            const qint64 next = (tick | WheelRootMask) + 1;
+            if (next > currentTick) {
+                tick = currentTick;
+                return;
+            }
+            tick = next;
+            cascade();
+            continue;
+        }
+
+        const qint64 slotTick = tick + (slot - from);
+        if (slotTick > currentTick) {
+            tick = currentTick;
+            return;
+        }
+        tick = slotTick;
+
+        QTimerInfoLink *head = &slotHeads[slot];
+        while (!linkIsEmpty(head)) {
+            QTimerInfo *t = static_cast<QTimerInfo *>(head->next);
+            if (slotTick == currentTick && currentTime < t->timeout)
+                return; // the rest of this millisecond is still ahead of us
+            linkRemove(t);
+            linkInsertBefore(expired, t);
+            t->wheelSlot = -1;
+            --count;
+        }
+        clearOccupied(slot);
+        if (slotTick == currentTick)
+            return;
+
+        if (!(++tick & WheelRootMask))
+            cascade();
+    }
+}
+
+/*
+  Finds the timeout of the first timer that is not being activated.  If
+  that timer may still sit in one of the upper levels, returns the time
+  at which the wheel cascades it instead, which is never later.
+*/
+bool QTimerWheel::nextTimeout(timeval *tv) const
+{
+    qint64 bound = Q_INT64_C(0x7fffffffffffffff);
+    for (int level = 1; level < WheelLevels; ++level) {
+        const int shift = levelShift(level);
+        const int offset = levelOffset(level);
+        const int index = int((tick >> shift) & WheelLevelMask);
+        int slot = nextOccupied(occupied, offset + index + 1, offset + WheelLevelSize);
+        if (slot < 0)
+            slot = nextOccupied(occupied, offset, offset + index + 1);
+        if (slot < 0)
+            continue;
+        int distance = (slot - offset - index) & WheelLevelMask;
+        if (!distance)
+            distance = WheelLevelSize;
+        bound = qMin(bound, ((tick >> shift) + distance) << shift);
+    }
+
+    const int from = int(tick & WheelRootMask);
+    for (int pass = 0; pass < 2; ++pass) {
+        const int begin = pass ? 0 : from;
+        const int end = pass ? from : int(WheelRootSize);
+        const qint64 base = pass ? (tick | WheelRootMask) + 1 : tick & ~qint64(WheelRootMask);
+        for (int slot = nextOccupied(occupied, begin, end); slot >= 0;
+             slot = nextOccupied(occupied, slot + 1, end)) {
+            if (base + slot >= bound)
+                goto upperLevels;
+            const QTimerInfoLink *head = &slotHeads[slot];
+            for (const QTimerInfoLink *l = head->next; l != head; l = l->next) {
+                const QTimerInfo *t = static_cast<const QTimerInfo *>(l);
+                if (!t->activateRef) {
+                    *tv = t->timeout;
+                    return true;
+                }
+            }
+        }
+    }
+
+upperLevels:
+    if (bound == Q_INT64_C(0x7fffffffffffffff))
+        return false;
+    tv->tv_sec = bound / 1000;
+    tv->tv_usec = (bound % 1000) * 1000;
+    return true;
+}
+
 QTimerInfoList::QTimerInfoList()
 {
 #if (_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC) && !defined(Q_OS_NACL)
@@ -84,7 +362,14 @@ QTimerInfoList::QTimerInfoList()
     }
 #endif
 
-    firstTimerInfo = 0;
+    wheel = 0;
+    linkInit(&firingTimers);
+}
+
+QTimerInfoList::~QTimerInfoList()
+{
+    qDeleteAll(timersById);
+    delete wheel;
 }
 
 timeval QTimerInfoList::updateCurrentTime()
@@ -152,11 +437,21 @@ bool QTimerInfoList::timeChanged(timeval *delta)
 */
 void QTimerInfoList::timerRepair(const timeval &diff)
 {
-    // repair all timers
-    for (int i = 0; i < size(); ++i) {
-        register QTimerInfo *t = at(i);
+    // repair all timers, the wheel has to be rebuilt around the new time
+    QList<QTimerInfo *> pending;
+    QHash<int, QTimerInfo *>::const_iterator it = timersById.constBegin();
+    for ( ; it != timersById.constEnd(); ++it) {
+        QTimerInfo *t = it.value();
+        if (t->wheelSlot >= 0) {
+            wheel->remove(t);
+            pending.append(t);
+        }
         t->timeout = t->timeout + diff;
     }
+    if (wheel)
+        wheel->tick = toTick(currentTime);
+    for (int i = 0; i < pending.size(); ++i)
+        timerInsert(pending.at(i));
 }
 
 void QTimerInfoList::repairTimersIfNeeded()
@@ -181,13 +476,33 @@ void QTimerInfoList::repairTimersIfNeeded()
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        register const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
-            break;
-    }
-    insert(index+1, ti);
+    if (!wheel)
+        wheel = new QTimerWheel(toTick(currentTime));
+    wheel->insert(ti);
+}
+
+/*
+  remove timer info from whichever list it is in
+*/
+void QTimerInfoList::timerRemove(QTimerInfo *t)
+{
+    timersById.remove(t->id);
+    if (t->objectNext)
+        t->objectNext->objectPrev = t->objectPrev;
+    if (t->objectPrev)
+        t->objectPrev->objectNext = t->objectNext;
+    else if (t->objectNext)
+        timersByObject.insert(t->obj, t->objectNext);
+    else
+        timersByObject.remove(t->obj);
+
+    if (t->wheelSlot >= 0)
+        wheel->remove(t);
+    else
+        linkRemove(t);
+    if (t->activateRef)
+        *(t->activateRef) = 0;
+    delete t;
 }
 
 inline timeval &operator+=(timeval &t1, int ms)
@@ -389,20 +704,21 @@ bool QTimerInfoList::timerWait(timeval &tm)
     repairTimersIfNeeded();
 
     // Find first waiting timer not already active
-    QTimerInfo *t = 0;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
+    bool expired = false;
+    for (QTimerInfoLink *l = firingTimers.next; l != &firingTimers; l = l->next) {
+        if (!static_cast<QTimerInfo *>(l)->activateRef) {
+            expired = true;
             break;
         }
     }
 
-    if (!t)
+    timeval timeout;
+    if (!expired && (!wheel || !wheel->nextTimeout(&timeout)))
       return false;
 
-    if (currentTime < t->timeout) {
+    if (!expired && currentTime < timeout) {
         // time to wait
-        tm = roundToMillisecond(t->timeout - currentTime);
+        tm = roundToMillisecond(timeout - currentTime);
     } else {
         // no time to wait
         tm.tv_sec  = 0;
@@ -412,6 +728,15 @@ bool QTimerInfoList::timerWait(timeval &tm)
     return true;
 }
 
+/*
+  Returns true if a timer that is not already active has expired.
+*/
+bool QTimerInfoList::hasExpiredTimers()
+{
+    timeval tm;
+    return timerWait(tm) && tm.tv_sec == 0 && tm.tv_usec == 0;
+}
+
 /*
   Returns the timer's remaining time in milliseconds with the given timerId, or
   null if there is nothing left. If the timer id is not found in the list, the
@@ -423,16 +748,14 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timeval tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        register QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_usec/1000;
-            } else {
-                return 0;
-            }
+    register const QTimerInfo * const t = timersById.value(timerId);
+    if (t) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_usec/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -451,6 +774,11 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
     t->timerType = timerType;
     t->obj = object;
     t->activateRef = 0;
+    t->wheelSlot = -1;
+    t->objectPrev = 0;
+    t->objectNext = timersByObject.value(object);
+    if (t->objectNext)
+        t->objectNext->objectPrev = t;
 
     timeval expected = updateCurrentTime() + interval;
 
@@ -494,6 +822,8 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
             ++t->timeout.tv_sec;
     }
 
+    timersById.insert(timerId, t);
+    timersByObject.insert(object, t);
     timerInsert(t);
 
 #ifdef QTIMERINFO_DEBUG
@@ -508,57 +838,33 @@ void QTimerInfoList::registerTimer(int timerId, int interval, Qt::TimerType time
 
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
-    // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        register QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            return true;
-        }
+    register QTimerInfo *t = timersById.value(timerId);
+    if (!t) {
+        // id not found
+        return false;
     }
-    // id not found
-    return false;
+    timerRemove(t);
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        register QTimerInfo *t = at(i);
-        if (t->obj == object) {
-            // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = 0;
-            if (t->activateRef)
-                *(t->activateRef) = 0;
-            delete t;
-            // move back one so that we don't skip the new current item
-            --i;
-        }
-    }
+    while (QTimerInfo *t = timersByObject.value(object))
+        timerRemove(t);
     return true;
 }
 
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
     QList<QAbstractEventDispatcher::TimerInfo> list;
-    for (int i = 0; i < count(); ++i) {
-        register const QTimerInfo * const t = at(i);
-        if (t->obj == object) {
-            list << QAbstractEventDispatcher::TimerInfo(t->id,
-                                                        (t->timerType == Qt::VeryCoarseTimer
-                                                         ? t->interval * 1000
-                                                         : t->interval),
-                                                        t->timerType);
-        }
+    for (const QTimerInfo *t = timersByObject.value(object); t; t = t->objectNext) {
+        list << QAbstractEventDispatcher::TimerInfo(t->id,
+                                                    (t->timerType == Qt::VeryCoarseTimer
+                                                     ? t->interval * 1000
+                                                     : t->interval),
+                                                    t->timerType);
     }
     return list;
 }
@@ -571,42 +877,24 @@ int QTimerInfoList::activateTimers()
     if (qt_disable_lowpriority_timers || isEmpty())
         return 0; // nothing to do
 
-    int n_act = 0, maxCount = 0;
-    firstTimerInfo = 0;
+    int n_act = 0;
 
     timeval currentTime = updateCurrentTime();
     // qDebug() << "Thread" << QThread::currentThreadId() << "woken up at" << currentTime;
     repairTimersIfNeeded();
 
-
-    // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
-    }
+    // Collect the timers that have expired, in order of their timeouts.
+    // Timers that get rescheduled while firing go back into the wheel, so
+    // each of them is sent at most once per call.
+    if (wheel)
+        wheel->advance(currentTime, &firingTimers);
 
     //fire the timers.
-    while (maxCount--) {
-        if (isEmpty())
-            break;
-
-        QTimerInfo *currentTimerInfo = first();
-        if (currentTime < currentTimerInfo->timeout)
-            break; // no timer has expired
-
-        if (!firstTimerInfo) {
-            firstTimerInfo = currentTimerInfo;
-        } else if (firstTimerInfo == currentTimerInfo) {
-            // avoid sending the same timer multiple times
-            break;
-        } else if (currentTimerInfo->interval <  firstTimerInfo->interval
-                   || currentTimerInfo->interval == firstTimerInfo->interval) {
-            firstTimerInfo = currentTimerInfo;
-        }
+    while (!linkIsEmpty(&firingTimers)) {
+        QTimerInfo *currentTimerInfo = static_cast<QTimerInfo *>(firingTimers.next);
 
         // remove from list
-        removeFirst();
+        linkRemove(currentTimerInfo);
 
 #ifdef QTIMERINFO_DEBUG
         float diff;
@@ -648,7 +936,6 @@ int QTimerInfoList::activateTimers()
         }
     }
 
-    firstTimerInfo = 0;
     // qDebug() << "Thread" << QThread::currentThreadId() << "activated" << n_act << "timers";
     return n_act;
 }
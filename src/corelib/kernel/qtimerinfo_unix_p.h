@@ -56,19 +56,29 @@
 // #define QTIMERINFO_DEBUG
 
 #include "qabstracteventdispatcher.h"
+#include "qhash.h"
 
 #include <sys/time.h> // struct timeval
 
 QT_BEGIN_NAMESPACE
 
+// intrusive doubly-linked list node, used to chain timers in the timer wheel
+struct QTimerInfoLink {
+    QTimerInfoLink *prev;
+    QTimerInfoLink *next;
+};
+
 // internal timer info
-struct QTimerInfo {
+struct QTimerInfo : public QTimerInfoLink {
     int id;           // - timer identifier
     int interval;     // - timer interval in milliseconds
     Qt::TimerType timerType; // - timer type
     timeval timeout;  // - when to actually fire
     QObject *obj;     // - object to receive event
     QTimerInfo **activateRef; // - ref from activateTimers
+    int wheelSlot;    // - slot in the timer wheel, -1 if not in the wheel
+    QTimerInfo *objectPrev; // - other timers of the same object
+    QTimerInfo *objectNext;
 
 #ifdef QTIMERINFO_DEBUG
     timeval expected; // when timer is expected to fire
@@ -77,7 +87,9 @@ struct QTimerInfo {
 #endif
 };
 
-class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
+struct QTimerWheel;
+
+class Q_CORE_EXPORT QTimerInfoList
 {
 #if ((_POSIX_MONOTONIC_CLOCK-0 <= 0) && !defined(Q_OS_MAC)) || defined(QT_BOOTSTRAPPED)
     timeval previousTime;
@@ -89,11 +101,23 @@ class Q_CORE_EXPORT QTimerInfoList : public QList<QTimerInfo*>
     void timerRepair(const timeval &);
 #endif
 
-    // state variables used by activateTimers()
-    QTimerInfo *firstTimerInfo;
+    QHash<int, QTimerInfo *> timersById;
+    QHash<QObject *, QTimerInfo *> timersByObject; // - first timer of each object
+
+    // pending timers, ordered by their timeout (allocated on first use)
+    QTimerWheel *wheel;
+
+    // expired timers that activateTimers() has not delivered yet
+    QTimerInfoLink firingTimers;
+
+    void timerRemove(QTimerInfo *);
 
 public:
     QTimerInfoList();
+    ~QTimerInfoList();
+
+    inline bool isEmpty() const { return timersById.isEmpty(); }
+    inline int size() const { return timersById.size(); }
 
     timeval currentTime;
     timeval updateCurrentTime();
@@ -102,6 +126,7 @@ public:
     void repairTimersIfNeeded();
 
     bool timerWait(timeval &);
+    bool hasExpiredTimers();
     void timerInsert(QTimerInfo *);
 
     int timerRemainingTime(int timerId);
@@ -112,6 +137,9 @@ public:
     QList<QAbstractEventDispatcher::TimerInfo> registeredTimers(QObject *object) const;
 
     int activateTimers();
+
+private:
+    Q_DISABLE_COPY(QTimerInfoList)
 };
 
 QT_END_NAMESPACE
@@ -55,6 +55,18 @@
 #include "qjsonvalue.h"
 #include "qjsonobject.h"
 #include "qjsonarray.h"
+#include "qhash.h"
+#include "qfileinfo.h"
+#include "qdatetime.h"
+#include "qdatastream.h"
+#include "qstandardpaths.h"
+#include "qtemporaryfile.h"
+
+#if defined(Q_OS_WIN)
+#  include <qt_windows.h>
+#else
+#  include <stdio.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -62,6 +74,224 @@ Q_GLOBAL_STATIC(QList<QFactoryLoader *>, qt_factory_loaders)
 
 Q_GLOBAL_STATIC_WITH_ARGS(QMutex, qt_factoryloader_mutex, (QMutex::Recursive))
 
+#ifdef QT_SHARED
+/*
+    Caches the meta data of the files found in the plugin directories, so
+    that unchanged plugins do not need to be opened on every start up. An
+    entry is used as long as the size and the modification time of the file
+    match. Files that are not plugins are recorded with empty meta data.
+
+    The cache file lives in the generic cache location, unless the
+    QT_PLUGIN_CACHE environment variable gives another file name. It is read
+    again whenever it changed on disk, so several processes can share it.
+
+    Only used with qt_factoryloader_mutex() locked.
+*/
+class QPluginMetaDataCache
+{
+public:
+    QPluginMetaDataCache();
+
+    bool isEnabled() const { return !cacheFile.isEmpty(); }
+
+    void refresh();
+    bool find(const QString &fileName, const QFileInfo &info, QJsonObject *metaData) const;
+    void insert(const QString &fileName, const QFileInfo &info, const QJsonObject &metaData);
+    void save();
+
+private:
+    struct Entry
+    {
+        qint64 lastModified;
+        qint64 size;
+        QJsonObject metaData;
+    };
+
+    enum { Magic = 0x51504d43, Version = 1 };
+
+    bool read(QHash<QString, Entry> *result) const;
+    void updateCacheInfo();
+
+    QString cacheFile;
+    QHash<QString, Entry> entries;
+    qint64 cacheLastModified;
+    qint64 cacheSize;
+    bool dirty;
+};
+
+Q_GLOBAL_STATIC(QPluginMetaDataCache, qt_plugin_metadata_cache)
+
+QPluginMetaDataCache::QPluginMetaDataCache()
+    : cacheLastModified(-1), cacheSize(-1), dirty(false)
+{
+    cacheFile = QFile::decodeName(qgetenv("QT_PLUGIN_CACHE"));
+#ifndef QT_NO_STANDARDPATHS
+    if (cacheFile.isEmpty()) {
+        const QString location = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+        if (!location.isEmpty())
+            cacheFile = location + QLatin1String("/qt-plugin-cache-" QT_VERSION_STR);
+    }
+#endif
+}
+
+void QPluginMetaDataCache::refresh()
+{
+    QFileInfo info(cacheFile);
+    const qint64 lastModified = info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+    const qint64 size = info.exists() ? info.size() : -1;
+    if (lastModified == cacheLastModified && size == cacheSize)
+        return;
+
+    entries.clear();
+    dirty = false;
+    cacheLastModified = lastModified;
+    cacheSize = size;
+    if (size >= 0 && !read(&entries)) {
+        if (qt_debug_component())
+            qDebug() << "QFactoryLoader: ignoring invalid plugin cache" << cacheFile;
+        entries.clear();
+    }
+}
+
+bool QPluginMetaDataCache::read(QHash<QString, Entry> *result) const
+{
+    QFile file(cacheFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic, version, count;
+    stream >> magic >> version >> count;
+    if (magic != quint32(Magic) || version != quint32(Version))
+        return false;
+
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString fileName;
+        Entry entry;
+        QByteArray data;
+        stream >> fileName >> entry.lastModified >> entry.size >> data;
+        if (!data.isEmpty())
+            entry.metaData = QJsonDocument::fromBinaryData(data).object();
+        result->insert(fileName, entry);
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+void QPluginMetaDataCache::updateCacheInfo()
+{
+    QFileInfo info(cacheFile);
+    cacheLastModified = info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+    cacheSize = info.exists() ? info.size() : -1;
+}
+
+// replaces target with source in one step, so that readers always see
+// either the old or the new file
+static bool replaceFile(const QString &source, const QString &target)
+{
+#if defined(Q_OS_WINCE)
+    QFile::remove(target);
+    return QFile::rename(source, target);
+#elif defined(Q_OS_WIN)
+    return ::MoveFileEx((wchar_t*)QDir::toNativeSeparators(source).utf16(),
+                        (wchar_t*)QDir::toNativeSeparators(target).utf16(),
+                        MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return ::rename(QFile::encodeName(source).constData(),
+                    QFile::encodeName(target).constData()) == 0;
+#endif
+}
+
+bool QPluginMetaDataCache::find(const QString &fileName, const QFileInfo &info,
+                                QJsonObject *metaData) const
+{
+    QHash<QString, Entry>::const_iterator it = entries.constFind(fileName);
+    if (it == entries.constEnd() || it->size != info.size()
+        || it->lastModified != info.lastModified().toMSecsSinceEpoch())
+        return false;
+    *metaData = it->metaData;
+    return true;
+}
+
+void QPluginMetaDataCache::insert(const QString &fileName, const QFileInfo &info,
+                                  const QJsonObject &metaData)
+{
+    Entry entry;
+    entry.lastModified = info.lastModified().toMSecsSinceEpoch();
+    entry.size = info.size();
+    entry.metaData = metaData;
+    entries.insert(fileName, entry);
+    dirty = true;
+}
+
+void QPluginMetaDataCache::save()
+{
+    if (!dirty)
+        return;
+    dirty = false;
+
+    // keep what other processes wrote since the cache was read
+    QFileInfo info(cacheFile);
+    if (info.exists() && (info.lastModified().toMSecsSinceEpoch() != cacheLastModified
+                          || info.size() != cacheSize)) {
+        QHash<QString, Entry> written;
+        if (read(&written)) {
+            for (QHash<QString, Entry>::const_iterator w = written.constBegin(); w != written.constEnd(); ++w) {
+                if (!entries.contains(w.key()))
+                    entries.insert(w.key(), w.value());
+            }
+        }
+    }
+
+    // forget about plugins that have been removed
+    QHash<QString, Entry>::iterator it = entries.begin();
+    while (it != entries.end()) {
+        if (QFileInfo(it.key()).exists())
+            ++it;
+        else
+            it = entries.erase(it);
+    }
+
+    if (!QDir().mkpath(info.absolutePath()))
+        return;
+
+    // write to a temporary file first, so that other processes never
+    // read a partially written cache
+#ifndef QT_NO_TEMPORARYFILE
+    QTemporaryFile file(cacheFile + QLatin1String(".XXXXXX"));
+    if (!file.open())
+        return;
+#else
+    QFile file(cacheFile + QLatin1String(".new"));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+#endif
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << quint32(Magic) << quint32(Version) << quint32(entries.size());
+    for (it = entries.begin(); it != entries.end(); ++it) {
+        stream << it.key() << it->lastModified << it->size
+               << (it->metaData.isEmpty() ? QByteArray() : QJsonDocument(it->metaData).toBinaryData());
+    }
+    file.close();
+    if (stream.status() != QDataStream::Ok || file.error() != QFile::NoError) {
+        file.remove();
+        return;
+    }
+
+    if (!replaceFile(file.fileName(), cacheFile)) {
+        file.remove();
+        return;
+    }
+#ifndef QT_NO_TEMPORARYFILE
+    file.setAutoRemove(false);
+#endif
+
+    updateCacheInfo();
+}
+#endif // QT_SHARED
+
 class QFactoryLoaderPrivate : public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QFactoryLoader)
@@ -112,6 +342,12 @@ void QFactoryLoader::update()
 {
 #ifdef QT_SHARED
     Q_D(QFactoryLoader);
+    QPluginMetaDataCache *cache = qt_plugin_metadata_cache();
+    if (cache && !cache->isEnabled())
+        cache = 0;
+    if (cache)
+        cache->refresh();
+
     QStringList paths = QCoreApplication::libraryPaths();
     for (int i = 0; i < paths.count(); ++i) {
         const QString &pluginDir = paths.at(i);
@@ -132,7 +368,21 @@ void QFactoryLoader::update()
             if (qt_debug_component()) {
                 qDebug() << "QFactoryLoader::QFactoryLoader() looking at" << fileName;
             }
-            library = QLibraryPrivate::findOrCreate(QFileInfo(fileName).canonicalFilePath());
+            QFileInfo fileInfo(fileName);
+            library = QLibraryPrivate::findOrCreate(fileInfo.canonicalFilePath());
+            if (cache && !library->isPluginStateKnown()) {
+                QJsonObject metaData;
+                if (cache->find(library->fileName, fileInfo, &metaData)) {
+                    library->setPluginMetaData(metaData);
+                } else if (library->isPlugin() || !library->metaData.isEmpty()) {
+                    cache->insert(library->fileName, fileInfo, library->metaData);
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MAC)
+                } else if (fileInfo.isReadable()) {
+                    // the file has been read and is not a plugin
+                    cache->insert(library->fileName, fileInfo, QJsonObject());
+#endif
+                }
+            }
             if (!library->isPlugin()) {
                 if (qt_debug_component()) {
                     qDebug() << library->errorString;
@@ -187,6 +437,9 @@ void QFactoryLoader::update()
             }
         }
     }
+
+    if (cache)
+        cache->save();
 #else
     Q_D(QFactoryLoader);
     if (qt_debug_component()) {
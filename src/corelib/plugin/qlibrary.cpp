@@ -698,6 +698,34 @@ void QLibraryPrivate::updatePluginState()
         return;
     }
 
+    checkPluginMetaData();
+}
+
+/*!
+    \internal
+
+    Sets the plugin state from \a data, the meta data found in this library
+    earlier (e.g. by QFactoryLoader's meta data cache), without opening the
+    file again. Empty \a data means the file is not a plugin.
+*/
+void QLibraryPrivate::setPluginMetaData(const QJsonObject &data)
+{
+    if (pluginState != MightBeAPlugin)
+        return;
+
+    errorString.clear();
+    if (data.isEmpty()) {
+        errorString = QLibrary::tr("The file '%1' is not a valid Qt plugin.").arg(fileName);
+        pluginState = IsNotAPlugin;
+        return;
+    }
+
+    metaData = data;
+    checkPluginMetaData();
+}
+
+void QLibraryPrivate::checkPluginMetaData()
+{
     pluginState = IsNotAPlugin; // be pessimistic
 
     uint qt_version = (uint)metaData.value(QLatin1String("version")).toDouble();
@@ -104,7 +104,9 @@ public:
     QLibrary::LoadHints loadHints;
 
     void updatePluginState();
+    void setPluginMetaData(const QJsonObject &data);
     bool isPlugin();
+    bool isPluginStateKnown() const { return pluginState != MightBeAPlugin; }
 
     static inline QJsonDocument fromRawMetaData(const char *raw) {
         raw += strlen("QTMETADATA  ");
@@ -122,6 +124,8 @@ private:
     bool unload_sys();
     QFunctionPointer resolve_sys(const char *);
 
+    void checkPluginMetaData();
+
     QAtomicInt libraryRefCount;
     QAtomicInt libraryUnloadCount;
 
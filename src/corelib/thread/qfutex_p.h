@@ -0,0 +1,108 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFUTEX_P_H
+#define QFUTEX_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of the implementation.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/qglobal.h>
+#include <QtCore/qatomic.h>
+#include "qmutex_p.h"
+
+#if !defined(QT_NO_THREAD) && defined(QT_LINUX_FUTEX)
+
+#include <linux/futex.h>
+#include <limits.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <asm/unistd.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtLinuxFutex {
+
+// the extra flags (FUTEX_PRIVATE_FLAG) supported by the kernel, see qmutex_linux.cpp
+int futexFlags() Q_DECL_NOTHROW;
+
+inline int _q_futex(volatile int *addr, int op, int val, const struct timespec *timeout) Q_DECL_NOTHROW
+{
+    int *addr2 = 0;
+    int val2 = 0;
+
+    // we use __NR_futex because some libcs (like Android's bionic) don't
+    // provide SYS_futex etc.
+    return syscall(__NR_futex, addr, op | futexFlags(), val, timeout, addr2, val2);
+}
+
+inline volatile int *futexAddress(QBasicAtomicInt *futex) Q_DECL_NOTHROW
+{
+    return &futex->_q_value;
+}
+
+// sleeps until woken up, as long as \a futex still has \a expectedValue
+inline int futexWait(QBasicAtomicInt &futex, int expectedValue,
+                     const struct timespec *timeout = 0) Q_DECL_NOTHROW
+{
+    return _q_futex(futexAddress(&futex), FUTEX_WAIT, expectedValue, timeout);
+}
+
+inline void futexWakeAll(QBasicAtomicInt &futex) Q_DECL_NOTHROW
+{
+    _q_futex(futexAddress(&futex), FUTEX_WAKE, INT_MAX, 0);
+}
+
+} // namespace QtLinuxFutex
+
+QT_END_NAMESPACE
+
+#endif // !QT_NO_THREAD && QT_LINUX_FUTEX
+
+#endif // QFUTEX_P_H
@@ -58,6 +58,105 @@ class QFutureWatcher;
 template <>
 class QFutureWatcher<void>;
 
+#ifndef qdoc
+namespace QtPrivate {
+
+template <typename T>
+struct ContinuationParent
+{
+    typedef QFutureInterface<T> Type;
+    enum { HasResult = true };
+};
+
+template <>
+struct ContinuationParent<void>
+{
+    typedef QFutureInterfaceBase Type;
+    enum { HasResult = false };
+};
+
+// calls the function with the parent's result and reports the function's
+// result; a parent without result cancels the child
+template <typename T, typename R>
+struct ContinuationCall
+{
+    template <typename Function>
+    static void call(Function &function, QFutureInterface<T> &parent, QFutureInterface<R> &child)
+    {
+        if (!parent.isResultReadyAt(0))
+            child.reportCanceled();
+        else
+            child.reportResult(function(parent.resultReference(0)));
+    }
+};
+
+template <typename T>
+struct ContinuationCall<T, void>
+{
+    template <typename Function>
+    static void call(Function &function, QFutureInterface<T> &parent, QFutureInterface<void> &child)
+    {
+        if (!parent.isResultReadyAt(0))
+            child.reportCanceled();
+        else
+            function(parent.resultReference(0));
+    }
+};
+
+template <typename R>
+struct ContinuationCall<void, R>
+{
+    template <typename Function>
+    static void call(Function &function, QFutureInterfaceBase &, QFutureInterface<R> &child)
+    {
+        child.reportResult(function());
+    }
+};
+
+template <>
+struct ContinuationCall<void, void>
+{
+    template <typename Function>
+    static void call(Function &function, QFutureInterfaceBase &, QFutureInterface<void> &)
+    {
+        function();
+    }
+};
+
+template <typename T, typename R, typename Function>
+class Continuation : public ContinuationBase
+{
+public:
+    static QFuture<R> create(const typename ContinuationParent<T>::Type &parent, Function function,
+                             QThreadPool *pool, QObject *context)
+    {
+        Continuation *continuation = new Continuation(function);
+        QFuture<R> future = continuation->childInterface.future();
+        // may run and delete the continuation right away
+        continuation->start(parent, pool, context);
+        return future;
+    }
+
+private:
+    // parentInterface shares the parent's data once it has finished
+    explicit Continuation(Function function)
+        : ContinuationBase(&parentInterface, &childInterface, ContinuationParent<T>::HasResult),
+          function(function)
+    { }
+
+    void runFunction()
+    {
+        ContinuationCall<T, R>::call(function, parentInterface, childInterface);
+    }
+
+    typename ContinuationParent<T>::Type parentInterface;
+    QFutureInterface<R> childInterface;
+    Function function;
+};
+
+} // namespace QtPrivate
+#endif // qdoc
+
 template <typename T>
 class QFuture
 {
@@ -105,6 +204,26 @@ public:
     operator T() const { return result(); }
     QList<T> results() const { return d.results(); }
 
+    template <typename R>
+    QFuture<R> then(R (*function)(T), QThreadPool *pool = 0) const
+    { return QtPrivate::Continuation<T, R, R (*)(T)>::create(d, function, pool, 0); }
+    template <typename R>
+    QFuture<R> then(R (*function)(const T &), QThreadPool *pool = 0) const
+    { return QtPrivate::Continuation<T, R, R (*)(const T &)>::create(d, function, pool, 0); }
+    template <typename Functor>
+    QFuture<typename Functor::result_type> then(Functor functor, QThreadPool *pool = 0) const
+    { return QtPrivate::Continuation<T, typename Functor::result_type, Functor>::create(d, functor, pool, 0); }
+
+    template <typename R>
+    QFuture<R> then(QObject *context, R (*function)(T)) const
+    { return QtPrivate::Continuation<T, R, R (*)(T)>::create(d, function, 0, context); }
+    template <typename R>
+    QFuture<R> then(QObject *context, R (*function)(const T &)) const
+    { return QtPrivate::Continuation<T, R, R (*)(const T &)>::create(d, function, 0, context); }
+    template <typename Functor>
+    QFuture<typename Functor::result_type> then(QObject *context, Functor functor) const
+    { return QtPrivate::Continuation<T, typename Functor::result_type, Functor>::create(d, functor, 0, context); }
+
     class const_iterator
     {
     public:
@@ -242,6 +361,20 @@ public:
     QString progressText() const { return d.progressText(); }
     void waitForFinished() { d.waitForFinished(); }
 
+    template <typename R>
+    QFuture<R> then(R (*function)(), QThreadPool *pool = 0) const
+    { return QtPrivate::Continuation<void, R, R (*)()>::create(d, function, pool, 0); }
+    template <typename Functor>
+    QFuture<typename Functor::result_type> then(Functor functor, QThreadPool *pool = 0) const
+    { return QtPrivate::Continuation<void, typename Functor::result_type, Functor>::create(d, functor, pool, 0); }
+
+    template <typename R>
+    QFuture<R> then(QObject *context, R (*function)()) const
+    { return QtPrivate::Continuation<void, R, R (*)()>::create(d, function, 0, context); }
+    template <typename Functor>
+    QFuture<typename Functor::result_type> then(QObject *context, Functor functor) const
+    { return QtPrivate::Continuation<void, typename Functor::result_type, Functor>::create(d, functor, 0, context); }
+
 private:
     friend class QFutureWatcher<void>;
 
@@ -47,6 +47,8 @@
 #include "qfutureinterface_p.h"
 
 #include <QtCore/qatomic.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qpointer.h>
 #include <QtCore/qthread.h>
 #include <QtCore/qthreadpool.h>
 #include <private/qthreadpool_p.h>
@@ -438,6 +440,15 @@ QFutureInterfaceBasePrivate::QFutureInterfaceBasePrivate(QFutureInterfaceBase::S
     progressTime.invalidate();
 }
 
+QFutureInterfaceBasePrivate::~QFutureInterfaceBasePrivate()
+{
+    // Continuations stay connected without holding a reference until this
+    // future has finished; it never will now, so cancel and free them.
+    const QList<QFutureCallOutInterface *> connections = outputConnections;
+    for (int i = 0; i < connections.count(); ++i)
+        connections.at(i)->callOutInterfaceDisconnected();
+}
+
 int QFutureInterfaceBasePrivate::internal_resultCount() const
 {
     return m_results.count(); // ### subtract canceled results.
@@ -571,6 +582,181 @@ void QFutureInterfaceBasePrivate::setState(QFutureInterfaceBase::State newState)
     state = newState;
 }
 
+namespace QtPrivate {
+
+// Runs a continuation in the thread of its context object. It lives in that
+// thread, so the continuation can be posted to it even while the context is
+// being destroyed, and the context is only checked there.
+class ContinuationContext : public QObject
+{
+public:
+    ContinuationContext(ContinuationBase *continuation, QObject *context)
+        : continuation(continuation), context(context)
+    {
+        moveToThread(context->thread());
+    }
+
+    bool event(QEvent *event)
+    {
+        if (event->type() != QEvent::FutureCallOut)
+            return QObject::event(event);
+
+        QObject *receiver = context.data();
+        if (receiver && receiver->thread() != thread()) {
+            // the context has been moved to another thread in the meantime
+            moveToThread(receiver->thread());
+            QCoreApplication::postEvent(this, new QFutureCallOutEvent(QFutureCallOutEvent::Finished));
+            return true;
+        }
+
+        if (receiver)
+            continuation->run();
+        else
+            continuation->runCanceled();
+        delete continuation;
+        continuation = 0;
+        deleteLater();
+        return true;
+    }
+
+private:
+    ContinuationBase *continuation;
+    QPointer<QObject> context;
+};
+
+// Starts the continuation once the parent future has finished, or cancels it
+// if the parent is destroyed without finishing.
+class ContinuationCallOut : public QFutureCallOutInterface
+{
+public:
+    ContinuationCallOut(ContinuationBase *continuation, QThreadPool *pool, QObject *context)
+        : continuation(continuation), pool(pool),
+          contextObject(context ? new ContinuationContext(continuation, context) : 0),
+          done(false)
+    { }
+
+    // called with the parent's mutex locked
+    void postCallOutEvent(const QFutureCallOutEvent &callOutEvent)
+    {
+        if (callOutEvent.callOutType != QFutureCallOutEvent::Finished)
+            return;
+
+        done = true;
+        continuation->attachParent();
+        if (contextObject)
+            QCoreApplication::postEvent(contextObject, new QFutureCallOutEvent(QFutureCallOutEvent::Finished));
+        else
+            pool->start(continuation);
+    }
+
+    // called when the continuation has run, or when the parent is destroyed
+    void callOutInterfaceDisconnected()
+    {
+        if (done)
+            return;
+
+        done = true;
+        if (contextObject) {
+            // the context object frees the continuation in its own thread
+            continuation->child->cancel();
+            QCoreApplication::postEvent(contextObject, new QFutureCallOutEvent(QFutureCallOutEvent::Finished));
+        } else {
+            // deletes this call-out as well
+            continuation->runCanceled();
+            delete continuation;
+        }
+    }
+
+private:
+    ContinuationBase *continuation;
+    QThreadPool *pool;
+    ContinuationContext *contextObject;
+    bool done;
+};
+
+ContinuationBase::ContinuationBase(QFutureInterfaceBase *parent, QFutureInterfaceBase *child,
+                                   bool parentHasResult)
+    : parent(parent), parentData(0), child(child), callOut(0), parentHasResult(parentHasResult)
+{ }
+
+ContinuationBase::~ContinuationBase()
+{
+    delete callOut;
+}
+
+/*!
+    \internal
+    Runs the continuation on \a pool, or in the thread of \a context if it is
+    not null, once \a parent has finished.
+*/
+void ContinuationBase::start(const QFutureInterfaceBase &parent, QThreadPool *pool, QObject *context)
+{
+    child->reportStarted();
+    parentData = parent.d;
+    callOut = new ContinuationCallOut(this, pool ? pool : QThreadPool::globalInstance(), context);
+    parentData->connectOutputInterface(callOut);
+}
+
+/*!
+    \internal
+    Makes the parent interface of the continuation share the data of the
+    parent future once it has finished. Until then the continuation holds no
+    reference to it, so that a parent which never finishes is still freed.
+*/
+void ContinuationBase::attachParent()
+{
+    QFutureInterfaceBasePrivate *placeholder = parent->d;
+    parentData->refCount.ref();
+    if (parentHasResult) {
+        parentData->refCount.refT();
+        placeholder->refCount.derefT();
+    }
+    parent->d = parentData;
+    if (!placeholder->refCount.deref())
+        delete placeholder;
+}
+
+void ContinuationBase::run()
+{
+    parent->d->disconnectOutputInterface(callOut);
+
+    if (child->isCanceled()) {
+        // canceled by the user, or the context was destroyed
+    } else if (parent->isCanceled()) {
+#ifndef QT_NO_EXCEPTIONS
+        if (QException *exception = parent->exceptionStore().exception().exception())
+            child->reportException(*exception);
+#endif
+        child->reportCanceled();
+    } else {
+#ifndef QT_NO_EXCEPTIONS
+        try {
+#endif
+            runFunction();
+#ifndef QT_NO_EXCEPTIONS
+        } catch (QException &e) {
+            child->reportException(e);
+        } catch (...) {
+            child->reportException(QUnhandledException());
+        }
+#endif
+    }
+    child->reportFinished();
+}
+
+/*!
+    \internal
+    Finishes the continuation's future as canceled, without calling the
+    function.
+*/
+void ContinuationBase::runCanceled()
+{
+    child->cancel();
+    run();
+}
+
+} // namespace QtPrivate
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_QFUTURE
@@ -58,6 +58,13 @@ template <typename T> class QFuture;
 class QFutureInterfaceBasePrivate;
 class QFutureWatcherBase;
 class QFutureWatcherBasePrivate;
+class QThreadPool;
+class QObject;
+
+namespace QtPrivate {
+class ContinuationBase;
+class ContinuationCallOut;
+}
 
 class Q_CORE_EXPORT QFutureInterfaceBase
 {
@@ -141,8 +148,42 @@ private:
 private:
     friend class QFutureWatcherBase;
     friend class QFutureWatcherBasePrivate;
+    friend class QtPrivate::ContinuationBase;
 };
 
+namespace QtPrivate {
+
+// Runs a function once the parent future has finished, and reports its
+// result to the child future. See QFuture::then().
+class Q_CORE_EXPORT ContinuationBase : public QRunnable
+{
+public:
+    virtual ~ContinuationBase();
+
+    void start(const QFutureInterfaceBase &parent, QThreadPool *pool, QObject *context);
+    void run();
+    void runCanceled();
+
+protected:
+    ContinuationBase(QFutureInterfaceBase *parent, QFutureInterfaceBase *child,
+                     bool parentHasResult);
+    virtual void runFunction() = 0;
+
+private:
+    Q_DISABLE_COPY(ContinuationBase)
+    friend class ContinuationCallOut;
+
+    void attachParent();
+
+    QFutureInterfaceBase *parent;
+    QFutureInterfaceBasePrivate *parentData; // not referenced until it has finished
+    QFutureInterfaceBase *child;
+    ContinuationCallOut *callOut;
+    bool parentHasResult;
+};
+
+} // namespace QtPrivate
+
 template <typename T>
 class QFutureInterface : public QFutureInterfaceBase
 {
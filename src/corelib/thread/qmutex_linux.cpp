@@ -46,13 +46,10 @@
 #ifndef QT_NO_THREAD
 #include "qatomic.h"
 #include "qmutex_p.h"
+#include "qfutex_p.h"
 #include "qelapsedtimer.h"
 
-#include <linux/futex.h>
-#include <sys/syscall.h>
-#include <unistd.h>
 #include <errno.h>
-#include <asm/unistd.h>
 
 #if defined(__GXX_EXPERIMENTAL_CXX0X__) || __cplusplus >= 201103L
 // C++11 mode
@@ -147,7 +144,7 @@ static int checkFutexPrivateSupport()
     return value;
 }
 
-static inline int futexFlags()
+int QtLinuxFutex::futexFlags() Q_DECL_NOTHROW
 {
     int value = futexFlagSupport.load();
     if (Q_LIKELY(value != -1))
@@ -161,12 +158,7 @@ static inline int _q_futex(void *addr, int op, int val, const struct timespec *t
 #if Q_BYTE_ORDER == Q_BIG_ENDIAN && QT_POINTER_SIZE == 8
     int_addr++; //We want a pointer to the 32 least significant bit of QMutex::d
 #endif
-    int *addr2 = 0;
-    int val2 = 0;
-
-    // we use __NR_futex because some libcs (like Android's bionic) don't
-    // provide SYS_futex etc.
-    return syscall(__NR_futex, int_addr, op | futexFlags(), val, timeout, addr2, val2);
+    return QtLinuxFutex::_q_futex(int_addr, op, val, timeout);
 }
 
 static inline QMutexData *dummyFutexValue()
@@ -46,8 +46,12 @@
 #include "qmutex.h"
 #include "qthread.h"
 #include "qwaitcondition.h"
+#include "qelapsedtimer.h"
 
 #include "qreadwritelock_p.h"
+#include "qfutex_p.h"
+
+#include <errno.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -142,6 +146,16 @@ QReadWriteLock::~QReadWriteLock()
 */
 void QReadWriteLock::lockForRead()
 {
+    if (!d->recursive) {
+        const int s = d->state.load();
+        if ((s & QReadWriteLockPrivate::WriterLocked) || d->writersWaiting.load()
+            || (s & QReadWriteLockPrivate::ReaderMask) == QReadWriteLockPrivate::ReaderMask
+            || !d->state.testAndSetAcquire(s, s + 1)) {
+            d->lockForRead(-1);
+        }
+        return;
+    }
+
     QMutexLocker lock(&d->mutex);
 
     Qt::HANDLE self = 0;
@@ -188,6 +202,18 @@ void QReadWriteLock::lockForRead()
 */
 bool QReadWriteLock::tryLockForRead()
 {
+    if (!d->recursive) {
+        for (;;) {
+            const int s = d->state.load();
+            if (s & QReadWriteLockPrivate::WriterLocked)
+                return false;
+            Q_ASSERT_X((s & QReadWriteLockPrivate::ReaderMask) != QReadWriteLockPrivate::ReaderMask,
+                       "QReadWriteLock::tryLockForRead()", "Overflow in lock counter");
+            if (d->state.testAndSetAcquire(s, s + 1))
+                return true;
+        }
+    }
+
     QMutexLocker lock(&d->mutex);
 
     Qt::HANDLE self = 0;
@@ -236,6 +262,9 @@ bool QReadWriteLock::tryLockForRead()
 */
 bool QReadWriteLock::tryLockForRead(int timeout)
 {
+    if (!d->recursive)
+        return d->lockForRead(timeout);
+
     QMutexLocker lock(&d->mutex);
 
     Qt::HANDLE self = 0;
@@ -281,6 +310,12 @@ bool QReadWriteLock::tryLockForRead(int timeout)
 */
 void QReadWriteLock::lockForWrite()
 {
+    if (!d->recursive) {
+        if (!d->state.testAndSetAcquire(0, QReadWriteLockPrivate::WriterLocked))
+            d->lockForWrite(-1);
+        return;
+    }
+
     QMutexLocker lock(&d->mutex);
 
     Qt::HANDLE self = 0;
@@ -324,6 +359,16 @@ void QReadWriteLock::lockForWrite()
 */
 bool QReadWriteLock::tryLockForWrite()
 {
+    if (!d->recursive) {
+        for (;;) {
+            const int s = d->state.load();
+            if (s & ~QReadWriteLockPrivate::Waiting)
+                return false;
+            if (d->state.testAndSetAcquire(s, s | QReadWriteLockPrivate::WriterLocked))
+                return true;
+        }
+    }
+
     QMutexLocker lock(&d->mutex);
 
     Qt::HANDLE self = 0;
@@ -371,6 +416,10 @@ bool QReadWriteLock::tryLockForWrite()
 */
 bool QReadWriteLock::tryLockForWrite(int timeout)
 {
+    if (!d->recursive)
+        return d->state.testAndSetAcquire(0, QReadWriteLockPrivate::WriterLocked)
+            || d->lockForWrite(timeout);
+
     QMutexLocker lock(&d->mutex);
 
     Qt::HANDLE self = 0;
@@ -413,6 +462,17 @@ bool QReadWriteLock::tryLockForWrite(int timeout)
 */
 void QReadWriteLock::unlock()
 {
+    if (!d->recursive) {
+        const int s = d->state.load();
+        // the last reader or the writer leaving without waiting threads
+        if ((s == 1 || s == QReadWriteLockPrivate::WriterLocked)
+            && d->state.testAndSetRelease(s, 0)) {
+            return;
+        }
+        d->unlock();
+        return;
+    }
+
     QMutexLocker lock(&d->mutex);
 
     Q_ASSERT_X(d->accessCount != 0, "QReadWriteLock::unlock()", "Cannot unlock an unlocked lock");
@@ -445,6 +505,178 @@ void QReadWriteLock::unlock()
     }
 }
 
+#ifdef QT_LINUX_FUTEX
+
+static inline void wakeAllWaiting(QReadWriteLockPrivate *d)
+{
+    QtLinuxFutex::futexWakeAll(d->state);
+}
+
+/*!
+    \internal
+    Sleeps for at most \a timeout milliseconds, unless the state differs from
+    \a expectedState. Returns false if the timeout expired.
+*/
+bool QReadWriteLockPrivate::waitForStateChange(int expectedState, int timeout)
+{
+    struct timespec ts, *pts = 0;
+    if (timeout >= 0) {
+        ts.tv_sec = timeout / 1000;
+        ts.tv_nsec = (timeout % 1000) * 1000 * 1000;
+        pts = &ts;
+    }
+    // woken up, interrupted or the state changed, all of which require
+    // looking at the state again
+    return QtLinuxFutex::futexWait(state, expectedState, pts) == 0 || errno != ETIMEDOUT;
+}
+
+#else
+
+static inline void wakeAllWaiting(QReadWriteLockPrivate *d)
+{
+    QMutexLocker locker(&d->mutex);
+    d->readerWait.wakeAll();
+}
+
+bool QReadWriteLockPrivate::waitForStateChange(int expectedState, int timeout)
+{
+    QMutexLocker locker(&mutex);
+    // the state is changed before taking the mutex to wake up the waiting
+    // threads, so no wake up is missed
+    if (state.load() != expectedState)
+        return true;
+    return readerWait.wait(&mutex, timeout < 0 ? ULONG_MAX : ulong(timeout));
+}
+
+#endif // QT_LINUX_FUTEX
+
+// the timer is only started for positive timeouts
+static inline int remainingTime(int timeout, const QElapsedTimer &timer)
+{
+    if (timeout < 0)
+        return -1;
+    if (timeout == 0)
+        return 0;
+    return int(qMax(qint64(0), timeout - timer.elapsed()));
+}
+
+/*!
+    \internal
+    Slow path of lockForRead() for non-recursive locks. Waits at most \a
+    timeout milliseconds, or forever if \a timeout is negative.
+*/
+bool QReadWriteLockPrivate::lockForRead(int timeout)
+{
+    QElapsedTimer timer;
+    if (timeout > 0)
+        timer.start();
+
+    for (;;) {
+        int s = state.load();
+        if (!(s & WriterLocked) && !writersWaiting.load()) {
+            Q_ASSERT_X((s & ReaderMask) != ReaderMask, "QReadWriteLock::lockForRead()",
+                       "Overflow in lock counter");
+            if (state.testAndSetAcquire(s, s + 1))
+                return true;
+            continue;
+        }
+
+        const int remaining = remainingTime(timeout, timer);
+        if (remaining == 0)
+            return false;
+        if (!(s & Waiting)) {
+            if (!state.testAndSetRelaxed(s, s | Waiting))
+                continue;
+            s |= Waiting;
+        }
+        if (!waitForStateChange(s, remaining))
+            return false;
+    }
+}
+
+/*!
+    \internal
+    Slow path of lockForWrite() for non-recursive locks. Waits at most \a
+    timeout milliseconds, or forever if \a timeout is negative.
+*/
+bool QReadWriteLockPrivate::lockForWrite(int timeout)
+{
+    QElapsedTimer timer;
+    if (timeout > 0)
+        timer.start();
+
+    writersWaiting.ref();
+    for (;;) {
+        int s = state.load();
+        if (!(s & ~Waiting)) {
+            // keep the Waiting bit, for the readers waiting for the lock
+            if (state.testAndSetAcquire(s, s | WriterLocked)) {
+                writersWaiting.deref();
+                return true;
+            }
+            continue;
+        }
+
+        const int remaining = remainingTime(timeout, timer);
+        if (remaining == 0)
+            break;
+        if (!(s & Waiting)) {
+            if (!state.testAndSetRelaxed(s, s | Waiting))
+                continue;
+            s |= Waiting;
+        }
+        if (!waitForStateChange(s, remaining))
+            break;
+    }
+
+    // timed out: readers may be waiting only because of this writer
+    if (!writersWaiting.deref())
+        wakeWaitingThreads();
+    return false;
+}
+
+/*!
+    \internal
+    Slow path of unlock() for non-recursive locks.
+*/
+void QReadWriteLockPrivate::unlock()
+{
+    for (;;) {
+        const int s = state.load();
+        int newState;
+        if (s & WriterLocked) {
+            newState = 0;
+        } else {
+            Q_ASSERT_X(s & ReaderMask, "QReadWriteLock::unlock()", "Cannot unlock an unlocked lock");
+            newState = s - 1;
+            // the waiting threads are woken up once the last reader is gone
+            if (!(newState & ReaderMask))
+                newState = 0;
+        }
+        if (state.testAndSetRelease(s, newState)) {
+            if ((s & Waiting) && !newState)
+                wakeAllWaiting(this);
+            return;
+        }
+    }
+}
+
+/*!
+    \internal
+    Clears the Waiting bit and wakes up all threads sleeping on the state.
+*/
+void QReadWriteLockPrivate::wakeWaitingThreads()
+{
+    for (;;) {
+        const int s = state.load();
+        if (!(s & Waiting))
+            return;
+        if (state.testAndSetRelaxed(s, s & ~Waiting))
+            break;
+    }
+    wakeAllWaiting(this);
+}
+
 /*!
     \class QReadLocker
     \inmodule QtCore
@@ -54,6 +54,7 @@
 //
 
 #include <QtCore/qglobal.h>
+#include <QtCore/qatomic.h>
 #include <QtCore/qhash.h>
 
 #ifndef QT_NO_THREAD
@@ -67,6 +68,45 @@ struct QReadWriteLockPrivate
           recursive(recursionMode == QReadWriteLock::Recursive), currentWriter(0)
     { }
 
+    // Non-recursive locks keep their whole state in one atomic integer: the
+    // number of readers, a bit for the writer and a bit telling that threads
+    // are sleeping until the state changes. Uncontended locking and
+    // unlocking is a single atomic operation, threads that have to wait
+    // sleep on the state (using futexes on Linux).
+    enum {
+        WriterLocked = 0x40000000,
+        Waiting = 0x20000000,
+        ReaderMask = 0x1fffffff
+    };
+    QAtomicInt state;
+    // number of threads waiting in lockForWrite(), readers don't lock while
+    // writers are waiting
+    QAtomicInt writersWaiting;
+
+    bool lockForRead(int timeout);
+    bool lockForWrite(int timeout);
+    void unlock();
+    bool waitForStateChange(int expectedState, int timeout);
+    void wakeWaitingThreads();
+
+    enum LockState { Unlocked, LockedForRead, LockedForWrite, RecursivelyLockedForWrite };
+    LockState lockState() const
+    {
+        if (!recursive) {
+            const int s = state.load();
+            if (s & WriterLocked)
+                return LockedForWrite;
+            return (s & ReaderMask) ? LockedForRead : Unlocked;
+        }
+        if (accessCount == 0)
+            return Unlocked;
+        if (accessCount < -1)
+            return RecursivelyLockedForWrite;
+        return accessCount < 0 ? LockedForWrite : LockedForRead;
+    }
+
+    // recursive locks use the mutex and wait conditions, non-recursive ones
+    // only where futexes are not available
     QMutex mutex;
     QWaitCondition readerWait;
     QWaitCondition writerWait;
@@ -82,6 +82,7 @@ QThreadData::~QThreadData()
     thread = 0;
     delete t;
 
+    postEventList.takeQueuedEvents();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
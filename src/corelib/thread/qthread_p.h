@@ -70,6 +70,7 @@ QT_BEGIN_NAMESPACE
 
 class QAbstractEventDispatcher;
 class QEventLoop;
+class QThreadData;
 
 class QPostEvent
 {
@@ -91,8 +92,33 @@ inline bool operator<(const QPostEvent &first, const QPostEvent &second)
     return first.priority > second.priority;
 }
 
+// An event posted with normal priority that postEvent() queued without
+// taking the mutex of the receiver's QPostEventList
+struct QQueuedPostEvent
+{
+    QQueuedPostEvent *next;
+    QObject *receiver;
+    QEvent *event;
+};
+
+// A snapshot of the counters of a QPostEventList, see
+// QCoreApplicationPrivate::postEventStatistics(); the counters wrap around
+struct QPostEventStatistics
+{
+    uint queued;     // events posted without locking
+    uint taken;      // of those, moved into the list
+    uint inserted;   // events posted with the mutex locked
+    uint delivered;  // events sent by sendPostedEvents()
+    int pending;     // events waiting to be delivered
+};
+
 // This class holds the list of posted events.
 //  The list has to be kept sorted by priority
+//
+//  Events that are never compressed and have normal priority are pushed
+//  onto the lock-free queuedEvents stack by any number of threads. They
+//  are moved into the list by takeQueuedEvents(), which must be called
+//  with the mutex locked before the list is looked at.
 class QPostEventList : public QVector<QPostEvent>
 {
 public:
@@ -106,10 +132,55 @@ public:
 
     QMutex mutex;
 
+    // queuedEvents == events queued without the mutex, newest first
+    QAtomicPointer<QQueuedPostEvent> queuedEvents;
+    // queueingThreads == number of threads in postEvent() that may be about to queue an event
+    QAtomicInt queueingThreads;
+
+    // statistics, these counters wrap around
+    QAtomicInt queuedCount;     // events queued without the mutex
+    QAtomicInt takenCount;      // queued events moved into the list
+    QAtomicInt insertedCount;   // events posted with the mutex locked
+    QAtomicInt deliveredCount;  // events sent by sendPostedEvents()
+
     inline QPostEventList()
         : QVector<QPostEvent>(), recursion(0), startOffset(0), insertionOffset(0)
     { }
 
+    inline bool hasQueuedEvents() const
+    { return queuedEvents.load() != 0; }
+
+    void queueEvent(QObject *receiver, QEvent *event)
+    {
+        QQueuedPostEvent *node = new QQueuedPostEvent;
+        node->receiver = receiver;
+        node->event = event;
+        queuedCount.ref();
+        QQueuedPostEvent *head;
+        do {
+            head = queuedEvents.load();
+            node->next = head;
+        } while (!queuedEvents.testAndSetRelease(head, node));
+    }
+
+    int takeQueuedEvents(QThreadData *target = 0);
+
+    // number of events waiting to be delivered
+    inline int pendingEventCount() const
+    { return size() - startOffset + (queuedCount.load() - takenCount.load()); }
+
+    // must be called with the mutex locked
+    inline QPostEventStatistics statistics() const
+    {
+        QPostEventStatistics statistics;
+        statistics.queued = uint(queuedCount.load());
+        statistics.taken = uint(takenCount.load());
+        statistics.inserted = uint(insertedCount.load());
+        statistics.delivered = uint(deliveredCount.load());
+        statistics.pending = pendingEventCount();
+        return statistics;
+    }
+
     void addEvent(const QPostEvent &ev) {
         int priority = ev.priority;
         if (isEmpty() ||
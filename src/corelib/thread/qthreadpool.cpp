@@ -42,6 +42,7 @@
 #include "qthreadpool.h"
 #include "qthreadpool_p.h"
 #include "qelapsedtimer.h"
+#include "qthreadstorage.h"
 
 #include <algorithm>
 
@@ -61,10 +62,40 @@ public:
     void run();
     void registerTheadInactive();
 
+    void pushLocalTask(QRunnable *task);
+    QRunnable *popLocalTask();
+    QRunnable *stealLocalTask();
+    bool removeLocalTask(QRunnable *task);
+
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // Tasks started from this thread in work stealing mode. The thread
+    // itself pushes and pops at the back, other threads steal from the
+    // front. Guarded by localMutex, so that the pool's mutex is not needed.
+    QMutex localMutex;
+    QList<QRunnable *> localTasks;
+    QAtomicInt localTaskCount;
+    quint32 stealSeed;
+};
+
+struct QThreadPoolThreadRef
+{
+    QThreadPoolThreadRef(QThreadPoolThread *thread = 0) : thread(thread) { }
+    QThreadPoolThread *thread;
 };
 
+Q_GLOBAL_STATIC(QThreadStorage<QThreadPoolThreadRef>, currentPoolThread)
+
+static inline QThreadPoolThread *currentPoolThreadOf(const QThreadPoolPrivate *manager)
+{
+    QThreadStorage<QThreadPoolThreadRef> *storage = currentPoolThread();
+    if (!storage || !storage->hasLocalData())
+        return 0;
+    QThreadPoolThread *thread = storage->localData().thread;
+    return thread && thread->manager == manager ? thread : 0;
+}
+
 /*
     QThreadPool private class.
 */
@@ -74,7 +105,7 @@ public:
     \internal
 */
 QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
-    :manager(manager), runnable(0)
+    :manager(manager), runnable(0), stealSeed(quint32(quintptr(this)) | 1)
 { }
 
 /*
@@ -82,13 +113,25 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    struct CurrentThreadSetter {
+        CurrentThreadSetter(QThreadPoolThread *thread)
+        { setCurrent(thread); }
+        ~CurrentThreadSetter()
+        { setCurrent(0); }
+        static void setCurrent(QThreadPoolThread *thread)
+        {
+            if (QThreadStorage<QThreadPoolThreadRef> *storage = currentPoolThread())
+                storage->setLocalData(QThreadPoolThreadRef(thread));
+        }
+    } currentThreadSetter(this);
+
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
         runnable = 0;
 
         do {
-            if (r) {
+            while (r) {
                 const bool autoDelete = r->autoDelete();
 
 
@@ -107,17 +150,35 @@ void QThreadPoolThread::run()
                     throw;
                 }
 #endif
-                locker.relock();
+                if (!manager->workStealing.load()) {
+                    locker.relock();
+                    if (autoDelete && !--r->ref)
+                        delete r;
+                    r = 0;
+                    break;
+                }
+
+                if (autoDelete)
+                    manager->releaseRunnable(r);
 
-                if (autoDelete && !--r->ref)
-                    delete r;
+                // run the tasks started from this thread without the pool's
+                // mutex, unless tasks with a higher priority are queued
+                r = 0;
+                if (localTaskCount.load() && !manager->highPriorityTasks.load()
+                    && !manager->tooManyThreadsActive()) {
+                    r = popLocalTask();
+                }
+                if (!r)
+                    locker.relock();
             }
 
             // if too many threads are active, expire this thread
-            if (manager->tooManyThreadsActive())
+            if (manager->tooManyThreadsActive()) {
+                manager->requeueLocalTasks(this);
                 break;
+            }
 
-            r = !manager->queue.isEmpty() ? manager->queue.takeFirst().first : 0;
+            r = manager->nextTask(this);
         } while (r != 0);
 
         if (manager->isExiting) {
@@ -151,12 +212,51 @@ void QThreadPoolThread::registerTheadInactive()
         manager->noActiveThreads.wakeAll();
 }
 
+void QThreadPoolThread::pushLocalTask(QRunnable *task)
+{
+    QMutexLocker locker(&localMutex);
+    localTasks.append(task);
+    localTaskCount.ref();
+}
+
+QRunnable *QThreadPoolThread::popLocalTask()
+{
+    QMutexLocker locker(&localMutex);
+    if (localTasks.isEmpty())
+        return 0;
+    localTaskCount.deref();
+    return localTasks.takeLast();
+}
+
+QRunnable *QThreadPoolThread::stealLocalTask()
+{
+    if (!localTaskCount.load())
+        return 0;
+    QMutexLocker locker(&localMutex);
+    if (localTasks.isEmpty())
+        return 0;
+    localTaskCount.deref();
+    return localTasks.takeFirst();
+}
+
+bool QThreadPoolThread::removeLocalTask(QRunnable *task)
+{
+    if (!localTaskCount.load())
+        return false;
+    QMutexLocker locker(&localMutex);
+    if (!localTasks.removeOne(task))
+        return false;
+    localTaskCount.deref();
+    return true;
+}
+
 
 /*
     \internal
 */
 QThreadPoolPrivate:: QThreadPoolPrivate()
     : isExiting(false),
+      workStealing(0),
       expiryTimeout(30000),
       maxThreadCount(qAbs(QThread::idealThreadCount())),
       reservedThreads(0),
@@ -218,9 +318,165 @@ void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
     if (it != begin && priority < (*(it - 1)).second)
         it = std::upper_bound(begin, --it, priority);
     queue.insert(it - begin, qMakePair(runnable, priority));
+    if (priority > 0)
+        highPriorityTasks.ref();
     runnableReady.wakeOne();
 }
 
+QRunnable *QThreadPoolPrivate::takeQueuedTask(int index)
+{
+    const QPair<QRunnable *, int> task = queue.takeAt(index);
+    if (task.second > 0)
+        highPriorityTasks.deref();
+    return task.first;
+}
+
+/*!
+    \internal
+    Queues \a task on the work stealing deque of the current thread, if it is
+    one of this pool's threads and the work stealing mode applies. Returns
+    false if the task has to go through the shared queue instead.
+
+    Only runnables that are not queued or running elsewhere are queued
+    locally. Like everywhere else, the reference count of the runnable is
+    only changed with the mutex locked.
+*/
+bool QThreadPoolPrivate::tryEnqueueLocalTask(QRunnable *task, int priority)
+{
+    if (!workStealing.load() || priority != 0)
+        return false;
+
+    QThreadPoolThread *thread = currentPoolThreadOf(this);
+    if (!thread)
+        return false;
+
+    QMutexLocker locker(&mutex);
+    if (!workStealing.load())
+        return false;
+    if (task->autoDelete()) {
+        if (task->ref != 0)
+            return false;
+        task->ref = 1;
+    }
+    thread->pushLocalTask(task);
+
+    // let an idle thread steal the task
+    if (waitingThreads > 0 || activeThreadCount() < maxThreadCount)
+        tryToStartIdleThread();
+    return true;
+}
+
+/*!
+    \internal
+    Returns the next task for \a thread: queued tasks with a higher priority
+    first, then the tasks started from \a thread, then the other queued tasks
+    and finally a task stolen from another thread.
+
+    Must be called with the mutex locked.
+*/
+QRunnable *QThreadPoolPrivate::nextTask(QThreadPoolThread *thread)
+{
+    if (!queue.isEmpty() && queue.first().second > 0)
+        return takeQueuedTask();
+    if (QRunnable *r = thread->popLocalTask())
+        return r;
+    if (!queue.isEmpty())
+        return takeQueuedTask();
+    return stealTask(thread);
+}
+
+/*!
+    \internal
+    Steals the oldest task of another thread, starting at a random thread.
+
+    Must be called with the mutex locked.
+*/
+QRunnable *QThreadPoolPrivate::stealTask(QThreadPoolThread *thread)
+{
+    const int count = allThreads.count();
+    if (!workStealing.load() || count < 2)
+        return 0;
+
+    // xorshift, good enough to spread the thieves over the threads
+    quint32 x = thread->stealSeed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    thread->stealSeed = x;
+
+    const int start = x % count;
+    QSet<QThreadPoolThread *>::const_iterator it = allThreads.constBegin();
+    for (int i = 0; i < start; ++i)
+        ++it;
+    for (int i = 0; i < count; ++i) {
+        if (it == allThreads.constEnd())
+            it = allThreads.constBegin();
+        QThreadPoolThread *victim = *it;
+        ++it;
+        if (victim == thread)
+            continue;
+        if (QRunnable *r = victim->stealLocalTask())
+            return r;
+    }
+    return 0;
+}
+
+/*!
+    \internal
+    Moves the tasks started from \a thread to the shared queue, before the
+    thread expires.
+
+    Must be called with the mutex locked.
+*/
+void QThreadPoolPrivate::requeueLocalTasks(QThreadPoolThread *thread)
+{
+    if (!thread->localTaskCount.load())
+        return;
+
+    QList<QRunnable *> tasks;
+    {
+        QMutexLocker locker(&thread->localMutex);
+        tasks.swap(thread->localTasks);
+        thread->localTaskCount.store(0);
+    }
+    for (int i = 0; i < tasks.count(); ++i) {
+        QRunnable *task = tasks.at(i);
+        // the reference was taken when the task was queued locally
+        if (task->autoDelete())
+            --task->ref;
+        enqueueTask(task);
+    }
+}
+
+/*!
+    \internal
+    Wakes up a waiting thread or starts a new one, without a task, so that
+    it can steal work from the other threads.
+
+    Must be called with the mutex locked.
+*/
+void QThreadPoolPrivate::tryToStartIdleThread()
+{
+    if (waitingThreads > 0) {
+        --waitingThreads;
+        runnableReady.wakeOne();
+        return;
+    }
+
+    if (activeThreadCount() >= maxThreadCount)
+        return;
+
+    if (!expiredThreads.isEmpty()) {
+        QThreadPoolThread *thread = expiredThreads.dequeue();
+        Q_ASSERT(thread->runnable == 0);
+        ++activeThreads;
+        thread->start();
+        return;
+    }
+
+    startThread();
+}
+
 int QThreadPoolPrivate::activeThreadCount() const
 {
     // To improve scalability this function is called without holding 
@@ -235,7 +491,7 @@ void QThreadPoolPrivate::tryToStartMoreThreads()
 {
     // try to push tasks on the queue to any available threads
     while (!queue.isEmpty() && tryStart(queue.first().first))
-        queue.removeFirst();
+        takeQueuedTask();
 }
 
 bool QThreadPoolPrivate::tooManyThreadsActive() const
@@ -254,7 +510,7 @@ void QThreadPoolPrivate::startThread(QRunnable *runnable)
     allThreads.insert(thread.data());
     ++activeThreads;
 
-    if (runnable->autoDelete())
+    if (runnable && runnable->autoDelete())
         ++runnable->ref;
     thread->runnable = runnable;
     thread.take()->start();
@@ -321,16 +577,21 @@ void QThreadPoolPrivate::stealRunnable(QRunnable *runnable)
     bool found = false;
     {
         QMutexLocker locker(&mutex);
-        QList<QPair<QRunnable *, int> >::iterator it = queue.begin();
-        QList<QPair<QRunnable *, int> >::iterator end = queue.end();
-
-        while (it != end) {
-            if (it->first == runnable) {
+        for (int i = 0; i < queue.count(); ++i) {
+            if (queue.at(i).first == runnable) {
                 found = true;
-                queue.erase(it);
+                takeQueuedTask(i);
                 break;
             }
-            ++it;
+        }
+
+        if (!found) {
+            foreach (QThreadPoolThread *thread, allThreads) {
+                if (thread->removeLocalTask(runnable)) {
+                    found = true;
+                    break;
+                }
+            }
         }
     }
 
@@ -347,6 +608,21 @@ void QThreadPoolPrivate::stealRunnable(QRunnable *runnable)
     }
 }
 
+/*!
+    \internal
+    Drops the reference taken on the auto-deleting \a runnable when it was
+    queued, deleting it if it was the last one.
+*/
+void QThreadPoolPrivate::releaseRunnable(QRunnable *runnable)
+{
+    // start() may take another reference concurrently
+    QMutexLocker locker(&mutex);
+    if (!--runnable->ref) {
+        locker.unlock();
+        delete runnable;
+    }
+}
+
 /*!
     \class QThreadPool
     \inmodule QtCore
@@ -438,6 +714,12 @@ QThreadPool *QThreadPool::globalInstance()
     ownership of \a runnable remains with the caller. Note that
     changing the auto-deletion on \a runnable after calling this
     functions results in undefined behavior.
+
+    If work stealing is enabled and this function is called from one of the
+    pool's threads with the default \a priority, \a runnable is queued on
+    that thread instead.
+
+    \sa workStealingEnabled
 */
 void QThreadPool::start(QRunnable *runnable, int priority)
 {
@@ -445,6 +727,9 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (d->tryEnqueueLocalTask(runnable, priority))
+        return;
+
     QMutexLocker locker(&d->mutex);
     if (!d->tryStart(runnable))
         d->enqueueTask(runnable, priority);
@@ -539,6 +824,36 @@ void QThreadPool::setMaxThreadCount(int maxThreadCount)
     d->tryToStartMoreThreads();
 }
 
+/*! \property QThreadPool::workStealingEnabled
+    \since 5.1
+
+    \brief whether runnables started from the pool's own threads are
+    scheduled by work stealing
+
+    When enabled, each thread keeps the runnables it starts with the default
+    priority in a queue of its own and runs the most recently started one
+    first, which keeps the data they share in the processor's cache. Threads
+    that run out of work take the oldest runnables from the queue of a
+    randomly chosen thread. Runnables queued with a higher priority still run
+    before the runnables queued by the threads.
+
+    This suits recursive algorithms that split their work into many small
+    runnables. The default value is false.
+*/
+
+bool QThreadPool::isWorkStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    return d->workStealing.load();
+}
+
+void QThreadPool::setWorkStealingEnabled(bool enabled)
+{
+    Q_D(QThreadPool);
+    QMutexLocker locker(&d->mutex);
+    d->workStealing.store(enabled);
+}
+
 /*! \property QThreadPool::activeThreadCount
 
     This property represents the number of active threads in the thread pool.
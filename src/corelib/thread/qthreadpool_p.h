@@ -75,6 +75,12 @@ public:
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
+    QRunnable *takeQueuedTask(int index = 0);
+    bool tryEnqueueLocalTask(QRunnable *task, int priority);
+    QRunnable *nextTask(QThreadPoolThread *thread);
+    QRunnable *stealTask(QThreadPoolThread *thread);
+    void requeueLocalTasks(QThreadPoolThread *thread);
+    void tryToStartIdleThread();
     int activeThreadCount() const;
 
     void tryToStartMoreThreads();
@@ -84,6 +90,7 @@ public:
     void reset();
     bool waitForDone(int msecs);
     void stealRunnable(QRunnable *);
+    void releaseRunnable(QRunnable *runnable);
 
     mutable QMutex mutex;
     QWaitCondition runnableReady;
@@ -91,8 +98,13 @@ public:
     QQueue<QThreadPoolThread *> expiredThreads;
     QList<QPair<QRunnable *, int> > queue;
     QWaitCondition noActiveThreads;
+    // number of tasks in the queue that take precedence over local tasks
+    QAtomicInt highPriorityTasks;
 
     bool isExiting;
+    // set with the mutex locked; read without it when starting and
+    // finishing tasks, a stale value only picks the slower, locked path
+    QAtomicInt workStealing;
     int expiryTimeout;
     int maxThreadCount;
     int reservedThreads;
@@ -41,6 +41,9 @@
 
 #include <QtCore/qarraydata.h>
 #include <QtCore/private/qtools_p.h>
+#ifndef QT_BOOTSTRAPPED
+#include <QtCore/private/qarraydataarena_p.h>
+#endif
 
 #include <stdlib.h>
 
@@ -95,7 +98,13 @@ QArrayData *QArrayData::allocate(size_t objectSize, size_t alignment,
 
     size_t allocSize = headerSize + objectSize * capacity;
 
-    QArrayData *header = static_cast<QArrayData *>(::malloc(allocSize));
+    QArrayData *header = 0;
+#ifndef QT_BOOTSTRAPPED
+    if (QArrayDataArenaPrivate::hasActiveArenas())
+        header = static_cast<QArrayData *>(QArrayDataArenaPrivate::allocate(allocSize));
+    if (!header)
+#endif
+        header = static_cast<QArrayData *>(::malloc(allocSize));
     if (header) {
         quintptr data = (quintptr(header) + sizeof(QArrayData) + alignment - 1)
                 & ~(alignment - 1);
@@ -122,7 +131,48 @@ void QArrayData::deallocate(QArrayData *data, size_t objectSize,
         return;
 
     Q_ASSERT_X(!data->ref.isStatic(), "QArrayData::deallocate", "Static data can not be deleted");
+#ifndef QT_BOOTSTRAPPED
+    if (QArrayDataArenaPrivate::hasArenaBlocks() && QArrayDataArenaPrivate::owns(data)) {
+        QArrayDataArenaPrivate::release(data);
+        return;
+    }
+#endif
     ::free(data);
 }
 
+/*
+    Resizes \a data, which must be unaligned (its array directly follows the
+    header), mutable and not shared, to hold \a capacity objects of size
+    \a objectSize. Only the CapacityReserved option is honored; growing is
+    up to the caller. Unlike ::realloc(), this also works for data
+    allocated from a QArrayDataArena.
+*/
+QArrayData *QArrayData::reallocateUnaligned(QArrayData *data, size_t objectSize,
+        size_t capacity, AllocationOptions options)
+{
+    Q_ASSERT(data);
+    Q_ASSERT(data->isMutable());
+    Q_ASSERT(!data->ref.isShared());
+    Q_ASSERT(size_t(data->offset) == sizeof(QArrayData));
+
+    size_t headerSize = sizeof(QArrayData);
+    size_t allocSize = headerSize + objectSize * capacity;
+
+    QArrayData *header;
+#ifndef QT_BOOTSTRAPPED
+    if (QArrayDataArenaPrivate::hasArenaBlocks() && QArrayDataArenaPrivate::owns(data)) {
+        size_t oldSize = headerSize + objectSize * data->alloc;
+        header = static_cast<QArrayData *>(QArrayDataArenaPrivate::reallocate(data, oldSize, allocSize));
+    } else
+#endif
+        header = static_cast<QArrayData *>(::realloc(data, allocSize));
+    if (header) {
+        header->alloc = capacity;
+        header->capacityReserved = bool(options & CapacityReserved);
+        header->offset = headerSize;
+    }
+
+    return header;
+}
+
 QT_END_NAMESPACE
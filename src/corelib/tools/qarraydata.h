@@ -121,6 +121,9 @@ struct Q_CORE_EXPORT QArrayData
         Q_REQUIRED_RESULT;
     static void deallocate(QArrayData *data, size_t objectSize,
             size_t alignment);
+    static QArrayData *reallocateUnaligned(QArrayData *data, size_t objectSize,
+            size_t capacity, AllocationOptions options = Default)
+        Q_REQUIRED_RESULT;
 
     static const QArrayData shared_null[2];
     static QArrayData *sharedNull() { return const_cast<QArrayData*>(shared_null); }
@@ -232,6 +235,14 @@ struct QTypedArrayData
         QArrayData::deallocate(data, sizeof(T), Q_ALIGNOF(AlignmentDummy));
     }
 
+    static QTypedArrayData *reallocateUnaligned(QTypedArrayData *data, size_t capacity,
+            AllocationOptions options = Default) Q_REQUIRED_RESULT
+    {
+        Q_STATIC_ASSERT(sizeof(QTypedArrayData) == sizeof(QArrayData));
+        return static_cast<QTypedArrayData *>(QArrayData::reallocateUnaligned(data,
+                    sizeof(T), capacity, options));
+    }
+
     static QTypedArrayData *fromRawData(const T *data, size_t n,
             AllocationOptions options = Default)
     {
@@ -0,0 +1,489 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qarraydataarena.h"
+#include "qarraydataarena_p.h"
+
+#include <QtCore/qmutex.h>
+#include <QtCore/qthreadstorage.h>
+
+#include <stdlib.h>
+#include <string.h>
+#ifdef Q_OS_WIN
+#  include <malloc.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+#if defined(Q_OS_LINUX) && defined(__GLIBC__) && (defined(Q_CC_GNU) || defined(Q_CC_INTEL)) && !defined(QT_LINUXBASE)
+/* LSB doesn't have __thread, https://lsbbugs.linuxfoundation.org/show_bug.cgi?id=993 */
+#define HAVE_TLS
+#endif
+#if defined(Q_CC_XLC) || defined (Q_CC_SUN)
+#define HAVE_TLS
+#endif
+
+#ifdef HAVE_TLS
+static __thread QArrayDataArena *currentThreadArena = 0;
+
+static inline QArrayDataArena *currentArena()
+{
+    return currentThreadArena;
+}
+
+static inline void setCurrentArena(QArrayDataArena *arena)
+{
+    currentThreadArena = arena;
+}
+#else
+namespace {
+struct CurrentArena
+{
+    CurrentArena() : arena(0) {}
+    QArrayDataArena *arena;
+};
+}
+
+Q_GLOBAL_STATIC(QThreadStorage<CurrentArena>, currentArenaStorage)
+
+static inline QArrayDataArena *currentArena()
+{
+    // hasLocalData() doesn't allocate, so it is safe to call from within
+    // QArrayData::allocate(); localData() could recurse into it.
+    QThreadStorage<CurrentArena> *storage = currentArenaStorage();
+    if (!storage || !storage->hasLocalData())
+        return 0;
+    return storage->localData().arena;
+}
+
+static inline void setCurrentArena(QArrayDataArena *arena)
+{
+    if (QThreadStorage<CurrentArena> *storage = currentArenaStorage())
+        storage->localData().arena = arena;
+}
+#endif
+
+/*
+    Arena memory comes in blocks of BlockSize bytes, aligned to BlockSize,
+    so that the block an allocation belongs to is found by masking the
+    pointer. The block starts with a reference count: the arena holds one
+    reference while it is still bumping through the block, and every
+    allocation holds another. Whoever drops the last reference frees the
+    block, which is what keeps data that outlives its arena valid.
+
+    QArrayData::deallocate() must tell arena memory from malloc'ed memory
+    for any pointer, on any thread. Blocks are therefore recorded in a
+    two-level bitmap indexed by block number. Lookups don't lock; the
+    bitmap is only ever extended, never freed, so a reader can't see a
+    dangling leaf.
+*/
+enum {
+    Alignment = 16,
+    HeaderSize = 16,
+    LeafShift = 16,
+    LeafSize = 1 << LeafShift,
+    RootSize = 1 << 16
+};
+
+struct ArenaBlockHeader
+{
+    QBasicAtomicInt ref;
+};
+
+struct PageMapLeaf
+{
+    QBasicAtomicInt bits[LeafSize / 32];
+};
+
+QBasicAtomicInt QArrayDataArenaPrivate::activeArenas = Q_BASIC_ATOMIC_INITIALIZER(0);
+QBasicAtomicInt QArrayDataArenaPrivate::registeredBlocks = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+static QBasicAtomicPointer<QBasicAtomicPointer<PageMapLeaf> > pageMap = Q_BASIC_ATOMIC_INITIALIZER(0);
+static QBasicMutex pageMapMutex;
+
+static inline size_t alignedSize(size_t size)
+{
+    return (size + Alignment - 1) & ~size_t(Alignment - 1);
+}
+
+static inline char *blockOf(const void *ptr)
+{
+    return reinterpret_cast<char *>(quintptr(ptr) & ~quintptr(QArrayDataArenaPrivate::BlockSize - 1));
+}
+
+static inline ArenaBlockHeader *blockHeader(char *block)
+{
+    return reinterpret_cast<ArenaBlockHeader *>(block);
+}
+
+static inline bool pageMapIndex(const void *ptr, uint *root, uint *word, uint *bit)
+{
+    const quint64 blockNumber = quint64(quintptr(ptr)) >> QArrayDataArenaPrivate::BlockShift;
+    if ((blockNumber >> LeafShift) >= quint64(RootSize))
+        return false;
+    *root = uint(blockNumber >> LeafShift);
+    *word = uint(blockNumber & (LeafSize - 1)) / 32;
+    *bit = uint(blockNumber & 31);
+    return true;
+}
+
+// Called with pageMapMutex locked.
+static bool registerBlock(char *block)
+{
+    uint root, word, bit;
+    if (!pageMapIndex(block, &root, &word, &bit))
+        return false;
+
+    QBasicAtomicPointer<PageMapLeaf> *map = pageMap.load();
+    if (!map) {
+        map = static_cast<QBasicAtomicPointer<PageMapLeaf> *>(
+                    ::calloc(RootSize, sizeof(QBasicAtomicPointer<PageMapLeaf>)));
+        if (!map)
+            return false;
+        pageMap.storeRelease(map);
+    }
+
+    PageMapLeaf *leaf = map[root].load();
+    if (!leaf) {
+        leaf = static_cast<PageMapLeaf *>(::calloc(1, sizeof(PageMapLeaf)));
+        if (!leaf)
+            return false;
+        map[root].storeRelease(leaf);
+    }
+
+    leaf->bits[word].storeRelease(leaf->bits[word].load() | int(1u << bit));
+    QArrayDataArenaPrivate::registeredBlocks.ref();
+    return true;
+}
+
+// Called with pageMapMutex locked.
+static void unregisterBlock(char *block)
+{
+    uint root, word, bit;
+    pageMapIndex(block, &root, &word, &bit);
+
+    PageMapLeaf *leaf = pageMap.load()[root].load();
+    leaf->bits[word].storeRelease(leaf->bits[word].load() & ~int(1u << bit));
+    QArrayDataArenaPrivate::registeredBlocks.deref();
+}
+
+static char *allocateBlock()
+{
+    void *block;
+#if defined(Q_OS_WIN)
+    block = ::_aligned_malloc(QArrayDataArenaPrivate::BlockSize, QArrayDataArenaPrivate::BlockSize);
+#elif defined(Q_OS_UNIX)
+    if (::posix_memalign(&block, QArrayDataArenaPrivate::BlockSize, QArrayDataArenaPrivate::BlockSize) != 0)
+        block = 0;
+#else
+    block = qMallocAligned(QArrayDataArenaPrivate::BlockSize, QArrayDataArenaPrivate::BlockSize);
+#endif
+    return static_cast<char *>(block);
+}
+
+static void freeBlock(char *block)
+{
+#if defined(Q_OS_WIN)
+    ::_aligned_free(block);
+#elif defined(Q_OS_UNIX)
+    ::free(block);
+#else
+    qFreeAligned(block);
+#endif
+}
+
+// Blocks are expensive to get from the heap, as they are much larger than
+// what malloc() hands out cheaply and must be aligned to their size. A few
+// unused ones are kept around for the next arena.
+enum { MaxCachedBlocks = 16 };
+static char *cachedBlocks[MaxCachedBlocks];
+static int cachedBlockCount = 0;
+
+static char *newBlock()
+{
+    QMutexLocker locker(&pageMapMutex);
+    char *block = 0;
+    if (cachedBlockCount) {
+        block = cachedBlocks[--cachedBlockCount];
+    } else {
+        locker.unlock();
+        block = allocateBlock();
+        if (!block)
+            return 0;
+        locker.relock();
+    }
+
+    if (!registerBlock(block)) {
+        locker.unlock();
+        freeBlock(block);
+        return 0;
+    }
+    blockHeader(block)->ref.store(1);
+    return block;
+}
+
+static void derefBlock(char *block)
+{
+    if (blockHeader(block)->ref.deref())
+        return;
+
+    QMutexLocker locker(&pageMapMutex);
+    unregisterBlock(block);
+    if (cachedBlockCount < MaxCachedBlocks) {
+        cachedBlocks[cachedBlockCount++] = block;
+        return;
+    }
+    locker.unlock();
+    freeBlock(block);
+}
+
+void *QArrayDataArenaPrivate::allocateFromBlock(size_t size)
+{
+    size = alignedSize(size);
+    if (!block || size_t(end - next) < size) {
+        char *fresh = newBlock();
+        if (!fresh)
+            return 0;
+        // The old block lives on for as long as allocations in it do.
+        if (block)
+            derefBlock(block);
+        block = fresh;
+        next = block + HeaderSize;
+        end = block + BlockSize;
+        ++blocks;
+    }
+
+    blockHeader(block)->ref.ref();
+    last = next;
+    next += size;
+    ++allocations;
+    bytes += size;
+    return last;
+}
+
+/*
+    Returns memory for \a size bytes from the current thread's arena, or 0
+    if the thread has no arena or the arena can't serve the request; the
+    caller then falls back to malloc.
+*/
+void *QArrayDataArenaPrivate::allocate(size_t size)
+{
+    QArrayDataArena *arena = currentArena();
+    if (!arena)
+        return 0;
+
+    QArrayDataArenaPrivate *d = arena->d;
+    void *ptr = size <= size_t(MaxAllocationSize) ? d->allocateFromBlock(size) : 0;
+    if (!ptr)
+        ++d->fallbacks;
+    return ptr;
+}
+
+bool QArrayDataArenaPrivate::owns(const void *ptr)
+{
+    QBasicAtomicPointer<PageMapLeaf> *map = pageMap.loadAcquire();
+    if (!map)
+        return false;
+
+    uint root, word, bit;
+    if (!pageMapIndex(ptr, &root, &word, &bit))
+        return false;
+
+    PageMapLeaf *leaf = map[root].loadAcquire();
+    return leaf && ((uint(leaf->bits[word].loadAcquire()) >> bit) & 1);
+}
+
+void QArrayDataArenaPrivate::release(void *ptr)
+{
+    Q_ASSERT(owns(ptr));
+    derefBlock(blockOf(ptr));
+}
+
+/*
+    Resizes the arena allocation \a ptr. The most recent allocation of the
+    current thread's arena is resized in place if the block has room,
+    which is the common case of a string being appended to in a loop.
+    Everything else is copied, into the arena if possible.
+*/
+void *QArrayDataArenaPrivate::reallocate(void *ptr, size_t oldSize, size_t newSize)
+{
+    Q_ASSERT(owns(ptr));
+
+    if (QArrayDataArena *arena = currentArena()) {
+        QArrayDataArenaPrivate *d = arena->d;
+        if (ptr == d->last && newSize <= size_t(MaxAllocationSize)
+                && size_t(d->end - d->last) >= alignedSize(newSize)) {
+            d->bytes += qint64(alignedSize(newSize)) - qint64(d->next - d->last);
+            d->next = d->last + alignedSize(newSize);
+            return ptr;
+        }
+    }
+
+    void *result = allocate(newSize);
+    if (!result)
+        result = ::malloc(newSize);
+    if (!result)
+        return 0;
+
+    ::memcpy(result, ptr, qMin(oldSize, newSize));
+    release(ptr);
+    return result;
+}
+
+/*!
+    \class QArrayDataArena
+    \inmodule QtCore
+    \since 5.1
+    \brief The QArrayDataArena class serves the memory of QString,
+    QByteArray and QVector from a per-thread arena for as long as it
+    exists.
+
+    \ingroup tools
+    \reentrant
+
+    Code that builds and drops many short-lived strings, byte arrays and
+    vectors, for example while handling one request or parsing one file,
+    spends a good part of its time in malloc() and free(), and makes all
+    threads doing so contend for the global heap.
+
+    While a QArrayDataArena exists, the memory for new QString, QByteArray
+    and QVector data allocated on the thread that created it is carved out
+    of large blocks owned by the arena instead. Allocating is then little
+    more than moving a pointer forward, freeing does not touch the heap at
+    all, and the blocks are returned in bulk when the arena is destroyed:
+
+    \snippet code/src_corelib_tools_qarraydataarena.cpp 0
+
+    Using an arena never changes the behavior of the containers. Data that
+    is still referenced when the arena is destroyed, because it was
+    returned or stored elsewhere, remains valid and may be used and freed
+    on any thread; it keeps the block it lives in alive until it is
+    released. Large allocations, and allocations made on other threads,
+    are served by the normal heap.
+
+    Arenas nest: creating an arena while another one is active on the same
+    thread redirects allocations to the new arena until it is destroyed.
+    An arena must be destroyed on the thread that created it, in reverse
+    order of creation, which is what happens naturally when arenas are
+    created on the stack.
+
+    Memory inside an arena is not reused until the arena is destroyed, so
+    arenas suit scopes that allocate a bounded amount of memory, not
+    long-running loops. allocationCount(), fallbackCount() and
+    blockCount() tell how much of the work was served by the arena.
+*/
+
+/*!
+    Creates an arena and makes it the current arena of the calling thread.
+*/
+QArrayDataArena::QArrayDataArena()
+    : d(new QArrayDataArenaPrivate)
+{
+    d->previous = currentArena();
+    setCurrentArena(this);
+    QArrayDataArenaPrivate::activeArenas.ref();
+}
+
+/*!
+    Makes the previously current arena current again and releases the
+    arena's memory, except for blocks that still hold data in use.
+*/
+QArrayDataArena::~QArrayDataArena()
+{
+    Q_ASSERT_X(currentArena() == this, "QArrayDataArena::~QArrayDataArena",
+               "Arenas must be destroyed in reverse order of creation, on the thread that created them");
+
+    setCurrentArena(d->previous);
+    QArrayDataArenaPrivate::activeArenas.deref();
+    if (d->block)
+        derefBlock(d->block);
+    delete d;
+}
+
+/*!
+    Returns the number of allocations this arena has served.
+
+    \sa fallbackCount()
+*/
+int QArrayDataArena::allocationCount() const
+{
+    return d->allocations;
+}
+
+/*!
+    Returns the number of allocations made while this arena was current
+    that had to be served by the heap, because they were too large or no
+    new block could be allocated.
+
+    \sa allocationCount()
+*/
+int QArrayDataArena::fallbackCount() const
+{
+    return d->fallbacks;
+}
+
+/*!
+    Returns the number of blocks this arena has allocated.
+*/
+int QArrayDataArena::blockCount() const
+{
+    return d->blocks;
+}
+
+/*!
+    Returns the number of bytes this arena has handed out, including
+    alignment padding.
+*/
+qint64 QArrayDataArena::bytesAllocated() const
+{
+    return d->bytes;
+}
+
+/*!
+    Returns the arena current for the calling thread, or 0 if there is
+    none.
+*/
+QArrayDataArena *QArrayDataArena::current()
+{
+    return currentArena();
+}
+
+QT_END_NAMESPACE
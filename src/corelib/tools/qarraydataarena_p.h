@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QARRAYDATAARENA_P_H
+#define QARRAYDATAARENA_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of other Qt classes.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "QtCore/qarraydataarena.h"
+#include "QtCore/qatomic.h"
+
+QT_BEGIN_NAMESPACE
+
+class QArrayDataArenaPrivate
+{
+public:
+    enum {
+        BlockShift = 16,
+        BlockSize = 1 << BlockShift,
+        // Anything bigger goes straight to malloc, so that one large array
+        // can't waste most of a block.
+        MaxAllocationSize = BlockSize / 4
+    };
+
+    QArrayDataArenaPrivate()
+        : previous(0), block(0), next(0), end(0), last(0),
+          allocations(0), fallbacks(0), blocks(0), bytes(0)
+    {}
+
+    // Cheap checks done before anything else, so that processes which
+    // never create an arena only pay for one relaxed load.
+    static bool hasActiveArenas()
+    { return activeArenas.load() != 0; }
+    static bool hasArenaBlocks()
+    { return registeredBlocks.load() != 0; }
+
+    // All of these are only called by QArrayData.
+    static void *allocate(size_t size);
+    static bool owns(const void *ptr);
+    static void release(void *ptr);
+    static void *reallocate(void *ptr, size_t oldSize, size_t newSize);
+
+    static QBasicAtomicInt activeArenas;
+    static QBasicAtomicInt registeredBlocks;
+
+    QArrayDataArena *previous;
+
+    char *block;
+    char *next;
+    char *end;
+    char *last;
+
+    int allocations;
+    int fallbacks;
+    int blocks;
+    qint64 bytes;
+
+private:
+    void *allocateFromBlock(size_t size);
+};
+
+QT_END_NAMESPACE
+
+#endif // QARRAYDATAARENA_P_H
@@ -1469,10 +1469,8 @@ void QByteArray::reallocData(uint alloc, Data::AllocationOptions options)
     } else {
         if (options & Data::Grow)
             alloc = qAllocMore(alloc, sizeof(Data));
-        Data *x = static_cast<Data *>(::realloc(d, sizeof(Data) + alloc));
+        Data *x = Data::reallocateUnaligned(d, alloc, options);
         Q_CHECK_PTR(x);
-        x->alloc = alloc;
-        x->capacityReserved = (options & Data::CapacityReserved) ? 1 : 0;
         d = x;
     }
 }
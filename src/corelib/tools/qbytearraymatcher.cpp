@@ -41,6 +41,8 @@
 
 #include "qbytearraymatcher.h"
 
+#include "private/qsimd_p.h"
+
 #include <limits.h>
 
 QT_BEGIN_NAMESPACE
@@ -54,11 +56,56 @@ static inline void bm_init_skiptable(const uchar *cc, int len, uchar *skiptable)
         skiptable[*cc++] = l;
 }
 
+#if defined(__SSE2__)
+/*
+    Boyer-Moore cannot skip more than the pattern length, so for short
+    patterns it is faster to look at 16 positions at a time: compare the
+    first and the last byte of the pattern with the corresponding bytes of
+    16 candidate positions, and only compare the rest of the pattern where
+    both match.
+*/
+enum { MaxSimdPatternLength = 32 };
+
+static int simd_find(const uchar *cc, int l, int index, const uchar *puc, uint pl)
+{
+    if (index > l - int(pl))
+        return -1;
+
+    const __m128i first = _mm_set1_epi8(puc[0]);
+    const __m128i last = _mm_set1_epi8(puc[pl - 1]);
+    const uchar *current = cc + index;
+    const uchar *end = cc + l - pl + 1;  // one past the last candidate position
+
+    for ( ; end - current >= 16; current += 16) {
+        const __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i *>(current));
+        const __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i *>(current + pl - 1));
+        uint mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(head, first),
+                                                    _mm_cmpeq_epi8(tail, last)));
+        while (mask) {
+            const uint i = qCountTrailingZeroBits(mask);
+            if (pl <= 2 || memcmp(current + i + 1, puc + 1, pl - 2) == 0)
+                return current + i - cc;
+            mask &= mask - 1;
+        }
+    }
+    for ( ; current < end; ++current) {
+        if (current[0] == puc[0] && current[pl - 1] == puc[pl - 1]
+            && (pl <= 2 || memcmp(current + 1, puc + 1, pl - 2) == 0))
+            return current - cc;
+    }
+    return -1;
+}
+#endif
+
 static inline int bm_find(const uchar *cc, int l, int index, const uchar *puc, uint pl,
                           const uchar *skiptable)
 {
     if (pl == 0)
         return index > l ? -1 : index;
+#if defined(__SSE2__)
+    if (pl <= MaxSimdPatternLength)
+        return simd_find(cc, l, index, puc, pl);
+#endif
     const uint pl_minus_one = pl - 1;
 
     register const uchar *current = cc + index + pl_minus_one;
@@ -0,0 +1,546 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QCONCURRENTCACHE_H
+#define QCONCURRENTCACHE_H
+
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qwaitcondition.h>
+
+QT_BEGIN_HEADER
+
+QT_BEGIN_NAMESPACE
+
+
+struct QConcurrentCacheStatistics
+{
+    inline QConcurrentCacheStatistics()
+        : hits(0), misses(0), insertions(0), evictions(0), coalescedMisses(0) {}
+
+    qint64 hits;
+    qint64 misses;
+    qint64 insertions;
+    qint64 evictions;
+    qint64 coalescedMisses;
+};
+
+template <class Key, class T>
+class QConcurrentCache
+{
+    struct Entry {
+        inline Entry() : cost(0), referenced(false), used(false) {}
+        Key key; T value; int cost; bool referenced; bool used;
+    };
+
+    // a value being computed by valueOrCompute(), shared with the threads
+    // waiting for it
+    struct Pending {
+        inline Pending() : ref(1), finished(false), succeeded(false) {}
+        int ref; bool finished; bool succeeded; T value;
+    };
+
+    // Each shard is an independent cache with its own lock. Eviction uses
+    // the CLOCK algorithm: lookups only set the referenced flag of an entry,
+    // and the hand sweeping over the entries gives referenced entries a
+    // second chance before evicting them.
+    struct Shard {
+        inline Shard() : hand(0), maxCost(0), totalCost(0) {}
+        QMutex mutex;
+        QWaitCondition computed;
+        QHash<Key, int> index;
+        QVector<Entry> entries;
+        QVector<int> freeEntries;
+        QHash<Key, Pending *> pending;
+        int hand;
+        int maxCost;
+        int totalCost;
+        QConcurrentCacheStatistics stats;
+    };
+
+    // Only the first numShards shards are used; there are fewer of them
+    // than allocated when maxCost is too small to give each one a share.
+    // numShards only changes with all shards locked.
+    Shard *shards;
+    int allocatedShards;
+    QAtomicInt numShards;
+    int mx;
+
+    static inline uint shardHash(const Key &key) {
+        uint h = qHash(key);
+        h ^= h >> 16;
+        h *= 0x45d9f3bU;
+        h ^= h >> 16;
+        return h;
+    }
+
+    // locks the shard a key belongs to
+    class ShardLocker
+    {
+    public:
+        inline ShardLocker(const QConcurrentCache *cache, const Key &key)
+            : c(cache), hash(shardHash(key)), s(0), n(0)
+        {
+            forever {
+                n = c->numShards.loadAcquire();
+                s = &c->shards[hash & (n - 1)];
+                s->mutex.lock();
+                if (isCurrent())
+                    break;
+                s->mutex.unlock();
+            }
+        }
+        inline ~ShardLocker() { if (s) s->mutex.unlock(); }
+
+        inline Shard &shard() const { return *s; }
+        // whether the key still belongs to the locked shard
+        inline bool isCurrent() const { return c->numShards.load() == n; }
+        inline void unlock() { s->mutex.unlock(); }
+        inline void relock() { s->mutex.lock(); }
+        inline void release() { s->mutex.unlock(); s = 0; }
+
+    private:
+        const QConcurrentCache *c;
+        uint hash;
+        Shard *s;
+        int n;
+    };
+    friend class ShardLocker;
+
+    bool lookupLocked(Shard &s, const Key &key, T *value) const;
+    bool insertLocked(Shard &s, const Key &key, const T &value, int cost);
+    bool takeLocked(Shard &s, const Key &key, T *value);
+    void addEntryLocked(Shard &s, const Key &key, const T &value, int cost);
+    void trimLocked(Shard &s, int m);
+    void distributeMaxCost();
+
+    Q_DISABLE_COPY(QConcurrentCache)
+
+public:
+    explicit QConcurrentCache(int maxCost = 100, int shardCount = 16);
+    inline ~QConcurrentCache() { delete [] shards; }
+
+    inline int maxCost() const { return mx; }
+    void setMaxCost(int m);
+    int totalCost() const;
+    inline int shardCount() const { return numShards.load(); }
+
+    int size() const;
+    inline int count() const { return size(); }
+    inline bool isEmpty() const { return size() == 0; }
+    QList<Key> keys() const;
+
+    void clear();
+
+    bool insert(const Key &key, const T &value, int cost = 1);
+    bool contains(const Key &key) const;
+    T value(const Key &key, const T &defaultValue = T()) const;
+    bool lookup(const Key &key, T *value) const;
+    template <typename Function>
+    T valueOrCompute(const Key &key, Function compute, int cost = 1);
+
+    bool remove(const Key &key);
+    T take(const Key &key);
+
+    QConcurrentCacheStatistics statistics() const;
+    void resetStatistics();
+};
+
+template <class Key, class T>
+inline QConcurrentCache<Key, T>::QConcurrentCache(int amaxCost, int shardCount)
+    : shards(0), allocatedShards(1), numShards(1), mx(amaxCost)
+{
+    while (allocatedShards < shardCount && allocatedShards < 256)
+        allocatedShards <<= 1;
+    shards = new Shard[allocatedShards];
+    distributeMaxCost();
+}
+
+template <class Key, class T>
+void QConcurrentCache<Key, T>::distributeMaxCost()
+{
+    for (int i = 0; i < allocatedShards; ++i)
+        shards[i].mutex.lock();
+
+    // use no more shards than there are units of cost, so that no shard
+    // is left without a share
+    int n = allocatedShards;
+    while (n > 1 && n > mx)
+        n >>= 1;
+
+    if (n != numShards.load()) {
+        // the keys belong to other shards now
+        QVector<Entry> moved;
+        for (int i = 0; i < allocatedShards; ++i) {
+            Shard &s = shards[i];
+            for (int j = 0; j < s.entries.size(); ++j) {
+                if (s.entries.at(j).used)
+                    moved.append(s.entries.at(j));
+            }
+            s.index.clear();
+            s.entries.clear();
+            s.freeEntries.clear();
+            s.hand = 0;
+            s.totalCost = 0;
+        }
+        numShards.storeRelease(n);
+        for (int i = 0; i < moved.size(); ++i) {
+            const Entry &e = moved.at(i);
+            addEntryLocked(shards[shardHash(e.key) & (n - 1)], e.key, e.value, e.cost);
+        }
+    }
+
+    for (int i = 0; i < allocatedShards; ++i) {
+        Shard &s = shards[i];
+        s.maxCost = i < n ? mx / n + (i < mx % n ? 1 : 0) : 0;
+        trimLocked(s, s.maxCost);
+    }
+
+    for (int i = allocatedShards - 1; i >= 0; --i)
+        shards[i].mutex.unlock();
+}
+
+template <class Key, class T>
+inline void QConcurrentCache<Key, T>::setMaxCost(int m)
+{ mx = m; distributeMaxCost(); }
+
+template <class Key, class T>
+int QConcurrentCache<Key, T>::totalCost() const
+{
+    int total = 0;
+    for (int i = 0; i < allocatedShards; ++i) {
+        QMutexLocker locker(&shards[i].mutex);
+        total += shards[i].totalCost;
+    }
+    return total;
+}
+
+template <class Key, class T>
+int QConcurrentCache<Key, T>::size() const
+{
+    int n = 0;
+    for (int i = 0; i < allocatedShards; ++i) {
+        QMutexLocker locker(&shards[i].mutex);
+        n += shards[i].index.size();
+    }
+    return n;
+}
+
+template <class Key, class T>
+QList<Key> QConcurrentCache<Key, T>::keys() const
+{
+    QList<Key> result;
+    for (int i = 0; i < allocatedShards; ++i) {
+        QMutexLocker locker(&shards[i].mutex);
+        result += shards[i].index.keys();
+    }
+    return result;
+}
+
+template <class Key, class T>
+void QConcurrentCache<Key, T>::clear()
+{
+    for (int i = 0; i < allocatedShards; ++i) {
+        Shard &s = shards[i];
+        QMutexLocker locker(&s.mutex);
+        s.index.clear();
+        s.entries.clear();
+        s.freeEntries.clear();
+        s.hand = 0;
+        s.totalCost = 0;
+    }
+}
+
+template <class Key, class T>
+bool QConcurrentCache<Key, T>::lookupLocked(Shard &s, const Key &key, T *value) const
+{
+    typename QHash<Key, int>::const_iterator i = s.index.constFind(key);
+    if (i == s.index.constEnd())
+        return false;
+    Entry &e = s.entries[*i];
+    e.referenced = true;
+    if (value)
+        *value = e.value;
+    return true;
+}
+
+template <class Key, class T>
+bool QConcurrentCache<Key, T>::insertLocked(Shard &s, const Key &key, const T &value, int cost)
+{
+    if (cost > s.maxCost) {
+        takeLocked(s, key, 0);
+        return false;
+    }
+
+    typename QHash<Key, int>::const_iterator i = s.index.constFind(key);
+    if (i != s.index.constEnd()) {
+        Entry &e = s.entries[*i];
+        s.totalCost += cost - e.cost;
+        e.value = value;
+        e.cost = cost;
+        e.referenced = true;
+    } else {
+        addEntryLocked(s, key, value, cost);
+    }
+    ++s.stats.insertions;
+    trimLocked(s, s.maxCost);
+    return true;
+}
+
+template <class Key, class T>
+void QConcurrentCache<Key, T>::addEntryLocked(Shard &s, const Key &key, const T &value, int cost)
+{
+    int slot;
+    if (!s.freeEntries.isEmpty()) {
+        slot = s.freeEntries.last();
+        s.freeEntries.resize(s.freeEntries.size() - 1);
+    } else {
+        slot = s.entries.size();
+        s.entries.resize(slot + 1);
+    }
+    Entry &e = s.entries[slot];
+    e.key = key;
+    e.value = value;
+    e.cost = cost;
+    // new entries survive one sweep of the hand, so that inserting
+    // can't evict the entry just inserted
+    e.referenced = true;
+    e.used = true;
+    s.index.insert(key, slot);
+    s.totalCost += cost;
+}
+
+template <class Key, class T>
+bool QConcurrentCache<Key, T>::takeLocked(Shard &s, const Key &key, T *value)
+{
+    typename QHash<Key, int>::iterator i = s.index.find(key);
+    if (i == s.index.end())
+        return false;
+    const int slot = *i;
+    s.index.erase(i);
+    Entry &e = s.entries[slot];
+    if (value)
+        *value = e.value;
+    s.totalCost -= e.cost;
+    e = Entry();
+    s.freeEntries.append(slot);
+    return true;
+}
+
+template <class Key, class T>
+void QConcurrentCache<Key, T>::trimLocked(Shard &s, int m)
+{
+    // a negative limit can't be met even by an empty shard
+    while (!s.index.isEmpty() && s.totalCost > m) {
+        if (s.hand >= s.entries.size())
+            s.hand = 0;
+        Entry &e = s.entries[s.hand];
+        if (e.used) {
+            if (e.referenced) {
+                e.referenced = false;
+            } else {
+                s.index.remove(e.key);
+                s.totalCost -= e.cost;
+                e = Entry();
+                s.freeEntries.append(s.hand);
+                ++s.stats.evictions;
+            }
+        }
+        ++s.hand;
+    }
+}
+
+template <class Key, class T>
+inline bool QConcurrentCache<Key, T>::insert(const Key &key, const T &value, int cost)
+{
+    ShardLocker locker(this, key);
+    Shard &s = locker.shard();
+    return insertLocked(s, key, value, cost);
+}
+
+template <class Key, class T>
+inline bool QConcurrentCache<Key, T>::contains(const Key &key) const
+{
+    ShardLocker locker(this, key);
+    Shard &s = locker.shard();
+    return s.index.contains(key);
+}
+
+template <class Key, class T>
+bool QConcurrentCache<Key, T>::lookup(const Key &key, T *value) const
+{
+    ShardLocker locker(this, key);
+    Shard &s = locker.shard();
+    if (lookupLocked(s, key, value)) {
+        ++s.stats.hits;
+        return true;
+    }
+    ++s.stats.misses;
+    return false;
+}
+
+template <class Key, class T>
+inline T QConcurrentCache<Key, T>::value(const Key &key, const T &defaultValue) const
+{
+    T result;
+    return lookup(key, &result) ? result : defaultValue;
+}
+
+template <class Key, class T>
+template <typename Function>
+T QConcurrentCache<Key, T>::valueOrCompute(const Key &key, Function compute, int cost)
+{
+    ShardLocker locker(this, key);
+    Shard &s = locker.shard();
+    T result;
+    if (lookupLocked(s, key, &result)) {
+        ++s.stats.hits;
+        return result;
+    }
+    ++s.stats.misses;
+
+    // wait for a thread already computing the value instead of computing
+    // it again; if that thread fails, the next waiter computes it
+    forever {
+        typename QHash<Key, Pending *>::const_iterator i = s.pending.constFind(key);
+        if (i == s.pending.constEnd())
+            break;
+        Pending *p = *i;
+        ++p->ref;
+        ++s.stats.coalescedMisses;
+        while (!p->finished)
+            s.computed.wait(&s.mutex);
+        const bool succeeded = p->succeeded;
+        if (succeeded)
+            result = p->value;
+        if (!--p->ref)
+            delete p;
+        if (succeeded)
+            return result;
+        if (lookupLocked(s, key, &result))
+            return result;
+    }
+
+    Pending *p = new Pending;
+    s.pending.insert(key, p);
+    locker.unlock();
+
+    QT_TRY {
+        result = compute(key);
+    } QT_CATCH(...) {
+        locker.relock();
+        s.pending.remove(key);
+        p->finished = true;
+        s.computed.wakeAll();
+        if (!--p->ref)
+            delete p;
+        QT_RETHROW;
+    }
+
+    locker.relock();
+    s.pending.remove(key);
+    // if setMaxCost() moved the key to another shard meanwhile, the
+    // value is inserted there after the waiters have been woken
+    const bool current = locker.isCurrent();
+    if (current)
+        insertLocked(s, key, result, cost);
+    p->value = result;
+    p->succeeded = true;
+    p->finished = true;
+    s.computed.wakeAll();
+    if (!--p->ref)
+        delete p;
+    if (!current) {
+        locker.release();
+        insert(key, result, cost);
+    }
+    return result;
+}
+
+template <class Key, class T>
+inline bool QConcurrentCache<Key, T>::remove(const Key &key)
+{
+    ShardLocker locker(this, key);
+    Shard &s = locker.shard();
+    return takeLocked(s, key, 0);
+}
+
+template <class Key, class T>
+inline T QConcurrentCache<Key, T>::take(const Key &key)
+{
+    ShardLocker locker(this, key);
+    Shard &s = locker.shard();
+    T result = T();
+    takeLocked(s, key, &result);
+    return result;
+}
+
+template <class Key, class T>
+QConcurrentCacheStatistics QConcurrentCache<Key, T>::statistics() const
+{
+    QConcurrentCacheStatistics result;
+    for (int i = 0; i < allocatedShards; ++i) {
+        QMutexLocker locker(&shards[i].mutex);
+        const QConcurrentCacheStatistics &stats = shards[i].stats;
+        result.hits += stats.hits;
+        result.misses += stats.misses;
+        result.insertions += stats.insertions;
+        result.evictions += stats.evictions;
+        result.coalescedMisses += stats.coalescedMisses;
+    }
+    return result;
+}
+
+template <class Key, class T>
+void QConcurrentCache<Key, T>::resetStatistics()
+{
+    for (int i = 0; i < allocatedShards; ++i) {
+        QMutexLocker locker(&shards[i].mutex);
+        shards[i].stats = QConcurrentCacheStatistics();
+    }
+}
+
+QT_END_NAMESPACE
+
+QT_END_HEADER
+
+#endif // QCONCURRENTCACHE_H
@@ -0,0 +1,721 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qflathash.h"
+
+QT_BEGIN_NAMESPACE
+
+// in qhash.cpp
+void qt_initialize_qhash_seed();
+extern Q_CORE_EXPORT QBasicAtomicInt qt_qhash_seed;
+
+const QFlatHashData QFlatHashData::shared_null = {
+    Q_REFCOUNT_INITIALIZE_STATIC, 0, 0, 0, 0, 0
+};
+
+/*
+    Returns the smallest number of buckets that can hold \a size items
+    without having to grow.
+*/
+int QFlatHashData::bucketsForSize(int size)
+{
+    int numBuckets = MinNumBuckets;
+    while (maxUsed(numBuckets) < size && numBuckets < (1 << 30))
+        numBuckets <<= 1;
+    return numBuckets;
+}
+
+QFlatHashData *QFlatHashData::allocate(int numBuckets, int nodeSize, int nodeAlign)
+{
+    Q_ASSERT(numBuckets >= MinNumBuckets && !(numBuckets & (numBuckets - 1)));
+
+    const size_t allocSize = size_t(nodeOffset(numBuckets, nodeAlign)) + size_t(numBuckets) * nodeSize;
+    QFlatHashData *d = static_cast<QFlatHashData *>(qMallocAligned(allocSize, nodeAlign));
+    Q_CHECK_PTR(d);
+
+    qt_initialize_qhash_seed();
+
+    d->ref.initializeOwned();
+    d->size = 0;
+    d->used = 0;
+    d->numBuckets = numBuckets;
+    d->numBits = 0;
+    while ((1 << d->numBits) < numBuckets)
+        ++d->numBits;
+    d->seed = uint(qt_qhash_seed.load());
+    memset(d->control(), Empty, numBuckets);
+    return d;
+}
+
+void QFlatHashData::deallocate(QFlatHashData *data, int nodeAlign)
+{
+    Q_UNUSED(nodeAlign);
+    qFreeAligned(data);
+}
+
+/*!
+    \class QFlatHash
+    \inmodule QtCore
+    \brief The QFlatHash class is a template class that provides an
+    open addressing hash-table-based dictionary.
+    \since 5.1
+
+    \ingroup tools
+    \ingroup shared
+
+    \reentrant
+
+    QFlatHash<Key, T> stores (key, value) pairs and provides very fast
+    lookup of the value associated with a key. Its API is a subset of
+    QHash's, and it uses the same qHash() overloads and \c operator==()
+    for the key type, so any type that can be used as a QHash key can
+    be used as a QFlatHash key as well.
+
+    Unlike QHash, which allocates one node per item and chains the
+    items of a bucket through pointers, QFlatHash stores all items in
+    one contiguous array and resolves collisions by probing the
+    neighbouring buckets (open addressing). Next to the items, it
+    keeps one byte per bucket with a few bits of the item's hash value,
+    so that a lookup rarely needs to compare keys that don't match.
+    This makes lookups cache friendly, avoids one memory allocation
+    per insertion, and needs less memory per item for small key and
+    value types. On the other hand, the hash table must be rehashed
+    as a whole when it grows, and since the items are stored inline,
+    large key or value types waste memory in empty buckets.
+
+    The main differences to QHash are:
+
+    \list
+    \li QFlatHash stores at most one value per key; there is no
+        insertMulti().
+    \li Inserting an item may move the items that are already in the
+        hash. References to values and iterators are invalidated by
+        any call to insert() or operator[]() that adds an item.
+        Removing an item, with remove(), take() or erase(), doesn't
+        move the other items.
+    \endlist
+
+    QFlatHash is \l{implicitly shared}, like all Qt containers. The
+    items are stored in an arbitrary order, which changes when the
+    hash is rehashed.
+
+    \sa QHash
+*/
+
+/*! \fn QFlatHash::QFlatHash()
+
+    Constructs an empty hash.
+
+    \sa clear()
+*/
+
+/*! \fn QFlatHash::QFlatHash(const QFlatHash<Key, T> &other)
+
+    Constructs a copy of \a other.
+
+    This operation occurs in \l{constant time}, because QFlatHash is
+    \l{implicitly shared}. This makes returning a QFlatHash from a
+    function very fast. If a shared instance is modified, it will be
+    copied (copy-on-write), and this takes \l{linear time}.
+
+    \sa operator=()
+*/
+
+/*! \fn QFlatHash::QFlatHash(QFlatHash<Key, T> &&other)
+
+    Move-constructs a QFlatHash instance, making it point at the same
+    object that \a other was pointing to.
+*/
+
+/*! \fn QFlatHash::~QFlatHash()
+
+    Destroys the hash. References to the values in the hash and all
+    iterators of this hash become invalid.
+*/
+
+/*! \fn QFlatHash<Key, T> &QFlatHash::operator=(const QFlatHash<Key, T> &other)
+
+    Assigns \a other to this hash and returns a reference to this hash.
+*/
+
+/*! \fn QFlatHash<Key, T> &QFlatHash::operator=(QFlatHash<Key, T> &&other)
+
+    Move-assigns \a other to this QFlatHash instance.
+*/
+
+/*! \fn void QFlatHash::swap(QFlatHash<Key, T> &other)
+
+    Swaps hash \a other with this hash. This operation is very
+    fast and never fails.
+*/
+
+/*! \fn bool QFlatHash::operator==(const QFlatHash<Key, T> &other) const
+
+    Returns true if \a other is equal to this hash; otherwise returns
+    false.
+
+    Two hashes are considered equal if they contain the same (key,
+    value) pairs.
+
+    This function requires the value type to implement \c operator==().
+
+    \sa operator!=()
+*/
+
+/*! \fn bool QFlatHash::operator!=(const QFlatHash<Key, T> &other) const
+
+    Returns true if \a other is not equal to this hash; otherwise
+    returns false.
+
+    \sa operator==()
+*/
+
+/*! \fn int QFlatHash::size() const
+
+    Returns the number of items in the hash.
+
+    \sa isEmpty(), count()
+*/
+
+/*! \fn int QFlatHash::count() const
+
+    Same as size().
+*/
+
+/*! \fn int QFlatHash::count(const Key &key) const
+
+    Returns 1 if the hash contains an item with the \a key; otherwise
+    returns 0.
+
+    \sa contains()
+*/
+
+/*! \fn bool QFlatHash::isEmpty() const
+
+    Returns true if the hash contains no items; otherwise returns
+    false.
+
+    \sa size()
+*/
+
+/*! \fn bool QFlatHash::empty() const
+
+    This function is provided for STL compatibility. It is equivalent
+    to isEmpty(), returning true if the hash is empty; otherwise
+    returns false.
+*/
+
+/*! \fn int QFlatHash::capacity() const
+
+    Returns the number of items the hash can hold without growing its
+    internal table.
+
+    The table is kept at most seven eighths full, so this is a bit
+    less than the number of buckets. Removed items may occupy a bucket
+    until the table is rehashed.
+
+    \sa reserve(), squeeze()
+*/
+
+/*! \fn void QFlatHash::reserve(int size)
+
+    Makes sure that the hash can hold at least \a size items without
+    having to grow its internal table.
+
+    Since growing rehashes and moves all items in the hash, calling
+    this function before building a large hash saves both time and
+    temporary memory.
+
+    \sa squeeze(), capacity()
+*/
+
+/*! \fn void QFlatHash::squeeze()
+
+    Reduces the size of the hash's internal table to the smallest
+    size that can hold the current items, dropping the buckets of
+    removed items.
+
+    \sa reserve(), capacity()
+*/
+
+/*! \fn void QFlatHash::detach()
+
+    \internal
+
+    Detaches this hash from any other hashes with which it may share
+    data.
+
+    \sa isDetached()
+*/
+
+/*! \fn bool QFlatHash::isDetached() const
+
+    \internal
+
+    Returns true if the hash's internal data isn't shared with any
+    other hash object; otherwise returns false.
+
+    \sa detach()
+*/
+
+/*! \fn void QFlatHash::setSharable(bool sharable)
+
+    \internal
+*/
+
+/*! \fn bool QFlatHash::isSharedWith(const QFlatHash<Key, T> &other) const
+
+    \internal
+*/
+
+/*! \fn void QFlatHash::clear()
+
+    Removes all items from the hash.
+
+    \sa remove()
+*/
+
+/*! \fn int QFlatHash::remove(const Key &key)
+
+    Removes the item that has the \a key from the hash. Returns the
+    number of items removed, which is 1 if the key exists in the hash,
+    and 0 otherwise.
+
+    \sa clear(), take()
+*/
+
+/*! \fn T QFlatHash::take(const Key &key)
+
+    Removes the item with the \a key from the hash and returns
+    the value associated with it.
+
+    If the item does not exist in the hash, the function simply
+    returns a \l{default-constructed value}.
+
+    \sa remove()
+*/
+
+/*! \fn bool QFlatHash::contains(const Key &key) const
+
+    Returns true if the hash contains an item with the \a key;
+    otherwise returns false.
+
+    \sa count()
+*/
+
+/*! \fn const T QFlatHash::value(const Key &key) const
+
+    Returns the value associated with the \a key.
+
+    If the hash contains no item with the \a key, the function
+    returns a \l{default-constructed value}.
+
+    \sa key(), values(), contains(), operator[]()
+*/
+
+/*! \fn const T QFlatHash::value(const Key &key, const T &defaultValue) const
+    \overload
+
+    If the hash contains no item with the given \a key, the function returns
+    \a defaultValue.
+*/
+
+/*! \fn T &QFlatHash::operator[](const Key &key)
+
+    Returns the value associated with the \a key as a modifiable
+    reference.
+
+    If the hash contains no item with the \a key, the function inserts
+    a \l{default-constructed value} into the hash with the \a key, and
+    returns a reference to it.
+
+    The reference is invalidated by the next insertion into the hash.
+
+    \sa insert(), value()
+*/
+
+/*! \fn const T QFlatHash::operator[](const Key &key) const
+
+    \overload
+
+    Same as value().
+*/
+
+/*! \fn const Key QFlatHash::key(const T &value) const
+
+    Returns the first key mapped to \a value.
+
+    If the hash contains no item with the \a value, the function
+    returns a \l{default-constructed value}{default-constructed key}.
+
+    This function can be slow (\l{linear time}), because QFlatHash's
+    internal data structure is optimized for fast lookup by key, not
+    by value.
+
+    \sa value()
+*/
+
+/*! \fn const Key QFlatHash::key(const T &value, const Key &defaultKey) const
+    \overload
+
+    Returns the first key mapped to \a value, or \a defaultKey if the
+    hash contains no item mapped to \a value.
+*/
+
+/*! \fn QList<Key> QFlatHash::keys() const
+
+    Returns a list containing all the keys in the hash, in an
+    arbitrary order.
+
+    The order is guaranteed to be the same as that used by values().
+
+    \sa values(), key()
+*/
+
+/*! \fn QList<T> QFlatHash::values() const
+
+    Returns a list containing all the values in the hash, in an
+    arbitrary order.
+
+    The order is guaranteed to be the same as that used by keys().
+
+    \sa keys(), value()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::insert(const Key &key, const T &value)
+
+    Inserts a new item with the \a key and a value of \a value, and
+    returns an iterator pointing to it.
+
+    If there is already an item with the \a key, that item's value
+    is replaced with \a value.
+
+    If the hash has to grow to make room for the new item, all other
+    iterators and references into the hash are invalidated.
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::find(const Key &key)
+
+    Returns an iterator pointing to the item with the \a key in the
+    hash.
+
+    If the hash contains no item with the \a key, the function
+    returns end().
+
+    \sa value(), contains()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::find(const Key &key) const
+
+    \overload
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::constFind(const Key &key) const
+
+    Returns an iterator pointing to the item with the \a key in the
+    hash.
+
+    If the hash contains no item with the \a key, the function
+    returns constEnd().
+
+    \sa find()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::erase(iterator pos)
+
+    Removes the (key, value) pair associated with the iterator \a pos
+    from the hash, and returns an iterator to the next item in the
+    hash.
+
+    Unlike remove() and take(), this function never causes QFlatHash
+    to rehash its internal data structure, and the other items stay
+    where they are. This means that it can safely be called while
+    iterating, and won't affect the order of items in the hash.
+
+    \sa remove(), take(), find()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::begin()
+
+    Returns an \l{STL-style iterator} pointing to the first item in
+    the hash.
+
+    \sa constBegin(), end()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::begin() const
+
+    \overload
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::cbegin() const
+
+    Returns a const \l{STL-style iterator} pointing to the first item
+    in the hash.
+
+    \sa begin(), cend()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::constBegin() const
+
+    Returns a const \l{STL-style iterator} pointing to the first item
+    in the hash.
+
+    \sa begin(), constEnd()
+*/
+
+/*! \fn QFlatHash::iterator QFlatHash::end()
+
+    Returns an \l{STL-style iterator} pointing to the imaginary item
+    after the last item in the hash.
+
+    \sa begin(), constEnd()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::end() const
+
+    \overload
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::cend() const
+
+    Returns a const \l{STL-style iterator} pointing to the imaginary
+    item after the last item in the hash.
+
+    \sa cbegin(), end()
+*/
+
+/*! \fn QFlatHash::const_iterator QFlatHash::constEnd() const
+
+    Returns a const \l{STL-style iterator} pointing to the imaginary
+    item after the last item in the hash.
+
+    \sa constBegin(), end()
+*/
+
+/*! \typedef QFlatHash::Iterator
+
+    Qt-style synonym for QFlatHash::iterator.
+*/
+
+/*! \typedef QFlatHash::ConstIterator
+
+    Qt-style synonym for QFlatHash::const_iterator.
+*/
+
+/*! \typedef QFlatHash::difference_type
+
+    Typedef for ptrdiff_t. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::key_type
+
+    Typedef for Key. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::mapped_type
+
+    Typedef for T. Provided for STL compatibility.
+*/
+
+/*! \typedef QFlatHash::size_type
+
+    Typedef for int. Provided for STL compatibility.
+*/
+
+/*! \class QFlatHash::iterator
+    \inmodule QtCore
+    \brief The QFlatHash::iterator class provides an STL-style non-const iterator for QFlatHash.
+
+    QFlatHash<Key, T>::iterator allows you to iterate over a QFlatHash
+    and to modify the value (but not the key) associated with each
+    item. If you want to iterate over a const QFlatHash, you should use
+    QFlatHash::const_iterator.
+
+    The usual QHash::iterator idioms apply. Iterators are invalidated
+    when an item is inserted into the hash, but erase() can be used to
+    remove items while iterating.
+
+    \sa QFlatHash::const_iterator
+*/
+
+/*! \class QFlatHash::const_iterator
+    \inmodule QtCore
+    \brief The QFlatHash::const_iterator class provides an STL-style const iterator for QFlatHash.
+
+    QFlatHash<Key, T>::const_iterator allows you to iterate over a
+    QFlatHash. If you want to modify the QFlatHash as you iterate
+    over it, you must use QFlatHash::iterator instead.
+
+    \sa QFlatHash::iterator
+*/
+
+/*! \fn QFlatHash::iterator::iterator()
+
+    Constructs an uninitialized iterator.
+
+    Functions like key(), value(), and operator++() must not be
+    called on an uninitialized iterator. Use operator=() to assign a
+    value to it before using it.
+
+    \sa QFlatHash::begin(), QFlatHash::end()
+*/
+
+/*! \fn QFlatHash::const_iterator::const_iterator()
+
+    Constructs an uninitialized iterator.
+
+    \sa QFlatHash::constBegin(), QFlatHash::constEnd()
+*/
+
+/*! \fn QFlatHash::const_iterator::const_iterator(const iterator &other)
+
+    Constructs a copy of \a other.
+*/
+
+/*! \fn const Key &QFlatHash::iterator::key() const
+    \fn const Key &QFlatHash::const_iterator::key() const
+
+    Returns the current item's key.
+
+    \sa value()
+*/
+
+/*! \fn T &QFlatHash::iterator::value() const
+
+    Returns a modifiable reference to the current item's value.
+
+    \sa key(), operator*()
+*/
+
+/*! \fn const T &QFlatHash::const_iterator::value() const
+
+    Returns the current item's value.
+
+    \sa key(), operator*()
+*/
+
+/*! \fn T &QFlatHash::iterator::operator*() const
+    \fn const T &QFlatHash::const_iterator::operator*() const
+
+    Returns the current item's value.
+
+    Same as value().
+
+    \sa key()
+*/
+
+/*! \fn T *QFlatHash::iterator::operator->() const
+    \fn const T *QFlatHash::const_iterator::operator->() const
+
+    Returns a pointer to the current item's value.
+
+    \sa value()
+*/
+
+/*!
+    \fn bool QFlatHash::iterator::operator==(const iterator &other) const
+    \fn bool QFlatHash::iterator::operator==(const const_iterator &other) const
+    \fn bool QFlatHash::const_iterator::operator==(const const_iterator &other) const
+
+    Returns true if \a other points to the same item as this
+    iterator; otherwise returns false.
+
+    \sa operator!=()
+*/
+
+/*!
+    \fn bool QFlatHash::iterator::operator!=(const iterator &other) const
+    \fn bool QFlatHash::iterator::operator!=(const const_iterator &other) const
+    \fn bool QFlatHash::const_iterator::operator!=(const const_iterator &other) const
+
+    Returns true if \a other points to a different item than this
+    iterator; otherwise returns false.
+
+    \sa operator==()
+*/
+
+/*!
+    \fn QFlatHash::iterator &QFlatHash::iterator::operator++()
+    \fn QFlatHash::const_iterator &QFlatHash::const_iterator::operator++()
+
+    The prefix ++ operator (\c{++i}) advances the iterator to the
+    next item in the hash and returns an iterator to the new current
+    item.
+
+    Calling this function on end() leads to undefined results.
+
+    \sa operator--()
+*/
+
+/*!
+    \fn QFlatHash::iterator QFlatHash::iterator::operator++(int)
+    \fn QFlatHash::const_iterator QFlatHash::const_iterator::operator++(int)
+    \overload
+
+    The postfix ++ operator (\c{i++}) advances the iterator to the
+    next item in the hash and returns an iterator to the previously
+    current item.
+*/
+
+/*!
+    \fn QFlatHash::iterator &QFlatHash::iterator::operator--()
+    \fn QFlatHash::const_iterator &QFlatHash::const_iterator::operator--()
+
+    The prefix -- operator (\c{--i}) makes the preceding item
+    current and returns an iterator pointing to the new current item.
+
+    Calling this function on begin() leads to undefined results.
+
+    \sa operator++()
+*/
+
+/*!
+    \fn QFlatHash::iterator QFlatHash::iterator::operator--(int)
+    \fn QFlatHash::const_iterator QFlatHash::const_iterator::operator--(int)
+    \overload
+
+    The postfix -- operator (\c{i--}) makes the preceding item
+    current and returns an iterator pointing to the previously
+    current item.
+*/
+
+QT_END_NAMESPACE
@@ -0,0 +1,696 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFLATHASH_H
+#define QFLATHASH_H
+
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qrefcount.h>
+
+#include <new>
+#include <string.h>
+
+QT_BEGIN_HEADER
+
+QT_BEGIN_NAMESPACE
+
+struct Q_CORE_EXPORT QFlatHashData
+{
+    // control byte of a bucket; full buckets store the low 7 bits of the
+    // hash value, so that most mismatches are rejected without touching
+    // the nodes at all
+    enum {
+        Empty = 0x80,
+        Deleted = 0xfe,
+        MinNumBuckets = 8
+    };
+
+    QtPrivate::RefCount ref;
+    int size;       // full buckets
+    int used;       // full and deleted buckets
+    int numBuckets; // power of two, 0 for shared_null
+    int numBits;
+    uint seed;
+
+    // numBuckets control bytes follow the header, the node array follows
+    // the control bytes at nodeOffset()
+
+    inline uchar *control() { return reinterpret_cast<uchar *>(this + 1); }
+    inline const uchar *control() const { return reinterpret_cast<const uchar *>(this + 1); }
+
+    static inline int maxUsed(int numBuckets) { return numBuckets - numBuckets / 8; }
+    static int bucketsForSize(int size);
+
+    static QFlatHashData *allocate(int numBuckets, int nodeSize, int nodeAlign);
+    static void deallocate(QFlatHashData *data, int nodeAlign);
+
+    static inline int nodeOffset(int numBuckets, int nodeAlign)
+    { return (int(sizeof(QFlatHashData)) + numBuckets + nodeAlign - 1) & ~(nodeAlign - 1); }
+
+    static const QFlatHashData shared_null;
+};
+
+template <class Key, class T>
+struct QFlatHashNode
+{
+    Key key;
+    T value;
+
+    inline QFlatHashNode(const Key &key0, const T &value0) : key(key0), value(value0) { }
+};
+
+template <class Key, class T>
+class QFlatHash
+{
+    typedef QFlatHashNode<Key, T> Node;
+
+    QFlatHashData *d;
+
+    static inline int alignOfNode() { return qMax<int>(sizeof(void*), Q_ALIGNOF(Node)); }
+    static inline Node *nodes(QFlatHashData *data)
+    {
+        return reinterpret_cast<Node *>(reinterpret_cast<char *>(data)
+                                        + QFlatHashData::nodeOffset(data->numBuckets, alignOfNode()));
+    }
+    static inline int nextFull(const QFlatHashData *data, int i)
+    {
+        const uchar *control = data->control();
+        while (++i < data->numBuckets && control[i] & QFlatHashData::Empty) { }
+        return i;
+    }
+    static inline int previousFull(const QFlatHashData *data, int i)
+    {
+        const uchar *control = data->control();
+        while (--i > 0 && control[i] & QFlatHashData::Empty) { }
+        return i;
+    }
+
+public:
+    inline QFlatHash() : d(const_cast<QFlatHashData *>(&QFlatHashData::shared_null)) { }
+    QFlatHash(const QFlatHash<Key, T> &other) : d(other.d) { if (!d->ref.ref()) d = copyData(other.d); }
+    inline ~QFlatHash() { if (!d->ref.deref()) freeData(d); }
+
+    QFlatHash<Key, T> &operator=(const QFlatHash<Key, T> &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    inline QFlatHash(QFlatHash<Key, T> &&other) : d(other.d)
+    { other.d = const_cast<QFlatHashData *>(&QFlatHashData::shared_null); }
+    inline QFlatHash<Key, T> &operator=(QFlatHash<Key, T> &&other)
+    { qSwap(d, other.d); return *this; }
+#endif
+    inline void swap(QFlatHash<Key, T> &other) { qSwap(d, other.d); }
+
+    bool operator==(const QFlatHash<Key, T> &other) const;
+    inline bool operator!=(const QFlatHash<Key, T> &other) const { return !(*this == other); }
+
+    inline int size() const { return d->size; }
+    inline int count() const { return d->size; }
+    inline bool isEmpty() const { return d->size == 0; }
+
+    inline int capacity() const { return QFlatHashData::maxUsed(d->numBuckets); }
+    void reserve(int size);
+    void squeeze();
+
+    inline void detach() { if (d->ref.isShared()) detach_helper(); }
+    inline bool isDetached() const { return !d->ref.isShared(); }
+    void setSharable(bool sharable);
+    inline bool isSharedWith(const QFlatHash<Key, T> &other) const { return d == other.d; }
+
+    void clear();
+
+    int remove(const Key &key);
+    T take(const Key &key);
+
+    bool contains(const Key &key) const;
+    const Key key(const T &value) const;
+    const Key key(const T &value, const Key &defaultKey) const;
+    const T value(const Key &key) const;
+    const T value(const Key &key, const T &defaultValue) const;
+    T &operator[](const Key &key);
+    const T operator[](const Key &key) const;
+
+    QList<Key> keys() const;
+    QList<T> values() const;
+    inline int count(const Key &key) const { return contains(key) ? 1 : 0; }
+
+    class const_iterator;
+
+    class iterator
+    {
+        friend class const_iterator;
+        friend class QFlatHash<Key, T>;
+        QFlatHashData *d;
+        int i;
+
+        inline iterator(QFlatHashData *data, int index) : d(data), i(index) { }
+        inline Node *node() const { return nodes(d) + i; }
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef T *pointer;
+        typedef T &reference;
+
+        inline iterator() : d(0), i(0) { }
+
+        inline const Key &key() const { return node()->key; }
+        inline T &value() const { return node()->value; }
+        inline T &operator*() const { return node()->value; }
+        inline T *operator->() const { return &node()->value; }
+        inline bool operator==(const iterator &o) const { return i == o.i && d == o.d; }
+        inline bool operator!=(const iterator &o) const { return !(*this == o); }
+
+        inline iterator &operator++() { i = nextFull(d, i); return *this; }
+        inline iterator operator++(int) { iterator r = *this; i = nextFull(d, i); return r; }
+        inline iterator &operator--() { i = previousFull(d, i); return *this; }
+        inline iterator operator--(int) { iterator r = *this; i = previousFull(d, i); return r; }
+
+#ifndef QT_STRICT_ITERATORS
+    public:
+        inline bool operator==(const const_iterator &o) const { return i == o.i && d == o.d; }
+        inline bool operator!=(const const_iterator &o) const { return !(*this == o); }
+#endif
+    };
+    friend class iterator;
+
+    class const_iterator
+    {
+        friend class iterator;
+        friend class QFlatHash<Key, T>;
+        QFlatHashData *d;
+        int i;
+
+        inline const_iterator(const QFlatHashData *data, int index)
+            : d(const_cast<QFlatHashData *>(data)), i(index) { }
+        inline const Node *node() const { return nodes(d) + i; }
+
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef qptrdiff difference_type;
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        inline const_iterator() : d(0), i(0) { }
+#ifdef QT_STRICT_ITERATORS
+        explicit inline const_iterator(const iterator &o)
+#else
+        inline const_iterator(const iterator &o)
+#endif
+            : d(o.d), i(o.i) { }
+
+        inline const Key &key() const { return node()->key; }
+        inline const T &value() const { return node()->value; }
+        inline const T &operator*() const { return node()->value; }
+        inline const T *operator->() const { return &node()->value; }
+        inline bool operator==(const const_iterator &o) const { return i == o.i && d == o.d; }
+        inline bool operator!=(const const_iterator &o) const { return !(*this == o); }
+
+        inline const_iterator &operator++() { i = nextFull(d, i); return *this; }
+        inline const_iterator operator++(int) { const_iterator r = *this; i = nextFull(d, i); return r; }
+        inline const_iterator &operator--() { i = previousFull(d, i); return *this; }
+        inline const_iterator operator--(int) { const_iterator r = *this; i = previousFull(d, i); return r; }
+    };
+    friend class const_iterator;
+
+    // STL style
+    inline iterator begin() { detach(); return iterator(d, nextFull(d, -1)); }
+    inline const_iterator begin() const { return const_iterator(d, nextFull(d, -1)); }
+    inline const_iterator cbegin() const { return const_iterator(d, nextFull(d, -1)); }
+    inline const_iterator constBegin() const { return const_iterator(d, nextFull(d, -1)); }
+    inline iterator end() { detach(); return iterator(d, d->numBuckets); }
+    inline const_iterator end() const { return const_iterator(d, d->numBuckets); }
+    inline const_iterator cend() const { return const_iterator(d, d->numBuckets); }
+    inline const_iterator constEnd() const { return const_iterator(d, d->numBuckets); }
+    iterator erase(iterator it);
+
+    // more Qt
+    typedef iterator Iterator;
+    typedef const_iterator ConstIterator;
+    iterator find(const Key &key);
+    const_iterator find(const Key &key) const;
+    const_iterator constFind(const Key &key) const;
+    iterator insert(const Key &key, const T &value);
+
+    // STL compatibility
+    typedef T mapped_type;
+    typedef Key key_type;
+    typedef qptrdiff difference_type;
+    typedef int size_type;
+
+    inline bool empty() const { return isEmpty(); }
+
+private:
+    void detach_helper();
+    static QFlatHashData *copyData(const QFlatHashData *data);
+    static void freeData(QFlatHashData *data);
+    void reallocData(int numBuckets);
+    inline void grow();
+    inline int createNode(uint h, const Key &key, const T &value);
+    inline uint hashOf(const Key &key) const;
+    int findBucket(const Key &key, uint h) const;
+    int insertBucket(uint h);
+    void removeBucket(int i);
+};
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE uint QFlatHash<Key, T>::hashOf(const Key &akey) const
+{
+    // qHash() is frequently the identity for integral keys; spread the bits
+    // so that the upper ones, which select the bucket, are well mixed
+    return qHash(akey, d->seed) * 2654435769U;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::findBucket(const Key &akey, uint h) const
+{
+    if (d->size == 0)
+        return -1;
+
+    const uchar *control = d->control();
+    const Node *n = nodes(d);
+    const uint mask = d->numBuckets - 1;
+    const uchar tag = h & 0x7f;
+    uint i = h >> (32 - d->numBits);
+    forever {
+        const uchar c = control[i];
+        if (c == tag && n[i].key == akey)
+            return i;
+        if (c == QFlatHashData::Empty)
+            return -1;
+        i = (i + 1) & mask;
+    }
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::insertBucket(uint h)
+{
+    // the caller has made sure that the key is not present and that
+    // there is room for one more bucket
+    uchar *control = d->control();
+    const uint mask = d->numBuckets - 1;
+    uint i = h >> (32 - d->numBits);
+    while (!(control[i] & QFlatHashData::Empty))
+        i = (i + 1) & mask;
+    if (control[i] == QFlatHashData::Empty)
+        ++d->used;
+    control[i] = h & 0x7f;
+    ++d->size;
+    return i;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::removeBucket(int i)
+{
+    uchar *control = d->control();
+    if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex)
+        (nodes(d) + i)->~Node();
+    // a probe sequence never continues past an empty bucket, so there is
+    // no need for a tombstone if the next bucket is empty
+    if (control[(i + 1) & (d->numBuckets - 1)] == QFlatHashData::Empty) {
+        control[i] = QFlatHashData::Empty;
+        --d->used;
+    } else {
+        control[i] = QFlatHashData::Deleted;
+    }
+    --d->size;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::freeData(QFlatHashData *x)
+{
+    if (QTypeInfo<Key>::isComplex || QTypeInfo<T>::isComplex) {
+        const uchar *control = x->control();
+        Node *n = nodes(x);
+        for (int i = 0; i < x->numBuckets; ++i) {
+            if (!(control[i] & QFlatHashData::Empty))
+                n[i].~Node();
+        }
+    }
+    QFlatHashData::deallocate(x, alignOfNode());
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reallocData(int numBuckets)
+{
+    QFlatHashData *x = QFlatHashData::allocate(numBuckets, sizeof(Node), alignOfNode());
+    if (d != &QFlatHashData::shared_null)
+        x->seed = d->seed;
+
+    const bool shared = d->ref.isShared();
+    const uchar *control = d->control();
+    uchar *xcontrol = x->control();
+    Node *n = nodes(d);
+    Node *xn = nodes(x);
+    const uint mask = numBuckets - 1;
+    for (int i = 0; i < d->numBuckets; ++i) {
+        if (control[i] & QFlatHashData::Empty)
+            continue;
+        const uint h = qHash(n[i].key, x->seed) * 2654435769U;
+        uint j = h >> (32 - x->numBits);
+        while (xcontrol[j] != QFlatHashData::Empty)
+            j = (j + 1) & mask;
+        xcontrol[j] = control[i];
+        if (shared) {
+            new (xn + j) Node(n[i]);
+        } else if (QTypeInfo<Key>::isStatic || QTypeInfo<T>::isStatic) {
+            new (xn + j) Node(n[i]);
+            n[i].~Node();
+        } else {
+            ::memcpy(static_cast<void *>(xn + j), static_cast<const void *>(n + i), sizeof(Node));
+        }
+    }
+    x->size = d->size;
+    x->used = d->size;
+    if (!d->ref.isSharable())
+        x->ref.setSharable(false);
+
+    if (shared) {
+        if (!d->ref.deref())
+            freeData(d);
+    } else {
+        QFlatHashData::deallocate(d, alignOfNode());
+    }
+    d = x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QFlatHashData *QFlatHash<Key, T>::copyData(const QFlatHashData *data)
+{
+    if (data->numBuckets == 0)
+        return QFlatHashData::allocate(QFlatHashData::MinNumBuckets, sizeof(Node), alignOfNode());
+
+    // keep the layout, so that the copy iterates in the same order
+    QFlatHashData *x = QFlatHashData::allocate(data->numBuckets, sizeof(Node), alignOfNode());
+    x->seed = data->seed;
+    x->size = data->size;
+    x->used = data->used;
+    ::memcpy(x->control(), data->control(), data->numBuckets);
+    const uchar *control = data->control();
+    Node *n = nodes(const_cast<QFlatHashData *>(data));
+    Node *xn = nodes(x);
+    for (int i = 0; i < data->numBuckets; ++i) {
+        if (!(control[i] & QFlatHashData::Empty))
+            new (xn + i) Node(n[i]);
+    }
+    return x;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::detach_helper()
+{
+    QFlatHashData *x = copyData(d);
+    if (!d->ref.deref())
+        freeData(d);
+    d = x;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::grow()
+{
+    if (d->used < QFlatHashData::maxUsed(d->numBuckets))
+        return;
+    // double the table if it is filled with live nodes, otherwise just
+    // get rid of the tombstones
+    if (d->size >= QFlatHashData::maxUsed(d->numBuckets) / 2)
+        reallocData(d->numBuckets * 2);
+    else
+        reallocData(d->numBuckets);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE int QFlatHash<Key, T>::createNode(uint h, const Key &akey, const T &avalue)
+{
+    if (d->used >= QFlatHashData::maxUsed(d->numBuckets)) {
+        // akey and avalue may refer into the table that grow() frees
+        const Node node(akey, avalue);
+        grow();
+        int i = insertBucket(h);
+        new (nodes(d) + i) Node(node);
+        return i;
+    }
+    int i = insertBucket(h);
+    new (nodes(d) + i) Node(akey, avalue);
+    return i;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE QFlatHash<Key, T> &QFlatHash<Key, T>::operator=(const QFlatHash<Key, T> &other)
+{
+    if (d != other.d) {
+        QFlatHashData *o = other.d;
+        if (!o->ref.ref()) {
+            QFlatHash<Key, T> copy(other);
+            swap(copy);
+            return *this;
+        }
+        if (!d->ref.deref())
+            freeData(d);
+        d = o;
+    }
+    return *this;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE bool QFlatHash<Key, T>::operator==(const QFlatHash<Key, T> &other) const
+{
+    if (size() != other.size())
+        return false;
+    if (d == other.d)
+        return true;
+
+    for (const_iterator it = constBegin(); it != constEnd(); ++it) {
+        const_iterator oit = other.constFind(it.key());
+        if (oit == other.constEnd() || !(oit.value() == it.value()))
+            return false;
+    }
+    return true;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::reserve(int asize)
+{
+    const int numBuckets = QFlatHashData::bucketsForSize(asize);
+    if (numBuckets > d->numBuckets)
+        reallocData(numBuckets);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::squeeze()
+{
+    if (d->size == 0) {
+        clear();
+        return;
+    }
+    const int numBuckets = QFlatHashData::bucketsForSize(d->size);
+    if (numBuckets < d->numBuckets || d->used > d->size)
+        reallocData(numBuckets);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE void QFlatHash<Key, T>::setSharable(bool sharable)
+{
+    if (!sharable)
+        detach();
+    if (d != &QFlatHashData::shared_null)
+        d->ref.setSharable(sharable);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE void QFlatHash<Key, T>::clear()
+{
+    *this = QFlatHash<Key, T>();
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE int QFlatHash<Key, T>::remove(const Key &akey)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return 0;
+    int i = findBucket(akey, hashOf(akey));
+    if (i < 0)
+        return 0;
+    detach();
+    removeBucket(i);
+    return 1;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE T QFlatHash<Key, T>::take(const Key &akey)
+{
+    if (isEmpty()) // prevents detaching shared null
+        return T();
+    int i = findBucket(akey, hashOf(akey));
+    if (i < 0)
+        return T();
+    detach();
+    T t = nodes(d)[i].value;
+    removeBucket(i);
+    return t;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE bool QFlatHash<Key, T>::contains(const Key &akey) const
+{
+    return findBucket(akey, hashOf(akey)) >= 0;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue) const
+{
+    return key(avalue, Key());
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE const Key QFlatHash<Key, T>::key(const T &avalue, const Key &defaultValue) const
+{
+    for (const_iterator it = constBegin(); it != constEnd(); ++it) {
+        if (it.value() == avalue)
+            return it.key();
+    }
+    return defaultValue;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey) const
+{
+    int i = findBucket(akey, hashOf(akey));
+    return i < 0 ? T() : nodes(d)[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::value(const Key &akey, const T &adefaultValue) const
+{
+    int i = findBucket(akey, hashOf(akey));
+    return i < 0 ? adefaultValue : nodes(d)[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE T &QFlatHash<Key, T>::operator[](const Key &akey)
+{
+    detach();
+    uint h = hashOf(akey);
+    int i = findBucket(akey, h);
+    if (i < 0)
+        i = createNode(h, akey, T());
+    return nodes(d)[i].value;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE const T QFlatHash<Key, T>::operator[](const Key &akey) const
+{
+    return value(akey);
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<Key> QFlatHash<Key, T>::keys() const
+{
+    QList<Key> res;
+    res.reserve(size());
+    for (const_iterator it = constBegin(); it != constEnd(); ++it)
+        res.append(it.key());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE QList<T> QFlatHash<Key, T>::values() const
+{
+    QList<T> res;
+    res.reserve(size());
+    for (const_iterator it = constBegin(); it != constEnd(); ++it)
+        res.append(it.value());
+    return res;
+}
+
+template <class Key, class T>
+Q_OUTOFLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::erase(iterator it)
+{
+    if (it == iterator(d, d->numBuckets))
+        return it;
+    Q_ASSERT_X(it.d == d, "QFlatHash::erase", "iterator does not belong to this hash");
+    Q_ASSERT(isDetached());
+    iterator ret = it;
+    ++ret;
+    removeBucket(it.i);
+    return ret;
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::find(const Key &akey)
+{
+    detach();
+    int i = findBucket(akey, hashOf(akey));
+    return iterator(d, i < 0 ? d->numBuckets : i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::find(const Key &akey) const
+{
+    return constFind(akey);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::const_iterator QFlatHash<Key, T>::constFind(const Key &akey) const
+{
+    int i = findBucket(akey, hashOf(akey));
+    return const_iterator(d, i < 0 ? d->numBuckets : i);
+}
+
+template <class Key, class T>
+Q_INLINE_TEMPLATE typename QFlatHash<Key, T>::iterator QFlatHash<Key, T>::insert(const Key &akey, const T &avalue)
+{
+    detach();
+    uint h = hashOf(akey);
+    int i = findBucket(akey, h);
+    if (i < 0) {
+        i = createNode(h, akey, avalue);
+    } else {
+        nodes(d)[i].value = avalue;
+    }
+    return iterator(d, i);
+}
+
+QT_END_NAMESPACE
+
+QT_END_HEADER
+
+#endif // QFLATHASH_H
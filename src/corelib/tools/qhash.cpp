@@ -60,6 +60,9 @@
 #include <qbytearray.h>
 #include <qdatetime.h>
 #include <qbasicatomic.h>
+#include <qendian.h>
+#include <qvarlengtharray.h>
+#include <private/qsimd_p.h>
 
 #ifndef QT_BOOTSTRAPPED
 #include <qcoreapplication.h>
@@ -71,48 +74,120 @@
 #endif // Q_OS_UNIX
 
 #include <limits.h>
+#include <string.h>
 
 QT_BEGIN_NAMESPACE
 
-/*
-    The Java's hashing algorithm for strings is a variation of D. J. Bernstein
-    hashing algorithm appeared here http://cr.yp.to/cdb/cdb.txt
-    and informally known as DJB33XX - DJB's 33 Times Xor.
-    Java uses DJB31XA, that is, 31 Times Add.
+#if defined(QT_COMPILER_SUPPORTS_SSE4_2) && !defined(QT_BOOTSTRAPPED)
+// in qhash_sse4_2.cpp
+extern uint qt_hash_crc32(const uchar *p, int len, uint seed);
+#endif
 
-    The original algorithm was a loop around
-        (h << 5) + h ^ c
-    (which is indeed h*33 ^ c); it was then changed to
-        (h << 5) - h ^ c
-    (so h*31^c: DJB31XX), and the XOR changed to a sum:
-        (h << 5) - h + c
-    (DJB31XA), which can save some assembly instructions.
+static bool qt_keyed_hash_enabled() Q_DECL_NOTHROW;
+static uint qt_keyed_hash(const uchar *p, int len, uint seed) Q_DECL_NOTHROW;
 
-    Still, we can avoid writing the multiplication as "(h << 5) - h"
-    -- the compiler will turn it into a shift and an addition anyway
-    (for instance, gcc 4.4 does that even at -O0).
-*/
+static inline uint rotateLeft(uint x, int n) Q_DECL_NOTHROW
+{
+    return (x << n) | (x >> (32 - n));
+}
 
-static inline uint hash(const uchar *p, int len, uint seed) Q_DECL_NOTHROW
+/*
+    The portable hash function is MurmurHash3 (x86, 32-bit) by Austin
+    Appleby, which is in the public domain. It processes four bytes at a
+    time, and mixes all of them into the result, unlike the DJB31XA
+    function ("h = 31 * h + c") used before, which is slow for long keys
+    and distributes keys that differ only at the end poorly.
+*/
+static uint murmurHash(const uchar *p, int len, uint seed) Q_DECL_NOTHROW
 {
+    const uint c1 = 0xcc9e2d51;
+    const uint c2 = 0x1b873593;
+
     uint h = seed;
+    const uchar *end = p + (len & ~3);
+    for ( ; p != end; p += 4) {
+        uint k;
+        memcpy(&k, p, sizeof(k));
+        k *= c1;
+        k = rotateLeft(k, 15);
+        k *= c2;
+
+        h ^= k;
+        h = rotateLeft(h, 13);
+        h = h * 5 + 0xe6546b64;
+    }
 
-    for (int i = 0; i < len; ++i)
-        h = 31 * h + p[i];
+    uint k = 0;
+    switch (len & 3) {
+    case 3:
+        k ^= uint(p[2]) << 16;
+        // fall through
+    case 2:
+        k ^= uint(p[1]) << 8;
+        // fall through
+    case 1:
+        k ^= p[0];
+        k *= c1;
+        k = rotateLeft(k, 15);
+        k *= c2;
+        h ^= k;
+    }
 
+    h ^= uint(len);
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
     return h;
 }
 
-static inline uint hash(const QChar *p, int len, uint seed) Q_DECL_NOTHROW
+/*
+    The DJB31XA function ("h = 31 * h + c") that qHash() used before still
+    hashes keys with a zero seed, qHash()'s default. Such values are stored
+    outside of QHash, for instance as identifiers in configuration files,
+    so they must not depend on the processor or on the environment. Keys
+    are hashed by character, so that a QLatin1String hashes like the
+    QString with the same contents.
+*/
+static inline uint legacyHash(const uchar *p, int len) Q_DECL_NOTHROW
 {
-    uint h = seed;
+    uint h = 0;
+    for (int i = 0; i < len; ++i)
+        h = 31 * h + p[i];
+    return h;
+}
 
+static inline uint legacyHash(const QChar *p, int len) Q_DECL_NOTHROW
+{
+    uint h = 0;
     for (int i = 0; i < len; ++i)
         h = 31 * h + p[i].unicode();
-
     return h;
 }
 
+static inline uint hash(const uchar *p, int len, uint seed) Q_DECL_NOTHROW
+{
+    if (!seed)
+        return legacyHash(p, len);
+    if (len == 0) // empty keys hash to the seed, with any function
+        return seed;
+    if (Q_UNLIKELY(qt_keyed_hash_enabled()))
+        return qt_keyed_hash(p, len, seed);
+#if defined(QT_COMPILER_SUPPORTS_SSE4_2) && !defined(QT_BOOTSTRAPPED)
+    if (qCpuHasFeature(SSE4_2))
+        return qt_hash_crc32(p, len, seed);
+#endif
+    return murmurHash(p, len, seed);
+}
+
+static inline uint hash(const QChar *p, int len, uint seed) Q_DECL_NOTHROW
+{
+    if (!seed)
+        return legacyHash(p, len);
+    return hash(reinterpret_cast<const uchar *>(p), len * int(sizeof(QChar)), seed);
+}
+
 uint qHash(const QByteArray &key, uint seed) Q_DECL_NOTHROW
 {
     return hash(reinterpret_cast<const uchar *>(key.constData()), key.size(), seed);
@@ -143,7 +218,16 @@ uint qHash(const QBitArray &bitArray, uint seed) Q_DECL_NOTHROW
 
 uint qHash(QLatin1String key, uint seed) Q_DECL_NOTHROW
 {
-    return hash(reinterpret_cast<const uchar *>(key.data()), key.size(), seed);
+    const uchar *p = reinterpret_cast<const uchar *>(key.data());
+    const int len = key.size();
+    if (!seed)
+        return legacyHash(p, len);
+
+    // the word-at-a-time functions hash QStrings as UTF-16, hash the same
+    QVarLengthArray<QChar, 256> buffer(len);
+    for (int i = 0; i < len; ++i)
+        buffer[i] = QLatin1Char(p[i]);
+    return hash(buffer.constData(), len, seed);
 }
 
 /*!
@@ -223,14 +307,122 @@ Q_CORE_EXPORT QBasicAtomicInt qt_qhash_seed = Q_BASIC_ATOMIC_INITIALIZER(-1);
     qt_create_qhash_seed() might return different values,
     as long as in the end everyone uses the very same value.
 */
-static void qt_initialize_qhash_seed()
+void qt_initialize_qhash_seed()
 {
     if (qt_qhash_seed.load() == -1) {
         int x(qt_create_qhash_seed() & INT_MAX);
+        // a zero seed selects the legacy hash function; only use it when
+        // requested with QT_HASH_SEED
+        if (x == 0 && qgetenv("QT_HASH_SEED").isNull())
+            x = 1;
         qt_qhash_seed.testAndSetRelaxed(-1, x);
     }
 }
 
+/*
+    The hash functions above are fast, but the seed doesn't keep an
+    attacker from finding keys that collide for any seed. When the
+    environment variable QT_HASH_KEYED is set to a non-zero value, the
+    strings are hashed with SipHash-1-3 instead, keyed with a random 128-bit
+    key per process, which makes it infeasible to precompute collisions.
+
+    Both are decided on first use: all the hash values of a process must
+    come from the same function.
+*/
+struct QKeyedHashKey
+{
+    quint64 k0;
+    quint64 k1;
+};
+
+static QBasicAtomicInt qt_keyed_hash_state = Q_BASIC_ATOMIC_INITIALIZER(-1);
+static QBasicAtomicPointer<QKeyedHashKey> qt_keyed_hash_key = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+static bool qt_keyed_hash_enabled() Q_DECL_NOTHROW
+{
+    int state = qt_keyed_hash_state.load();
+    if (Q_LIKELY(state >= 0))
+        return state;
+
+    // racing threads all come to the same result
+    state = qgetenv("QT_HASH_KEYED").toInt() != 0;
+    qt_keyed_hash_state.store(state);
+    return state;
+}
+
+static const QKeyedHashKey *keyedHashKey() Q_DECL_NOTHROW
+{
+    QKeyedHashKey *key = qt_keyed_hash_key.loadAcquire();
+    if (Q_LIKELY(key))
+        return key;
+
+    // qt_create_qhash_seed() honors QT_HASH_SEED, for reproducible runs
+    key = new QKeyedHashKey;
+    key->k0 = quint64(qt_create_qhash_seed()) << 32 | qt_create_qhash_seed();
+    key->k1 = quint64(qt_create_qhash_seed()) << 32 | qt_create_qhash_seed();
+    if (!qt_keyed_hash_key.testAndSetOrdered(0, key)) {
+        delete key;
+        key = qt_keyed_hash_key.loadAcquire();
+    }
+    return key;
+}
+
+static inline quint64 rotateLeft64(quint64 x, int n) Q_DECL_NOTHROW
+{
+    return (x << n) | (x >> (64 - n));
+}
+
+#define SIPROUND \
+    do { \
+        v0 += v1; v1 = rotateLeft64(v1, 13); v1 ^= v0; v0 = rotateLeft64(v0, 32); \
+        v2 += v3; v3 = rotateLeft64(v3, 16); v3 ^= v2; \
+        v0 += v3; v3 = rotateLeft64(v3, 21); v3 ^= v0; \
+        v2 += v1; v1 = rotateLeft64(v1, 17); v1 ^= v2; v2 = rotateLeft64(v2, 32); \
+    } while (0)
+
+static uint qt_keyed_hash(const uchar *p, int len, uint seed) Q_DECL_NOTHROW
+{
+    const QKeyedHashKey *key = keyedHashKey();
+    const quint64 k0 = key->k0 ^ seed;
+    const quint64 k1 = key->k1;
+
+    quint64 v0 = k0 ^ Q_UINT64_C(0x736f6d6570736575);
+    quint64 v1 = k1 ^ Q_UINT64_C(0x646f72616e646f6d);
+    quint64 v2 = k0 ^ Q_UINT64_C(0x6c7967656e657261);
+    quint64 v3 = k1 ^ Q_UINT64_C(0x7465646279746573);
+
+    const uchar *end = p + (len & ~7);
+    for ( ; p != end; p += 8) {
+        const quint64 m = qFromLittleEndian<quint64>(p);
+        v3 ^= m;
+        SIPROUND;
+        v0 ^= m;
+    }
+
+    quint64 b = quint64(len) << 56;
+    switch (len & 7) {
+    case 7: b |= quint64(p[6]) << 48; // fall through
+    case 6: b |= quint64(p[5]) << 40; // fall through
+    case 5: b |= quint64(p[4]) << 32; // fall through
+    case 4: b |= quint64(p[3]) << 24; // fall through
+    case 3: b |= quint64(p[2]) << 16; // fall through
+    case 2: b |= quint64(p[1]) << 8;  // fall through
+    case 1: b |= quint64(p[0]);
+    }
+    v3 ^= b;
+    SIPROUND;
+    v0 ^= b;
+
+    v2 ^= 0xff;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    b = v0 ^ v1 ^ v2 ^ v3;
+    return uint(b) ^ uint(b >> 32);
+}
+
+#undef SIPROUND
+
 /*!
     \internal
 
@@ -914,6 +1106,22 @@ void QHashData::checkSanity()
     variable \c QT_HASH_SEED. The contents of that variable, interpreted as a
     decimal value, will be used as the seed for qHash().
 
+    The seed makes the bucket of a key unpredictable, but the functions that
+    qHash() uses for strings and byte arrays are chosen for speed, and an
+    attacker may still find keys whose hash values collide for any seed.
+    Applications that store large numbers of externally supplied strings in
+    a QHash, such as network servers, can set the environment variable
+    \c QT_HASH_KEYED to \c 1. qHash() then hashes QString, QStringRef,
+    QLatin1String and QByteArray keys with SipHash, a keyed hash function
+    that uses a random 128-bit key generated once per process. This is
+    slower, especially for short keys. Both environment variables are read
+    once, before the first string is hashed.
+
+    qHash() called with a seed of 0, its default, always uses the same
+    function for strings and byte arrays, on every platform and in every
+    process. Such hash values can be stored, but they are slower to
+    compute and easier to make collide.
+
     \sa QHashIterator, QMutableHashIterator, QMap, QSet
 */
 
@@ -0,0 +1,84 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <private/qsimd_p.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+#ifdef QT_COMPILER_SUPPORTS_SSE4_2
+
+#ifndef __SSE4_2__
+#error "SSE4.2 not enabled in this file, cannot proceed"
+#endif
+
+// The CRC32 instruction of SSE 4.2 makes a good and very fast hash function;
+// called from qhash.cpp when the CPU supports it.
+uint qt_hash_crc32(const uchar *p, int len, uint seed)
+{
+    // start from the length, so that runs of zeroes of different lengths
+    // do not collide
+    uint h = seed ^ uint(len);
+    const uchar *e = p + len;
+
+#ifdef Q_PROCESSOR_X86_64
+    quint64 h64 = h;
+    for ( ; e - p >= 8; p += 8) {
+        quint64 v;
+        memcpy(&v, p, sizeof(v));
+        h64 = _mm_crc32_u64(h64, v);
+    }
+    h = uint(h64);
+#endif
+    for ( ; e - p >= 4; p += 4) {
+        uint v;
+        memcpy(&v, p, sizeof(v));
+        h = _mm_crc32_u32(h, v);
+    }
+    for ( ; p != e; ++p)
+        h = _mm_crc32_u8(h, *p);
+    return h;
+}
+
+#endif
+
+QT_END_NAMESPACE
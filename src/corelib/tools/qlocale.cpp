@@ -2582,99 +2582,29 @@ QString QLocalePrivate::doubleToString(const QChar _zero, const QChar plus, cons
 
     // Handle normal numbers
     if (!special_number) {
-        int decpt, sign;
-        QString digits;
-
-#ifdef QT_QLOCALE_USES_FCVT
-        // NOT thread safe!
-        if (form == DFDecimal) {
-            digits = QLatin1String(fcvt(d, precision, &decpt, &sign));
-        } else {
-            int pr = precision;
-            if (form == DFExponent)
-                ++pr;
-            else if (form == DFSignificantDigits && pr == 0)
-                pr = 1;
-            digits = QLatin1String(ecvt(d, pr, &decpt, &sign));
-
-            // Chop trailing zeros
-            if (digits.length() > 0) {
-                int last_nonzero_idx = digits.length() - 1;
-                while (last_nonzero_idx > 0
-                       && digits.unicode()[last_nonzero_idx] == QLatin1Char('0'))
-                    --last_nonzero_idx;
-                digits.truncate(last_nonzero_idx + 1);
-            }
-
-        }
-
-#else
-        int mode;
-        if (form == DFDecimal)
-            mode = 3;
-        else
-            mode = 2;
-
-        /* This next bit is a bit quirky. In DFExponent form, the precision
-           is the number of digits after decpt. So that would suggest using
-           mode=3 for qdtoa. But qdtoa behaves strangely when mode=3 and
-           precision=0. So we get around this by using mode=2 and reasoning
-           that we want precision+1 significant digits, since the decimal
-           point in this mode is always after the first digit. */
-        int pr = precision;
-        if (form == DFExponent)
-            ++pr;
-
-        char *rve = 0;
-        char *buff = 0;
-        QT_TRY {
-            digits = QLatin1String(qdtoa(d, mode, pr, &decpt, &sign, &rve, &buff));
-        } QT_CATCH(...) {
-            if (buff != 0)
-                free(buff);
-            QT_RETHROW;
-        }
-        if (buff != 0)
-            free(buff);
-#endif // QT_QLOCALE_USES_FCVT
-
-        if (_zero.unicode() != '0') {
-            ushort z = _zero.unicode() - '0';
-            for (int i = 0; i < digits.length(); ++i)
-                reinterpret_cast<ushort *>(digits.data())[i] += z;
-        }
-
-        bool always_show_decpt = (flags & Alternate || flags & ForcePoint);
-        switch (form) {
-            case DFExponent: {
-                num_str = exponentForm(_zero, decimal, exponential, group, plus, minus,
-                                       digits, decpt, precision, PMDecimalDigits,
-                                       always_show_decpt);
-                break;
-            }
-            case DFDecimal: {
-                num_str = decimalForm(_zero, decimal, group,
-                                      digits, decpt, precision, PMDecimalDigits,
-                                      always_show_decpt, flags & ThousandsGroup);
-                break;
-            }
-            case DFSignificantDigits: {
-                PrecisionMode mode = (flags & Alternate) ?
-                            PMSignificantDigits : PMChopTrailingZeros;
-
-                if (decpt != digits.length() && (decpt <= -4 || decpt > precision))
-                    num_str = exponentForm(_zero, decimal, exponential, group, plus, minus,
-                                           digits, decpt, precision, mode,
-                                           always_show_decpt);
-                else
-                    num_str = decimalForm(_zero, decimal, group,
-                                          digits, decpt, precision, mode,
-                                          always_show_decpt, flags & ThousandsGroup);
-                break;
-            }
+        CharBuff buf;
+        qt_doubleToAscii(d, form, precision, flags, &buf);
+
+        // replace the C locale's symbols with the ones of this locale
+        num_str.resize(buf.size());
+        QChar *out = num_str.data();
+        for (int i = 0; i < buf.size(); ++i) {
+            const char c = buf.at(i);
+            if (c >= '0' && c <= '9')
+                out[i] = _zero.unicode() + (c - '0');
+            else if (c == '.')
+                out[i] = decimal;
+            else if (c == ',')
+                out[i] = group;
+            else if (c == 'e')
+                out[i] = exponential;
+            else if (c == '+')
+                out[i] = plus;
+            else
+                out[i] = minus;
         }
 
-        negative = sign != 0 && !isZero(d);
+        negative = d < 0;
     }
 
     // pad with zeros. LeftAdjusted overrides this flag). Also, we don't
@@ -2885,12 +2815,12 @@ QString QLocalePrivate::unsLongLongToString(const QChar zero, const QChar group,
     number. We can't detect junk here, since we don't even know the base
     of the number.
 */
-bool QLocalePrivate::numberToCLocale(const QString &num,
-                                            GroupSeparatorMode group_sep_mode,
-                                            CharBuff *result) const
+bool QLocalePrivate::numberToCLocale(const QChar *str, int len,
+                                     GroupSeparatorMode group_sep_mode,
+                                     CharBuff *result) const
 {
-    const QChar *uc = num.unicode();
-    int l = num.length();
+    const QChar *uc = str;
+    int l = len;
     int idx = 0;
 
     // Skip whitespace
@@ -3032,12 +2962,26 @@ bool QLocalePrivate::validateChars(const QString &str, NumberMode numMode, QByte
     return true;
 }
 
-double QLocalePrivate::stringToDouble(const QString &number, bool *ok,
-                                        GroupSeparatorMode group_sep_mode) const
+// Leading and trailing white space is skipped by numberToCLocale(), but
+// it would mistake non-breaking spaces for group separators there.
+static inline void trimNonBreakingSpaces(QChar group, const QChar *&begin, int &len)
+{
+    if (group.unicode() != 0xa0)
+        return;
+    while (len > 0 && begin->isSpace()) {
+        ++begin;
+        --len;
+    }
+    while (len > 0 && begin[len - 1].isSpace())
+        --len;
+}
+
+double QLocalePrivate::stringToDouble(const QChar *begin, int len, bool *ok,
+                                      GroupSeparatorMode group_sep_mode) const
 {
     CharBuff buff;
-    if (!numberToCLocale(group().unicode() == 0xa0 ? number.trimmed() : number,
-                         group_sep_mode, &buff)) {
+    trimNonBreakingSpaces(group(), begin, len);
+    if (!numberToCLocale(begin, len, group_sep_mode, &buff)) {
         if (ok != 0)
             *ok = false;
         return 0.0;
@@ -3045,12 +2989,12 @@ double QLocalePrivate::stringToDouble(const QString &number, bool *ok,
     return bytearrayToDouble(buff.constData(), ok);
 }
 
-qlonglong QLocalePrivate::stringToLongLong(const QString &number, int base,
+qlonglong QLocalePrivate::stringToLongLong(const QChar *begin, int len, int base,
                                            bool *ok, GroupSeparatorMode group_sep_mode) const
 {
     CharBuff buff;
-    if (!numberToCLocale(group().unicode() == 0xa0 ? number.trimmed() : number,
-                         group_sep_mode, &buff)) {
+    trimNonBreakingSpaces(group(), begin, len);
+    if (!numberToCLocale(begin, len, group_sep_mode, &buff)) {
         if (ok != 0)
             *ok = false;
         return 0;
@@ -3059,12 +3003,12 @@ qlonglong QLocalePrivate::stringToLongLong(const QString &number, int base,
     return bytearrayToLongLong(buff.constData(), base, ok);
 }
 
-qulonglong QLocalePrivate::stringToUnsLongLong(const QString &number, int base,
+qulonglong QLocalePrivate::stringToUnsLongLong(const QChar *begin, int len, int base,
                                                bool *ok, GroupSeparatorMode group_sep_mode) const
 {
     CharBuff buff;
-    if (!numberToCLocale(group().unicode() == 0xa0 ? number.trimmed() : number,
-                         group_sep_mode, &buff)) {
+    trimNonBreakingSpaces(group(), begin, len);
+    if (!numberToCLocale(begin, len, group_sep_mode, &buff)) {
         if (ok != 0)
             *ok = false;
         return 0;
@@ -3087,6 +3031,11 @@ double QLocalePrivate::bytearrayToDouble(const char *num, bool *ok, bool *overfl
         return 0.0;
     }
 
+    // Plain decimal numbers usually don't need the bignum code at all
+    double fast;
+    if (qt_fastStrtod(num, &fast))
+        return fast;
+
     if (qstrcmp(num, "nan") == 0)
         return qt_snan();
 
@@ -307,9 +307,15 @@ public:
                                 int base = 10,
                                 int width = -1,
                                 unsigned flags = NoFlags) const;
-    double stringToDouble(const QString &num, bool *ok, GroupSeparatorMode group_sep_mode) const;
-    qint64 stringToLongLong(const QString &num, int base, bool *ok, GroupSeparatorMode group_sep_mode) const;
-    quint64 stringToUnsLongLong(const QString &num, int base, bool *ok, GroupSeparatorMode group_sep_mode) const;
+    double stringToDouble(const QChar *begin, int len, bool *ok, GroupSeparatorMode group_sep_mode) const;
+    qint64 stringToLongLong(const QChar *begin, int len, int base, bool *ok, GroupSeparatorMode group_sep_mode) const;
+    quint64 stringToUnsLongLong(const QChar *begin, int len, int base, bool *ok, GroupSeparatorMode group_sep_mode) const;
+    inline double stringToDouble(const QString &num, bool *ok, GroupSeparatorMode group_sep_mode) const
+    { return stringToDouble(num.constData(), num.size(), ok, group_sep_mode); }
+    inline qint64 stringToLongLong(const QString &num, int base, bool *ok, GroupSeparatorMode group_sep_mode) const
+    { return stringToLongLong(num.constData(), num.size(), base, ok, group_sep_mode); }
+    inline quint64 stringToUnsLongLong(const QString &num, int base, bool *ok, GroupSeparatorMode group_sep_mode) const
+    { return stringToUnsLongLong(num.constData(), num.size(), base, ok, group_sep_mode); }
 
 
     static double bytearrayToDouble(const char *num, bool *ok, bool *overflow = 0);
@@ -317,9 +323,9 @@ public:
     static quint64 bytearrayToUnsLongLong(const char *num, int base, bool *ok);
 
     typedef QVarLengthArray<char, 256> CharBuff;
-    bool numberToCLocale(const QString &num,
-    	    	    	  GroupSeparatorMode group_sep_mode,
-                          CharBuff *result) const;
+    bool numberToCLocale(const QChar *str, int len,
+                         GroupSeparatorMode group_sep_mode,
+                         CharBuff *result) const;
     inline char digitToCLocale(QChar c) const;
 
     static void updateSystemPrivate();
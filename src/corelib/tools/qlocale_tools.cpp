@@ -40,6 +40,7 @@
 ****************************************************************************/
 
 #include "qlocale_tools_p.h"
+#include "qlocale_powers_p.h"
 #include "qlocale_p.h"
 #include "qstring.h"
 
@@ -48,6 +49,7 @@
 #include <limits.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 #ifdef Q_OS_WINCE
@@ -113,75 +115,195 @@ QString qlltoa(qlonglong l, int base, const QChar zero)
     return qulltoa(l < 0 ? -l : l, base, zero);
 }
 
-QString &decimalForm(QChar zero, QChar decimal, QChar group,
-                     QString &digits, int decpt, uint precision,
-                     PrecisionMode pm,
-                     bool always_show_decpt,
-                     bool thousands_group)
+static void decimalForm(const char *digits, int length, int decpt, uint precision,
+                        PrecisionMode pm, bool always_show_decpt, bool thousands_group,
+                        QLocalePrivate::CharBuff *buf)
 {
+    // the digits are padded with leading and trailing zeros so that
+    // the decimal point falls inside of them
+    int leading = 0;
     if (decpt < 0) {
-        for (int i = 0; i < -decpt; ++i)
-            digits.prepend(zero);
+        leading = -decpt;
         decpt = 0;
     }
-    else if (decpt > digits.length()) {
-        for (int i = digits.length(); i < decpt; ++i)
-            digits.append(zero);
-    }
+    int total = qMax(leading + length, decpt);
 
     if (pm == PMDecimalDigits) {
-        uint decimal_digits = digits.length() - decpt;
-        for (uint i = decimal_digits; i < precision; ++i)
-            digits.append(zero);
-    }
-    else if (pm == PMSignificantDigits) {
-        for (uint i = digits.length(); i < precision; ++i)
-            digits.append(zero);
-    }
-    else { // pm == PMChopTrailingZeros
-    }
-
-    if (always_show_decpt || decpt < digits.length())
-        digits.insert(decpt, decimal);
-
-    if (thousands_group) {
-        for (int i = decpt - 3; i > 0; i -= 3)
-            digits.insert(i, group);
+        if (uint(total - decpt) < precision)
+            total = decpt + precision;
+    } else if (pm == PMSignificantDigits) {
+        if (uint(total) < precision)
+            total = precision;
+    } else { // pm == PMChopTrailingZeros
     }
 
     if (decpt == 0)
-        digits.prepend(zero);
-
-    return digits;
+        buf->append('0');
+    for (int i = 0; i < total; ++i) {
+        if (i == decpt)
+            buf->append('.');
+        else if (thousands_group && i > 0 && i < decpt && (decpt - i) % 3 == 0)
+            buf->append(',');
+        const int index = i - leading;
+        buf->append(index >= 0 && index < length ? digits[index] : '0');
+    }
+    if (always_show_decpt && decpt == total)
+        buf->append('.');
 }
 
-QString &exponentForm(QChar zero, QChar decimal, QChar exponential,
-                      QChar group, QChar plus, QChar minus,
-                      QString &digits, int decpt, uint precision,
-                      PrecisionMode pm,
-                      bool always_show_decpt)
+static void exponentForm(const char *digits, int length, int decpt, uint precision,
+                         PrecisionMode pm, bool always_show_decpt,
+                         QLocalePrivate::CharBuff *buf)
 {
     int exp = decpt - 1;
+    int total = length;
 
     if (pm == PMDecimalDigits) {
-        for (uint i = digits.length(); i < precision + 1; ++i)
-            digits.append(zero);
-    }
-    else if (pm == PMSignificantDigits) {
-        for (uint i = digits.length(); i < precision; ++i)
-            digits.append(zero);
+        if (uint(total) < precision + 1)
+            total = precision + 1;
+    } else if (pm == PMSignificantDigits) {
+        if (uint(total) < precision)
+            total = precision;
+    } else { // pm == PMChopTrailingZeros
+    }
+
+    buf->append(digits[0]);
+    if (always_show_decpt || total > 1)
+        buf->append('.');
+    for (int i = 1; i < total; ++i)
+        buf->append(i < length ? digits[i] : '0');
+
+    buf->append('e');
+    buf->append(exp < 0 ? '-' : '+');
+    if (exp < 0)
+        exp = -exp;
+    char exponent[12];
+    char *p = exponent + sizeof(exponent);
+    do {
+        *--p = '0' + exp % 10;
+        exp /= 10;
+    } while (exp != 0 || exponent + sizeof(exponent) - p < 2);
+    buf->append(p, exponent + sizeof(exponent) - p);
+}
+
+static void formDigits(const char *digits, int length, int decpt, int precision,
+                       QLocalePrivate::DoubleForm form, bool shortest, unsigned flags,
+                       QLocalePrivate::CharBuff *buf)
+{
+    bool always_show_decpt = (flags & QLocalePrivate::Alternate || flags & QLocalePrivate::ForcePoint);
+    switch (form) {
+        case QLocalePrivate::DFExponent: {
+            if (shortest)
+                precision = length - 1;
+            exponentForm(digits, length, decpt, precision, PMDecimalDigits,
+                         always_show_decpt, buf);
+            break;
+        }
+        case QLocalePrivate::DFDecimal: {
+            if (shortest)
+                precision = qMax(length - decpt, 0);
+            decimalForm(digits, length, decpt, precision, PMDecimalDigits,
+                        always_show_decpt, flags & QLocalePrivate::ThousandsGroup, buf);
+            break;
+        }
+        case QLocalePrivate::DFSignificantDigits: {
+            PrecisionMode mode = (flags & QLocalePrivate::Alternate) ?
+                        PMSignificantDigits : PMChopTrailingZeros;
+
+            // A shortest representation has at most 17 digits; use the
+            // exponent form where "%.17g" would.
+            int cutoff = precision;
+            if (shortest) {
+                precision = length;
+                cutoff = 17;
+            }
+
+            if (decpt != length && (decpt <= -4 || decpt > cutoff))
+                exponentForm(digits, length, decpt, precision, mode,
+                             always_show_decpt, buf);
+            else
+                decimalForm(digits, length, decpt, precision, mode,
+                            always_show_decpt, flags & QLocalePrivate::ThousandsGroup, buf);
+            break;
+        }
     }
-    else { // pm == PMChopTrailingZeros
+}
+
+/*
+    Appends the absolute value of the finite number \a d to \a buf, laid
+    out as QLocalePrivate::doubleToString() does with the C locale's
+    symbols: the digits '0' to '9', '.' as the decimal point, ',' between
+    digit groups and 'e' followed by '+' or '-' for the exponent. Only the
+    Alternate, ForcePoint and ThousandsGroup \a flags are used.
+*/
+void qt_doubleToAscii(double d, QLocalePrivate::DoubleForm form, int precision,
+                      unsigned flags, QLocalePrivate::CharBuff *buf)
+{
+    if (precision == -1)
+        precision = 6;
+    const bool shortest = precision == QLocale::FloatingPointShortest;
+
+    /* This next bit is a bit quirky. In DFExponent form, the precision
+       is the number of digits after decpt. So that would suggest using
+       mode=3 for qdtoa. But qdtoa behaves strangely when mode=3 and
+       precision=0. So we get around this by using mode=2 and reasoning
+       that we want precision+1 significant digits, since the decimal
+       point in this mode is always after the first digit. */
+    int mode;
+    int pr = precision;
+    if (shortest) {
+        mode = 0;
+        pr = 0;
+    } else if (form == QLocalePrivate::DFDecimal) {
+        mode = 3;
+    } else {
+        mode = 2;
+        if (form == QLocalePrivate::DFExponent)
+            ++pr;
     }
 
-    if (always_show_decpt || digits.length() > 1)
-        digits.insert(1, decimal);
+    int decpt, sign;
+    char fastDigits[FastDtoaBufferSize];
+    int fastLength;
+    if (qt_fastDtoa(d, mode, pr, fastDigits, &fastLength, &decpt)) {
+        formDigits(fastDigits, fastLength, decpt, precision, form, shortest, flags, buf);
+        return;
+    }
 
-    digits.append(exponential);
-    digits.append(QLocalePrivate::longLongToString(zero, group, plus, minus,
-                   exp, 2, 10, -1, QLocalePrivate::AlwaysShowSign));
+#ifdef QT_QLOCALE_USES_FCVT
+    // NOT thread safe!
+    const char *digits;
+    if (form == QLocalePrivate::DFDecimal && !shortest) {
+        digits = fcvt(d, precision, &decpt, &sign);
+    } else {
+        if (shortest)
+            pr = 17;
+        else if (form == QLocalePrivate::DFSignificantDigits && pr == 0)
+            pr = 1;
+        digits = ecvt(d, pr, &decpt, &sign);
+    }
+    int length = qstrlen(digits);
 
-    return digits;
+    // Chop trailing zeros
+    if (!(form == QLocalePrivate::DFDecimal && !shortest)) {
+        while (length > 1 && digits[length - 1] == '0')
+            --length;
+    }
+    formDigits(digits, length, decpt, precision, form, shortest, flags, buf);
+#else
+    char *rve = 0;
+    char *buff = 0;
+    QT_TRY {
+        const char *digits = qdtoa(d, mode, pr, &decpt, &sign, &rve, &buff);
+        formDigits(digits, qstrlen(digits), decpt, precision, form, shortest, flags, buf);
+    } QT_CATCH(...) {
+        if (buff != 0)
+            free(buff);
+        QT_RETHROW;
+    }
+    if (buff != 0)
+        free(buff);
+#endif // QT_QLOCALE_USES_FCVT
 }
 
 // Removes thousand-group separators in "C" locale.
@@ -472,6 +594,477 @@ qlonglong qstrtoll(const char *nptr, const char **endptr, register int base, boo
     return acc;
 }
 
+/*
+    Fast paths for the conversions between doubles and decimal strings.
+
+    qt_fastDtoa() implements Florian Loitsch's Grisu3 algorithm ("Printing
+    Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010)
+    for the shortest (0), significant digits (2) and fixed (3) modes of
+    qdtoa(). It only uses 64-bit integer arithmetic, and gives up on the
+    small fraction of inputs for which it cannot prove that its result is
+    the one qdtoa() would produce.
+
+    qt_fastStrtod() implements the Eisel-Lemire algorithm (Daniel Lemire,
+    "Number Parsing at a Gigabyte per Second", 2021) for plain decimal
+    numbers with up to 19 significant digits, and gives up on everything
+    else, including the rare inputs where a 128-bit approximation of the
+    power of ten is not precise enough to decide the rounding.
+
+    In both cases the caller falls back to the exact, but much slower,
+    bignum code below.
+*/
+
+static const quint64 DoubleSignMask = Q_UINT64_C(0x8000000000000000);
+static const quint64 DoubleExponentMask = Q_UINT64_C(0x7ff0000000000000);
+static const quint64 DoubleSignificandMask = Q_UINT64_C(0x000fffffffffffff);
+static const quint64 DoubleHiddenBit = Q_UINT64_C(0x0010000000000000);
+
+static inline quint64 doubleToBits(double d)
+{
+    quint64 bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+static inline double bitsToDouble(quint64 bits)
+{
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+// Returns the low 64 bits of a * b and stores the high 64 bits in *high
+static inline quint64 multiply128(quint64 a, quint64 b, quint64 *high)
+{
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    *high = quint64(r >> 64);
+    return quint64(r);
+#else
+    const quint64 aLo = a & 0xffffffff, aHi = a >> 32;
+    const quint64 bLo = b & 0xffffffff, bHi = b >> 32;
+    const quint64 loLo = aLo * bLo;
+    const quint64 hiLo = aHi * bLo;
+    const quint64 cross = (loLo >> 32) + (hiLo & 0xffffffff) + aLo * bHi;
+    *high = aHi * bHi + (hiLo >> 32) + (cross >> 32);
+    return (cross << 32) | (loLo & 0xffffffff);
+#endif
+}
+
+static inline int countLeadingZeroBits(quint64 v)
+{
+#if defined(Q_CC_GNU)
+    return __builtin_clzll(v);
+#else
+    int n = 0;
+    while (!(v & DoubleSignMask)) {
+        v <<= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// floor(q * log2(10)) for |q| < 1500
+static inline int floorLog2Pow10(int q)
+{
+    return (217706 * q) >> 16;
+}
+
+namespace {
+// A floating point number f * 2^e with a 64-bit significand
+struct DiyFp
+{
+    quint64 f;
+    int e;
+};
+}
+
+static inline DiyFp diyFpNormalize(DiyFp x)
+{
+    const int shift = countLeadingZeroBits(x.f);
+    x.f <<= shift;
+    x.e -= shift;
+    return x;
+}
+
+// The product rounded to 64 bits; the error is at most half a unit in the last place
+static inline DiyFp diyFpMultiply(DiyFp x, DiyFp y)
+{
+    quint64 high;
+    const quint64 low = multiply128(x.f, y.f, &high);
+    DiyFp r = { high + (low >> 63), x.e + y.e + 64 };
+    return r;
+}
+
+// The power of ten 10^q rounded to 64 bits, for q within the table
+static inline DiyFp cachedPowerOfTen(int q)
+{
+    const quint64 *entry = qt_powersOfFive + 2 * (q - PowersOfFiveMinExponent);
+    DiyFp r = { entry[0] + (entry[1] >> 63), floorLog2Pow10(q) - 63 };
+    return r;
+}
+
+// Stores the largest power of ten <= n in *power and returns its exponent plus one
+static inline int biggestPowerOfTen(quint32 n, quint32 *power)
+{
+    quint32 p = 1;
+    int exponentPlusOne = 1;
+    while (n / 10 >= p) {
+        p *= 10;
+        ++exponentPlusOne;
+    }
+    *power = p;
+    return exponentPlusOne;
+}
+
+/*
+    Moves the last digit of the shortest representation as close to the
+    scaled value w as possible, and decides whether the result is provably
+    correct. distanceTooHighW is the distance between w and the upper end of
+    the unsafe interval, rest the distance between the digits generated so
+    far and that upper end, tenKappa the weight of the last digit and unit
+    the error of the scaled values.
+*/
+static bool grisuRoundWeed(char *buffer, int length, quint64 distanceTooHighW,
+                           quint64 unsafeInterval, quint64 rest, quint64 tenKappa, quint64 unit)
+{
+    const quint64 smallDistance = distanceTooHighW - unit;
+    const quint64 bigDistance = distanceTooHighW + unit;
+
+    while (rest < smallDistance
+           && unsafeInterval - rest >= tenKappa
+           && (rest + tenKappa < smallDistance
+               || smallDistance - rest >= rest + tenKappa - smallDistance)) {
+        --buffer[length - 1];
+        rest += tenKappa;
+    }
+
+    // If the digits could be moved closer to the upper bound of w, we cannot
+    // tell which representation is the closest one.
+    if (rest < bigDistance
+        && unsafeInterval - rest >= tenKappa
+        && (rest + tenKappa < bigDistance
+            || bigDistance - rest > rest + tenKappa - bigDistance))
+        return false;
+
+    // The digits must be safely inside the unsafe interval.
+    return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+}
+
+// Generates the shortest digits of w, a value between low and high
+static bool grisuDigitGen(DiyFp low, DiyFp w, DiyFp high, char *buffer, int *length, int *kappa)
+{
+    quint64 unit = 1;
+    const quint64 tooLow = low.f - unit;
+    const quint64 tooHigh = high.f + unit;
+    quint64 unsafeInterval = tooHigh - tooLow;
+
+    const int shift = -w.e;
+    const quint64 one = quint64(1) << shift;
+    quint32 integrals = quint32(tooHigh >> shift);
+    quint64 fractionals = tooHigh & (one - 1);
+
+    quint32 divisor;
+    *kappa = biggestPowerOfTen(integrals, &divisor);
+    *length = 0;
+
+    while (*kappa > 0) {
+        buffer[(*length)++] = char('0' + integrals / divisor);
+        integrals %= divisor;
+        --*kappa;
+        const quint64 rest = (quint64(integrals) << shift) + fractionals;
+        if (rest < unsafeInterval)
+            return grisuRoundWeed(buffer, *length, tooHigh - w.f, unsafeInterval, rest,
+                                  quint64(divisor) << shift, unit);
+        divisor /= 10;
+    }
+
+    forever {
+        fractionals *= 10;
+        unit *= 10;
+        unsafeInterval *= 10;
+        buffer[(*length)++] = char('0' + (fractionals >> shift));
+        fractionals &= one - 1;
+        --*kappa;
+        if (fractionals < unsafeInterval)
+            return grisuRoundWeed(buffer, *length, (tooHigh - w.f) * unit, unsafeInterval,
+                                  fractionals, one, unit);
+    }
+}
+
+// Rounds the counted digits, returning false if the rounding direction is unclear
+static bool grisuRoundWeedCounted(char *buffer, int length, quint64 rest, quint64 tenKappa,
+                                  quint64 unit, int *kappa)
+{
+    if (unit >= tenKappa || tenKappa - unit <= unit)
+        return false;
+
+    // Round down
+    if (tenKappa - rest > rest && tenKappa - 2 * rest >= 2 * unit)
+        return true;
+
+    // Round up
+    if (rest > unit && tenKappa - (rest - unit) <= rest - unit) {
+        ++buffer[length - 1];
+        for (int i = length - 1; i > 0 && buffer[i] == '0' + 10; --i) {
+            buffer[i] = '0';
+            ++buffer[i - 1];
+        }
+        if (buffer[0] == '0' + 10) {
+            buffer[0] = '1';
+            ++*kappa;
+        }
+        return true;
+    }
+    return false;
+}
+
+/*
+    Generates \a requested digits of w. The caller has already computed the
+    integral part of w, the weight of its first digit and that digit's
+    position.
+*/
+static bool grisuDigitGenCounted(DiyFp w, quint32 integrals, quint32 divisor, int requested,
+                                 char *buffer, int *length, int *kappa)
+{
+    quint64 error = 1;
+    const int shift = -w.e;
+    const quint64 one = quint64(1) << shift;
+    quint64 fractionals = w.f & (one - 1);
+
+    *length = 0;
+    while (*kappa > 0) {
+        buffer[(*length)++] = char('0' + integrals / divisor);
+        integrals %= divisor;
+        --*kappa;
+        if (--requested == 0)
+            break;
+        divisor /= 10;
+    }
+
+    if (requested == 0) {
+        const quint64 rest = (quint64(integrals) << shift) + fractionals;
+        return grisuRoundWeedCounted(buffer, *length, rest, quint64(divisor) << shift, error, kappa);
+    }
+
+    while (requested > 0 && fractionals > error) {
+        fractionals *= 10;
+        error *= 10;
+        buffer[(*length)++] = char('0' + (fractionals >> shift));
+        fractionals &= one - 1;
+        --*kappa;
+        --requested;
+    }
+    if (requested != 0)
+        return false;
+    return grisuRoundWeedCounted(buffer, *length, fractionals, one, error, kappa);
+}
+
+/*
+    Converts \a d like qdtoa() does in \a mode 0, 2 or 3 with \a ndigits,
+    without the sign. On success, stores the digits (without trailing zeros)
+    in \a buffer, which must have room for FastDtoaBufferSize characters,
+    and their number in \a length, sets \a decpt like qdtoa() and returns
+    true. Returns false if the caller has to use qdtoa() instead.
+*/
+bool qt_fastDtoa(double d, int mode, int ndigits, char *buffer, int *length, int *decpt)
+{
+    const quint64 bits = doubleToBits(d) & ~DoubleSignMask;
+    if (bits == 0 || (bits & DoubleExponentMask) == DoubleExponentMask)
+        return false;
+
+    // v = f * 2^e exactly; denormals have no hidden bit
+    const int biasedExponent = int(bits >> 52);
+    DiyFp v;
+    if (biasedExponent == 0) {
+        v.f = bits & DoubleSignificandMask;
+        v.e = 1 - 1075;
+    } else {
+        v.f = (bits & DoubleSignificandMask) | DoubleHiddenBit;
+        v.e = biasedExponent - 1075;
+    }
+    const DiyFp w = diyFpNormalize(v);
+
+    // Scale w by a power of ten so that its exponent lies in [-60, -32].
+    // Then the integral part fits in 32 bits and the fractional part can be
+    // multiplied by 10 without overflowing.
+    int q = ((-61 - w.e) * 78913) >> 18;
+    while (w.e + 1 + floorLog2Pow10(q) < -60)
+        ++q;
+    while (w.e + 1 + floorLog2Pow10(q) > -32)
+        --q;
+    if (q < PowersOfFiveMinExponent || q > PowersOfFiveMaxExponent)
+        return false;
+    const DiyFp tenQ = cachedPowerOfTen(q);
+    const DiyFp scaledW = diyFpMultiply(w, tenQ);
+
+    int kappa;
+    if (mode == 0) {
+        // The boundaries halfway to the neighbouring doubles. The lower one
+        // is closer if v is a power of two (and not the smallest normal).
+        DiyFp plus = { (v.f << 1) + 1, v.e - 1 };
+        plus = diyFpNormalize(plus);
+        DiyFp minus;
+        if ((bits & DoubleSignificandMask) == 0 && biasedExponent > 1) {
+            minus.f = (v.f << 2) - 1;
+            minus.e = v.e - 2;
+        } else {
+            minus.f = (v.f << 1) - 1;
+            minus.e = v.e - 1;
+        }
+        minus.f <<= minus.e - plus.e;
+        minus.e = plus.e;
+
+        if (!grisuDigitGen(diyFpMultiply(minus, tenQ), scaledW, diyFpMultiply(plus, tenQ),
+                           buffer, length, &kappa))
+            return false;
+    } else {
+        const int shift = -scaledW.e;
+        const quint32 integrals = quint32(scaledW.f >> shift);
+        quint32 divisor;
+        kappa = biggestPowerOfTen(integrals, &divisor);
+
+        // kappa - q is the decimal point position of the result, unless
+        // rounding adds a digit in front.
+        int requested;
+        if (mode == 3)
+            requested = kappa - q + ndigits;
+        else
+            requested = qMax(ndigits, 1);
+        if (requested <= 0 || requested > FastDtoaBufferSize - 1)
+            return false;
+
+        if (!grisuDigitGenCounted(scaledW, integrals, divisor, requested, buffer, length, &kappa))
+            return false;
+    }
+
+    // buffer * 10^(kappa - q) is the result
+    *decpt = *length + kappa - q;
+    while (*length > 1 && buffer[*length - 1] == '0')
+        --*length;
+    buffer[*length] = '\0';
+    return true;
+}
+
+/*
+    Converts the number in \a num, which must consist of an optional sign,
+    digits with an optional decimal point and an optional exponent and
+    nothing else. On success, stores the correctly rounded result in \a d
+    and returns true. Returns false for any other input and if the result
+    is denormal or out of range, so that qstrtod() can deal with it.
+*/
+bool qt_fastStrtod(const char *num, double *d)
+{
+    const char *p = num;
+    bool negative = false;
+    if (*p == '-') {
+        negative = true;
+        ++p;
+    } else if (*p == '+') {
+        ++p;
+    }
+
+    quint64 mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool anyDigits = false;
+
+    for (; uint(*p - '0') < 10; ++p) {
+        anyDigits = true;
+        if (mantissa == 0 && *p == '0')
+            continue;
+        if (++significantDigits > 19)
+            return false;
+        mantissa = mantissa * 10 + (*p - '0');
+    }
+    if (*p == '.') {
+        for (++p; uint(*p - '0') < 10; ++p) {
+            anyDigits = true;
+            --exponent;
+            if (mantissa == 0 && *p == '0')
+                continue;
+            if (++significantDigits > 19)
+                return false;
+            mantissa = mantissa * 10 + (*p - '0');
+        }
+    }
+    if (!anyDigits)
+        return false;
+
+    if (*p == 'e' || *p == 'E') {
+        ++p;
+        bool negativeExponent = false;
+        if (*p == '-') {
+            negativeExponent = true;
+            ++p;
+        } else if (*p == '+') {
+            ++p;
+        }
+        if (uint(*p - '0') >= 10)
+            return false;
+        int e = 0;
+        for (; uint(*p - '0') < 10; ++p) {
+            if (e < 100000)
+                e = e * 10 + (*p - '0');
+        }
+        exponent += negativeExponent ? -e : e;
+    }
+    if (*p != '\0')
+        return false;
+
+    if (mantissa == 0) {
+        *d = bitsToDouble(negative ? DoubleSignMask : 0);
+        return true;
+    }
+    if (exponent < PowersOfFiveMinExponent || exponent > 308)
+        return false;
+
+    // Multiply the normalized mantissa by the 128-bit approximation of
+    // 10^exponent. We need the top 55 bits of the product; the low word of
+    // the table entry only matters if they might be affected by a carry.
+    const int leadingZeros = countLeadingZeroBits(mantissa);
+    const quint64 w = mantissa << leadingZeros;
+    const quint64 *entry = qt_powersOfFive + 2 * (exponent - PowersOfFiveMinExponent);
+    quint64 high;
+    quint64 low = multiply128(w, entry[0], &high);
+    if ((high & 0x1ff) == 0x1ff) {
+        quint64 secondHigh;
+        multiply128(w, entry[1], &secondHigh);
+        low += secondHigh;
+        if (secondHigh > low)
+            ++high;
+        if (low == ~quint64(0))
+            return false;
+    }
+
+    const int upperBit = int(high >> 63);
+    quint64 significand = high >> (upperBit + 9);
+    int biasedExponent = floorLog2Pow10(exponent) + 63 + upperBit - leadingZeros + 1023;
+    if (biasedExponent <= 0)
+        return false;
+
+    // An exact halfway case has to be rounded to even; those can only
+    // occur for small exponents.
+    if (low <= 1 && exponent >= -4 && exponent <= 23 && (significand & 3) == 1
+        && (significand << (upperBit + 9)) == high)
+        significand &= ~quint64(1);
+
+    significand += significand & 1;
+    significand >>= 1;
+    if (significand >= (DoubleHiddenBit << 1)) {
+        significand = DoubleHiddenBit;
+        ++biasedExponent;
+    }
+    if (biasedExponent >= 0x7ff)
+        return false;
+
+    *d = bitsToDouble((negative ? DoubleSignMask : 0)
+                      | (quint64(biasedExponent) << 52)
+                      | (significand & DoubleSignificandMask));
+    return true;
+}
+
 #ifndef QT_QLOCALE_USES_FCVT
 
 /*        From: NetBSD: strtod.c,v 1.26 1998/02/03 18:44:21 perry Exp */
@@ -83,16 +83,8 @@ enum PrecisionMode {
     PMChopTrailingZeros =   0x03
 };
 
-QString &decimalForm(QChar zero, QChar decimal, QChar group,
-                     QString &digits, int decpt, uint precision,
-                     PrecisionMode pm,
-                     bool always_show_decpt,
-                     bool thousands_group);
-QString &exponentForm(QChar zero, QChar decimal, QChar exponential,
-                      QChar group, QChar plus, QChar minus,
-                      QString &digits, int decpt, uint precision,
-                      PrecisionMode pm,
-                      bool always_show_decpt);
+void qt_doubleToAscii(double d, QLocalePrivate::DoubleForm form, int precision,
+                      unsigned flags, QLocalePrivate::CharBuff *buf);
 
 inline bool isZero(double d)
 {
@@ -110,6 +102,10 @@ bool removeGroupSeparators(QLocalePrivate::CharBuff *num);
 Q_CORE_EXPORT char *qdtoa(double d, int mode, int ndigits, int *decpt,
                           int *sign, char **rve, char **digits_str);
 Q_CORE_EXPORT double qstrtod(const char *s00, char const **se, bool *ok);
+
+enum { FastDtoaBufferSize = 18 };
+bool qt_fastDtoa(double d, int mode, int ndigits, char *buffer, int *length, int *decpt);
+bool qt_fastStrtod(const char *num, double *d);
 qlonglong qstrtoll(const char *nptr, const char **endptr, register int base, bool *ok);
 qulonglong qstrtoull(const char *nptr, const char **endptr, register int base, bool *ok);
 
@@ -0,0 +1,612 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qmultipatternmatcher.h"
+
+#include "qalgorithms.h"
+#include "qiodevice.h"
+#include "qpair.h"
+#include "qvector.h"
+#include "private/qsimd_p.h"
+
+#include <algorithm>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    An Aho-Corasick automaton over 16-bit symbols, stored as a complete
+    DFA: every state has a transition for every symbol class, so matching
+    costs one table lookup per input symbol regardless of the number of
+    patterns.
+
+    The input symbols are mapped to classes first. Class 0 stands for all
+    symbols that do not occur in any pattern; the other classes are the
+    distinct (case folded) pattern symbols. Case insensitive matching is
+    handled entirely by that mapping, so the input is never folded.
+*/
+struct QMultiPatternAutomaton
+{
+    typedef ushort (*FoldFunction)(ushort);
+
+    QMultiPatternAutomaton();
+
+    void build(const QVector<QVector<ushort> > &patterns, int symbolCount, FoldFunction fold);
+
+    inline int classOf(uchar c) const { return classes[c]; }
+    inline int classOf(ushort c) const
+    {
+        if (c < 256)
+            return classes[c];
+        const QPair<ushort, int> key(c, 0);
+        const QVector<QPair<ushort, int> >::const_iterator it =
+                qLowerBound(wideClasses.constBegin(), wideClasses.constEnd(), key);
+        return (it != wideClasses.constEnd() && it->first == c) ? it->second : 0;
+    }
+
+    int skipToStart(const uchar *data, int from, int length) const;
+    int skipToStart(const ushort *data, int from, int length) const;
+
+    template <typename Char>
+    int scan(const Char *data, int from, int length, int *state) const;
+
+    int classCount;
+    QVector<int> transitions;   // classCount entries per state, starting with the root
+    QVector<int> matches;       // the longest pattern ending in each state, or -1
+    int classes[256];           // the classes of the symbols 0 to 255
+    QVector<QPair<ushort, int> > wideClasses;   // the other symbols with a class, sorted
+
+    // The symbols that leave the root state, if there are only a few of them
+    enum { MaxStartSymbols = 4 };
+    int startSymbolCount;
+    ushort startSymbols[MaxStartSymbols];
+};
+
+QMultiPatternAutomaton::QMultiPatternAutomaton()
+    : classCount(1), startSymbolCount(0)
+{
+    memset(classes, 0, sizeof(classes));
+    transitions.fill(0, classCount);
+    matches.fill(-1, 1);
+}
+
+void QMultiPatternAutomaton::build(const QVector<QVector<ushort> > &patterns, int symbolCount,
+                                   FoldFunction fold)
+{
+    // Assign a class to each distinct pattern symbol
+    QVector<ushort> symbols;
+    for (int i = 0; i < patterns.size(); ++i)
+        symbols += patterns.at(i);
+    qSort(symbols);
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+    classCount = symbols.size() + 1;
+
+    memset(classes, 0, sizeof(classes));
+    wideClasses.clear();
+    for (int u = 0; u < symbolCount; ++u) {
+        const ushort key = fold ? fold(ushort(u)) : ushort(u);
+        const QVector<ushort>::const_iterator it = qBinaryFind(symbols, key);
+        if (it == symbols.constEnd())
+            continue;
+        const int c = int(it - symbols.constBegin()) + 1;
+        if (u < 256)
+            classes[u] = c;
+        else
+            wideClasses.append(qMakePair(ushort(u), c));
+    }
+
+    // Build the trie; -1 marks a missing transition
+    transitions.fill(-1, classCount);
+    matches.fill(-1, 1);
+    for (int i = 0; i < patterns.size(); ++i) {
+        const QVector<ushort> &pattern = patterns.at(i);
+        if (pattern.isEmpty())
+            continue;
+        int state = 0;
+        for (int j = 0; j < pattern.size(); ++j) {
+            const int c = int(qBinaryFind(symbols, pattern.at(j)) - symbols.constBegin()) + 1;
+            int next = transitions.at(state * classCount + c);
+            if (next < 0) {
+                next = matches.size();
+                transitions[state * classCount + c] = next;
+                transitions.resize(transitions.size() + classCount);
+                int *row = transitions.data() + next * classCount;
+                for (int k = 0; k < classCount; ++k)
+                    row[k] = -1;
+                matches.append(-1);
+            }
+            state = next;
+        }
+        if (matches.at(state) < 0)
+            matches[state] = i;
+    }
+
+    // Turn it into a DFA by following the failure links breadth first, so
+    // that the failure state of a state is always complete before it is
+    // needed. Each state inherits the match of its failure state unless it
+    // completes a (longer) pattern itself.
+    const int stateCount = matches.size();
+    QVector<int> failure(stateCount, 0);
+    QVector<int> queue;
+    queue.reserve(stateCount);
+    int *table = transitions.data();
+    for (int c = 0; c < classCount; ++c) {
+        const int next = table[c];
+        if (next < 0) {
+            table[c] = 0;
+        } else {
+            failure[next] = 0;
+            queue.append(next);
+        }
+    }
+    for (int head = 0; head < queue.size(); ++head) {
+        const int state = queue.at(head);
+        const int *failureRow = table + failure.at(state) * classCount;
+        int *row = table + state * classCount;
+        for (int c = 0; c < classCount; ++c) {
+            const int next = row[c];
+            if (next < 0) {
+                row[c] = failureRow[c];
+            } else {
+                failure[next] = failureRow[c];
+                if (matches.at(next) < 0)
+                    matches[next] = matches.at(failureRow[c]);
+                queue.append(next);
+            }
+        }
+    }
+
+    // Remember the input symbols that can start a match if there are few
+    startSymbolCount = 0;
+    for (int u = 0; u < 256 && startSymbolCount <= MaxStartSymbols; ++u) {
+        if (table[classes[u]] != 0) {
+            if (startSymbolCount < MaxStartSymbols)
+                startSymbols[startSymbolCount] = ushort(u);
+            ++startSymbolCount;
+        }
+    }
+    for (int i = 0; i < wideClasses.size() && startSymbolCount <= MaxStartSymbols; ++i) {
+        if (table[wideClasses.at(i).second] != 0) {
+            if (startSymbolCount < MaxStartSymbols)
+                startSymbols[startSymbolCount] = wideClasses.at(i).first;
+            ++startSymbolCount;
+        }
+    }
+}
+
+// Returns the position of the next symbol that leaves the root state
+int QMultiPatternAutomaton::skipToStart(const uchar *data, int from, int length) const
+{
+    int i = from;
+#if defined(__SSE2__)
+    if (startSymbolCount > 0 && startSymbolCount <= MaxStartSymbols) {
+        const __m128i s0 = _mm_set1_epi8(startSymbols[0]);
+        const __m128i s1 = _mm_set1_epi8(startSymbols[qMin(1, startSymbolCount - 1)]);
+        const __m128i s2 = _mm_set1_epi8(startSymbols[qMin(2, startSymbolCount - 1)]);
+        const __m128i s3 = _mm_set1_epi8(startSymbols[qMin(3, startSymbolCount - 1)]);
+        for ( ; i + 16 <= length; i += 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            const __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, s0),
+                                                            _mm_cmpeq_epi8(chunk, s1)),
+                                               _mm_or_si128(_mm_cmpeq_epi8(chunk, s2),
+                                                            _mm_cmpeq_epi8(chunk, s3)));
+            const uint mask = _mm_movemask_epi8(found);
+            if (mask)
+                return i + qCountTrailingZeroBits(mask);
+        }
+    }
+#endif
+    const int *root = transitions.constData();
+    while (i < length && !root[classes[data[i]]])
+        ++i;
+    return i;
+}
+
+int QMultiPatternAutomaton::skipToStart(const ushort *data, int from, int length) const
+{
+    int i = from;
+#if defined(__SSE2__)
+    if (startSymbolCount > 0 && startSymbolCount <= MaxStartSymbols) {
+        const __m128i s0 = _mm_set1_epi16(startSymbols[0]);
+        const __m128i s1 = _mm_set1_epi16(startSymbols[qMin(1, startSymbolCount - 1)]);
+        const __m128i s2 = _mm_set1_epi16(startSymbols[qMin(2, startSymbolCount - 1)]);
+        const __m128i s3 = _mm_set1_epi16(startSymbols[qMin(3, startSymbolCount - 1)]);
+        for ( ; i + 8 <= length; i += 8) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            const __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(chunk, s0),
+                                                            _mm_cmpeq_epi16(chunk, s1)),
+                                               _mm_or_si128(_mm_cmpeq_epi16(chunk, s2),
+                                                            _mm_cmpeq_epi16(chunk, s3)));
+            const uint mask = _mm_movemask_epi8(found);
+            if (mask)
+                return i + qCountTrailingZeroBits(mask) / 2;
+        }
+    }
+#endif
+    const int *root = transitions.constData();
+    while (i < length && !root[classOf(data[i])])
+        ++i;
+    return i;
+}
+
+/*
+    Feeds data[from] to data[length - 1] to the automaton, starting in
+    *state. Returns the position after the first match, or -1 if there is
+    none; *state is left in the state reached.
+*/
+template <typename Char>
+int QMultiPatternAutomaton::scan(const Char *data, int from, int length, int *state) const
+{
+    const int *table = transitions.constData();
+    const int *match = matches.constData();
+    int s = *state;
+    int i = from;
+    while (i < length) {
+        if (s == 0) {
+            i = skipToStart(data, i, length);
+            if (i == length)
+                break;
+        }
+        s = table[s * classCount + classOf(data[i++])];
+        if (match[s] >= 0) {
+            *state = s;
+            return i;
+        }
+    }
+    *state = s;
+    return -1;
+}
+
+class QMultiPatternMatcherPrivate : public QSharedData
+{
+public:
+    QMultiPatternMatcherPrivate(const QStringList &patterns, Qt::CaseSensitivity cs);
+
+    QStringList patterns;
+    Qt::CaseSensitivity cs;
+
+    QMultiPatternAutomaton utf16;
+    QMultiPatternAutomaton utf8;
+    QVector<int> utf16Lengths;
+    QVector<int> utf8Lengths;
+};
+
+static ushort foldUtf16(ushort c)
+{
+    return ushort(QChar::toCaseFolded(uint(c)));
+}
+
+static ushort foldAscii(ushort c)
+{
+    return (c >= 'A' && c <= 'Z') ? ushort(c - 'A' + 'a') : c;
+}
+
+QMultiPatternMatcherPrivate::QMultiPatternMatcherPrivate(const QStringList &patterns,
+                                                         Qt::CaseSensitivity cs)
+    : patterns(patterns), cs(cs)
+{
+    const int count = patterns.size();
+    QVector<QVector<ushort> > utf16Symbols(count);
+    QVector<QVector<ushort> > utf8Symbols(count);
+    utf16Lengths.resize(count);
+    utf8Lengths.resize(count);
+
+    for (int i = 0; i < count; ++i) {
+        const QString &pattern = patterns.at(i);
+        const QByteArray encoded = pattern.toUtf8();
+        utf16Lengths[i] = pattern.size();
+        utf8Lengths[i] = encoded.size();
+
+        QVector<ushort> &units = utf16Symbols[i];
+        units.resize(pattern.size());
+        for (int j = 0; j < pattern.size(); ++j) {
+            const ushort u = pattern.at(j).unicode();
+            units[j] = cs == Qt::CaseSensitive ? u : foldUtf16(u);
+        }
+
+        QVector<ushort> &bytes = utf8Symbols[i];
+        bytes.resize(encoded.size());
+        for (int j = 0; j < encoded.size(); ++j) {
+            const ushort b = uchar(encoded.at(j));
+            bytes[j] = cs == Qt::CaseSensitive ? b : foldAscii(b);
+        }
+    }
+
+    utf16.build(utf16Symbols, 0x10000, cs == Qt::CaseSensitive ? 0 : foldUtf16);
+    utf8.build(utf8Symbols, 0x100, cs == Qt::CaseSensitive ? 0 : foldAscii);
+}
+
+/*!
+    \class QMultiPatternMatcher
+    \inmodule QtCore
+    \since 5.1
+    \brief The QMultiPatternMatcher class finds any of a set of strings
+    in a single pass over the searched data.
+
+    \ingroup tools
+    \ingroup string-processing
+
+    Searching for many different strings with one QStringMatcher or
+    QByteArrayMatcher per string requires one pass over the data for each
+    of them. QMultiPatternMatcher instead compiles all patterns into a
+    single automaton (using the Aho-Corasick algorithm), which finds the
+    first occurrence of any of them while looking at every character of
+    the data only once. The time taken by a search does not depend on the
+    number of patterns.
+
+    Create the QMultiPatternMatcher with the list of strings you want to
+    search for, then call indexIn() on the data you want to search. The
+    matcher can search QStrings, byte arrays and QIODevices:
+
+    \list
+    \li Strings are searched as UTF-16. Case insensitive matching uses
+        the simple case folding of each character.
+    \li Byte arrays, character strings and devices are assumed to be UTF-8
+        encoded, and are searched for the UTF-8 representation of the
+        patterns. Case insensitive matching only folds the letters of the
+        US-ASCII range; other characters must match exactly.
+    \endlist
+
+    indexIn() reports the match that \e ends first. If several patterns
+    end at the same position, the longest of them is reported. Empty
+    patterns never match. If a pattern occurs more than once in the list,
+    the first occurrence is reported.
+
+    Building the automaton takes time and memory proportional to the total
+    length of the patterns multiplied by the number of distinct characters
+    in them, so it only pays off if the same patterns are searched for in
+    a sufficient amount of data.
+
+    QMultiPatternMatcher is \l{implicitly shared}; searching with the same
+    matcher from several threads is safe.
+
+    \sa QStringMatcher, QByteArrayMatcher
+*/
+
+/*!
+    Constructs a matcher without any patterns, which never matches
+    anything. Call setPatterns() to give it patterns to search for.
+*/
+QMultiPatternMatcher::QMultiPatternMatcher()
+    : d(new QMultiPatternMatcherPrivate(QStringList(), Qt::CaseSensitive))
+{
+}
+
+/*!
+    Constructs a matcher that searches for any of the strings in \a
+    patterns, with case sensitivity \a cs.
+*/
+QMultiPatternMatcher::QMultiPatternMatcher(const QStringList &patterns, Qt::CaseSensitivity cs)
+    : d(new QMultiPatternMatcherPrivate(patterns, cs))
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QMultiPatternMatcher::QMultiPatternMatcher(const QMultiPatternMatcher &other)
+    : d(other.d)
+{
+}
+
+/*!
+    Destroys the matcher.
+*/
+QMultiPatternMatcher::~QMultiPatternMatcher()
+{
+}
+
+/*!
+    Assigns \a other to this matcher and returns a reference to it.
+*/
+QMultiPatternMatcher &QMultiPatternMatcher::operator=(const QMultiPatternMatcher &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    \fn void QMultiPatternMatcher::swap(QMultiPatternMatcher &other)
+
+    Swaps this matcher with \a other. This operation is very fast and
+    never fails.
+*/
+
+/*!
+    Sets the strings that this matcher searches for to \a patterns. The
+    index of a pattern in this list is what indexIn() reports.
+
+    \sa patterns(), indexIn()
+*/
+void QMultiPatternMatcher::setPatterns(const QStringList &patterns)
+{
+    d = new QMultiPatternMatcherPrivate(patterns, d->cs);
+}
+
+/*!
+    Returns the strings that this matcher searches for.
+
+    \sa setPatterns()
+*/
+QStringList QMultiPatternMatcher::patterns() const
+{
+    return d->patterns;
+}
+
+/*!
+    Sets the case sensitivity of this matcher to \a cs.
+
+    \sa caseSensitivity()
+*/
+void QMultiPatternMatcher::setCaseSensitivity(Qt::CaseSensitivity cs)
+{
+    if (cs != d->cs)
+        d = new QMultiPatternMatcherPrivate(d->patterns, cs);
+}
+
+/*!
+    Returns the case sensitivity of this matcher.
+
+    \sa setCaseSensitivity()
+*/
+Qt::CaseSensitivity QMultiPatternMatcher::caseSensitivity() const
+{
+    return d->cs;
+}
+
+/*!
+    Searches the string \a str from character position \a from (default
+    0, i.e. from the first character) for any of the patterns. Returns
+    the position where the first match starts, or -1 if there is none.
+
+    If \a matchedPattern is not 0, the index of the pattern that was found
+    is stored in it; if \a matchedLength is not 0, the length of the match
+    is stored in it.
+*/
+int QMultiPatternMatcher::indexIn(const QString &str, int from,
+                                  int *matchedPattern, int *matchedLength) const
+{
+    return indexIn(str.unicode(), str.size(), from, matchedPattern, matchedLength);
+}
+
+/*!
+    \overload
+
+    Searches the \a length characters starting at \a str.
+*/
+int QMultiPatternMatcher::indexIn(const QChar *str, int length, int from,
+                                  int *matchedPattern, int *matchedLength) const
+{
+    int state = 0;
+    const int end = d->utf16.scan(reinterpret_cast<const ushort *>(str), qMax(from, 0),
+                                  length, &state);
+    if (end < 0)
+        return -1;
+    const int pattern = d->utf16.matches.at(state);
+    const int patternLength = d->utf16Lengths.at(pattern);
+    if (matchedPattern)
+        *matchedPattern = pattern;
+    if (matchedLength)
+        *matchedLength = patternLength;
+    return end - patternLength;
+}
+
+/*!
+    \overload
+
+    Searches the UTF-8 encoded byte array \a ba from byte position \a from
+    (default 0, i.e. from the first byte) for any of the patterns. The
+    position and the length of the match are in bytes.
+*/
+int QMultiPatternMatcher::indexIn(const QByteArray &ba, int from,
+                                  int *matchedPattern, int *matchedLength) const
+{
+    return indexIn(ba.constData(), ba.size(), from, matchedPattern, matchedLength);
+}
+
+/*!
+    \overload
+
+    Searches the \a length bytes of UTF-8 encoded text starting at \a str.
+*/
+int QMultiPatternMatcher::indexIn(const char *str, int length, int from,
+                                  int *matchedPattern, int *matchedLength) const
+{
+    int state = 0;
+    const int end = d->utf8.scan(reinterpret_cast<const uchar *>(str), qMax(from, 0),
+                                 length, &state);
+    if (end < 0)
+        return -1;
+    const int pattern = d->utf8.matches.at(state);
+    const int patternLength = d->utf8Lengths.at(pattern);
+    if (matchedPattern)
+        *matchedPattern = pattern;
+    if (matchedLength)
+        *matchedLength = patternLength;
+    return end - patternLength;
+}
+
+/*!
+    \overload
+
+    Reads UTF-8 encoded text from \a device, which must be open for
+    reading, until one of the patterns is found or no more data is
+    available. Returns the position of the match relative to the position
+    of \a device when the function was called, or -1 if there is none.
+
+    The data is read in blocks, so the memory used does not depend on
+    the amount of data. If a match is found, \a device is left positioned
+    right after it, so that calling this function again continues the
+    search; otherwise all available data has been consumed.
+*/
+qint64 QMultiPatternMatcher::indexIn(QIODevice *device,
+                                     int *matchedPattern, int *matchedLength) const
+{
+    if (!device)
+        return -1;
+
+    char buffer[16384];
+    qint64 offset = 0;
+    int state = 0;
+    forever {
+        const qint64 available = device->peek(buffer, sizeof(buffer));
+        if (available <= 0)
+            return -1;
+
+        const int end = d->utf8.scan(reinterpret_cast<const uchar *>(buffer), 0,
+                                     int(available), &state);
+        if (end >= 0) {
+            device->read(buffer, end);
+            const int pattern = d->utf8.matches.at(state);
+            const int patternLength = d->utf8Lengths.at(pattern);
+            if (matchedPattern)
+                *matchedPattern = pattern;
+            if (matchedLength)
+                *matchedLength = patternLength;
+            return offset + end - patternLength;
+        }
+
+        device->read(buffer, available);
+        offset += available;
+    }
+}
+
+QT_END_NAMESPACE
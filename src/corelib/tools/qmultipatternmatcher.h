@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QMULTIPATTERNMATCHER_H
+#define QMULTIPATTERNMATCHER_H
+
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstringlist.h>
+
+QT_BEGIN_HEADER
+
+QT_BEGIN_NAMESPACE
+
+
+class QIODevice;
+class QMultiPatternMatcherPrivate;
+
+class Q_CORE_EXPORT QMultiPatternMatcher
+{
+public:
+    QMultiPatternMatcher();
+    explicit QMultiPatternMatcher(const QStringList &patterns,
+                                  Qt::CaseSensitivity cs = Qt::CaseSensitive);
+    QMultiPatternMatcher(const QMultiPatternMatcher &other);
+    ~QMultiPatternMatcher();
+
+    QMultiPatternMatcher &operator=(const QMultiPatternMatcher &other);
+#ifdef Q_COMPILER_RVALUE_REFS
+    inline QMultiPatternMatcher &operator=(QMultiPatternMatcher &&other)
+    { d.swap(other.d); return *this; }
+#endif
+
+    inline void swap(QMultiPatternMatcher &other) { d.swap(other.d); }
+
+    void setPatterns(const QStringList &patterns);
+    QStringList patterns() const;
+
+    void setCaseSensitivity(Qt::CaseSensitivity cs);
+    Qt::CaseSensitivity caseSensitivity() const;
+
+    int indexIn(const QString &str, int from = 0,
+                int *matchedPattern = 0, int *matchedLength = 0) const;
+    int indexIn(const QChar *str, int length, int from = 0,
+                int *matchedPattern = 0, int *matchedLength = 0) const;
+    int indexIn(const QByteArray &ba, int from = 0,
+                int *matchedPattern = 0, int *matchedLength = 0) const;
+    int indexIn(const char *str, int length, int from = 0,
+                int *matchedPattern = 0, int *matchedLength = 0) const;
+    qint64 indexIn(QIODevice *device,
+                   int *matchedPattern = 0, int *matchedLength = 0) const;
+
+private:
+    QExplicitlySharedDataPointer<QMultiPatternMatcherPrivate> d;
+};
+
+Q_DECLARE_SHARED(QMultiPatternMatcher)
+
+QT_END_NAMESPACE
+
+QT_END_HEADER
+
+#endif // QMULTIPATTERNMATCHER_H
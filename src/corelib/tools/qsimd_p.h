@@ -74,7 +74,7 @@ QT_BEGIN_HEADER
  * I = intrinsics; C = code generation
  */
 
-#ifdef __MINGW64_VERSION_MAJOR
+#if defined(__MINGW64_VERSION_MAJOR) || defined(Q_CC_MSVC)
 #include <intrin.h>
 #endif
 
@@ -246,6 +246,25 @@ inline uint qCpuHasFeature(CPUFeatures feature)
 }
 
 
+// returns the index of the lowest set bit in \a v, which must not be zero
+inline uint qCountTrailingZeroBits(uint v)
+{
+#if defined(Q_CC_GNU)
+    return __builtin_ctz(v);
+#elif defined(Q_CC_MSVC)
+    unsigned long result;
+    _BitScanForward(&result, v);
+    return result;
+#else
+    uint n = 0;
+    while (!(v & 1)) {
+        v >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
 #define ALIGNMENT_PROLOGUE_16BYTES(ptr, i, length) \
     for (; i < static_cast<int>(qMin(static_cast<quintptr>(length), ((4 - ((reinterpret_cast<quintptr>(ptr) >> 2) & 0x3)) & 0x3))); ++i)
 
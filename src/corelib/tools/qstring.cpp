@@ -778,7 +778,14 @@ const QString::Null QString::null = { };
     and the \c{'+'} will automatically be performed as the
     \c{QStringBuilder} \c{'%'} everywhere.
 
-    \sa fromRawData(), QChar, QLatin1String, QByteArray, QStringRef
+    Numbers can take part in such an expression as well. Wrapping an
+    integer or a \c double in a QStringNumber formats it the same way as
+    QString::number() does, but writes the digits directly into the
+    result instead of creating a temporary QString:
+
+    \snippet qstring/stringbuilder.cpp 6
+
+    \sa fromRawData(), QChar, QLatin1String, QByteArray, QStringRef, QStringNumber
 */
 
 /*!
@@ -1283,11 +1290,10 @@ void QString::reallocData(uint alloc, bool grow)
             Data::deallocate(d);
         d = x;
     } else {
-        Data *p = static_cast<Data *>(::realloc(d, sizeof(Data) + alloc * sizeof(QChar)));
+        Data::AllocationOptions allocOptions(d->capacityReserved ? Data::CapacityReserved : 0);
+        Data *p = Data::reallocateUnaligned(d, alloc, allocOptions);
         Q_CHECK_PTR(p);
         d = p;
-        d->alloc = alloc;
-        d->offset = sizeof(QStringData);
     }
 }
 
@@ -5737,6 +5743,138 @@ QString &QString::vsprintf(const char* cformat, va_list ap)
     return *this;
 }
 
+static inline bool isAsciiSpace(ushort c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Parses the common case of a plain decimal number, optionally surrounded
+// by ASCII white space, without going through QLocale. Returns false if
+// the string needs the general conversion.
+static bool parseDecimal(const QChar *data, int len, int base, bool allowSign,
+                         quint64 *value, bool *negative)
+{
+    if (base != 10 && base != 0)
+        return false;
+    const ushort *p = reinterpret_cast<const ushort *>(data);
+    const ushort *end = p + len;
+    while (p != end && isAsciiSpace(*p))
+        ++p;
+    while (end != p && isAsciiSpace(end[-1]))
+        --end;
+    *negative = false;
+    if (p != end && (*p == '-' || *p == '+')) {
+        if (!allowSign)
+            return false;
+        *negative = *p == '-';
+        ++p;
+    }
+    // at most 18 digits cannot overflow; leave octal to the general code
+    const int digits = end - p;
+    if (digits < 1 || digits > 18 || (base == 0 && *p == '0' && digits > 1))
+        return false;
+    quint64 v = 0;
+    for (; p != end; ++p) {
+        const uint digit = uint(*p) - '0';
+        if (digit > 9)
+            return false;
+        v = v * 10 + digit;
+    }
+    *value = v;
+    return true;
+}
+
+// The number conversions of QString and QStringRef work on the characters
+// directly, so that converting a part of a string needs no copy of it.
+qint64 QString::toLongLong_helper(const QChar *data, int len, bool *ok, int base)
+{
+#if defined(QT_CHECK_RANGE)
+    if (base != 0 && (base < 2 || base > 36)) {
+        qWarning("QString::toLongLong: Invalid base (%d)", base);
+        base = 10;
+    }
+#endif
+
+    quint64 value;
+    bool negative;
+    if (parseDecimal(data, len, base, true, &value, &negative)) {
+        if (ok)
+            *ok = true;
+        return negative ? -qint64(value) : qint64(value);
+    }
+
+    QLocale c_locale(QLocale::C);
+    return c_locale.d->stringToLongLong(data, len, base, ok, QLocalePrivate::FailOnGroupSeparators);
+}
+
+quint64 QString::toULongLong_helper(const QChar *data, int len, bool *ok, int base)
+{
+#if defined(QT_CHECK_RANGE)
+    if (base != 0 && (base < 2 || base > 36)) {
+        qWarning("QString::toULongLong: Invalid base (%d)", base);
+        base = 10;
+    }
+#endif
+
+    quint64 value;
+    bool negative;
+    if (parseDecimal(data, len, base, false, &value, &negative)) {
+        if (ok)
+            *ok = true;
+        return value;
+    }
+
+    QLocale c_locale(QLocale::C);
+    return c_locale.d->stringToUnsLongLong(data, len, base, ok, QLocalePrivate::FailOnGroupSeparators);
+}
+
+double QString::toDouble_helper(const QChar *data, int len, bool *ok)
+{
+    QLocale c_locale(QLocale::C);
+    return c_locale.d->stringToDouble(data, len, ok, QLocalePrivate::FailOnGroupSeparators);
+}
+
+static inline qint64 checkSignedRange(qint64 v, qint64 min, qint64 max, bool *ok)
+{
+    if (v < min || v > max) {
+        if (ok)
+            *ok = false;
+        v = 0;
+    }
+    return v;
+}
+
+static inline quint64 checkUnsignedRange(quint64 v, quint64 max, bool *ok)
+{
+    if (v > max) {
+        if (ok)
+            *ok = false;
+        v = 0;
+    }
+    return v;
+}
+
+#define QT_MAX_FLOAT 3.4028234663852886e+38
+
+static float doubleToFloat(double d, bool converted, bool *ok)
+{
+    if (!converted) {
+        if (ok != 0)
+            *ok = false;
+        return 0.0;
+    }
+    if (qIsInf(d))
+        return float(d);
+    if (d > QT_MAX_FLOAT || d < -QT_MAX_FLOAT) {
+        if (ok != 0)
+            *ok = false;
+        return 0.0;
+    }
+    if (ok != 0)
+        *ok = true;
+    return float(d);
+}
+
 /*!
     Returns the string converted to a \c{long long} using base \a
     base, which is 10 by default and must be between 2 and 36, or 0.
@@ -5761,15 +5899,7 @@ QString &QString::vsprintf(const char* cformat, va_list ap)
 
 qint64 QString::toLongLong(bool *ok, int base) const
 {
-#if defined(QT_CHECK_RANGE)
-    if (base != 0 && (base < 2 || base > 36)) {
-        qWarning("QString::toLongLong: Invalid base (%d)", base);
-        base = 10;
-    }
-#endif
-
-    QLocale c_locale(QLocale::C);
-    return c_locale.d->stringToLongLong(*this, base, ok, QLocalePrivate::FailOnGroupSeparators);
+    return toLongLong_helper(constData(), size(), ok, base);
 }
 
 /*!
@@ -5796,15 +5926,7 @@ qint64 QString::toLongLong(bool *ok, int base) const
 
 quint64 QString::toULongLong(bool *ok, int base) const
 {
-#if defined(QT_CHECK_RANGE)
-    if (base != 0 && (base < 2 || base > 36)) {
-        qWarning("QString::toULongLong: Invalid base (%d)", base);
-        base = 10;
-    }
-#endif
-
-    QLocale c_locale(QLocale::C);
-    return c_locale.d->stringToUnsLongLong(*this, base, ok, QLocalePrivate::FailOnGroupSeparators);
+    return toULongLong_helper(constData(), size(), ok, base);
 }
 
 /*!
@@ -5833,13 +5955,7 @@ quint64 QString::toULongLong(bool *ok, int base) const
 
 long QString::toLong(bool *ok, int base) const
 {
-    qint64 v = toLongLong(ok, base);
-    if (v < LONG_MIN || v > LONG_MAX) {
-        if (ok)
-            *ok = false;
-        v = 0;
-    }
-    return (long)v;
+    return long(checkSignedRange(toLongLong(ok, base), LONG_MIN, LONG_MAX, ok));
 }
 
 /*!
@@ -5868,13 +5984,7 @@ long QString::toLong(bool *ok, int base) const
 
 ulong QString::toULong(bool *ok, int base) const
 {
-    quint64 v = toULongLong(ok, base);
-    if (v > ULONG_MAX) {
-        if (ok)
-            *ok = false;
-        v = 0;
-    }
-    return (ulong)v;
+    return ulong(checkUnsignedRange(toULongLong(ok, base), ULONG_MAX, ok));
 }
 
 
@@ -5902,13 +6012,7 @@ ulong QString::toULong(bool *ok, int base) const
 
 int QString::toInt(bool *ok, int base) const
 {
-    qint64 v = toLongLong(ok, base);
-    if (v < INT_MIN || v > INT_MAX) {
-        if (ok)
-            *ok = false;
-        v = 0;
-    }
-    return v;
+    return int(checkSignedRange(toLongLong(ok, base), INT_MIN, INT_MAX, ok));
 }
 
 /*!
@@ -5935,13 +6039,7 @@ int QString::toInt(bool *ok, int base) const
 
 uint QString::toUInt(bool *ok, int base) const
 {
-    quint64 v = toULongLong(ok, base);
-    if (v > UINT_MAX) {
-        if (ok)
-            *ok = false;
-        v = 0;
-    }
-    return (uint)v;
+    return uint(checkUnsignedRange(toULongLong(ok, base), UINT_MAX, ok));
 }
 
 /*!
@@ -5968,13 +6066,7 @@ uint QString::toUInt(bool *ok, int base) const
 
 short QString::toShort(bool *ok, int base) const
 {
-    long v = toLongLong(ok, base);
-    if (v < SHRT_MIN || v > SHRT_MAX) {
-        if (ok)
-            *ok = false;
-        v = 0;
-    }
-    return (short)v;
+    return short(checkSignedRange(toLongLong(ok, base), SHRT_MIN, SHRT_MAX, ok));
 }
 
 /*!
@@ -6001,13 +6093,7 @@ short QString::toShort(bool *ok, int base) const
 
 ushort QString::toUShort(bool *ok, int base) const
 {
-    ulong v = toULongLong(ok, base);
-    if (v > USHRT_MAX) {
-        if (ok)
-            *ok = false;
-        v = 0;
-    }
-    return (ushort)v;
+    return ushort(checkUnsignedRange(toULongLong(ok, base), USHRT_MAX, ok));
 }
 
 
@@ -6042,8 +6128,7 @@ ushort QString::toUShort(bool *ok, int base) const
 
 double QString::toDouble(bool *ok) const
 {
-    QLocale c_locale(QLocale::C);
-    return c_locale.d->stringToDouble(*this, ok, QLocalePrivate::FailOnGroupSeparators);
+    return toDouble_helper(constData(), size(), ok);
 }
 
 /*!
@@ -6062,27 +6147,11 @@ double QString::toDouble(bool *ok) const
     \sa number(), toDouble(), toInt(), QLocale::toFloat()
 */
 
-#define QT_MAX_FLOAT 3.4028234663852886e+38
-
 float QString::toFloat(bool *ok) const
 {
     bool myOk;
-    double d = toDouble(&myOk);
-    if (!myOk) {
-        if (ok != 0)
-            *ok = false;
-        return 0.0;
-    }
-    if (qIsInf(d))
-        return float(d);
-    if (d > QT_MAX_FLOAT || d < -QT_MAX_FLOAT) {
-        if (ok != 0)
-            *ok = false;
-        return 0.0;
-    }
-    if (ok != 0)
-        *ok = true;
-    return float(d);
+    const double d = toDouble(&myOk);
+    return doubleToFloat(d, myOk, ok);
 }
 
 /*! \fn QString &QString::setNum(int n, int base)
@@ -6369,6 +6438,42 @@ QStringList QString::split(QChar sep, SplitBehavior behavior, Qt::CaseSensitivit
     return list;
 }
 
+/*!
+    \since 5.1
+
+    Splits the string into substring references wherever \a sep occurs,
+    and returns the list of those references. If \a sep does not match
+    anywhere in the string, splitRef() returns a single-element vector
+    containing a reference to the whole string.
+
+    \a cs specifies whether \a sep should be matched case
+    sensitively or case insensitively.
+
+    If \a behavior is QString::SkipEmptyParts, empty entries don't
+    appear in the result. By default, empty entries are kept.
+
+    Unlike split(), this function does not copy the parts of the string.
+    The references are only valid as long as this string exists and is
+    not modified.
+
+    \sa split(), QStringRef::split()
+*/
+QVector<QStringRef> QString::splitRef(const QString &sep, SplitBehavior behavior,
+                                      Qt::CaseSensitivity cs) const
+{
+    return QStringRef(this).split(sep, behavior, cs);
+}
+
+/*!
+    \overload
+    \since 5.1
+*/
+QVector<QStringRef> QString::splitRef(QChar sep, SplitBehavior behavior,
+                                      Qt::CaseSensitivity cs) const
+{
+    return QStringRef(this).split(sep, behavior, cs);
+}
+
 #ifndef QT_NO_REGEXP
 /*!
     \overload
@@ -6815,8 +6920,9 @@ QString QString::arg(const QString &a, int fieldWidth, QChar fillChar) const
   \overload arg()
 
   This is the same as \c {str.arg(a1).arg(a2)}, except that the
-  strings \a a1 and \a a2 are replaced in one pass. This can make a
-  difference if \a a1 contains e.g. \c{%1}:
+  strings \a a1 and \a a2 are replaced in one pass, and the result is
+  allocated only once. This can make a difference if \a a1 contains
+  e.g. \c{%1}:
 
   \snippet qstring/main.cpp 13
 */
@@ -7216,56 +7322,84 @@ static int getEscape(const QChar *uc, int *pos, int len, int maxNumber = 999)
     return -1;
 }
 
+struct MultiArgEscape
+{
+    int start;  // the position of the '%'
+    int end;    // the position after the last digit
+    int number;
+};
+
 QString QString::multiArg(int numArgs, const QString **args) const
 {
-    QString result;
-    QMap<int, int> numbersUsed;
     const QChar *uc = (const QChar *) d->data();
     const int len = d->size;
     const int end = len - 1;
-    int lastNumber = -1;
     int i = 0;
 
-    // populate the numbersUsed map with the %n's that actually occur in the string
+    // find the %n's that actually occur in the string
+    QVarLengthArray<MultiArgEscape, 16> escapes;
+    QVarLengthArray<int, 16> numbersUsed;
     while (i < end) {
         if (uc[i] == QLatin1Char('%')) {
-            int number = getEscape(uc, &i, len);
+            const int start = i;
+            const int number = getEscape(uc, &i, len);
             if (number != -1) {
-                numbersUsed.insert(number, -1);
+                const MultiArgEscape escape = { start, i, number };
+                escapes.append(escape);
+                numbersUsed.append(number);
                 continue;
             }
         }
         ++i;
     }
 
-    // assign an argument number to each of the %n's
-    QMap<int, int>::iterator j = numbersUsed.begin();
-    QMap<int, int>::iterator jend = numbersUsed.end();
-    int arg = 0;
-    while (j != jend && arg < numArgs) {
-        *j = arg++;
-        lastNumber = j.key();
-        ++j;
+    // the lowest numArgs distinct numbers are assigned to the arguments,
+    // in order; the others are left as they are
+    qSort(numbersUsed.begin(), numbersUsed.end());
+    int numbersCount = 0;
+    for (int k = 0; k < numbersUsed.size(); ++k) {
+        if (k == 0 || numbersUsed.at(k) != numbersUsed.at(k - 1))
+            numbersUsed[numbersCount++] = numbersUsed.at(k);
     }
+    const int *numbersEnd = numbersUsed.constData() + numbersCount;
 
     // sanity
-    if (numArgs > arg) {
-        qWarning("QString::arg: %d argument(s) missing in %s", numArgs - arg, toLocal8Bit().data());
-        numArgs = arg;
+    if (numArgs > numbersCount) {
+        qWarning("QString::arg: %d argument(s) missing in %s", numArgs - numbersCount, toLocal8Bit().data());
+        numArgs = numbersCount;
+    }
+
+    // compute the size of the result, so that it is allocated only once
+    QVarLengthArray<int, 16> argIndexes(escapes.size());
+    int size = len;
+    for (int k = 0; k < escapes.size(); ++k) {
+        const MultiArgEscape &escape = escapes.at(k);
+        const int arg = qLowerBound(numbersUsed.constData(), numbersEnd, escape.number)
+                        - numbersUsed.constData();
+        if (arg < numArgs) {
+            argIndexes[k] = arg;
+            size += args[arg]->size() - (escape.end - escape.start);
+        } else {
+            argIndexes[k] = -1;
+        }
     }
 
+    QString result(size, Qt::Uninitialized);
+    QChar *out = result.data();
     i = 0;
-    while (i < len) {
-        if (uc[i] == QLatin1Char('%') && i != end) {
-            int number = getEscape(uc, &i, len, lastNumber);
-            int arg = numbersUsed[number];
-            if (number != -1 && arg != -1) {
-                result += *args[arg];
-                continue;
-            }
-        }
-        result += uc[i++];
-    }
+    for (int k = 0; k < escapes.size(); ++k) {
+        const int arg = argIndexes.at(k);
+        if (arg == -1)
+            continue;
+        const MultiArgEscape &escape = escapes.at(k);
+        memcpy(out, uc + i, (escape.start - i) * sizeof(QChar));
+        out += escape.start - i;
+        const QString &a = *args[arg];
+        memcpy(out, a.constData(), a.size() * sizeof(QChar));
+        out += a.size();
+        i = escape.end;
+    }
+    memcpy(out, uc + i, (len - i) * sizeof(QChar));
     return result;
 }
 
@@ -9160,6 +9294,267 @@ QVector<uint> QStringRef::toUcs4() const
     return v;
 }
 
+/*!
+    \since 5.1
+
+    Splits the string into substring references wherever \a sep occurs,
+    and returns the list of those references. If \a sep does not match
+    anywhere in the string, split() returns a single-element vector
+    containing this reference.
+
+    \a cs specifies whether \a sep should be matched case
+    sensitively or case insensitively.
+
+    If \a behavior is QString::SkipEmptyParts, empty entries don't
+    appear in the result. By default, empty entries are kept.
+
+    The returned references point into the same QString as this one.
+
+    \sa QString::splitRef(), QString::split()
+*/
+QVector<QStringRef> QStringRef::split(const QString &sep, QString::SplitBehavior behavior,
+                                      Qt::CaseSensitivity cs) const
+{
+    QVector<QStringRef> list;
+    int start = 0;
+    int extra = 0;
+    int end;
+    while ((end = indexOf(sep, start + extra, cs)) != -1) {
+        if (start != end || behavior == QString::KeepEmptyParts)
+            list.append(QStringRef(m_string, m_position + start, end - start));
+        start = end + sep.size();
+        extra = (sep.size() == 0 ? 1 : 0);
+    }
+    if (start != m_size || behavior == QString::KeepEmptyParts)
+        list.append(QStringRef(m_string, m_position + start, m_size - start));
+    return list;
+}
+
+/*!
+    \overload
+    \since 5.1
+*/
+QVector<QStringRef> QStringRef::split(QChar sep, QString::SplitBehavior behavior,
+                                      Qt::CaseSensitivity cs) const
+{
+    QVector<QStringRef> list;
+    int start = 0;
+    int end;
+    while ((end = indexOf(sep, start, cs)) != -1) {
+        if (start != end || behavior == QString::KeepEmptyParts)
+            list.append(QStringRef(m_string, m_position + start, end - start));
+        start = end + 1;
+    }
+    if (start != m_size || behavior == QString::KeepEmptyParts)
+        list.append(QStringRef(m_string, m_position + start, m_size - start));
+    return list;
+}
+
+/*!
+    \since 5.1
+
+    Returns a reference to the part of the string without the whitespace
+    at its start and its end.
+
+    Whitespace means any character for which QChar::isSpace() returns
+    true. Unlike QString::trimmed(), this function does not remove
+    whitespace from the inside of the string, and does not copy it.
+
+    \sa QString::trimmed()
+*/
+QStringRef QStringRef::trimmed() const
+{
+    const QChar *s = unicode();
+    int start = 0;
+    int end = m_size;
+    while (start < end && s[start].isSpace())
+        ++start;
+    while (end > start && s[end - 1].isSpace())
+        --end;
+    if (start == 0 && end == m_size)
+        return *this;
+    return QStringRef(m_string, m_position + start, end - start);
+}
+
+/*!
+    \since 5.1
+
+    Returns the string converted to a \c{long long} using base \a
+    base, which is 10 by default and must be between 2 and 36, or 0.
+    Returns 0 if the conversion fails.
+
+    If a conversion error occurs, *\a{ok} is set to false; otherwise
+    *\a{ok} is set to true.
+
+    If \a base is 0, the C language convention is used: If the string
+    begins with "0x", base 16 is used; if the string begins with "0",
+    base 8 is used; otherwise, base 10 is used.
+
+    The string conversion will always happen in the 'C' locale. Unlike
+    toString().toLongLong(), no temporary QString is created.
+
+    \sa QString::toLongLong()
+*/
+qint64 QStringRef::toLongLong(bool *ok, int base) const
+{
+    return QString::toLongLong_helper(unicode(), m_size, ok, base);
+}
+
+/*!
+    \since 5.1
+
+    Returns the string converted to an \c{unsigned long long} using base
+    \a base, which is 10 by default and must be between 2 and 36, or 0.
+    Returns 0 if the conversion fails.
+
+    If a conversion error occurs, *\a{ok} is set to false; otherwise
+    *\a{ok} is set to true.
+
+    \sa QString::toULongLong(), toLongLong()
+*/
+quint64 QStringRef::toULongLong(bool *ok, int base) const
+{
+    return QString::toULongLong_helper(unicode(), m_size, ok, base);
+}
+
+/*!
+    \since 5.1
+
+    Returns the string converted to a \c long using base \a base,
+    which is 10 by default and must be between 2 and 36, or 0.
+    Returns 0 if the conversion fails.
+
+    If a conversion error occurs, *\a{ok} is set to false; otherwise
+    *\a{ok} is set to true.
+
+    \sa QString::toLong(), toLongLong()
+*/
+long QStringRef::toLong(bool *ok, int base) const
+{
+    return long(checkSignedRange(toLongLong(ok, base), LONG_MIN, LONG_MAX, ok));
+}
+
+/*!
+    \since 5.1
+
+    Returns the string converted to an \c{unsigned long} using base \a
+    base, which is 10 by default and must be between 2 and 36, or 0.
+    Returns 0 if the conversion fails.
+
+    If a conversion error occurs, *\a{ok} is set to false; otherwise
+    *\a{ok} is set to true.
+
+    \sa QString::toULong(), toLongLong()
+*/
+ulong QStringRef::toULong(bool *ok, int base) const
+{
+    return ulong(checkUnsignedRange(toULongLong(ok, base), ULONG_MAX, ok));
+}
+
+/*!
+    \since 5.1
+
+    Returns the string converted to an \c int using base \a base,
+    which is 10 by default and must be between 2 and 36, or 0.
+    Returns 0 if the conversion fails.
+
+    If a conversion error occurs, *\a{ok} is set to false; otherwise
+    *\a{ok} is set to true.
+
+    \sa QString::toInt(), toLongLong()
+*/
+int QStringRef::toInt(bool *ok, int base) const
+{
+    return int(checkSignedRange(toLongLong(ok, base), INT_MIN, INT_MAX, ok));
+}
+
+/*!
+    \since 5.1
+
+    Returns the string converted to an \c{unsigned int} using base \a
+    base, which is 10 by default and must be between 2 and 36, or 0.
+    Returns 0 if the conversion fails.
+
+    If a conversion error occurs, *\a{ok} is set to false; otherwise
+    *\a{ok} is set to true.
+
+    \sa QString::toUInt(), toLongLong()
+*/
+uint QStringRef::toUInt(bool *ok, int base) const
+{
+    return uint(checkUnsignedRange(toULongLong(ok, base), UINT_MAX, ok));
+}
+
+/*!
+    \since 5.1
+
+    Returns the string converted to a \c short using base \a base,
+    which is 10 by default and must be between 2 and 36, or 0.
+    Returns 0 if the conversion fails.
+
+    If a conversion error occurs, *\a{ok} is set to false; otherwise
+    *\a{ok} is set to true.
+
+    \sa QString::toShort(), toLongLong()
+*/
+short QStringRef::toShort(bool *ok, int base) const
+{
+    return short(checkSignedRange(toLongLong(ok, base), SHRT_MIN, SHRT_MAX, ok));
+}
+
+/*!
+    \since 5.1
+
+    Returns the string converted to an \c{unsigned short} using base \a
+    base, which is 10 by default and must be between 2 and 36, or 0.
+    Returns 0 if the conversion fails.
+
+    If a conversion error occurs, *\a{ok} is set to false; otherwise
+    *\a{ok} is set to true.
+
+    \sa QString::toUShort(), toLongLong()
+*/
+ushort QStringRef::toUShort(bool *ok, int base) const
+{
+    return ushort(checkUnsignedRange(toULongLong(ok, base), USHRT_MAX, ok));
+}
+
+/*!
+    \since 5.1
+
+    Returns the string converted to a \c double value.
+    Returns 0.0 if the conversion fails.
+
+    If a conversion error occurs, \c{*}\a{ok} is set to false;
+    otherwise \c{*}\a{ok} is set to true.
+
+    The string conversion will always happen in the 'C' locale.
+
+    \sa QString::toDouble()
+*/
+double QStringRef::toDouble(bool *ok) const
+{
+    return QString::toDouble_helper(unicode(), m_size, ok);
+}
+
+/*!
+    \since 5.1
+
+    Returns the string converted to a \c float value.
+    Returns 0.0 if the conversion fails.
+
+    If a conversion error occurs, *\a{ok} is set to false; otherwise
+    *\a{ok} is set to true.
+
+    \sa QString::toFloat(), toDouble()
+*/
+float QStringRef::toFloat(bool *ok) const
+{
+    bool myOk;
+    const double d = toDouble(&myOk);
+    return doubleToFloat(d, myOk, ok);
+}
+
 
 /*!
     \obsolete
@@ -41,6 +41,8 @@
 
 #include "qstringbuilder.h"
 #include <QtCore/qtextcodec.h>
+#include <QtCore/qnumeric.h>
+#include "qlocale_tools_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -92,7 +94,7 @@ QT_BEGIN_NAMESPACE
     takes a QString parameter.
 
     This function is usable with arguments of type \c QString,
-    \c QLatin1String, \c QStringRef,
+    \c QLatin1String, \c QStringRef, \c QStringNumber,
     \c QChar, \c QCharRef, \c QLatin1Char, and \c char.
 */
 
@@ -106,6 +108,184 @@ QT_BEGIN_NAMESPACE
  */
 
 
+/*!
+    \class QStringNumber
+    \inmodule QtCore
+    \reentrant
+    \since 5.1
+
+    \brief The QStringNumber class formats a number as part of a string
+    concatenation.
+
+    \ingroup tools
+    \ingroup string-processing
+
+    QStringNumber formats an integer or a \c double the same way as
+    QString::number() does. It is meant to be used with the \c{'%'}
+    operator of QStringBuilder: the digits are kept in a small buffer
+    inside the QStringNumber object and are written directly into the
+    string that is being built, so no temporary QString is created.
+
+    \snippet qstring/stringbuilder.cpp 6
+
+    Like all parts of a QStringBuilder expression, a QStringNumber must
+    outlive the expression it is used in. Assign the expression to a
+    QString rather than storing it in a variable of type \c auto.
+
+    \sa QString::number(), QString::arg()
+*/
+
+/*!
+    Constructs a QStringNumber that holds \a n, formatted in the given
+    \a base, which is 10 by default and must be between 2 and 36. For
+    bases other than 10, \a n is treated as an unsigned integer.
+
+    \sa QString::number()
+*/
+QStringNumber::QStringNumber(int n, int base)
+{
+    setNumber(n < 0 && base == 10 ? 0 - qulonglong(n) : qulonglong(qlonglong(n)), n < 0 && base == 10, base);
+}
+
+/*!
+    \overload
+*/
+QStringNumber::QStringNumber(uint n, int base)
+{
+    setNumber(n, false, base);
+}
+
+/*!
+    \overload
+*/
+QStringNumber::QStringNumber(long n, int base)
+{
+    setNumber(n < 0 && base == 10 ? 0 - qulonglong(n) : qulonglong(qlonglong(n)), n < 0 && base == 10, base);
+}
+
+/*!
+    \overload
+*/
+QStringNumber::QStringNumber(ulong n, int base)
+{
+    setNumber(n, false, base);
+}
+
+/*!
+    \overload
+*/
+QStringNumber::QStringNumber(qlonglong n, int base)
+{
+    setNumber(n < 0 && base == 10 ? 0 - qulonglong(n) : qulonglong(n), n < 0 && base == 10, base);
+}
+
+/*!
+    \overload
+*/
+QStringNumber::QStringNumber(qulonglong n, int base)
+{
+    setNumber(n, false, base);
+}
+
+/*!
+    Constructs a QStringNumber that holds \a n, formatted according to
+    \a format and \a precision, like QString::number() does.
+
+    \sa QString::number(), {Argument Formats}
+*/
+QStringNumber::QStringNumber(double n, char format, int precision)
+{
+    setNumber(n, format, precision);
+}
+
+/*!
+    \fn int QStringNumber::size() const
+
+    Returns the number of characters of the formatted number.
+*/
+
+/*!
+    Returns the formatted number as a QString.
+*/
+QString QStringNumber::toString() const
+{
+    if (!m_fallback.isNull())
+        return m_fallback;
+    return QString::fromLatin1(m_buffer + m_begin, m_size);
+}
+
+void QStringNumber::setNumber(qulonglong n, bool negative, int base)
+{
+#if defined(QT_CHECK_RANGE)
+    if (base < 2 || base > 36) {
+        qWarning("QStringNumber: Invalid base (%d)", base);
+        base = 10;
+    }
+#endif
+    // the digits are written backwards, starting at the end of the buffer
+    char *p = m_buffer + BufferSize;
+    do {
+        const int c = n % base;
+        *--p = c < 10 ? '0' + c : 'a' + c - 10;
+        n /= base;
+    } while (n != 0);
+    if (negative)
+        *--p = '-';
+
+    m_begin = p - m_buffer;
+    m_size = BufferSize - m_begin;
+}
+
+/*
+    Formats \a n into m_buffer in the same way as the C locale's
+    QLocalePrivate::doubleToString() does without any flags, using the
+    same qt_doubleToAscii() layout. Results that do not fit into the
+    buffer are kept in m_fallback instead.
+*/
+void QStringNumber::setNumber(double n, char format, int precision)
+{
+    m_begin = 0;
+    m_size = 0;
+
+    const bool upper = format >= 'A' && format <= 'Z';
+    QLocalePrivate::DoubleForm form = QLocalePrivate::DFDecimal;
+    switch (upper ? format - 'A' + 'a' : format) {
+    case 'e':
+        form = QLocalePrivate::DFExponent;
+        break;
+    case 'g':
+        form = QLocalePrivate::DFSignificantDigits;
+        break;
+    default:
+        break;
+    }
+
+    if (qIsInf(n) || qIsNaN(n)) {
+        const char *special = qIsNaN(n) ? "nan" : (n < 0 ? "-inf" : "inf");
+        for (; *special; ++special)
+            m_buffer[m_size++] = upper && *special != '-' ? *special - 'a' + 'A' : *special;
+        return;
+    }
+
+    QLocalePrivate::CharBuff buf;
+    if (n < 0)
+        buf.append('-');
+    qt_doubleToAscii(n, form, precision, 0, &buf);
+    if (upper) {
+        for (int i = 0; i < buf.size(); ++i) {
+            if (buf.at(i) == 'e')
+                buf[i] = 'E';
+        }
+    }
+
+    if (buf.size() > int(BufferSize)) {
+        m_fallback = QString::fromLatin1(buf.constData(), buf.size());
+        return;
+    }
+    memcpy(m_buffer, buf.constData(), buf.size());
+    m_size = buf.size();
+}
+
 /*!
     \internal
  */
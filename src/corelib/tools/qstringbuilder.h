@@ -351,6 +351,65 @@ template <> struct QConcatenable<QByteArray> : private QAbstractConcatenable
 };
 
 
+class Q_CORE_EXPORT QStringNumber
+{
+public:
+    explicit QStringNumber(int n, int base = 10);
+    explicit QStringNumber(uint n, int base = 10);
+    explicit QStringNumber(long n, int base = 10);
+    explicit QStringNumber(ulong n, int base = 10);
+    explicit QStringNumber(qlonglong n, int base = 10);
+    explicit QStringNumber(qulonglong n, int base = 10);
+    explicit QStringNumber(double n, char format = 'g', int precision = 6);
+
+    inline int size() const { return m_fallback.isNull() ? m_size : m_fallback.size(); }
+    QString toString() const;
+
+private:
+    void setNumber(qulonglong n, bool negative, int base);
+    void setNumber(double n, char format, int precision);
+
+    enum { BufferSize = 65 }; // the length of MAX_ULLONG in base 2
+    char m_buffer[BufferSize];
+    int m_begin;
+    int m_size;
+    QString m_fallback; // only used for numbers that do not fit into m_buffer
+
+    friend struct QConcatenable<QStringNumber>;
+};
+
+template <> struct QConcatenable<QStringNumber>
+{
+    typedef QStringNumber type;
+    typedef QString ConvertTo;
+    enum { ExactSize = true };
+    static int size(const QStringNumber &n) { return n.size(); }
+    static inline void appendTo(const QStringNumber &n, QChar *&out)
+    {
+        if (!n.m_fallback.isNull()) {
+            const int len = n.m_fallback.size();
+            memcpy(out, reinterpret_cast<const char*>(n.m_fallback.constData()), sizeof(QChar) * len);
+            out += len;
+            return;
+        }
+        const char *s = n.m_buffer + n.m_begin;
+        for (const char * const end = s + n.m_size; s != end; )
+            *out++ = QLatin1Char(*s++);
+    }
+    static inline void appendTo(const QStringNumber &n, char *&out)
+    {
+        if (!n.m_fallback.isNull()) {
+            const QChar *s = n.m_fallback.constData();
+            for (const QChar * const end = s + n.m_fallback.size(); s != end; )
+                *out++ = (s++)->toLatin1();
+            return;
+        }
+        memcpy(out, n.m_buffer + n.m_begin, n.m_size);
+        out += n.m_size;
+    }
+};
+
+
 template <typename A, typename B>
 struct QConcatenable< QStringBuilder<A, B> >
 {
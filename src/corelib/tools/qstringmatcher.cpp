@@ -40,6 +40,7 @@
 ****************************************************************************/
 
 #include "qstringmatcher.h"
+#include "private/qsimd_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -62,11 +63,57 @@ static void bm_init_skiptable(const ushort *uc, int len, uchar *skiptable, Qt::C
     }
 }
 
+#if defined(__SSE2__)
+/*
+    Boyer-Moore cannot skip more than the pattern length, so for short
+    case sensitive patterns it is faster to look at 8 positions at a time:
+    compare the first and the last character of the pattern with the
+    corresponding characters of 8 candidate positions, and only compare the
+    rest of the pattern where both match.
+*/
+enum { MaxSimdPatternLength = 16 };
+
+static int simd_find(const ushort *uc, int l, int index, const ushort *puc, uint pl)
+{
+    if (index > l - int(pl))
+        return -1;
+
+    const __m128i first = _mm_set1_epi16(puc[0]);
+    const __m128i last = _mm_set1_epi16(puc[pl - 1]);
+    const ushort *current = uc + index;
+    const ushort *end = uc + l - pl + 1;  // one past the last candidate position
+
+    for ( ; end - current >= 8; current += 8) {
+        const __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i *>(current));
+        const __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i *>(current + pl - 1));
+        uint mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi16(head, first),
+                                                    _mm_cmpeq_epi16(tail, last)));
+        while (mask) {
+            // two bits per character
+            const uint i = qCountTrailingZeroBits(mask);
+            if (pl <= 2 || memcmp(current + i / 2 + 1, puc + 1, (pl - 2) * sizeof(ushort)) == 0)
+                return current + i / 2 - uc;
+            mask &= ~(3u << i);
+        }
+    }
+    for ( ; current < end; ++current) {
+        if (current[0] == puc[0] && current[pl - 1] == puc[pl - 1]
+            && (pl <= 2 || memcmp(current + 1, puc + 1, (pl - 2) * sizeof(ushort)) == 0))
+            return current - uc;
+    }
+    return -1;
+}
+#endif
+
 static inline int bm_find(const ushort *uc, uint l, int index, const ushort *puc, uint pl,
                           const uchar *skiptable, Qt::CaseSensitivity cs)
 {
     if (pl == 0)
         return index > (int)l ? -1 : index;
+#if defined(__SSE2__)
+    if (cs == Qt::CaseSensitive && pl <= MaxSimdPatternLength)
+        return simd_find(uc, int(l), index, puc, pl);
+#endif
     const uint pl_minus_one = pl - 1;
 
     register const ushort *current = uc + index + pl_minus_one;
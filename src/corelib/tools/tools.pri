@@ -3,6 +3,8 @@
 HEADERS +=  \
         tools/qalgorithms.h \
         tools/qarraydata.h \
+        tools/qarraydataarena.h \
+        tools/qarraydataarena_p.h \
         tools/qarraydataops.h \
         tools/qarraydatapointer.h \
         tools/qbitarray.h \
@@ -10,6 +12,7 @@ HEADERS +=  \
         tools/qbytearraymatcher.h \
         tools/qbytedata_p.h \
         tools/qcache.h \
+        tools/qconcurrentcache.h \
         tools/qchar.h \
         tools/qcollator_p.h \
         tools/qcontainerfwd.h \
@@ -27,9 +30,12 @@ HEADERS +=  \
         tools/qlocale_p.h \
         tools/qlocale_tools_p.h \
         tools/qlocale_data_p.h \
+        tools/qlocale_powers_p.h \
         tools/qmap.h \
+        tools/qmultipatternmatcher.h \
         tools/qmargins.h \
         tools/qcontiguouscache.h \
+        tools/qflathash.h \
         tools/qpodlist_p.h \
         tools/qpair.h \
         tools/qpoint.h \
@@ -64,6 +70,7 @@ HEADERS +=  \
 
 SOURCES += \
         tools/qarraydata.cpp \
+        tools/qarraydataarena.cpp \
         tools/qbitarray.cpp \
         tools/qbytearray.cpp \
         tools/qbytearraymatcher.cpp \
@@ -81,8 +88,10 @@ SOURCES += \
         tools/qlocale_tools.cpp \
         tools/qpoint.cpp \
         tools/qmap.cpp \
+        tools/qmultipatternmatcher.cpp \
         tools/qmargins.cpp \
         tools/qcontiguouscache.cpp \
+        tools/qflathash.cpp \
         tools/qrect.cpp \
         tools/qregexp.cpp \
         tools/qregularexpression.cpp \
@@ -100,6 +109,8 @@ SOURCES += \
         tools/qvector.cpp \
         tools/qvsnprintf.cpp
 
+SSE4_2_SOURCES += tools/qhash_sse4_2.cpp
+
 !nacl:mac: {
     SOURCES += tools/qelapsedtimer_mac.cpp
     OBJECTIVE_SOURCES += tools/qlocale_mac.mm
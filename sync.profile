@@ -37,6 +37,7 @@
     "qtconcurrentmap.h" => "QtConcurrentMap",
     "qtconcurrentfilter.h" => "QtConcurrentFilter",
     "qtconcurrentrun.h" => "QtConcurrentRun",
+    "qtconcurrentsort.h" => "QtConcurrentSort",
 );
 %deprecatedheaders = (
     "QtGui" =>  {
@@ -4,5 +4,6 @@ SUBDIRS=\
    qtconcurrentiteratekernel \
    qtconcurrentmap \
    qtconcurrentrun \
+   qtconcurrentsort \
    qtconcurrentthreadengine
 
@@ -66,6 +66,7 @@ private slots:
     void blocking_mapped();
     void mappedReduced();
     void blocking_mappedReduced();
+    void parallelReduce();
     void assignResult();
     void functionOverloads();
 #ifndef QT_NO_EXCEPTIONS
@@ -2027,6 +2028,66 @@ int sleeper(int val)
     return val;
 }
 
+void appendReduce(QList<int> &list, int x)
+{
+    list.append(x);
+}
+
+void listJoinReduce(QList<int> &list, const QList<int> &other)
+{
+    list += other;
+}
+
+QList<int> intToList(int x)
+{
+    return QList<int>() << x;
+}
+
+void tst_QtConcurrentMap::parallelReduce()
+{
+    QList<int> list;
+    for (int i = 0; i < 10000; ++i)
+        list << i % 100;
+    int expected = 0;
+    for (int i = 0; i < list.count(); ++i)
+        expected += list.at(i) * list.at(i);
+
+    // the map function returns the type of the final result
+    {
+        int sum = QtConcurrent::blockingMappedReduced<int>(list, intSquare, intSumReduce,
+                                                           UnorderedReduce | ParallelReduce);
+        QCOMPARE(sum, expected);
+        QFuture<int> future = QtConcurrent::mappedReduced<int>(list, intSquare, intSumReduce,
+                                                                UnorderedReduce | ParallelReduce);
+        QCOMPARE(future.result(), expected);
+        sum = QtConcurrent::blockingMappedReduced<int>(list.constBegin(), list.constEnd(),
+                                                       IntSquare(), intSumReduce,
+                                                       UnorderedReduce | ParallelReduce);
+        QCOMPARE(sum, expected);
+    }
+    {
+        QList<int> joined = QtConcurrent::blockingMappedReduced<QList<int> >(list, intToList, listJoinReduce,
+                                                                             UnorderedReduce | ParallelReduce);
+        QCOMPARE(joined.count(), list.count());
+        qSort(joined);
+        QList<int> sorted = list;
+        qSort(sorted);
+        QCOMPARE(joined, sorted);
+    }
+    {
+        int sum = QtConcurrent::blockingMappedReduced<int>(QList<int>(), intSquare, intSumReduce,
+                                                           UnorderedReduce | ParallelReduce);
+        QCOMPARE(sum, 0);
+    }
+
+    // falls back to sequential reduction otherwise
+    {
+        QList<int> squares = QtConcurrent::blockingMappedReduced<QList<int> >(list, intSquare, appendReduce,
+                                                                              UnorderedReduce | ParallelReduce);
+        QCOMPARE(squares.count(), list.count());
+    }
+}
+
 void tst_QtConcurrentMap::assignResult()
 {
     const QList<int> startList = QList<int>() << 0 << 1 << 2;
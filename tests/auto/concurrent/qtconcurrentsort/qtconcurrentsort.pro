@@ -0,0 +1,5 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qtconcurrentsort
+QT = core testlib concurrent
+SOURCES = tst_qtconcurrentsort.cpp
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
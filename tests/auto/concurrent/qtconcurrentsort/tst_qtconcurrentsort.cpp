@@ -0,0 +1,307 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <qtconcurrentsort.h>
+#include <qtconcurrentrun.h>
+#include <QSemaphore>
+#include <QStringList>
+#include <QtTest/QtTest>
+
+class tst_QtConcurrentSort: public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void sort_data();
+    void sort();
+    void stableSort_data();
+    void stableSort();
+    void customLessThan();
+    void list();
+    void merge_data();
+    void merge();
+    void busyPool();
+    void calledFromPool();
+};
+
+// Keeps the parallel code paths in use on machines with few cores.
+void tst_QtConcurrentSort::initTestCase()
+{
+    QThreadPool::globalInstance()->setMaxThreadCount(qMax(4, QThread::idealThreadCount()));
+}
+
+static QVector<int> generate(const QString &type, int size)
+{
+    QVector<int> data(size);
+    for (int i = 0; i < size; ++i) {
+        if (type == QLatin1String("random"))
+            data[i] = qrand();
+        else if (type == QLatin1String("ascending"))
+            data[i] = i;
+        else if (type == QLatin1String("descending"))
+            data[i] = size - i;
+        else if (type == QLatin1String("equal"))
+            data[i] = 42;
+        else
+            data[i] = qrand() % 10;
+    }
+    return data;
+}
+
+Q_DECLARE_METATYPE(QVector<int>)
+
+void tst_QtConcurrentSort::sort_data()
+{
+    QTest::addColumn<QVector<int> >("data");
+
+    qsrand(1);
+    const int sizes[] = { 0, 1, 100, QtConcurrent::SortSerialThreshold - 1,
+                          QtConcurrent::SortSerialThreshold, 100000, 1000003 };
+    const char *types[] = { "random", "ascending", "descending", "equal", "duplicates" };
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        for (size_t j = 0; j < sizeof(types) / sizeof(types[0]); ++j) {
+            QTest::newRow(QByteArray(types[j]) + ' ' + QByteArray::number(sizes[i]))
+                    << generate(QLatin1String(types[j]), sizes[i]);
+        }
+    }
+}
+
+void tst_QtConcurrentSort::sort()
+{
+    QFETCH(QVector<int>, data);
+
+    QVector<int> expected = data;
+    qSort(expected);
+
+    QVector<int> sorted = data;
+    QtConcurrent::blockingSort(sorted.begin(), sorted.end());
+    QVERIFY(sorted == expected);
+
+    sorted = data;
+    QtConcurrent::blockingSort(sorted);
+    QVERIFY(sorted == expected);
+
+    sorted = data;
+    QtConcurrent::blockingStableSort(sorted);
+    QVERIFY(sorted == expected);
+}
+
+struct Item
+{
+    Item() : key(0), index(0) {}
+    Item(int key, int index) : key(key), index(index) {}
+
+    int key;
+    int index;
+
+    bool operator==(const Item &other) const
+    { return key == other.key && index == other.index; }
+};
+
+static bool keyLessThan(const Item &a, const Item &b)
+{
+    return a.key < b.key;
+}
+
+void tst_QtConcurrentSort::stableSort_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("keyCount");
+
+    QTest::newRow("small") << 1000 << 10;
+    QTest::newRow("few keys") << 200000 << 3;
+    QTest::newRow("many keys") << 200000 << 10000;
+    QTest::newRow("one key") << 100000 << 1;
+}
+
+void tst_QtConcurrentSort::stableSort()
+{
+    QFETCH(int, size);
+    QFETCH(int, keyCount);
+
+    qsrand(2);
+    QVector<Item> data;
+    for (int i = 0; i < size; ++i)
+        data.append(Item(qrand() % keyCount, i));
+
+    QVector<Item> expected = data;
+    qStableSort(expected.begin(), expected.end(), keyLessThan);
+
+    QtConcurrent::blockingStableSort(data.begin(), data.end(), keyLessThan);
+    QVERIFY(data == expected);
+}
+
+void tst_QtConcurrentSort::customLessThan()
+{
+    QVector<int> data = generate(QLatin1String("random"), 50000);
+    QVector<int> expected = data;
+    qSort(expected.begin(), expected.end(), qGreater<int>());
+
+    QtConcurrent::blockingSort(data.begin(), data.end(), qGreater<int>());
+    QVERIFY(data == expected);
+}
+
+void tst_QtConcurrentSort::list()
+{
+    QStringList list;
+    for (int i = 0; i < 50000; ++i)
+        list.append(QString::number(qrand()));
+
+    QStringList expected = list;
+    qSort(expected);
+
+    QtConcurrent::blockingSort(list);
+    QCOMPARE(list, expected);
+}
+
+void tst_QtConcurrentSort::merge_data()
+{
+    QTest::addColumn<int>("size1");
+    QTest::addColumn<int>("size2");
+
+    QTest::newRow("empty") << 0 << 0;
+    QTest::newRow("first empty") << 0 << 50000;
+    QTest::newRow("second empty") << 50000 << 0;
+    QTest::newRow("small") << 10 << 20;
+    QTest::newRow("balanced") << 100000 << 100000;
+    QTest::newRow("unbalanced") << 1000 << 200000;
+}
+
+void tst_QtConcurrentSort::merge()
+{
+    QFETCH(int, size1);
+    QFETCH(int, size2);
+
+    // Items of the first range must come before equal ones of the second.
+    qsrand(3);
+    QVector<Item> first;
+    for (int i = 0; i < size1; ++i)
+        first.append(Item(qrand() % 1000, i));
+    QVector<Item> second;
+    for (int i = 0; i < size2; ++i)
+        second.append(Item(qrand() % 1000, size1 + i));
+    qStableSort(first.begin(), first.end(), keyLessThan);
+    qStableSort(second.begin(), second.end(), keyLessThan);
+
+    QVector<Item> expected = first + second;
+    qStableSort(expected.begin(), expected.end(), keyLessThan);
+
+    QVector<Item> merged(size1 + size2);
+    QtConcurrent::blockingMerge(first.constBegin(), first.constEnd(),
+                                second.constBegin(), second.constEnd(),
+                                merged.begin(), keyLessThan);
+    QVERIFY(merged == expected);
+
+    QVector<int> firstKeys;
+    for (int i = 0; i < size1; ++i)
+        firstKeys.append(first.at(i).key);
+    QVector<int> secondKeys;
+    for (int i = 0; i < size2; ++i)
+        secondKeys.append(second.at(i).key);
+    QVector<int> mergedKeys(size1 + size2);
+    QtConcurrent::blockingMerge(firstKeys.constBegin(), firstKeys.constEnd(),
+                                secondKeys.constBegin(), secondKeys.constEnd(),
+                                mergedKeys.begin());
+    for (int i = 0; i < mergedKeys.size(); ++i)
+        QCOMPARE(mergedKeys.at(i), expected.at(i).key);
+}
+
+class BlockingRunnable : public QRunnable
+{
+public:
+    BlockingRunnable(QSemaphore *started, QSemaphore *release)
+        : started(started), release(release)
+    {}
+
+    void run()
+    {
+        started->release();
+        release->acquire();
+    }
+
+private:
+    QSemaphore *started;
+    QSemaphore *release;
+};
+
+void tst_QtConcurrentSort::busyPool()
+{
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int threadCount = pool->maxThreadCount();
+    QSemaphore started;
+    QSemaphore release;
+    for (int i = 0; i < threadCount; ++i)
+        pool->start(new BlockingRunnable(&started, &release));
+    started.acquire(threadCount);
+
+    // No thread of the pool is available, so the calling thread does all
+    // the work.
+    QVector<int> data = generate(QLatin1String("random"), 100000);
+    QVector<int> expected = data;
+    qSort(expected);
+    QtConcurrent::blockingStableSort(data);
+    QVERIFY(data == expected);
+
+    release.release(threadCount);
+    pool->waitForDone();
+}
+
+static QVector<int> sortedCopy(const QVector<int> &data)
+{
+    QVector<int> copy = data;
+    QtConcurrent::blockingSort(copy);
+    return copy;
+}
+
+void tst_QtConcurrentSort::calledFromPool()
+{
+    QVector<int> data = generate(QLatin1String("random"), 100000);
+    QVector<int> expected = data;
+    qSort(expected);
+
+    QList<QFuture<QVector<int> > > futures;
+    for (int i = 0; i < QThreadPool::globalInstance()->maxThreadCount(); ++i)
+        futures.append(QtConcurrent::run(sortedCopy, data));
+    for (int i = 0; i < futures.size(); ++i)
+        QVERIFY(futures[i].result() == expected);
+}
+
+QTEST_MAIN(tst_QtConcurrentSort)
+#include "tst_qtconcurrentsort.moc"
@@ -68,6 +68,12 @@ private slots:
     void charByChar_data();
     void charByChar();
 
+    void longStrings_data();
+    void longStrings();
+
+    void longInvalidUtf8_data();
+    void longInvalidUtf8();
+
     void invalidUtf8_data();
     void invalidUtf8();
 
@@ -202,6 +208,80 @@ void tst_Utf8::charByChar()
     }
 }
 
+// The ASCII runs are converted in blocks of 16 and 32 characters. Place
+// non-ASCII characters at every offset around the block boundaries.
+void tst_Utf8::longStrings_data()
+{
+    QTest::addColumn<QByteArray>("utf8");
+    QTest::addColumn<QString>("utf16");
+
+    static const uint nonAscii[] = { 0x00A0, 0x20AC, 0x10FFFD };
+    static const char *const nonAsciiUtf8[] = { "\302\240", "\342\202\254", "\364\217\277\275" };
+
+    const QByteArray ascii("The quick brown fox jumps over the lazy dog, ~0123456789 times!");
+    for (uint c = 0; c < sizeof(nonAscii) / sizeof(nonAscii[0]); ++c) {
+        for (int pos = 0; pos <= ascii.length(); ++pos) {
+            QByteArray utf8 = ascii;
+            utf8.insert(pos, nonAsciiUtf8[c]);
+            QString utf16 = QString::fromLatin1(ascii);
+            utf16.insert(pos, QString::fromUcs4(nonAscii + c, 1));
+            QTest::newRow(QByteArray("U+" + QByteArray::number(nonAscii[c], 16) + " at "
+                                     + QByteArray::number(pos)).constData())
+                    << utf8 << utf16;
+        }
+    }
+
+    QByteArray utf8 = ascii;
+    QString utf16 = QString::fromLatin1(ascii);
+    for (int i = 0; i < 4; ++i) {
+        utf8 += utf8;
+        utf16 += utf16;
+    }
+    QTest::newRow("long ascii") << utf8 << utf16;
+    QTest::newRow("long mixed") << (utf8 + "\342\202\254" + utf8) << (utf16 + QChar(0x20AC) + utf16);
+}
+
+void tst_Utf8::longStrings()
+{
+    roundTrip();
+}
+
+void tst_Utf8::longInvalidUtf8_data()
+{
+    QTest::addColumn<QByteArray>("utf8");
+    QTest::addColumn<int>("pos");
+
+    static const char *const invalid[] = { "\377", "\200", "\300\200", "\355\240\200", "\357\277\276" };
+    const QByteArray ascii("The quick brown fox jumps over the lazy dog, ~0123456789 times!");
+    for (uint i = 0; i < sizeof(invalid) / sizeof(invalid[0]); ++i) {
+        for (int pos = 0; pos <= ascii.length(); pos += 3) {
+            QByteArray utf8 = ascii;
+            utf8.insert(pos, invalid[i]);
+            QTest::newRow(QByteArray(QByteArray(invalid[i]).toHex() + " at " + QByteArray::number(pos)).constData())
+                    << utf8 << pos;
+        }
+    }
+}
+
+void tst_Utf8::longInvalidUtf8()
+{
+    QFETCH(QByteArray, utf8);
+    QFETCH(int, pos);
+    QFETCH_GLOBAL(bool, useLocale);
+    if (useLocale)
+        QSKIP("Only enforce correctness on our UTF-8 decoder");
+
+    QSharedPointer<QTextDecoder> decoder = QSharedPointer<QTextDecoder>(codec->makeDecoder());
+    const QString decoded = decoder->toUnicode(utf8);
+    QVERIFY(decoder->hasFailure());
+
+    // the ASCII characters around the invalid sequence are kept
+    const QByteArray ascii("The quick brown fox jumps over the lazy dog, ~0123456789 times!");
+    QCOMPARE(decoded.left(pos), QString::fromLatin1(ascii.left(pos)));
+    QVERIFY(decoded.endsWith(QString::fromLatin1(ascii.mid(pos))));
+    QCOMPARE(decoded.at(pos), QChar(QChar::ReplacementCharacter));
+}
+
 void tst_Utf8::invalidUtf8_data()
 {
     QTest::addColumn<QByteArray>("utf8");
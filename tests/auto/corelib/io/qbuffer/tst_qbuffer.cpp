@@ -71,6 +71,7 @@ private slots:
     void getAndUngetChar();
     void writeAfterQByteArrayResize();
     void read_null();
+    void peekView();
 
 protected slots:
     void readyReadSlot();
@@ -615,5 +616,46 @@ void tst_QBuffer::read_null()
     QCOMPARE(chunk, buffer.mid(16380, chunk.size()));
 }
 
+void tst_QBuffer::peekView()
+{
+    const QByteArray data("0123456789");
+    QBuffer buffer;
+    buffer.setData(data);
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+
+    // the view points straight into the byte array
+    qint64 size;
+    const char *view = buffer.peekView(&size);
+    QCOMPARE(view, buffer.buffer().constData());
+    QCOMPARE(size, qint64(10));
+
+    QCOMPARE(buffer.skip(3), qint64(3));
+    QCOMPARE(buffer.pos(), qint64(3));
+    view = buffer.peekView(&size);
+    QCOMPARE(view, buffer.buffer().constData() + 3);
+    QCOMPARE(size, qint64(7));
+
+    // mixing with buffered reads
+    char c;
+    QVERIFY(buffer.getChar(&c));
+    QCOMPARE(c, '3');
+    view = buffer.peekView(&size);
+    QCOMPARE(QByteArray(view, size), QByteArray("456789"));
+    QCOMPARE(buffer.skip(2), qint64(2));
+    QCOMPARE(buffer.read(2), QByteArray("67"));
+
+    // writes are visible to the next view
+    QCOMPARE(buffer.write("ab"), qint64(2));
+    QVERIFY(buffer.seek(8));
+    view = buffer.peekView(&size);
+    QCOMPARE(QByteArray(view, size), QByteArray("ab"));
+
+    QCOMPARE(buffer.skip(100), qint64(2));
+    QVERIFY(!buffer.peekView(&size));
+    QCOMPARE(size, qint64(0));
+    QCOMPARE(buffer.skip(1), qint64(0));
+    QVERIFY(buffer.atEnd());
+}
+
 QTEST_MAIN(tst_QBuffer)
 #include "tst_qbuffer.moc"
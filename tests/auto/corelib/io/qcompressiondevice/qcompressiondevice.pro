@@ -0,0 +1,4 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qcompressiondevice
+QT = core testlib
+SOURCES = tst_qcompressiondevice.cpp
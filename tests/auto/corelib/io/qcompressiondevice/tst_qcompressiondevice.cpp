@@ -0,0 +1,391 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QBuffer>
+#include <QByteArray>
+#include <qcompressiondevice.h>
+
+Q_DECLARE_METATYPE(QCompressionDevice::Format)
+
+static QByteArray testData(int size)
+{
+    // half text, half noise, so that both the literal and the match paths are used
+    QByteArray data;
+    data.reserve(size);
+    qsrand(size);
+    while (data.size() < size) {
+        data += "The quick brown fox jumps over the lazy dog. ";
+        for (int i = 0; i < 40; ++i)
+            data += char(qrand());
+    }
+    data.truncate(size);
+    return data;
+}
+
+static const char helloGzip[] =
+    "\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\x03\xf3\x48\xcd\xc9\xc9\xd7"
+    "\x51\x48\xaf\xca\x2c\x50\xe4\x02\x00\x05\x14\xa6\xf3\x0d\x00\x00"
+    "\x00";
+
+// two members, as produced by "cat one.gz two.gz"
+static const char twoMembersGzip[] =
+    "\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\x03\x2b\x48\x2c\x2a\x51\xc8"
+    "\xcf\x4b\xe5\x02\x00\x0c\xa1\x3d\xf9\x09\x00\x00\x00"
+    "\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\x03\x2b\x48\x2c\x2a\x51\x28"
+    "\x29\xcf\xe7\x02\x00\xe7\x01\x3d\x97\x09\x00\x00\x00";
+
+class tst_QCompressionDevice : public QObject
+{
+    Q_OBJECT
+private slots:
+    void getSetCheck();
+    void openModes();
+    void roundTrip_data();
+    void roundTrip();
+    void readGzip();
+    void concatenatedGzipMembers();
+    void qCompressCompatibility();
+    void readByteByByte();
+    void readLine();
+    void flush();
+    void compressionLevel();
+    void truncatedData_data();
+    void truncatedData();
+    void corruptData();
+    void underlyingDeviceStaysOpen();
+};
+
+void tst_QCompressionDevice::getSetCheck()
+{
+    QBuffer buffer;
+    QCompressionDevice device(&buffer);
+    QCOMPARE(device.device(), static_cast<QIODevice *>(&buffer));
+    QCOMPARE(device.format(), QCompressionDevice::GzipFormat);
+    QCOMPARE(device.compressionLevel(), -1);
+    QCOMPARE(device.bufferSize(), 64 * 1024);
+    QVERIFY(device.isSequential());
+
+    device.setCompressionLevel(9);
+    QCOMPARE(device.compressionLevel(), 9);
+    device.setCompressionLevel(42);
+    QCOMPARE(device.compressionLevel(), 9);
+    device.setCompressionLevel(-5);
+    QCOMPARE(device.compressionLevel(), -1);
+
+    device.setBufferSize(4096);
+    QCOMPARE(device.bufferSize(), 4096);
+    device.setBufferSize(1);
+    QCOMPARE(device.bufferSize(), 64);
+
+    QCompressionDevice raw(&buffer, QCompressionDevice::RawDeflateFormat);
+    QCOMPARE(raw.format(), QCompressionDevice::RawDeflateFormat);
+}
+
+void tst_QCompressionDevice::openModes()
+{
+    QBuffer buffer;
+    QCompressionDevice device(&buffer);
+
+    QTest::ignoreMessage(QtWarningMsg, "QCompressionDevice::open: Underlying device is not open in a compatible mode");
+    QVERIFY(!device.open(QIODevice::ReadOnly));
+
+    buffer.open(QIODevice::WriteOnly);
+    QTest::ignoreMessage(QtWarningMsg, "QCompressionDevice::open: Underlying device is not open in a compatible mode");
+    QVERIFY(!device.open(QIODevice::ReadOnly));
+
+    QTest::ignoreMessage(QtWarningMsg, "QCompressionDevice::open: Device must be opened either ReadOnly or WriteOnly");
+    QVERIFY(!device.open(QIODevice::ReadWrite));
+
+    QVERIFY(device.open(QIODevice::WriteOnly));
+    QCOMPARE(device.openMode(), QIODevice::WriteOnly);
+    QTest::ignoreMessage(QtWarningMsg, "QCompressionDevice::open: Device already open");
+    QVERIFY(!device.open(QIODevice::WriteOnly));
+}
+
+void tst_QCompressionDevice::roundTrip_data()
+{
+    QTest::addColumn<QCompressionDevice::Format>("format");
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("bufferSize");
+
+    static const struct { QCompressionDevice::Format format; const char *name; } formats[] = {
+        { QCompressionDevice::ZlibFormat, "zlib" },
+        { QCompressionDevice::GzipFormat, "gzip" },
+        { QCompressionDevice::RawDeflateFormat, "raw" }
+    };
+    for (int i = 0; i < 3; ++i) {
+        const QByteArray name = formats[i].name;
+        QTest::newRow(name + "-empty") << formats[i].format << 0 << 65536;
+        QTest::newRow(name + "-small") << formats[i].format << 100 << 65536;
+        QTest::newRow(name + "-large") << formats[i].format << 1000000 << 65536;
+        QTest::newRow(name + "-large-tinybuffer") << formats[i].format << 100000 << 64;
+    }
+}
+
+void tst_QCompressionDevice::roundTrip()
+{
+    QFETCH(QCompressionDevice::Format, format);
+    QFETCH(int, size);
+    QFETCH(int, bufferSize);
+
+    const QByteArray data = testData(size);
+
+    QBuffer compressed;
+    compressed.open(QIODevice::WriteOnly);
+    QCompressionDevice writer(&compressed, format);
+    writer.setBufferSize(bufferSize);
+    QVERIFY(writer.open(QIODevice::WriteOnly));
+    // write in uneven pieces
+    for (int pos = 0; pos < data.size(); pos += 7777)
+        QCOMPARE(writer.write(data.mid(pos, 7777)), qint64(qMin(7777, data.size() - pos)));
+    writer.close();
+    compressed.close();
+    QVERIFY(!compressed.data().isEmpty());
+
+    QCOMPARE(QCompressionDevice::decompressData(compressed.data(), format), data);
+    QCOMPARE(QCompressionDevice::compressData(data, format), compressed.data());
+
+    compressed.open(QIODevice::ReadOnly);
+    QCompressionDevice reader(&compressed, format);
+    reader.setBufferSize(bufferSize);
+    QVERIFY(reader.open(QIODevice::ReadOnly));
+    QCOMPARE(reader.readAll(), data);
+    QVERIFY(reader.atEnd());
+    QCOMPARE(reader.read(10), QByteArray());
+}
+
+void tst_QCompressionDevice::readGzip()
+{
+    const QByteArray gzipped(helloGzip, sizeof(helloGzip) - 1);
+    QCOMPARE(QCompressionDevice::decompressData(gzipped), QByteArray("Hello, gzip!\n"));
+
+    // what we write has to be readable by other gzip implementations: check the header
+    const QByteArray ours = QCompressionDevice::compressData("Hello, gzip!\n");
+    QVERIFY(ours.startsWith("\x1f\x8b\x08"));
+    // the trailer holds the CRC-32 and the size, which are independent of the compressor
+    QCOMPARE(ours.right(8), gzipped.right(8));
+}
+
+void tst_QCompressionDevice::concatenatedGzipMembers()
+{
+    QByteArray gzipped(twoMembersGzip, sizeof(twoMembersGzip) - 1);
+    QCOMPARE(QCompressionDevice::decompressData(gzipped), QByteArray("part one\npart two\n"));
+
+    gzipped = QCompressionDevice::compressData("abc") + QCompressionDevice::compressData("def");
+    QCOMPARE(QCompressionDevice::decompressData(gzipped), QByteArray("abcdef"));
+}
+
+void tst_QCompressionDevice::qCompressCompatibility()
+{
+    const QByteArray data = testData(50000);
+
+    // qCompress() output is zlib data behind a four byte size prefix
+    QCOMPARE(QCompressionDevice::decompressData(qCompress(data).mid(4),
+                                                QCompressionDevice::ZlibFormat), data);
+
+    QByteArray zlib = QCompressionDevice::compressData(data, QCompressionDevice::ZlibFormat);
+    QByteArray prefix(4, 0);
+    prefix[0] = char(data.size() >> 24);
+    prefix[1] = char(data.size() >> 16);
+    prefix[2] = char(data.size() >> 8);
+    prefix[3] = char(data.size());
+    QCOMPARE(qUncompress(prefix + zlib), data);
+}
+
+void tst_QCompressionDevice::readByteByByte()
+{
+    const QByteArray data = testData(5000);
+    QBuffer buffer;
+    buffer.setData(QCompressionDevice::compressData(data));
+    buffer.open(QIODevice::ReadOnly);
+
+    QCompressionDevice device(&buffer);
+    device.setBufferSize(64);
+    QVERIFY(device.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+    QByteArray result;
+    char c;
+    while (device.getChar(&c))
+        result += c;
+    QCOMPARE(result, data);
+    QVERIFY(device.atEnd());
+}
+
+void tst_QCompressionDevice::readLine()
+{
+    QByteArray text;
+    for (int i = 0; i < 1000; ++i)
+        text += "line " + QByteArray::number(i) + '\n';
+
+    QBuffer buffer;
+    buffer.setData(QCompressionDevice::compressData(text));
+    buffer.open(QIODevice::ReadOnly);
+    QCompressionDevice device(&buffer);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+
+    int lines = 0;
+    while (!device.atEnd()) {
+        QCOMPARE(device.readLine(), "line " + QByteArray::number(lines) + '\n');
+        ++lines;
+    }
+    QCOMPARE(lines, 1000);
+}
+
+void tst_QCompressionDevice::flush()
+{
+    QBuffer compressed;
+    compressed.open(QIODevice::WriteOnly);
+    QCompressionDevice writer(&compressed, QCompressionDevice::ZlibFormat);
+    QVERIFY(writer.open(QIODevice::WriteOnly));
+    writer.write("first chunk;");
+    QVERIFY(writer.flush());
+
+    // everything written so far can be decompressed, although the stream is not finished
+    QBuffer partial;
+    partial.setData(compressed.data());
+    partial.open(QIODevice::ReadOnly);
+    QCompressionDevice reader(&partial, QCompressionDevice::ZlibFormat);
+    QVERIFY(reader.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+    char chunk[100];
+    QCOMPARE(reader.read(chunk, sizeof(chunk)), qint64(12));
+    QCOMPARE(QByteArray(chunk, 12), QByteArray("first chunk;"));
+    // the buffer ends before the stream does
+    QCOMPARE(reader.read(chunk, sizeof(chunk)), qint64(-1));
+
+    writer.write("second chunk");
+    writer.close();
+    QCOMPARE(QCompressionDevice::decompressData(compressed.data(), QCompressionDevice::ZlibFormat),
+             QByteArray("first chunk;second chunk"));
+
+    QCompressionDevice notOpen(&compressed);
+    QVERIFY(!notOpen.flush());
+}
+
+void tst_QCompressionDevice::compressionLevel()
+{
+    const QByteArray data = QByteArray("compressible ").repeated(10000);
+    const QByteArray stored = QCompressionDevice::compressData(data, QCompressionDevice::RawDeflateFormat, 0);
+    const QByteArray best = QCompressionDevice::compressData(data, QCompressionDevice::RawDeflateFormat, 9);
+    QVERIFY(stored.size() > data.size());
+    QVERIFY(best.size() < data.size() / 100);
+    QCOMPARE(QCompressionDevice::decompressData(stored, QCompressionDevice::RawDeflateFormat), data);
+    QCOMPARE(QCompressionDevice::decompressData(best, QCompressionDevice::RawDeflateFormat), data);
+}
+
+void tst_QCompressionDevice::truncatedData_data()
+{
+    QTest::addColumn<QCompressionDevice::Format>("format");
+    QTest::newRow("zlib") << QCompressionDevice::ZlibFormat;
+    QTest::newRow("gzip") << QCompressionDevice::GzipFormat;
+    QTest::newRow("raw") << QCompressionDevice::RawDeflateFormat;
+}
+
+void tst_QCompressionDevice::truncatedData()
+{
+    QFETCH(QCompressionDevice::Format, format);
+
+    const QByteArray data = testData(20000);
+    QByteArray compressed = QCompressionDevice::compressData(data, format);
+    compressed.chop(compressed.size() / 3);
+    QCOMPARE(QCompressionDevice::decompressData(compressed, format), QByteArray());
+
+    QBuffer buffer;
+    buffer.setData(compressed);
+    buffer.open(QIODevice::ReadOnly);
+    QCompressionDevice device(&buffer, format);
+    QVERIFY(device.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+
+    char chunk[1024];
+    qint64 total = 0;
+    qint64 n;
+    while ((n = device.read(chunk, sizeof(chunk))) > 0) {
+        QCOMPARE(QByteArray(chunk, n), data.mid(total, n));
+        total += n;
+    }
+    QCOMPARE(n, qint64(-1));
+    QVERIFY(total < data.size());
+    QCOMPARE(device.errorString(), QString("Unexpected end of compressed data"));
+    QVERIFY(device.atEnd());
+}
+
+void tst_QCompressionDevice::corruptData()
+{
+    QByteArray compressed = QCompressionDevice::compressData(testData(20000));
+    QCOMPARE(QCompressionDevice::decompressData(compressed.left(10) + QByteArray(100, '\xff')),
+             QByteArray());
+    QCOMPARE(QCompressionDevice::decompressData("this is not gzip data"), QByteArray());
+
+    QBuffer buffer;
+    buffer.setData("this is not gzip data");
+    buffer.open(QIODevice::ReadOnly);
+    QCompressionDevice device(&buffer);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+    QCOMPARE(device.readAll(), QByteArray());
+    QVERIFY(device.errorString().startsWith("Cannot decompress data: "));
+    QVERIFY(device.atEnd());
+}
+
+void tst_QCompressionDevice::underlyingDeviceStaysOpen()
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    buffer.write("header:");
+    {
+        QCompressionDevice device(&buffer, QCompressionDevice::ZlibFormat);
+        QVERIFY(device.open(QIODevice::WriteOnly));
+        device.write("payload");
+        // the destructor finishes the stream
+    }
+    QVERIFY(buffer.isOpen());
+    buffer.write(":footer");
+    buffer.close();
+
+    const QByteArray all = buffer.data();
+    QVERIFY(all.startsWith("header:"));
+    QVERIFY(all.endsWith(":footer"));
+    QCOMPARE(QCompressionDevice::decompressData(all.mid(7, all.size() - 14),
+                                                QCompressionDevice::ZlibFormat),
+             QByteArray("payload"));
+}
+
+QTEST_MAIN(tst_QCompressionDevice)
+#include "tst_qcompressiondevice.moc"
@@ -47,6 +47,8 @@
 #include <qdiriterator.h>
 #include <qfileinfo.h>
 #include <qstringlist.h>
+#include <qtemporarydir.h>
+#include <qthreadpool.h>
 
 #include <QtCore/private/qfsfileengine_p.h>
 
@@ -108,6 +110,10 @@ private slots:
     void iterateResource_data();
     void iterateResource();
     void stopLinkLoop();
+    void parallelTraversal_data();
+    void parallelTraversal();
+    void parallelTraversalEarlyExit();
+    void parallelTraversalOnPoolThread();
 #ifdef QT_BUILD_INTERNAL
     void engineWithNoIterator();
 #endif
@@ -460,6 +466,156 @@ void tst_QDirIterator::stopLinkLoop()
     // The goal of this test is only to ensure that the test above don't malfunction
 }
 
+void tst_QDirIterator::parallelTraversal_data()
+{
+    QTest::addColumn<QDirIterator::IteratorFlags>("flags");
+    QTest::addColumn<QDir::Filters>("filters");
+    QTest::addColumn<QStringList>("nameFilters");
+
+    QTest::newRow("all") << QDirIterator::IteratorFlags(QDirIterator::Subdirectories)
+                         << QDir::Filters(QDir::NoFilter) << QStringList();
+    QTest::newRow("files") << QDirIterator::IteratorFlags(QDirIterator::Subdirectories)
+                           << QDir::Filters(QDir::Files) << QStringList();
+    QTest::newRow("dirs, no dot and dotdot")
+        << QDirIterator::IteratorFlags(QDirIterator::Subdirectories)
+        << QDir::Filters(QDir::Dirs | QDir::NoDotAndDotDot) << QStringList();
+    QTest::newRow("name filter") << QDirIterator::IteratorFlags(QDirIterator::Subdirectories)
+                                 << QDir::Filters(QDir::Files) << QStringList("*.txt");
+    QTest::newRow("hidden") << QDirIterator::IteratorFlags(QDirIterator::Subdirectories)
+                            << QDir::Filters(QDir::AllEntries | QDir::Hidden) << QStringList();
+#ifndef Q_NO_SYMLINKS
+    QTest::newRow("follow symlinks")
+        << QDirIterator::IteratorFlags(QDirIterator::Subdirectories | QDirIterator::FollowSymlinks)
+        << QDir::Filters(QDir::NoFilter) << QStringList();
+#endif
+}
+
+void tst_QDirIterator::parallelTraversal()
+{
+    QFETCH(QDirIterator::IteratorFlags, flags);
+    QFETCH(QDir::Filters, filters);
+    QFETCH(QStringList, nameFilters);
+
+    QTemporaryDir tree;
+    QVERIFY(tree.isValid());
+    QDir root(tree.path());
+    for (int i = 0; i < 8; ++i) {
+        const QString level1 = QString("dir%1").arg(i);
+        QVERIFY(root.mkpath(level1 + "/sub/subsub"));
+        QVERIFY(root.mkpath(level1 + "/.hidden"));
+        const QStringList dirs = QStringList() << level1 << level1 + "/sub"
+                                               << level1 + "/sub/subsub" << level1 + "/.hidden";
+        foreach (const QString &dir, dirs) {
+            for (int j = 0; j < 10; ++j) {
+                QFile file(root.filePath(dir + QString("/file%1.%2").arg(j).arg(j % 2 ? "txt" : "dat")));
+                QVERIFY(file.open(QIODevice::WriteOnly));
+            }
+            QFile hidden(root.filePath(dir + "/.hiddenfile"));
+            QVERIFY(hidden.open(QIODevice::WriteOnly));
+        }
+    }
+#ifndef Q_NO_SYMLINKS
+    // a loop, which must not make the walk endless
+    QVERIFY(QFile::link(root.absolutePath(), root.filePath("dir0/sub/loop.lnk")));
+#endif
+
+    QStringList expected;
+    QDirIterator sequential(root.path(), nameFilters, filters, flags);
+    while (sequential.hasNext())
+        expected << sequential.next();
+    expected.sort();
+    QVERIFY(expected.size() > 8);
+
+    QStringList list;
+    QDirIterator parallel(root.path(), nameFilters, filters,
+                          flags | QDirIterator::ParallelTraversal);
+    while (parallel.hasNext()) {
+        const QString next = parallel.next();
+        QCOMPARE(parallel.filePath(), next);
+        QCOMPARE(parallel.fileInfo().filePath(), next);
+        list << next;
+    }
+    QVERIFY(parallel.next().isEmpty());
+    list.sort();
+
+    if (expected != list) {
+        qDebug() << "EXPECTED:" << expected;
+        qDebug() << "ACTUAL:  " << list;
+    }
+    QCOMPARE(list, expected);
+}
+
+void tst_QDirIterator::parallelTraversalEarlyExit()
+{
+    QTemporaryDir tree;
+    QVERIFY(tree.isValid());
+    QDir root(tree.path());
+    for (int i = 0; i < 50; ++i) {
+        QVERIFY(root.mkpath(QString("dir%1/sub").arg(i)));
+        QFile file(root.filePath(QString("dir%1/sub/file").arg(i)));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    // destroying the iterator while the walk is still going must be safe
+    for (int stopAfter = 0; stopAfter < 20; stopAfter += 5) {
+        QDirIterator it(root.path(), QDir::Files,
+                        QDirIterator::Subdirectories | QDirIterator::ParallelTraversal);
+        for (int i = 0; i < stopAfter && it.hasNext(); ++i)
+            QVERIFY(!it.next().isEmpty());
+    }
+    QVERIFY(QThreadPool::globalInstance()->waitForDone(5000));
+}
+
+class ParallelWalkTask : public QRunnable
+{
+public:
+    explicit ParallelWalkTask(const QString &path)
+        : path(path), count(0)
+    { setAutoDelete(false); }
+
+    void run()
+    {
+        QDirIterator it(path, QDirIterator::Subdirectories | QDirIterator::ParallelTraversal);
+        while (it.hasNext()) {
+            it.next();
+            ++count;
+        }
+    }
+
+    QString path;
+    int count;
+};
+
+void tst_QDirIterator::parallelTraversalOnPoolThread()
+{
+    QTemporaryDir tree;
+    QVERIFY(tree.isValid());
+    QDir root(tree.path());
+    for (int i = 0; i < 20; ++i) {
+        QVERIFY(root.mkpath(QString("dir%1/sub").arg(i)));
+        QFile file(root.filePath(QString("dir%1/sub/file").arg(i)));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    int expected = 0;
+    QDirIterator sequential(root.path(), QDirIterator::Subdirectories);
+    while (sequential.hasNext()) {
+        sequential.next();
+        ++expected;
+    }
+
+    // the walk must not wait for helpers that the full pool cannot run
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const int maxThreadCount = pool->maxThreadCount();
+    pool->setMaxThreadCount(1);
+    ParallelWalkTask task(root.path());
+    pool->start(&task);
+    const bool done = pool->waitForDone(10000);
+    pool->setMaxThreadCount(maxThreadCount);
+    QVERIFY(done);
+    QCOMPARE(task.count, expected);
+}
+
 #ifdef QT_BUILD_INTERNAL
 class EngineWithNoIterator : public QFSFileEngine
 {
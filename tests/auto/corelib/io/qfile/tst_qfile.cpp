@@ -158,6 +158,10 @@ private slots:
     void copyRemovesTemporaryFile() const;
     void copyShouldntOverwrite();
     void copyFallback();
+    void copyLargeFile();
+    void copyRange();
+    void copyRangeAppend();
+    void peekViewReadWrite();
     void link();
     void linkToDir();
     void absolutePathLinkToRelativePath();
@@ -1283,6 +1287,175 @@ void tst_QFile::copyShouldntOverwrite()
     QVERIFY(!file.copy("tst_qfile.cpy"));
 }
 
+void tst_QFile::copyLargeFile()
+{
+    // larger than any single block, so that all paths loop
+    QByteArray data(3 * 1024 * 1024 + 17, Qt::Uninitialized);
+    for (int i = 0; i < data.size(); ++i)
+        data[i] = char(i * 7 + (i >> 12));
+    {
+        QFile source("copy-large-source");
+        QVERIFY(source.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        QCOMPARE(source.write(data), qint64(data.size()));
+    }
+    QFile::remove("copy-large-destination");
+    QVERIFY(QFile::copy("copy-large-source", "copy-large-destination"));
+
+    QFile destination("copy-large-destination");
+    QVERIFY(destination.open(QIODevice::ReadOnly));
+    QCOMPARE(destination.size(), qint64(data.size()));
+    QVERIFY(destination.readAll() == data);
+    destination.close();
+
+    QFile::remove("copy-large-source");
+    QFile::remove("copy-large-destination");
+}
+
+void tst_QFile::copyRange()
+{
+    QByteArray data;
+    for (int i = 0; i < 10000; ++i)
+        data += QByteArray::number(i) + ' ';
+
+    QFile source("copy-range-source");
+    QVERIFY(source.open(QIODevice::ReadWrite | QIODevice::Truncate));
+    QCOMPARE(source.write(data), qint64(data.size()));
+
+    QFile destination("copy-range-destination");
+    QVERIFY(destination.open(QIODevice::ReadWrite | QIODevice::Truncate));
+    // buffered data on both sides must be taken into account
+    QCOMPARE(destination.write("header:"), qint64(7));
+
+    QVERIFY(source.seek(100));
+    char c;
+    QVERIFY(source.getChar(&c));
+    QCOMPARE(c, data.at(100));
+
+    QCOMPARE(QFile::copyRange(&source, &destination, 5000), qint64(5000));
+    QCOMPARE(source.pos(), qint64(5101));
+    QCOMPARE(destination.pos(), qint64(5007));
+
+    // the positions really moved: the next read and write carry on from there
+    QVERIFY(source.getChar(&c));
+    QCOMPARE(c, data.at(5101));
+    QCOMPARE(destination.write(":middle:"), qint64(8));
+
+    // copying past the end copies what is there
+    QVERIFY(source.seek(data.size() - 10));
+    QCOMPARE(QFile::copyRange(&source, &destination, 1000), qint64(10));
+    QCOMPARE(QFile::copyRange(&source, &destination, 1000), qint64(0));
+    QCOMPARE(QFile::copyRange(&source, &destination, 0), qint64(0));
+
+    QVERIFY(destination.seek(0));
+    QCOMPARE(destination.readAll(),
+             "header:" + data.mid(101, 5000) + ":middle:" + data.right(10));
+
+    QTest::ignoreMessage(QtWarningMsg, "QFile::copyRange: Null device");
+    QCOMPARE(QFile::copyRange(0, &destination, 10), qint64(-1));
+
+    source.close();
+    QVERIFY(source.open(QIODevice::WriteOnly | QIODevice::Append));
+    QTest::ignoreMessage(QtWarningMsg, "QFile::copyRange: Source device not open for reading");
+    QCOMPARE(QFile::copyRange(&source, &destination, 10), qint64(-1));
+
+    destination.close();
+    QVERIFY(destination.open(QIODevice::ReadOnly));
+    QTest::ignoreMessage(QtWarningMsg, "QFile::copyRange: Destination device not open for writing");
+    QCOMPARE(QFile::copyRange(&destination, &destination, 10), qint64(-1));
+
+    source.close();
+    destination.close();
+    QFile::remove("copy-range-source");
+    QFile::remove("copy-range-destination");
+}
+
+void tst_QFile::copyRangeAppend()
+{
+    {
+        QFile source("copy-range-source");
+        QVERIFY(source.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        source.write("0123456789");
+        QFile destination("copy-range-destination");
+        QVERIFY(destination.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        destination.write("existing;");
+    }
+
+    QFile source("copy-range-source");
+    QVERIFY(source.open(QIODevice::ReadOnly));
+    QFile destination("copy-range-destination");
+    QVERIFY(destination.open(QIODevice::WriteOnly | QIODevice::Append));
+    QVERIFY(source.seek(2));
+    QCOMPARE(QFile::copyRange(&source, &destination, 5), qint64(5));
+    destination.close();
+
+    QVERIFY(destination.open(QIODevice::ReadOnly));
+    QCOMPARE(destination.readAll(), QByteArray("existing;23456"));
+    destination.close();
+    source.close();
+    QFile::remove("copy-range-source");
+    QFile::remove("copy-range-destination");
+}
+
+void tst_QFile::peekViewReadWrite()
+{
+    QFile::remove("peek-view-file");
+    QFile file("peek-view-file");
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    const QByteArray block(200000, 'a');
+    QCOMPARE(file.write(block), qint64(block.size()));
+
+    // pending writes are flushed before the file is mapped
+    QVERIFY(file.seek(0));
+    qint64 size;
+    const char *view = file.peekView(&size);
+    QVERIFY(view);
+    QCOMPARE(size, qint64(block.size()));
+    QCOMPARE(QByteArray(view, size), block);
+
+    // writes through the file show up in the view window
+    QVERIFY(file.seek(100));
+    QCOMPARE(file.write("bcd", 3), qint64(3));
+    QVERIFY(file.seek(100));
+    view = file.peekView(&size);
+    QVERIFY(view);
+    QCOMPARE(QByteArray(view, 3), QByteArray("bcd"));
+    QCOMPARE(file.skip(3), qint64(3));
+    QCOMPARE(file.pos(), qint64(103));
+    QCOMPARE(file.read(2), QByteArray("aa"));
+
+    // skipping inside the window, then writing, lands at the right offset
+    QCOMPARE(file.skip(1000), qint64(1000));
+    QCOMPARE(file.write("x", 1), qint64(1));
+    QVERIFY(file.seek(1105));
+    QCOMPARE(file.read(1), QByteArray("x"));
+
+    // data appended past the mapped window is seen once the window is left
+    QVERIFY(file.seek(0));
+    QVERIFY(file.peekView(&size));
+    QVERIFY(file.seek(block.size()));
+    QCOMPARE(file.write(block), qint64(block.size()));
+    QVERIFY(file.seek(block.size() - 10));
+    view = file.peekView(&size);
+    QVERIFY(view);
+    QCOMPARE(file.skip(size), size);
+    view = file.peekView(&size);
+    QVERIFY(view);
+    QCOMPARE(file.pos() + size, qint64(2 * block.size()));
+
+    // shrinking the file drops the mapping
+    QVERIFY(file.resize(50));
+    QVERIFY(file.seek(40));
+    view = file.peekView(&size);
+    QVERIFY(view);
+    QCOMPARE(size, qint64(10));
+    QCOMPARE(file.skip(100), qint64(10));
+    QVERIFY(!file.peekView(&size));
+    QVERIFY(file.atEnd());
+
+    file.close();
+    QFile::remove("peek-view-file");
+}
+
 void tst_QFile::copyFallback()
 {
     // Using a resource file to trigger QFile::copy's fallback handling
@@ -79,6 +79,12 @@ private slots:
     void QTBUG2331();
     void QTBUG2331_data() { basicTest_data(); }
 
+    void recursiveWatch();
+    void recursiveRemovePath();
+    void latency();
+    void latencyRemovePath();
+    void queueOverflow();
+
 private:
     QString m_tempDirPattern;
 };
@@ -580,5 +586,200 @@ void tst_QFileSystemWatcher::QTBUG2331()
     QCOMPARE(watcher.directories(), QStringList());
 }
 
+static QStringList sorted(QStringList list)
+{
+    list.sort();
+    return list;
+}
+
+void tst_QFileSystemWatcher::recursiveWatch()
+{
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+    const QString root = temporaryDirectory.path();
+    QDir rootDir(root);
+    QVERIFY(rootDir.mkpath("a/b"));
+    QVERIFY(rootDir.mkpath("c"));
+
+    QFileSystemWatcher watcher;
+    QVERIFY(watcher.addRecursivePath(root));
+    QVERIFY(!watcher.addRecursivePath(root));
+    QVERIFY(!watcher.addRecursivePath(root + "/a"));
+    QCOMPARE(watcher.recursivePaths(), QStringList(root));
+    QCOMPARE(sorted(watcher.directories()),
+             QStringList() << root << root + "/a" << root + "/a/b" << root + "/c");
+
+    QSignalSpy changedSpy(&watcher, SIGNAL(directoryChanged(QString)));
+    QSignalSpy batchSpy(&watcher, SIGNAL(directoriesChanged(QStringList)));
+    QVERIFY(changedSpy.isValid());
+    QVERIFY(batchSpy.isValid());
+
+    // new subdirectories are picked up and reported
+    QVERIFY(rootDir.mkpath("a/b/new/deeper"));
+    QTRY_VERIFY(watcher.directories().contains(root + "/a/b/new/deeper"));
+    QVERIFY(watcher.directories().contains(root + "/a/b/new"));
+    QTRY_VERIFY(!batchSpy.isEmpty());
+
+    // changes in them are seen
+    changedSpy.clear();
+    QFile file(root + "/a/b/new/deeper/file");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+    QTRY_VERIFY(!changedSpy.isEmpty());
+    QCOMPARE(changedSpy.last().at(0).toString(), root + "/a/b/new/deeper");
+
+    // moving a subtree away drops it; moving it back brings it back
+    QVERIFY(rootDir.rename("a/b/new", "c/moved"));
+    QTRY_VERIFY(watcher.directories().contains(root + "/c/moved/deeper"));
+    QVERIFY(!watcher.directories().contains(root + "/a/b/new"));
+    QVERIFY(!watcher.directories().contains(root + "/a/b/new/deeper"));
+
+    // deleting a subtree drops it
+    QVERIFY(QDir(root + "/c").removeRecursively());
+    QTRY_COMPARE(sorted(watcher.directories()), QStringList() << root << root + "/a" << root + "/a/b");
+
+    // symbolic links are not followed
+#ifdef Q_OS_UNIX
+    QVERIFY(QFile::link(root + "/a", root + "/link"));
+    changedSpy.clear();
+    QTRY_VERIFY(!changedSpy.isEmpty());
+    QCOMPARE(sorted(watcher.directories()), QStringList() << root << root + "/a" << root + "/a/b");
+#endif
+}
+
+void tst_QFileSystemWatcher::recursiveRemovePath()
+{
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+    const QString root = temporaryDirectory.path();
+    QVERIFY(QDir(root).mkpath("tree/a/b"));
+    QVERIFY(QDir(root).mkpath("other"));
+    const QString tree = root + "/tree";
+
+    QFileSystemWatcher watcher;
+    QVERIFY(watcher.addPath(root + "/other"));
+    QVERIFY(watcher.addRecursivePath(tree));
+    QCOMPARE(watcher.directories().count(), 4);
+
+    // subdirectories of a recursive watch stay
+    QCOMPARE(watcher.removePaths(QStringList() << tree + "/a" << root + "/other"),
+             QStringList(tree + "/a"));
+    QCOMPARE(watcher.directories().count(), 3);
+
+    QSignalSpy changedSpy(&watcher, SIGNAL(directoryChanged(QString)));
+    QVERIFY(changedSpy.isValid());
+    QVERIFY(watcher.removePath(tree));
+    QCOMPARE(watcher.directories(), QStringList());
+    QCOMPARE(watcher.recursivePaths(), QStringList());
+
+    QVERIFY(QDir(tree).mkdir("c"));
+    QTest::qWait(200);
+    QCOMPARE(changedSpy.count(), 0);
+
+    // the root itself going away ends the recursive watch
+    QVERIFY(watcher.addRecursivePath(tree));
+    QVERIFY(QDir(tree).removeRecursively());
+    QTRY_COMPARE(watcher.directories(), QStringList());
+    QCOMPARE(watcher.recursivePaths(), QStringList());
+}
+
+void tst_QFileSystemWatcher::latency()
+{
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+    const QString root = temporaryDirectory.path();
+
+    QFileSystemWatcher watcher;
+    QCOMPARE(watcher.latency(), 0);
+    watcher.setLatency(300);
+    QCOMPARE(watcher.latency(), 300);
+    QVERIFY(watcher.addRecursivePath(root));
+
+    QSignalSpy changedSpy(&watcher, SIGNAL(directoryChanged(QString)));
+    QSignalSpy batchSpy(&watcher, SIGNAL(directoriesChanged(QStringList)));
+    QVERIFY(changedSpy.isValid());
+    QVERIFY(batchSpy.isValid());
+
+    // a burst of changes is reported once per path, in a single batch
+    QDir rootDir(root);
+    for (int i = 0; i < 20; ++i) {
+        QFile file(root + QString::fromLatin1("/file%1").arg(i));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.close();
+    }
+    QVERIFY(rootDir.mkpath("sub/dir"));
+    QTest::qWait(100);
+    QCOMPARE(batchSpy.count(), 0);
+    QTRY_COMPARE(batchSpy.count(), 1);
+    QCOMPARE(sorted(batchSpy.at(0).at(0).toStringList()),
+             QStringList() << root << root + "/sub" << root + "/sub/dir");
+    QCOMPARE(changedSpy.count(), 3);
+    QCOMPARE(watcher.directories().count(), 3);
+
+    // dropping the latency delivers what is pending
+    batchSpy.clear();
+    QVERIFY(rootDir.rmdir("sub/dir"));
+    QTRY_VERIFY(!watcher.directories().contains(root + "/sub/dir"));
+    QVERIFY(batchSpy.isEmpty());
+    watcher.setLatency(0);
+    QCOMPARE(batchSpy.count(), 1);
+    QVERIFY(batchSpy.at(0).at(0).toStringList().contains(root + "/sub/dir"));
+}
+
+void tst_QFileSystemWatcher::latencyRemovePath()
+{
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+
+    QFileSystemWatcher watcher;
+    watcher.setLatency(200);
+    QVERIFY(watcher.addPath(temporaryDirectory.path()));
+    QSignalSpy changedSpy(&watcher, SIGNAL(directoryChanged(QString)));
+    QVERIFY(changedSpy.isValid());
+
+    QVERIFY(QDir(temporaryDirectory.path()).mkdir("sub"));
+    QTest::qWait(50);
+    // pending changes for paths that are no longer watched are dropped
+    QVERIFY(watcher.removePath(temporaryDirectory.path()));
+    QTest::qWait(400);
+    QCOMPARE(changedSpy.count(), 0);
+}
+
+void tst_QFileSystemWatcher::queueOverflow()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("Only the inotify backend reports overflows");
+#else
+    QFile limitFile("/proc/sys/fs/inotify/max_queued_events");
+    if (!limitFile.open(QIODevice::ReadOnly))
+        QSKIP("Cannot read the inotify queue limit");
+    const int limit = limitFile.readAll().trimmed().toInt();
+    if (limit <= 0 || limit > 100000)
+        QSKIP("The inotify queue limit is too large to exceed in a test");
+
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY(temporaryDirectory.isValid());
+    const QString root = temporaryDirectory.path();
+
+    QFileSystemWatcher watcher;
+    QVERIFY(watcher.addRecursivePath(root));
+    QSignalSpy overflowSpy(&watcher, SIGNAL(queueOverflowed()));
+    QVERIFY(overflowSpy.isValid());
+
+    // Queue more events than the kernel keeps, without returning to the
+    // event loop; the subdirectory created last can only be found by the
+    // rescan that follows the overflow.
+    QDir rootDir(root);
+    for (int i = 0; i < limit / 2 + 10; ++i) {
+        QVERIFY(rootDir.mkdir("x"));
+        QVERIFY(rootDir.rmdir("x"));
+    }
+    QVERIFY(rootDir.mkdir("survivor"));
+
+    QTRY_COMPARE(overflowSpy.count(), 1);
+    QVERIFY(watcher.directories().contains(root + "/survivor"));
+#endif
+}
+
 QTEST_MAIN(tst_QFileSystemWatcher)
 #include "tst_qfilesystemwatcher.moc"
@@ -66,6 +66,14 @@ private slots:
     void readLine2();
 
     void peekBug();
+
+    void peekView_data();
+    void peekView();
+    void peekViewAndRead_data();
+    void peekViewAndRead();
+    void peekViewTextMode();
+    void skip_data();
+    void skip();
 };
 
 void tst_QIODevice::initTestCase()
@@ -585,5 +593,240 @@ void tst_QIODevice::peekBug()
 
 }
 
+// Sequential device handing out its data in short chunks.
+class SequentialDevice : public QIODevice
+{
+    Q_OBJECT
+public:
+    SequentialDevice(const QByteArray &data) : data(data), offset(0) {}
+    bool isSequential() const { return true; }
+    qint64 bytesAvailable() const { return data.size() - offset + QIODevice::bytesAvailable(); }
+protected:
+    qint64 readData(char *target, qint64 maxlen)
+    {
+        const qint64 chunk = qMin(qMin(maxlen, qint64(1000)), qint64(data.size() - offset));
+        memcpy(target, data.constData() + offset, chunk);
+        offset += int(chunk);
+        return chunk;
+    }
+    qint64 writeData(const char *, qint64) { return -1; }
+private:
+    QByteArray data;
+    int offset;
+};
+
+static QByteArray peekViewTestData(int size)
+{
+    QByteArray data;
+    data.reserve(size);
+    for (int i = 0; i < size; ++i)
+        data.append(char(i * 7 + i / 251));
+    return data;
+}
+
+// Creates the device a peekView()/skip() test row asks for.
+static QIODevice *createDevice(const QString &type, const QByteArray &data, QIODevice::OpenMode extraMode = 0)
+{
+    if (type == QLatin1String("buffer")) {
+        QBuffer *buffer = new QBuffer;
+        buffer->setData(data);
+        buffer->open(QIODevice::ReadOnly | extraMode);
+        return buffer;
+    }
+    if (type == QLatin1String("sequential")) {
+        SequentialDevice *device = new SequentialDevice(data);
+        device->open(QIODevice::ReadOnly | extraMode);
+        return device;
+    }
+    QFile::remove("peekviewtestfile");
+    QFile *file = new QFile("peekviewtestfile");
+    if (!file->open(QIODevice::WriteOnly) || file->write(data) != data.size()) {
+        delete file;
+        return 0;
+    }
+    file->close();
+    file->open(QIODevice::ReadOnly | extraMode);
+    return file;
+}
+
+static void addPeekViewRows()
+{
+    QTest::addColumn<QString>("type");
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("unbuffered");
+
+    const char * const types[] = { "buffer", "file", "sequential" };
+    for (int i = 0; i < 3; ++i) {
+        // files below and above the size peekView() starts mapping at
+        QTest::newRow(QByteArray(types[i]) + "-small") << types[i] << 1000 << false;
+        QTest::newRow(QByteArray(types[i]) + "-large") << types[i] << 300000 << false;
+        QTest::newRow(QByteArray(types[i]) + "-large-unbuffered") << types[i] << 300000 << true;
+        QTest::newRow(QByteArray(types[i]) + "-empty") << types[i] << 0 << false;
+    }
+}
+
+void tst_QIODevice::peekView_data()
+{
+    addPeekViewRows();
+}
+
+void tst_QIODevice::peekView()
+{
+    QFETCH(QString, type);
+    QFETCH(int, size);
+    QFETCH(bool, unbuffered);
+
+    const QByteArray data = peekViewTestData(size);
+    QScopedPointer<QIODevice> device(createDevice(type, data, unbuffered ? QIODevice::Unbuffered : QIODevice::NotOpen));
+    QVERIFY(device);
+
+    QByteArray result;
+    qint64 viewSize;
+    while (const char *view = device->peekView(&viewSize)) {
+        QVERIFY(viewSize > 0);
+        // peeking does not advance
+        qint64 again;
+        QCOMPARE(device->peekView(&again), view);
+        QCOMPARE(again, viewSize);
+        if (!device->isSequential())
+            QCOMPARE(device->pos(), qint64(result.size()));
+
+        result.append(view, viewSize);
+        QCOMPARE(device->skip(viewSize), viewSize);
+    }
+    QCOMPARE(viewSize, qint64(0));
+    QCOMPARE(result.size(), data.size());
+    QVERIFY(result == data);
+    QVERIFY(device->atEnd());
+
+    device.reset();
+    QFile::remove("peekviewtestfile");
+}
+
+void tst_QIODevice::peekViewAndRead_data()
+{
+    addPeekViewRows();
+}
+
+void tst_QIODevice::peekViewAndRead()
+{
+    QFETCH(QString, type);
+    QFETCH(int, size);
+    QFETCH(bool, unbuffered);
+
+    const QByteArray data = peekViewTestData(size);
+    QScopedPointer<QIODevice> device(createDevice(type, data, unbuffered ? QIODevice::Unbuffered : QIODevice::NotOpen));
+    QVERIFY(device);
+
+    // Alternate between consuming part of a view, reading and getChar().
+    QByteArray result;
+    qint64 viewSize;
+    int step = 0;
+    while (const char *view = device->peekView(&viewSize)) {
+        const qint64 chunk = qMin(viewSize, qint64(1 + (step * 977) % 5000));
+        switch (step++ % 3) {
+        case 0:
+            result.append(view, chunk);
+            QCOMPARE(device->skip(chunk), chunk);
+            break;
+        case 1: {
+            // the view is invalidated by read()
+            const QByteArray expected(view, chunk);
+            const QByteArray bytes = device->read(chunk);
+            QCOMPARE(bytes, expected);
+            result += bytes;
+            break;
+        }
+        default: {
+            const char expected = *view;
+            char c;
+            QVERIFY(device->getChar(&c));
+            QCOMPARE(c, expected);
+            result += c;
+            break;
+        }
+        }
+        if (!device->isSequential())
+            QCOMPARE(device->pos(), qint64(result.size()));
+    }
+    QVERIFY(result == data);
+
+    if (!device->isSequential() && size) {
+        // views follow seek() in both directions
+        QVERIFY(device->seek(size / 2));
+        const char *view = device->peekView(&viewSize);
+        QVERIFY(view);
+        QCOMPARE(*view, data.at(size / 2));
+        QVERIFY(device->seek(1));
+        view = device->peekView(&viewSize);
+        QVERIFY(view);
+        QCOMPARE(*view, data.at(1));
+        QCOMPARE(device->read(2), data.mid(1, 2));
+    }
+
+    device.reset();
+    QFile::remove("peekviewtestfile");
+}
+
+void tst_QIODevice::peekViewTextMode()
+{
+    QBuffer buffer;
+    buffer.setData("line\r\nline\r\n");
+    QVERIFY(buffer.open(QIODevice::ReadOnly | QIODevice::Text));
+    qint64 size = -1;
+    QVERIFY(!buffer.peekView(&size));
+    QCOMPARE(size, qint64(0));
+    QCOMPARE(buffer.readLine(), QByteArray("line\n"));
+
+    QBuffer writeOnly;
+    QVERIFY(writeOnly.open(QIODevice::WriteOnly));
+    QTest::ignoreMessage(QtWarningMsg, "QIODevice::peekView: WriteOnly device");
+    QVERIFY(!writeOnly.peekView(&size));
+    QTest::ignoreMessage(QtWarningMsg, "QIODevice::skip: WriteOnly device");
+    QCOMPARE(writeOnly.skip(1), qint64(-1));
+}
+
+void tst_QIODevice::skip_data()
+{
+    addPeekViewRows();
+}
+
+void tst_QIODevice::skip()
+{
+    QFETCH(QString, type);
+    QFETCH(int, size);
+    QFETCH(bool, unbuffered);
+
+    const QByteArray data = peekViewTestData(size);
+    QScopedPointer<QIODevice> device(createDevice(type, data, unbuffered ? QIODevice::Unbuffered : QIODevice::NotOpen));
+    QVERIFY(device);
+
+    qint64 position = 0;
+    qint64 viewSize;
+    while (position < size) {
+        // skip from inside a view, from the read buffer and from nothing
+        if (position % 2)
+            device->peekView(&viewSize);
+        else if (position % 3)
+            device->peek(1);
+        const qint64 skipped = device->skip(12345);
+        QCOMPARE(skipped, qMin(qint64(12345), size - position));
+        position += skipped;
+        if (!device->isSequential())
+            QCOMPARE(device->pos(), position);
+        if (position < size) {
+            char c;
+            QVERIFY(device->getChar(&c));
+            QCOMPARE(c, data.at(position));
+            ++position;
+        }
+    }
+    QCOMPARE(device->skip(10), qint64(0));
+    QVERIFY(device->atEnd());
+
+    device.reset();
+    QFile::remove("peekviewtestfile");
+}
+
 QTEST_MAIN(tst_QIODevice)
 #include "tst_qiodevice.moc"
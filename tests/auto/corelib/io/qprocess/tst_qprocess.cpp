@@ -50,6 +50,9 @@
 #include <QtCore/QMetaType>
 #include <QtNetwork/QHostInfo>
 #include <stdlib.h>
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
 
 #ifndef QT_NO_PROCESS
 # if defined(Q_OS_WIN)
@@ -130,6 +133,10 @@ private slots:
     void setWorkingDirectory();
 #endif // Q_OS_WIN
 #endif // not Q_OS_WINCE
+#if defined(Q_OS_UNIX) && !defined(Q_OS_QNX)
+    void setWorkingDirectoryAbsoluteProgram();
+    void setupChildProcess();
+#endif
 
     void exitStatus_data();
     void exitStatus();
@@ -2079,6 +2086,47 @@ void tst_QProcess::setWorkingDirectory()
 }
 #endif
 
+//-----------------------------------------------------------------------------
+#if defined(Q_OS_UNIX) && !defined(Q_OS_QNX)
+// The child enters the working directory before exec(), so the program
+// must not be given relative to the current directory.
+void tst_QProcess::setWorkingDirectoryAbsoluteProgram()
+{
+    QProcess process;
+    process.setWorkingDirectory("test");
+    process.start(QDir::currentPath() + "/testSetWorkingDirectory/testSetWorkingDirectory");
+    QVERIFY(process.waitForFinished());
+    QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+
+    QByteArray workingDir = process.readAllStandardOutput();
+    QCOMPARE(QDir("test").canonicalPath(), QDir(workingDir.constData()).canonicalPath());
+}
+
+class ChdirProcess : public QProcess
+{
+protected:
+    void setupChildProcess()
+    {
+        if (::chdir("test") != 0)
+            ::_exit(1);
+    }
+};
+
+// QProcess may start the child without fork(); subclasses that reimplement
+// setupChildProcess() must still have it called in the child.
+void tst_QProcess::setupChildProcess()
+{
+    ChdirProcess process;
+    process.start(QDir::currentPath() + "/testSetWorkingDirectory/testSetWorkingDirectory");
+    QVERIFY(process.waitForFinished());
+    QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(process.exitCode(), 0);
+
+    QByteArray workingDir = process.readAllStandardOutput();
+    QCOMPARE(QDir("test").canonicalPath(), QDir(workingDir.constData()).canonicalPath());
+}
+#endif
+
 //-----------------------------------------------------------------------------
 void tst_QProcess::startFinishStartFinish()
 {
@@ -60,6 +60,8 @@ private slots:
     void removePostedEvents();
 #ifndef QT_NO_THREAD
     void deliverInDefinedOrder();
+    void postEventFromManyThreads();
+    void postEventWhileMovingToThread();
 #endif
     void applicationPid();
     void globalPostedEventsCount();
@@ -470,6 +472,163 @@ void tst_QCoreApplication::deliverInDefinedOrder()
     QObject::connect(&obj, SIGNAL(done()), &app, SLOT(quit()));
     app.exec();
 }
+
+class SequenceEvent : public QEvent
+{
+public:
+    SequenceEvent(QEvent::Type type, int producer, int sequence)
+        : QEvent(type), producer(producer), sequence(sequence)
+    { }
+
+    int producer;
+    int sequence;
+};
+
+// QEvent::User is posted without locking, QEvent::None with the mutex locked
+class SequenceProducer : public QThread
+{
+public:
+    SequenceProducer(QObject *receiver, int id, int count)
+        : receiver(receiver), id(id), count(count)
+    { }
+
+    void run()
+    {
+        for (int i = 0; i < count; ++i) {
+            const QEvent::Type type = i % 2 ? QEvent::None : QEvent::User;
+            QCoreApplication::postEvent(receiver, new SequenceEvent(type, id, i));
+        }
+    }
+
+    QObject *receiver;
+    int id;
+    int count;
+};
+
+class SequenceReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SequenceReceiver(int producerCount)
+        : lastSequence(producerCount, -1), received(0), outOfOrder(0), inWrongThread(0)
+    { }
+
+    bool event(QEvent *event)
+    {
+        if (event->type() != QEvent::User && event->type() != QEvent::None)
+            return QObject::event(event);
+
+        const SequenceEvent *sequenceEvent = static_cast<SequenceEvent *>(event);
+        int &last = lastSequence[sequenceEvent->producer];
+        if (sequenceEvent->sequence != last + 1)
+            ++outOfOrder;
+        last = sequenceEvent->sequence;
+        ++received;
+        if (QThread::currentThread() != thread())
+            ++inWrongThread;
+        return true;
+    }
+
+    QVector<int> lastSequence;
+    int received;
+    int outOfOrder;
+    int inWrongThread;
+    QSemaphore movedToMainThread;
+
+public slots:
+    void moveToMainThread()
+    {
+        moveToThread(QCoreApplication::instance()->thread());
+        movedToMainThread.release();
+    }
+};
+
+static bool allFinished(const QList<SequenceProducer *> &producers)
+{
+    foreach (SequenceProducer *producer, producers) {
+        if (!producer->isFinished())
+            return false;
+    }
+    return true;
+}
+
+void tst_QCoreApplication::postEventFromManyThreads()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>("tst_qcoreapplication") };
+    QCoreApplication app(argc, argv);
+
+    enum { ProducerCount = 4, EventCount = 5000 };
+    SequenceReceiver receiver(ProducerCount);
+    QCoreApplication::sendPostedEvents();
+    const QPostEventStatistics before = QCoreApplicationPrivate::postEventStatistics();
+    QCOMPARE(before.pending, 0);
+
+    QList<SequenceProducer *> producers;
+    for (int i = 0; i < ProducerCount; ++i) {
+        producers << new SequenceProducer(&receiver, i, EventCount);
+        producers.last()->start();
+    }
+    // deliver while the producers are posting
+    while (!allFinished(producers))
+        QCoreApplication::processEvents();
+    foreach (SequenceProducer *producer, producers)
+        QVERIFY(producer->wait(10000));
+    qDeleteAll(producers);
+
+    const QPostEventStatistics posted = QCoreApplicationPrivate::postEventStatistics();
+    QCOMPARE(posted.pending, int(ProducerCount * EventCount - receiver.received));
+    QCoreApplication::sendPostedEvents();
+    const QPostEventStatistics after = QCoreApplicationPrivate::postEventStatistics();
+
+    QCOMPARE(receiver.received, int(ProducerCount * EventCount));
+    QCOMPARE(receiver.outOfOrder, 0);
+    QCOMPARE(after.queued - before.queued, uint(ProducerCount * EventCount / 2));
+    QCOMPARE(after.taken - before.taken, uint(ProducerCount * EventCount / 2));
+    QCOMPARE(after.inserted - before.inserted, uint(ProducerCount * EventCount / 2));
+    QCOMPARE(after.delivered - before.delivered, uint(ProducerCount * EventCount));
+    QCOMPARE(after.pending, 0);
+}
+
+void tst_QCoreApplication::postEventWhileMovingToThread()
+{
+    int argc = 1;
+    char *argv[] = { const_cast<char*>("tst_qcoreapplication") };
+    QCoreApplication app(argc, argv);
+
+    QThread worker;
+    worker.start();
+
+    enum { ProducerCount = 4, EventCount = 5000 };
+    SequenceReceiver receiver(ProducerCount);
+    QList<SequenceProducer *> producers;
+    for (int i = 0; i < ProducerCount; ++i) {
+        producers << new SequenceProducer(&receiver, i, EventCount);
+        producers.last()->start();
+    }
+
+    // move the receiver back and forth while events are posted to it
+    int moves = 0;
+    while (!allFinished(producers) || moves < 20) {
+        receiver.moveToThread(&worker);
+        QVERIFY(QMetaObject::invokeMethod(&receiver, "moveToMainThread", Qt::QueuedConnection));
+        QVERIFY(receiver.movedToMainThread.tryAcquire(1, 10000));
+        ++moves;
+        QCoreApplication::processEvents();
+    }
+    foreach (SequenceProducer *producer, producers)
+        QVERIFY(producer->wait(10000));
+    qDeleteAll(producers);
+
+    QCoreApplication::sendPostedEvents();
+    worker.quit();
+    QVERIFY(worker.wait(10000));
+
+    QCOMPARE(receiver.received, int(ProducerCount * EventCount));
+    QCOMPARE(receiver.outOfOrder, 0);
+    QCOMPARE(receiver.inWrongThread, 0);
+    QCOMPARE(QCoreApplicationPrivate::postEventStatistics().pending, 0);
+}
 #endif // QT_NO_QTHREAD
 
 void tst_QCoreApplication::applicationPid()
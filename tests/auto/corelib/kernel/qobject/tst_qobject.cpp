@@ -141,6 +141,8 @@ private slots:
     void returnValue2();
     void connectVirtualSlots();
     void connectFunctorArgDifference();
+    void concurrentEmitAndDisconnect();
+    void emitDuringMoveToThread();
 };
 
 class SenderObject : public QObject
@@ -5571,5 +5573,103 @@ void tst_QObject::connectFunctorArgDifference()
     QVERIFY(true);
 }
 
+class ConcurrentReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    static QAtomicInt calls;
+    static QAtomicInt callsInWrongThread;
+
+public slots:
+    void slot()
+    {
+        calls.ref();
+        if (QThread::currentThread() != thread())
+            callsInWrongThread.ref();
+    }
+};
+
+QAtomicInt ConcurrentReceiver::calls;
+QAtomicInt ConcurrentReceiver::callsInWrongThread;
+
+class ConcurrentEmitThread : public QThread
+{
+public:
+    ConcurrentEmitThread(SenderObject *sender)
+        : sender(sender), emissions(0)
+    { }
+
+    void run()
+    {
+        while (!stop.load()) {
+            sender->emitSignal1();
+            ++emissions;
+            QCoreApplication::processEvents();
+        }
+    }
+
+    SenderObject *sender;
+    QAtomicInt stop;
+    int emissions;
+};
+
+void tst_QObject::concurrentEmitAndDisconnect()
+{
+    // receivers in this thread are connected, disconnected and destroyed
+    // while other threads emit the signal without holding the sender's lock
+    ConcurrentReceiver::calls.store(0);
+    ConcurrentReceiver::callsInWrongThread.store(0);
+    SenderObject sender;
+    ConcurrentEmitThread thread1(&sender);
+    ConcurrentEmitThread thread2(&sender);
+    thread1.start();
+    thread2.start();
+
+    for (int i = 0; i < 2000; ++i) {
+        ConcurrentReceiver *receiver = new ConcurrentReceiver;
+        QVERIFY(connect(&sender, SIGNAL(signal1()), receiver, SLOT(slot())));
+        ConcurrentReceiver other;
+        QVERIFY(connect(&sender, SIGNAL(signal1()), &other, SLOT(slot())));
+        if (i % 2)
+            QVERIFY(QObject::disconnect(&sender, SIGNAL(signal1()), receiver, SLOT(slot())));
+        QCoreApplication::processEvents();
+        delete receiver;
+    }
+
+    thread1.stop.store(1);
+    thread2.stop.store(1);
+    QVERIFY(thread1.wait(10000));
+    QVERIFY(thread2.wait(10000));
+    QVERIFY(thread1.emissions > 0);
+    QVERIFY(thread2.emissions > 0);
+    QCoreApplication::processEvents();
+    QCOMPARE(ConcurrentReceiver::callsInWrongThread.load(), 0);
+}
+
+void tst_QObject::emitDuringMoveToThread()
+{
+    // a receiver that moves to the emitting thread must only ever be
+    // called in the thread it lives in
+    ConcurrentReceiver::calls.store(0);
+    ConcurrentReceiver::callsInWrongThread.store(0);
+    SenderObject sender;
+    ConcurrentEmitThread thread(&sender);
+    thread.start();
+
+    for (int i = 0; i < 500; ++i) {
+        ConcurrentReceiver *receiver = new ConcurrentReceiver;
+        QVERIFY(connect(&sender, SIGNAL(signal1()), receiver, SLOT(slot())));
+        // move while queued calls are on their way
+        const int calls = ConcurrentReceiver::calls.load();
+        QTRY_VERIFY(ConcurrentReceiver::calls.load() > calls);
+        receiver->moveToThread(&thread);
+        receiver->deleteLater();
+    }
+
+    thread.stop.store(1);
+    QVERIFY(thread.wait(10000));
+    QCOMPARE(ConcurrentReceiver::callsInWrongThread.load(), 0);
+}
+
 QTEST_MAIN(tst_QObject)
 #include "tst_qobject.moc"
@@ -51,6 +51,9 @@
 #include <private/qnativesocketengine_p.h>
 #define NATIVESOCKETENGINE QNativeSocketEngine
 #ifdef Q_OS_UNIX
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <private/qeventdispatcher_unix_p.h>
 #include <private/qnet_unix_p.h>
 #include <sys/select.h>
 #endif
@@ -69,6 +72,10 @@ private slots:
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
     void posixSockets();
+    void reimplementedSelect_data();
+    void reimplementedSelect();
+    void multipleNotifiersForSameSocket_data();
+    void multipleNotifiersForSameSocket();
 #endif
 };
 
@@ -301,6 +308,172 @@ void tst_QSocketNotifier::posixSockets()
     }
     qt_safe_close(posixSocket);
 }
+
+class SelectCountingDispatcher : public QEventDispatcherUNIX
+{
+public:
+    SelectCountingDispatcher(bool callBase)
+        : selectCount(0), callBase(callBase)
+    { }
+
+    int selectCount;
+
+protected:
+    int select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, timeval *timeout)
+    {
+        ++selectCount;
+        if (callBase)
+            return QEventDispatcherUNIX::select(nfds, readfds, writefds, exceptfds, timeout);
+        return ::select(nfds, readfds, writefds, exceptfds, timeout);
+    }
+
+private:
+    bool callBase;
+};
+
+// runs the notifiers in a thread of its own, so that the event
+// dispatcher can be chosen regardless of the one of the main thread
+class NotifierThread : public QThread
+{
+public:
+    enum Mode { ReadThreeTimes, TwoNotifiers };
+
+    NotifierThread(Mode mode, int *fds)
+        : mode(mode), fds(fds), activations(0), secondActivations(0), selectCount(0)
+    { }
+
+    Mode mode;
+    int *fds;
+    int activations;
+    int secondActivations;
+    int selectCount;
+
+protected:
+    void run()
+    {
+        if (mode == ReadThreeTimes)
+            readThreeTimes();
+        else
+            twoNotifiers();
+
+        if (SelectCountingDispatcher *dispatcher =
+                dynamic_cast<SelectCountingDispatcher *>(eventDispatcher()))
+            selectCount = dispatcher->selectCount;
+    }
+
+private:
+    // processes events until the spies have seen activations or a timeout
+    static void waitFor(const QSignalSpy &spy, int count, const QSignalSpy *other = 0)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while ((spy.count() < count || (other && other->isEmpty())) && !timer.hasExpired(5000))
+            QAbstractEventDispatcher::instance()->processEvents(QEventLoop::AllEvents);
+    }
+
+    void readThreeTimes()
+    {
+        QSocketNotifier notifier(fds[0], QSocketNotifier::Read);
+        QSignalSpy spy(&notifier, SIGNAL(activated(int)));
+        for (int i = 1; i <= 3; ++i) {
+            char c = 'a';
+            qt_safe_write(fds[1], &c, 1);
+            waitFor(spy, i);
+            qt_safe_read(fds[0], &c, 1);
+        }
+        activations = spy.count();
+    }
+
+    void twoNotifiers()
+    {
+        // the pipe stays readable, so the notifiers fire on every pass
+        char c = 'a';
+        qt_safe_write(fds[1], &c, 1);
+
+        QSocketNotifier *first = new QSocketNotifier(fds[0], QSocketNotifier::Read);
+        QSocketNotifier second(fds[0], QSocketNotifier::Read);
+        QSignalSpy firstSpy(first, SIGNAL(activated(int)));
+        QSignalSpy secondSpy(&second, SIGNAL(activated(int)));
+        waitFor(firstSpy, 1, &secondSpy);
+        activations = qMin(firstSpy.count(), secondSpy.count());
+
+        delete first;
+        secondSpy.clear();
+        waitFor(secondSpy, 1);
+        secondActivations = secondSpy.count();
+    }
+};
+
+void tst_QSocketNotifier::reimplementedSelect_data()
+{
+    QTest::addColumn<bool>("useEpoll");
+    QTest::addColumn<bool>("callBase");
+
+    QTest::newRow("epoll, calling base") << true << true;
+    QTest::newRow("epoll, own select") << true << false;
+    QTest::newRow("select, calling base") << false << true;
+    QTest::newRow("select, own select") << false << false;
+}
+
+void tst_QSocketNotifier::reimplementedSelect()
+{
+    QFETCH(bool, useEpoll);
+    QFETCH(bool, callBase);
+
+    // QT_NO_EPOLL is only read when the dispatcher is created
+    const QByteArray noEpoll = qgetenv("QT_NO_EPOLL");
+    qputenv("QT_NO_EPOLL", useEpoll ? QByteArray() : QByteArray("1"));
+    SelectCountingDispatcher *dispatcher = new SelectCountingDispatcher(callBase);
+    qputenv("QT_NO_EPOLL", noEpoll);
+
+    int fds[2];
+    QVERIFY(qt_safe_pipe(fds) == 0);
+    NotifierThread thread(NotifierThread::ReadThreeTimes, fds);
+    thread.setEventDispatcher(dispatcher);
+    thread.start();
+    const bool finished = thread.wait(30000);
+    qt_safe_close(fds[0]);
+    qt_safe_close(fds[1]);
+    QVERIFY(finished);
+
+    QCOMPARE(thread.activations, 3);
+    QVERIFY(thread.selectCount >= 3);
+}
+
+void tst_QSocketNotifier::multipleNotifiersForSameSocket_data()
+{
+    QTest::addColumn<bool>("useEpoll");
+
+    QTest::newRow("epoll") << true;
+    QTest::newRow("select") << false;
+}
+
+void tst_QSocketNotifier::multipleNotifiersForSameSocket()
+{
+    QFETCH(bool, useEpoll);
+
+    const QByteArray noEpoll = qgetenv("QT_NO_EPOLL");
+    qputenv("QT_NO_EPOLL", useEpoll ? QByteArray() : QByteArray("1"));
+    QEventDispatcherUNIX *dispatcher = new QEventDispatcherUNIX;
+    qputenv("QT_NO_EPOLL", noEpoll);
+
+    int fds[2];
+    QVERIFY(qt_safe_pipe(fds) == 0);
+    const QByteArray warning = "QSocketNotifier: Multiple socket notifiers for same socket "
+                               + QByteArray::number(fds[0]) + " and type Read";
+    QTest::ignoreMessage(QtWarningMsg, warning.constData());
+
+    NotifierThread thread(NotifierThread::TwoNotifiers, fds);
+    thread.setEventDispatcher(dispatcher);
+    thread.start();
+    const bool finished = thread.wait(30000);
+    qt_safe_close(fds[0]);
+    qt_safe_close(fds[1]);
+    QVERIFY(finished);
+
+    QVERIFY(thread.activations > 0);
+    QVERIFY(thread.secondActivations > 0);
+}
 #endif
 
 QTEST_MAIN(tst_QSocketNotifier)
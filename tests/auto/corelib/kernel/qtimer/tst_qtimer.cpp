@@ -80,6 +80,13 @@ private slots:
 
     void dontBlockEvents();
     void postedEventsShouldNotStarveTimers();
+    void cascadingTimers();
+    void equalDeadlines_data();
+    void equalDeadlines();
+    void restartFromOwnTimerEvent_data();
+    void restartFromOwnTimerEvent();
+    void killPendingTimerFromTimerEvent();
+    void remainingTimeAfterCascading();
 };
 
 class TimerHelper : public QObject
@@ -717,5 +724,246 @@ void tst_QTimer::postedEventsShouldNotStarveTimers()
     QVERIFY(timerHelper.count > 5);
 }
 
+// The root level of the timer wheel covers the next 256 ms, timers that
+// are further away wait in the upper levels until they are cascaded down.
+class WheelTimerObject : public QObject
+{
+    Q_OBJECT
+public:
+    QElapsedTimer elapsed;
+    QHash<int, int> intervals;  // - interval of each timer
+    QHash<int, int> counts;     // - how often each timer fired
+    QSet<int> singleShots;
+    QList<int> fired;           // - single shot timers in firing order
+    bool tooEarly;
+    int maxDelay;
+
+    WheelTimerObject()
+        : tooEarly(false), maxDelay(0)
+    {
+        elapsed.start();
+    }
+
+    int start(int interval, bool singleShot, Qt::TimerType timerType = Qt::PreciseTimer)
+    {
+        int id = startTimer(interval, timerType);
+        intervals.insert(id, interval);
+        if (singleShot)
+            singleShots.insert(id);
+        return id;
+    }
+
+    void timerEvent(QTimerEvent *te)
+    {
+        const int id = te->timerId();
+        const int due = intervals.value(id) * ++counts[id];
+        const int now = int(elapsed.elapsed());
+        if (now < due)
+            tooEarly = true;
+        if (singleShots.contains(id)) {
+            killTimer(id);
+            fired << id;
+            maxDelay = qMax(maxDelay, now - due);
+            if (fired.size() == singleShots.size())
+                QTestEventLoop::instance().exitLoop();
+        }
+    }
+};
+
+void tst_QTimer::cascadingTimers()
+{
+    WheelTimerObject object;
+    QList<int> expected;
+    const int t1300 = object.start(1300, true);
+    const int t270 = object.start(270, true);
+    const int t700 = object.start(700, true);
+    const int t30 = object.start(30, true);
+    const int t520 = object.start(520, true);
+    const int shortTimer = object.start(10, false);
+    const int repeatingTimer = object.start(300, false);
+    const int longTimer = object.start(20000, false);
+    expected << t30 << t270 << t520 << t700 << t1300;
+
+    QTestEventLoop::instance().enterLoop(5);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+
+    QCOMPARE(object.fired, expected);
+    QVERIFY(!object.tooEarly);
+    QVERIFY2(object.maxDelay < 200, qPrintable(QString::number(object.maxDelay)));
+    QVERIFY(object.counts.value(shortTimer) > 10);
+    QVERIFY(object.counts.value(repeatingTimer) >= 3);
+    QCOMPARE(object.counts.value(longTimer), 0);
+}
+
+void tst_QTimer::equalDeadlines_data()
+{
+    QTest::addColumn<int>("interval");
+    QTest::addColumn<int>("timerType");
+
+    QTest::newRow("precise") << 20 << int(Qt::PreciseTimer);
+    QTest::newRow("precise-cascaded") << 300 << int(Qt::PreciseTimer);
+    QTest::newRow("verycoarse") << 1000 << int(Qt::VeryCoarseTimer);
+}
+
+void tst_QTimer::equalDeadlines()
+{
+    QFETCH(int, interval);
+    QFETCH(int, timerType);
+
+    // timers that expire at the same time fire in the order they were started
+    WheelTimerObject object;
+    QList<int> expected;
+    for (int i = 0; i < 10; ++i)
+        expected << object.start(interval, true, Qt::TimerType(timerType));
+
+    QTestEventLoop::instance().enterLoop(5);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QCOMPARE(object.fired, expected);
+}
+
+class RestartingTimerObject : public QObject
+{
+    Q_OBJECT
+public:
+    QElapsedTimer sinceStart;
+    int timerId;
+    int interval;
+    int restartInterval;
+    int restarts;
+    int companionId;
+    int companionCount;
+    bool tooEarly;
+
+    RestartingTimerObject(int interval, int restartInterval)
+        : interval(interval), restartInterval(restartInterval), restarts(0),
+          companionCount(0), tooEarly(false)
+    {
+        sinceStart.start();
+        timerId = startTimer(interval, Qt::PreciseTimer);
+        // expires together with the first timer
+        companionId = startTimer(interval, Qt::PreciseTimer);
+    }
+
+    void timerEvent(QTimerEvent *te)
+    {
+        if (te->timerId() == companionId) {
+            ++companionCount;
+            return;
+        }
+        QCOMPARE(te->timerId(), timerId);
+        if (sinceStart.elapsed() < interval)
+            tooEarly = true;
+
+        killTimer(timerId);
+        timerId = 0;
+        if (++restarts == 3) {
+            QTestEventLoop::instance().exitLoop();
+            return;
+        }
+        sinceStart.start();
+        interval = restartInterval;
+        timerId = startTimer(interval, Qt::PreciseTimer);
+    }
+};
+
+void tst_QTimer::restartFromOwnTimerEvent_data()
+{
+    QTest::addColumn<int>("interval");
+    QTest::addColumn<int>("restartInterval");
+
+    QTest::newRow("root") << 10 << 10;
+    QTest::newRow("cascaded") << 300 << 300;
+    QTest::newRow("root-to-cascaded") << 10 << 300;
+    QTest::newRow("cascaded-to-root") << 300 << 10;
+}
+
+void tst_QTimer::restartFromOwnTimerEvent()
+{
+    QFETCH(int, interval);
+    QFETCH(int, restartInterval);
+
+    RestartingTimerObject object(interval, restartInterval);
+    QTestEventLoop::instance().enterLoop(5);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+
+    QCOMPARE(object.restarts, 3);
+    QCOMPARE(object.timerId, 0);
+    QVERIFY(!object.tooEarly);
+    QTRY_VERIFY(object.companionCount > 0);
+}
+
+class KillingTimerObject : public QObject
+{
+    Q_OBJECT
+public:
+    int firstId;
+    int secondId;
+    int firstCount;
+    int secondCount;
+
+    KillingTimerObject(int interval)
+        : firstCount(0), secondCount(0)
+    {
+        firstId = startTimer(interval, Qt::PreciseTimer);
+        secondId = startTimer(interval, Qt::PreciseTimer);
+    }
+
+    void timerEvent(QTimerEvent *te)
+    {
+        if (te->timerId() == firstId) {
+            ++firstCount;
+            if (secondId) {
+                // the second timer has expired, but was not delivered yet
+                killTimer(secondId);
+                secondId = 0;
+            }
+        } else {
+            ++secondCount;
+        }
+    }
+};
+
+void tst_QTimer::killPendingTimerFromTimerEvent()
+{
+    KillingTimerObject object(300);
+    QTRY_VERIFY(object.firstCount >= 2);
+    QCOMPARE(object.secondCount, 0);
+}
+
+void tst_QTimer::remainingTimeAfterCascading()
+{
+    TimerHelper helper;
+    QTimer timer;
+    timer.setTimerType(Qt::PreciseTimer);
+    timer.setSingleShot(true);
+    connect(&timer, SIGNAL(timeout()), &helper, SLOT(timeout()));
+    QTimer longTimer;
+    longTimer.setTimerType(Qt::PreciseTimer);
+    QTimer shortTimer;
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    timer.start(1000);
+    longTimer.start(20000);
+    shortTimer.start(10);
+
+    // sample the remaining time while the timer moves down the wheel
+    while (elapsed.elapsed() < 950) {
+        const int remaining = timer.remainingTime();
+        const int expected = 1000 - int(elapsed.elapsed());
+        QVERIFY2(qAbs(remaining - expected) <= 10,
+                 qPrintable(QString::fromLatin1("%1 %2").arg(remaining).arg(expected)));
+        const int longRemaining = longTimer.remainingTime();
+        QVERIFY2(qAbs(longRemaining - (expected + 19000)) <= 10,
+                 qPrintable(QString::number(longRemaining)));
+        QCOMPARE(helper.count, 0);
+        QTest::qWait(50);
+    }
+
+    QTRY_COMPARE(helper.count, 1);
+    QVERIFY(elapsed.elapsed() >= 1000);
+    QVERIFY(longTimer.isActive());
+}
+
 QTEST_MAIN(tst_QTimer)
 #include "tst_qtimer.moc"
@@ -42,6 +42,12 @@
 #include <QtTest/qtest.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
+#include <QtCore/qdatastream.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qpluginloader.h>
+#include <QtCore/qtemporarydir.h>
 #include <private/qfactoryloader_p.h>
 #include "plugin1/plugininterface1.h"
 #include "plugin2/plugininterface2.h"
@@ -54,6 +60,20 @@ public slots:
 
 private slots:
     void usingTwoFactoriesFromSameDir();
+#ifdef QT_SHARED
+    void metaDataCacheIsUsed();
+    void metaDataCacheRebuiltWhenPluginChanges_data();
+    void metaDataCacheRebuiltWhenPluginChanges();
+    void corruptMetaDataCacheIsIgnored_data();
+    void corruptMetaDataCacheIsIgnored();
+#endif
+
+private:
+    QString copyPlugin(const QString &name);
+
+    QString m_binFolder;
+    QTemporaryDir m_cacheDir;
+    QString m_cacheFile;
 };
 
 static const char binFolderC[] = "bin";
@@ -62,6 +82,12 @@ void tst_QFactoryLoader::initTestCase()
 {
     const QString binFolder = QFINDTESTDATA(binFolderC);
     QVERIFY2(!binFolder.isEmpty(), "Unable to locate 'bin' folder");
+    m_binFolder = binFolder;
+
+    // the cache file name is read when the first QFactoryLoader is created
+    QVERIFY(m_cacheDir.isValid());
+    m_cacheFile = m_cacheDir.path() + QLatin1String("/plugin-cache");
+    qputenv("QT_PLUGIN_CACHE", QFile::encodeName(m_cacheFile));
 
     QCoreApplication::setLibraryPaths(QStringList(QFileInfo(binFolder).absolutePath()));
 }
@@ -87,5 +113,162 @@ void tst_QFactoryLoader::usingTwoFactoriesFromSameDir()
     QCOMPARE(plugin2->pluginName(), QLatin1String("Plugin2 ok"));
 }
 
+// Copies plugin1 to <cache dir>/<name>/bin and makes that the only plugin
+// directory, so that a fresh file is looked at. Returns its canonical path.
+QString tst_QFactoryLoader::copyPlugin(const QString &name)
+{
+    const QStringList plugins = QDir(m_binFolder).entryList(QStringList(QLatin1String("*plugin1*")), QDir::Files);
+    if (plugins.isEmpty())
+        return QString();
+
+    const QString root = m_cacheDir.path() + QLatin1Char('/') + name;
+    const QString target = root + QLatin1Char('/') + QLatin1String(binFolderC)
+            + QLatin1Char('/') + plugins.first();
+    if (!QDir().mkpath(QFileInfo(target).absolutePath())
+        || !QFile::copy(m_binFolder + QLatin1Char('/') + plugins.first(), target))
+        return QString();
+
+    QCoreApplication::setLibraryPaths(QStringList(root));
+    return QFileInfo(target).canonicalFilePath();
+}
+
+#ifdef QT_SHARED
+// the cache file format of QPluginMetaDataCache
+enum { CacheMagic = 0x51504d43, CacheVersion = 1 };
+
+static bool writeCache(const QString &cacheFile, const QByteArray &data)
+{
+    QByteArray contents = data;
+    // the cache is only read again when its size or time stamp changed
+    if (QFileInfo(cacheFile).size() == contents.size())
+        contents.append('\0');
+    QFile file(cacheFile);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            && file.write(contents) == contents.size();
+}
+
+static QByteArray cacheData(const QString &fileName, qint64 lastModified, qint64 size,
+                            const QJsonObject &metaData)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << quint32(CacheMagic) << quint32(CacheVersion) << quint32(1)
+           << fileName << lastModified << size << QJsonDocument(metaData).toBinaryData();
+    return data;
+}
+
+// returns the IID the cache records for fileName
+static QString cachedIid(const QString &cacheFile, const QString &fileName)
+{
+    QFile file(cacheFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return QString();
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic, version, count;
+    stream >> magic >> version >> count;
+    if (magic != quint32(CacheMagic) || version != quint32(CacheVersion))
+        return QString();
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString name;
+        qint64 lastModified, size;
+        QByteArray data;
+        stream >> name >> lastModified >> size >> data;
+        if (name == fileName)
+            return QJsonDocument::fromBinaryData(data).object().value(QLatin1String("IID")).toString();
+    }
+    return QString();
+}
+
+static const char cachedIidC[] = "org.qt-project.Qt.tst_qfactoryloader.CachedInterface";
+
+// the meta data of plugin, claiming to implement another interface
+static QJsonObject cachedMetaData(const QString &plugin)
+{
+    QJsonObject metaData = QPluginLoader(plugin).metaData();
+    metaData.insert(QLatin1String("IID"), QLatin1String(cachedIidC));
+    return metaData;
+}
+
+void tst_QFactoryLoader::metaDataCacheIsUsed()
+{
+    const QString plugin = copyPlugin(QLatin1String("used"));
+    QVERIFY(!plugin.isEmpty());
+
+    // the cached meta data wins as long as the plugin is unchanged
+    const QFileInfo info(plugin);
+    QVERIFY(writeCache(m_cacheFile, cacheData(plugin, info.lastModified().toMSecsSinceEpoch(),
+                                              info.size(), cachedMetaData(plugin))));
+
+    const QString suffix = QLatin1Char('/') + QLatin1String(binFolderC);
+    QFactoryLoader loader(cachedIidC, suffix);
+    QCOMPARE(loader.metaData().size(), 1);
+    QCOMPARE(cachedIid(m_cacheFile, plugin), QLatin1String(cachedIidC));
+}
+
+void tst_QFactoryLoader::metaDataCacheRebuiltWhenPluginChanges_data()
+{
+    QTest::addColumn<qint64>("timeOffset");
+    QTest::addColumn<qint64>("sizeOffset");
+
+    QTest::newRow("modified") << qint64(-2000) << qint64(0);
+    QTest::newRow("resized") << qint64(0) << qint64(1);
+}
+
+void tst_QFactoryLoader::metaDataCacheRebuiltWhenPluginChanges()
+{
+    QFETCH(qint64, timeOffset);
+    QFETCH(qint64, sizeOffset);
+
+    const QString plugin = copyPlugin(QLatin1String("changed-") + QLatin1String(QTest::currentDataTag()));
+    QVERIFY(!plugin.isEmpty());
+
+    const QFileInfo info(plugin);
+    QVERIFY(writeCache(m_cacheFile, cacheData(plugin, info.lastModified().toMSecsSinceEpoch() + timeOffset,
+                                              info.size() + sizeOffset, cachedMetaData(plugin))));
+
+    const QString suffix = QLatin1Char('/') + QLatin1String(binFolderC);
+    QFactoryLoader cachedLoader(cachedIidC, suffix);
+    QCOMPARE(cachedLoader.metaData().size(), 0);
+    QFactoryLoader loader(PluginInterface1_iid, suffix);
+    QCOMPARE(loader.metaData().size(), 1);
+
+    // the stale entry has been replaced
+    QCOMPARE(cachedIid(m_cacheFile, plugin), QLatin1String(PluginInterface1_iid));
+}
+
+void tst_QFactoryLoader::corruptMetaDataCacheIsIgnored_data()
+{
+    QTest::addColumn<QByteArray>("contents");
+
+    QTest::newRow("garbage") << QByteArray("this is not a plugin cache");
+
+    QByteArray valid = cacheData(QLatin1String("/nonexistent/libplugin.so"), 0, 0, QJsonObject());
+    QTest::newRow("truncated") << valid.left(valid.size() - 3);
+
+    QByteArray wrongVersion;
+    QDataStream stream(&wrongVersion, QIODevice::WriteOnly);
+    stream << quint32(CacheMagic) << quint32(CacheVersion + 1) << quint32(0);
+    QTest::newRow("wrong-version") << wrongVersion;
+}
+
+void tst_QFactoryLoader::corruptMetaDataCacheIsIgnored()
+{
+    QFETCH(QByteArray, contents);
+
+    const QString plugin = copyPlugin(QLatin1String("corrupt-") + QLatin1String(QTest::currentDataTag()));
+    QVERIFY(!plugin.isEmpty());
+    QVERIFY(writeCache(m_cacheFile, contents));
+
+    const QString suffix = QLatin1Char('/') + QLatin1String(binFolderC);
+    QFactoryLoader loader(PluginInterface1_iid, suffix);
+    QCOMPARE(loader.metaData().size(), 1);
+
+    // a valid cache has been written in its place
+    QCOMPARE(cachedIid(m_cacheFile, plugin), QLatin1String(PluginInterface1_iid));
+}
+#endif // QT_SHARED
+
 QTEST_MAIN(tst_QFactoryLoader)
 #include "tst_qfactoryloader.moc"
@@ -76,9 +76,13 @@ private slots:
     void pause();
     void throttling();
     void voidConversions();
+    void continuations();
+    void continuationContext();
+    void continuationOfDestroyedFuture();
 #ifndef QT_NO_EXCEPTIONS
     void exceptions();
     void nestedExceptions();
+    void continuationExceptions();
 #endif
 };
 
@@ -1282,6 +1286,279 @@ void tst_QFuture::voidConversions()
 
 #ifndef QT_NO_EXCEPTIONS
 
+static int addOne(int value)
+{
+    return value + 1;
+}
+
+static QThread *continuationThread;
+
+static int currentThreadResult()
+{
+    continuationThread = QThread::currentThread();
+    return 42;
+}
+
+static QAtomicInt continuationCalls;
+
+static void countCall()
+{
+    continuationCalls.ref();
+}
+
+static void countIntCall(const int &)
+{
+    continuationCalls.ref();
+}
+
+struct IntToString
+{
+    typedef QString result_type;
+    QString operator()(int value) const { return QString::number(value); }
+};
+
+// counts its copies, to check that continuations are freed
+struct CountedAddOne
+{
+    typedef int result_type;
+    static QAtomicInt instances;
+
+    CountedAddOne() { instances.ref(); }
+    CountedAddOne(const CountedAddOne &) { instances.ref(); }
+    ~CountedAddOne() { instances.deref(); }
+    int operator()(int value) const { return value + 1; }
+};
+
+QAtomicInt CountedAddOne::instances;
+
+class ThenFromThread : public QThread
+{
+public:
+    ThenFromThread(const QFuture<void> &source, QObject *context)
+        : source(source), context(context)
+    { }
+
+    QFuture<int> future;
+
+protected:
+    void run()
+    {
+        future = source.then(context, currentThreadResult);
+    }
+
+private:
+    QFuture<void> source;
+    QObject *context;
+};
+
+void tst_QFuture::continuations()
+{
+    // continuations of running futures
+    {
+        QFutureInterface<int> source;
+        source.reportStarted();
+        QFuture<QString> f = source.future().then(addOne).then(addOne).then(IntToString());
+        QVERIFY(f.isStarted());
+        QVERIFY(!f.isFinished());
+        source.reportResult(1);
+        source.reportFinished();
+        QCOMPARE(f.result(), QString("3"));
+        f.waitForFinished();
+        QVERIFY(f.isFinished());
+        QVERIFY(!f.isCanceled());
+    }
+
+    // continuations of finished futures
+    {
+        QFutureInterface<int> source;
+        source.reportStarted();
+        source.reportResult(41);
+        source.reportFinished();
+        QCOMPARE(source.future().then(addOne).result(), 42);
+    }
+
+    // void futures and functions
+    {
+        continuationCalls.store(0);
+        QFutureInterface<void> source;
+        source.reportStarted();
+        QFuture<void> f = source.future().then(countCall).then(countCall);
+        QFuture<int> g = source.future().then(currentThreadResult);
+        source.reportFinished();
+        f.waitForFinished();
+        QCOMPARE(continuationCalls.load(), 2);
+        QCOMPARE(g.result(), 42);
+
+        QFutureInterface<int> intSource;
+        intSource.reportStarted();
+        intSource.reportResult(1);
+        intSource.reportFinished();
+        intSource.future().then(countIntCall).waitForFinished();
+        QCOMPARE(continuationCalls.load(), 3);
+    }
+
+    // cancellation is propagated, without calling the functions
+    {
+        continuationCalls.store(0);
+        QFutureInterface<int> source;
+        source.reportStarted();
+        QFuture<void> f = source.future().then(countIntCall).then(countCall);
+        source.future().cancel();
+        source.reportFinished();
+        f.waitForFinished();
+        QVERIFY(f.isCanceled());
+        QCOMPARE(continuationCalls.load(), 0);
+
+        QFuture<int> canceled = QFuture<int>().then(addOne);
+        canceled.waitForFinished();
+        QVERIFY(canceled.isCanceled());
+    }
+
+    // finished futures without result cancel their continuations
+    {
+        QFutureInterface<int> source;
+        source.reportStarted();
+        source.reportFinished();
+        QFuture<int> f = source.future().then(addOne);
+        f.waitForFinished();
+        QVERIFY(f.isCanceled());
+    }
+
+    // canceling a continuation
+    {
+        continuationCalls.store(0);
+        QFutureInterface<void> source;
+        source.reportStarted();
+        QFuture<void> f = source.future().then(countCall);
+        f.cancel();
+        source.reportFinished();
+        f.waitForFinished();
+        QVERIFY(f.isCanceled());
+        QCOMPARE(continuationCalls.load(), 0);
+    }
+
+    // running on a given pool
+    {
+        QThreadPool pool;
+        QFutureInterface<int> source;
+        source.reportStarted();
+        QFuture<int> f = source.future().then(addOne, &pool);
+        source.reportResult(1);
+        source.reportFinished();
+        QCOMPARE(f.result(), 2);
+        pool.waitForDone();
+    }
+}
+
+void tst_QFuture::continuationContext()
+{
+    // the continuation runs in the context's thread
+    {
+        continuationThread = 0;
+        QObject context;
+        QFutureInterface<void> source;
+        source.reportStarted();
+        QFuture<int> f = source.future().then(&context, currentThreadResult);
+        source.reportFinished();
+        QTRY_VERIFY(f.isFinished());
+        QCOMPARE(f.result(), 42);
+        QCOMPARE(continuationThread, QThread::currentThread());
+    }
+
+    // destroying the context cancels the continuation
+    {
+        continuationCalls.store(0);
+        QObject *context = new QObject;
+        QFutureInterface<void> source;
+        source.reportStarted();
+        QFuture<void> f = source.future().then(context, countCall);
+        source.reportFinished();
+        delete context;
+        QTRY_VERIFY(f.isFinished());
+        QVERIFY(f.isCanceled());
+        QCOMPARE(continuationCalls.load(), 0);
+
+        f = source.future().then(context = new QObject, countCall);
+        delete context;
+        QTRY_VERIFY(f.isFinished());
+        QVERIFY(f.isCanceled());
+        QCOMPARE(continuationCalls.load(), 0);
+    }
+
+    // then() called from another thread still runs in the context's thread
+    {
+        continuationThread = 0;
+        QObject context;
+        QFutureInterface<void> source;
+        source.reportStarted();
+        ThenFromThread thread(source.future(), &context);
+        thread.start();
+        QVERIFY(thread.wait(30000));
+        source.reportFinished();
+        QTRY_VERIFY(thread.future.isFinished());
+        QCOMPARE(thread.future.result(), 42);
+        QCOMPARE(continuationThread, QThread::currentThread());
+    }
+}
+
+void tst_QFuture::continuationOfDestroyedFuture()
+{
+    // a future that can no longer finish cancels and frees its continuations
+    {
+        QFuture<int> f;
+        {
+            QFutureInterface<int> source;
+            source.reportStarted();
+            f = source.future().then(CountedAddOne());
+            QCOMPARE(CountedAddOne::instances.load(), 1);
+        }
+        QCOMPARE(CountedAddOne::instances.load(), 0);
+        QVERIFY(f.isFinished());
+        QVERIFY(f.isCanceled());
+    }
+
+    // the rest of a chain is canceled as well
+    {
+        QFuture<int> f;
+        {
+            QFutureInterface<int> source;
+            source.reportStarted();
+            f = source.future().then(CountedAddOne()).then(CountedAddOne());
+            QCOMPARE(CountedAddOne::instances.load(), 2);
+        }
+        f.waitForFinished();
+        QVERIFY(f.isCanceled());
+        QTRY_COMPARE(CountedAddOne::instances.load(), 0);
+    }
+
+    // continuations with a context are freed in the context's thread
+    {
+        QObject context;
+        QFuture<int> f;
+        {
+            QFutureInterface<int> source;
+            source.reportStarted();
+            f = source.future().then(&context, CountedAddOne());
+        }
+        QTRY_VERIFY(f.isFinished());
+        QVERIFY(f.isCanceled());
+        QCOMPARE(CountedAddOne::instances.load(), 0);
+    }
+
+    // finished futures are kept alive by their continuations until they ran
+    {
+        QFutureInterface<int> *source = new QFutureInterface<int>;
+        source->reportStarted();
+        QObject context;
+        QFuture<int> f = source->future().then(&context, CountedAddOne());
+        source->reportResult(1);
+        source->reportFinished();
+        delete source;
+        QTRY_VERIFY(f.isFinished());
+        QCOMPARE(f.result(), 2);
+    }
+}
+
 QFuture<void> createExceptionFuture()
 {
     QFutureInterface<void> i;
@@ -1444,6 +1721,55 @@ void tst_QFuture::nestedExceptions()
     QVERIFY(MyClass::caught);
 }
 
+static int throwException(int)
+{
+    throw QException();
+}
+
+void tst_QFuture::continuationExceptions()
+{
+    // exceptions of the parent are propagated
+    {
+        QFuture<int> f = createExceptionResultFuture().then(addOne).then(addOne);
+        bool caught = false;
+        try {
+            f.waitForFinished();
+        } catch (QException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+        QVERIFY(f.isCanceled());
+    }
+
+    // exceptions thrown by the function are reported
+    {
+        QFutureInterface<int> source;
+        source.reportStarted();
+        source.reportResult(1);
+        source.reportFinished();
+        QFuture<int> f = source.future().then(throwException).then(addOne);
+        bool caught = false;
+        try {
+            f.waitForFinished();
+        } catch (QException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+
+    // derived exceptions keep their type
+    {
+        QFuture<void> f = createDerivedExceptionFuture().then(countCall);
+        bool caught = false;
+        try {
+            f.waitForFinished();
+        } catch (DerivedException &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+}
+
 #endif // QT_NO_EXCEPTIONS
 
 QTEST_MAIN(tst_QFuture)
@@ -96,6 +96,8 @@ private slots:
     void countingTest();
     void limitedReaders();
     void deleteOnUnlock();
+    void contendedTryLockTimeouts();
+    void writerPreference();
 
 /*
     Performance tests
@@ -899,6 +901,156 @@ void tst_QReadWriteLock::deleteOnUnlock()
     }
 }
 
+/*
+    Tries to lock a lock held by the main thread, with a zero and a
+    positive timeout.
+*/
+class TryLockThread : public QThread
+{
+public:
+    enum Mode { Read, Write };
+
+    TryLockThread(QReadWriteLock &lock, Mode mode, int timeout)
+        : lock(lock), mode(mode), timeout(timeout), locked(false), elapsed(-1)
+    { }
+
+    QReadWriteLock &lock;
+    Mode mode;
+    int timeout;
+    bool locked;
+    qint64 elapsed;
+
+    void run()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        locked = mode == Read ? lock.tryLockForRead(timeout) : lock.tryLockForWrite(timeout);
+        elapsed = timer.elapsed();
+        if (locked)
+            lock.unlock();
+    }
+};
+
+void tst_QReadWriteLock::contendedTryLockTimeouts()
+{
+    QReadWriteLock testLock;
+
+    // a zero timeout never blocks, whatever holds the lock
+    testLock.lockForWrite();
+    {
+        TryLockThread reader(testLock, TryLockThread::Read, 0);
+        TryLockThread writer(testLock, TryLockThread::Write, 0);
+        reader.start();
+        writer.start();
+        QVERIFY(reader.wait(5000));
+        QVERIFY(writer.wait(5000));
+        QVERIFY(!reader.locked);
+        QVERIFY(!writer.locked);
+    }
+
+    // a positive timeout waits that long, then gives up
+    {
+        TryLockThread reader(testLock, TryLockThread::Read, 200);
+        TryLockThread writer(testLock, TryLockThread::Write, 200);
+        reader.start();
+        writer.start();
+        QVERIFY(reader.wait(5000));
+        QVERIFY(writer.wait(5000));
+        QVERIFY(!reader.locked);
+        QVERIFY(!writer.locked);
+        QVERIFY(reader.elapsed >= 200);
+        QVERIFY(writer.elapsed >= 200);
+    }
+    testLock.unlock();
+
+    // readers share the lock, writers time out
+    testLock.lockForRead();
+    {
+        TryLockThread reader(testLock, TryLockThread::Read, 0);
+        TryLockThread writer(testLock, TryLockThread::Write, 0);
+        reader.start();
+        writer.start();
+        QVERIFY(reader.wait(5000));
+        QVERIFY(writer.wait(5000));
+        QVERIFY(reader.locked);
+        QVERIFY(!writer.locked);
+    }
+
+    // a positive timeout succeeds once the lock is released in time
+    {
+        TryLockThread writer(testLock, TryLockThread::Write, 10000);
+        writer.start();
+        QTest::qSleep(100);
+        testLock.unlock();
+        QVERIFY(writer.wait(15000));
+        QVERIFY(writer.locked);
+        QVERIFY(writer.elapsed < 10000);
+    }
+
+    // the failed attempts left the lock usable
+    QVERIFY(testLock.tryLockForWrite());
+    testLock.unlock();
+}
+
+static QAtomicInt lockOrder;
+
+/*
+    lock, note the order in which the lock was acquired,
+    hold the lock a little, unlock
+*/
+class OrderedLockThread : public QThread
+{
+public:
+    OrderedLockThread(QReadWriteLock &lock, bool write)
+        : lock(lock), write(write), order(-1)
+    { }
+
+    QReadWriteLock &lock;
+    bool write;
+    int order;
+
+    void run()
+    {
+        if (write)
+            lock.lockForWrite();
+        else
+            lock.lockForRead();
+        order = lockOrder.fetchAndAddRelaxed(1);
+        msleep(50);
+        lock.unlock();
+    }
+};
+
+/*
+    A reader holds the lock and a writer waits for it: new readers must
+    wait behind the writer instead of starving it.
+*/
+void tst_QReadWriteLock::writerPreference()
+{
+    QReadWriteLock testLock;
+    lockOrder.store(0);
+
+    testLock.lockForRead();
+    OrderedLockThread writer(testLock, true);
+    writer.start();
+    QTest::qSleep(200);
+
+    // the waiting writer keeps out new readers that would wait
+    QVERIFY(!testLock.tryLockForRead(0));
+    QVERIFY(!testLock.tryLockForRead(100));
+
+    OrderedLockThread reader(testLock, false);
+    reader.start();
+    QTest::qSleep(200);
+    QCOMPARE(lockOrder.load(), 0);
+
+    testLock.unlock();
+    QVERIFY(writer.wait(10000));
+    QVERIFY(reader.wait(10000));
+    QCOMPARE(writer.order, 0);
+    QCOMPARE(reader.order, 1);
+}
+
 
 void tst_QReadWriteLock::uncontendedLocks()
 {
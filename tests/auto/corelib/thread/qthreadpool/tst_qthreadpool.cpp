@@ -91,6 +91,7 @@ private slots:
     void waitForDone();
     void waitForDoneTimeout();
     void destroyingWaitsForTasksToFinish();
+    void workStealing();
     void stressTest();
 };
 
@@ -812,6 +813,80 @@ void tst_QThreadPool::destroyingWaitsForTasksToFinish()
     }
 }
 
+QAtomicInt workStealingCount;
+QAtomicInt workStealingHighPriorityCount;
+
+void tst_QThreadPool::workStealing()
+{
+    class HighPriorityTask : public QRunnable
+    {
+    public:
+        void run()
+        {
+            workStealingHighPriorityCount.ref();
+        }
+    };
+
+    class Task : public QRunnable
+    {
+        QThreadPool *pool;
+        int depth;
+    public:
+        Task(QThreadPool *pool, int depth) : pool(pool), depth(depth) { }
+
+        void run()
+        {
+            if (depth > 0) {
+                pool->start(new Task(pool, depth - 1));
+                pool->start(new Task(pool, depth - 1));
+                if (depth == 5)
+                    pool->start(new HighPriorityTask, 1);
+            }
+            workStealingCount.ref();
+        }
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    QVERIFY(!pool.isWorkStealingEnabled());
+    pool.setWorkStealingEnabled(true);
+    QVERIFY(pool.isWorkStealingEnabled());
+
+    for (int i = 0; i < 5; ++i) {
+        workStealingCount.store(0);
+        workStealingHighPriorityCount.store(0);
+        pool.start(new Task(&pool, 12));
+        QVERIFY(pool.waitForDone(60000));
+        QCOMPARE(workStealingCount.load(), (1 << 13) - 1);
+        QCOMPARE(workStealingHighPriorityCount.load(), 1 << 7);
+        QCOMPARE(pool.activeThreadCount(), 0);
+    }
+
+    // runnables that are not auto-deleted can be run several times
+    workStealingCount.store(0);
+    class RepeatedTask : public QRunnable
+    {
+    public:
+        RepeatedTask() { setAutoDelete(false); }
+        void run() { workStealingCount.ref(); }
+    } repeatedTask;
+    class SpawningTask : public QRunnable
+    {
+        QThreadPool *pool;
+        QRunnable *task;
+    public:
+        SpawningTask(QThreadPool *pool, QRunnable *task) : pool(pool), task(task) { }
+        void run()
+        {
+            for (int i = 0; i < 100; ++i)
+                pool->start(task);
+        }
+    };
+    pool.start(new SpawningTask(&pool, &repeatedTask));
+    QVERIFY(pool.waitForDone(60000));
+    QCOMPARE(workStealingCount.load(), 100);
+}
+
 void tst_QThreadPool::stressTest()
 {
     class Task : public QRunnable
@@ -0,0 +1,4 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qarraydataarena
+QT = core testlib
+SOURCES = tst_qarraydataarena.cpp
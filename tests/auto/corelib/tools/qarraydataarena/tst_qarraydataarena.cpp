@@ -0,0 +1,294 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qarraydataarena.h>
+#include <qthread.h>
+
+class tst_QArrayDataArena : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void noArena();
+    void allocations();
+    void nesting();
+    void escapingData();
+    void appendInPlace();
+    void largeAllocations();
+    void manyBlocks();
+    void vector();
+    void otherThreads();
+};
+
+void tst_QArrayDataArena::noArena()
+{
+    QVERIFY(!QArrayDataArena::current());
+
+    QString s(100, QLatin1Char('a'));
+    s.append(QLatin1String("bc"));
+    QCOMPARE(s.size(), 102);
+}
+
+void tst_QArrayDataArena::allocations()
+{
+    // QCOMPARE allocates too, so the counts are sampled first.
+    QArrayDataArena arena;
+    QCOMPARE(QArrayDataArena::current(), &arena);
+    const int initialCount = arena.allocationCount();
+    const int initialBlocks = arena.blockCount();
+    QCOMPARE(initialCount, 0);
+    QCOMPARE(initialBlocks, 0);
+
+    int count = arena.allocationCount();
+    QString s(10, QLatin1Char('x'));
+    QByteArray b("hello");
+    int newCount = arena.allocationCount();
+    QCOMPARE(newCount - count, 2);
+    QCOMPARE(arena.blockCount(), 1);
+    QVERIFY(arena.bytesAllocated() > 0);
+    QCOMPARE(s, QString("xxxxxxxxxx"));
+    QCOMPARE(b, QByteArray("hello"));
+
+    // Shared copies don't allocate, detaching does.
+    count = arena.allocationCount();
+    QString copy = s;
+    newCount = arena.allocationCount();
+    QCOMPARE(newCount, count);
+    count = arena.allocationCount();
+    copy[0] = QLatin1Char('y');
+    newCount = arena.allocationCount();
+    QCOMPARE(newCount - count, 1);
+    QCOMPARE(s, QString("xxxxxxxxxx"));
+    QCOMPARE(copy, QString("yxxxxxxxxx"));
+
+    // Empty containers use shared null data.
+    count = arena.allocationCount();
+    QString empty;
+    QByteArray emptyArray;
+    QVector<int> emptyVector;
+    newCount = arena.allocationCount();
+    QCOMPARE(newCount, count);
+    QCOMPARE(arena.fallbackCount(), 0);
+}
+
+void tst_QArrayDataArena::nesting()
+{
+    QArrayDataArena outer;
+    QString a(QLatin1String("outer"));
+    {
+        QArrayDataArena inner;
+        QCOMPARE(QArrayDataArena::current(), &inner);
+        const int outerCount = outer.allocationCount();
+        QString b(QLatin1String("inner"));
+        const int innerCount = inner.allocationCount();
+        QCOMPARE(outer.allocationCount(), outerCount);
+        QVERIFY(innerCount > 0);
+
+        a += b;
+        QCOMPARE(a, QString("outerinner"));
+    }
+    QCOMPARE(QArrayDataArena::current(), &outer);
+    QCOMPARE(a, QString("outerinner"));
+}
+
+static QString makeString(int n)
+{
+    QArrayDataArena arena;
+    QString result;
+    for (int i = 0; i < n; ++i)
+        result += QString::number(i);
+    return result;
+}
+
+void tst_QArrayDataArena::escapingData()
+{
+    QString escaped = makeString(100);
+    QVERIFY(!QArrayDataArena::current());
+    QVERIFY(escaped.startsWith(QLatin1String("0123456789101112")));
+    QVERIFY(escaped.endsWith(QLatin1String("979899")));
+
+    // Growing data that was allocated from an arena which is gone moves it
+    // to the heap.
+    for (int i = 0; i < 1000; ++i)
+        escaped += QLatin1Char('!');
+    QCOMPARE(escaped.count(QLatin1Char('!')), 1000);
+    QVERIFY(escaped.contains(QLatin1String("99!!!!")));
+    escaped.squeeze();
+
+    QByteArray bytes;
+    {
+        QArrayDataArena arena;
+        bytes = QByteArray("abc").repeated(10);
+    }
+    bytes.resize(20);
+    QCOMPARE(bytes, QByteArray("abcabcabcabcabcabcab"));
+    bytes.clear();
+}
+
+void tst_QArrayDataArena::appendInPlace()
+{
+    QArrayDataArena arena;
+    QString s;
+    for (int i = 0; i < 1000; ++i)
+        s += QLatin1Char('a' + i % 26);
+    QByteArray b;
+    for (int i = 0; i < 1000; ++i)
+        b += char('a' + i % 26);
+
+    // Appending to the most recent allocation grows it in place, so the
+    // arena needs little more memory than the final data.
+    const int blocks = arena.blockCount();
+    const qint64 bytes = arena.bytesAllocated();
+    QCOMPARE(blocks, 1);
+    QVERIFY(bytes < qint64(s.capacity()) * 2 + b.capacity() + 256);
+
+    QCOMPARE(s.size(), 1000);
+    QCOMPARE(b.size(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        QCOMPARE(s.at(i), QChar('a' + i % 26));
+        QCOMPARE(b.at(i), char('a' + i % 26));
+    }
+}
+
+void tst_QArrayDataArena::largeAllocations()
+{
+    QArrayDataArena arena;
+    QByteArray large(1024 * 1024, 'x');
+    int count = arena.allocationCount();
+    int fallbacks = arena.fallbackCount();
+    QCOMPARE(count, 0);
+    QCOMPARE(fallbacks, 1);
+    QCOMPARE(large.count('x'), 1024 * 1024);
+
+    // Data that grows beyond what the arena serves moves to the heap.
+    count = arena.allocationCount();
+    QString s(QLatin1String("abc"));
+    fallbacks = arena.fallbackCount();
+    s.resize(100000);
+    QCOMPARE(arena.allocationCount(), count + 1);
+    QCOMPARE(arena.fallbackCount(), fallbacks + 1);
+    QCOMPARE(s.left(3), QString("abc"));
+}
+
+void tst_QArrayDataArena::manyBlocks()
+{
+    QStringList kept;
+    int blocks;
+    {
+        QArrayDataArena arena;
+        for (int i = 0; i < 1000; ++i) {
+            QString s(500, QLatin1Char('a' + i % 26));
+            if (i % 10 == 0)
+                kept.append(s);
+        }
+        const int count = arena.allocationCount();
+        blocks = arena.blockCount();
+        QCOMPARE(count, 1000);
+        QVERIFY(blocks > 1);
+    }
+
+    QCOMPARE(kept.size(), 100);
+    for (int i = 0; i < kept.size(); ++i)
+        QCOMPARE(kept.at(i), QString(500, QLatin1Char('a' + (i * 10) % 26)));
+}
+
+void tst_QArrayDataArena::vector()
+{
+    QArrayDataArena arena;
+    QVector<int> v;
+    for (int i = 0; i < 1000; ++i)
+        v.append(i);
+    QVERIFY(arena.allocationCount() > 0);
+    QCOMPARE(arena.fallbackCount(), 0);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(v.at(i), i);
+}
+
+class ArenaThread : public QThread
+{
+public:
+    ArenaThread() : allocations(0) {}
+
+    QString input;
+    QString output;
+    int allocations;
+
+protected:
+    void run()
+    {
+        // Data allocated by the main thread's arena can be freed here.
+        input = QString();
+        if (QArrayDataArena::current())
+            return;
+
+        QArrayDataArena arena;
+        QString s;
+        for (int i = 0; i < 100; ++i)
+            s += QString::number(i);
+        output = s;
+        allocations = arena.allocationCount();
+    }
+};
+
+void tst_QArrayDataArena::otherThreads()
+{
+    ArenaThread thread;
+    {
+        QArrayDataArena arena;
+        thread.input = QString(100, QLatin1Char('x'));
+        const int count = arena.allocationCount();
+        QCOMPARE(count, 1);
+
+        thread.start();
+        QVERIFY(thread.wait());
+        QCOMPARE(arena.allocationCount(), count);
+    }
+
+    QVERIFY(thread.allocations > 0);
+    QVERIFY(thread.output.startsWith(QLatin1String("0123456789")));
+    QVERIFY(thread.output.endsWith(QLatin1String("9899")));
+    thread.output = QString();
+}
+
+QTEST_APPLESS_MAIN(tst_QArrayDataArena)
+#include "tst_qarraydataarena.moc"
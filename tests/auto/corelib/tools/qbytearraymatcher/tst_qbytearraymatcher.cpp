@@ -56,6 +56,7 @@ class tst_QByteArrayMatcher : public QObject
 private slots:
     void interface();
     void indexIn();
+    void shortPatterns();
 };
 
 static QByteArrayMatcher matcher1;
@@ -125,5 +126,34 @@ void tst_QByteArrayMatcher::indexIn()
     QCOMPARE(matcher.indexIn(haystack, 2), 5);
 }
 
+void tst_QByteArrayMatcher::shortPatterns()
+{
+    // Place a pattern at every offset relative to a 16 byte block, with
+    // partial matches (same first and last byte) in front of it
+    for (int length = 1; length <= 20; ++length) {
+        QByteArray pattern(length, 'x');
+        pattern[0] = 'a';
+        pattern[length - 1] = 'z';
+        QByteArray decoy = pattern;
+        decoy[length / 2] = 'y';
+        QByteArrayMatcher matcher(pattern);
+
+        for (int offset = 0; offset < 40; ++offset) {
+            QByteArray haystack(offset, '.');
+            if (length > 2)
+                haystack += decoy;
+            haystack += pattern;
+            haystack += QByteArray(offset % 7, '.');
+            const int expected = offset + (length > 2 ? length : 0);
+
+            QCOMPARE(matcher.indexIn(haystack), expected);
+            QCOMPARE(matcher.indexIn(haystack, expected), expected);
+            QCOMPARE(matcher.indexIn(haystack, expected + 1), -1);
+            QCOMPARE(matcher.indexIn(haystack.constData(), haystack.size() - 1),
+                     expected + length < haystack.size() ? expected : -1);
+        }
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_QByteArrayMatcher)
 #include "tst_qbytearraymatcher.moc"
@@ -0,0 +1,4 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qconcurrentcache
+QT = core testlib
+SOURCES = tst_qconcurrentcache.cpp
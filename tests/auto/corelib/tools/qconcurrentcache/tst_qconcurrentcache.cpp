@@ -0,0 +1,521 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qconcurrentcache.h>
+#include <qthread.h>
+
+class tst_QConcurrentCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void empty();
+    void insertAndLookup();
+    void maxCost();
+    void secondChance();
+    void tooExpensive();
+    void smallMaxCost();
+    void zeroAndNegativeMaxCost();
+    void removeAndTake();
+    void statistics();
+    void valueOrCompute();
+    void coalescedMisses();
+#ifndef QT_NO_EXCEPTIONS
+    void computeThrows();
+#endif
+    void threads();
+    void setMaxCostFromThreads();
+};
+
+void tst_QConcurrentCache::empty()
+{
+    QConcurrentCache<int, QString> cache;
+    QCOMPARE(cache.maxCost(), 100);
+    QCOMPARE(cache.shardCount(), 16);
+    QCOMPARE(cache.size(), 0);
+    QVERIFY(cache.isEmpty());
+    QCOMPARE(cache.totalCost(), 0);
+    QVERIFY(!cache.contains(1));
+    QCOMPARE(cache.value(1), QString());
+    QCOMPARE(cache.value(1, "default"), QString("default"));
+    QVERIFY(!cache.remove(1));
+
+    QConcurrentCache<int, QString> odd(10, 5);
+    QCOMPARE(odd.shardCount(), 8);
+    QConcurrentCache<int, QString> single(10, 0);
+    QCOMPARE(single.shardCount(), 1);
+}
+
+void tst_QConcurrentCache::insertAndLookup()
+{
+    QConcurrentCache<QString, int> cache(1000);
+    for (int i = 0; i < 100; ++i)
+        QVERIFY(cache.insert(QString::number(i), i));
+    QCOMPARE(cache.size(), 100);
+    QCOMPARE(cache.totalCost(), 100);
+
+    for (int i = 0; i < 100; ++i) {
+        int value = -1;
+        QVERIFY(cache.lookup(QString::number(i), &value));
+        QCOMPARE(value, i);
+        QCOMPARE(cache.value(QString::number(i)), i);
+    }
+    QVERIFY(!cache.lookup("100", 0));
+
+    // replacing updates the cost
+    QVERIFY(cache.insert("1", 42, 5));
+    QCOMPARE(cache.value("1"), 42);
+    QCOMPARE(cache.size(), 100);
+    QCOMPARE(cache.totalCost(), 104);
+
+    QList<QString> keys = cache.keys();
+    qSort(keys);
+    QCOMPARE(keys.size(), 100);
+    QCOMPARE(keys.first(), QString("0"));
+
+    cache.clear();
+    QVERIFY(cache.isEmpty());
+    QCOMPARE(cache.totalCost(), 0);
+    QVERIFY(!cache.contains("1"));
+}
+
+void tst_QConcurrentCache::maxCost()
+{
+    QConcurrentCache<int, int> cache(64, 4);
+    for (int i = 0; i < 1000; ++i) {
+        cache.insert(i, i, 1 + i % 3);
+        QVERIFY(cache.totalCost() <= 64);
+    }
+    QVERIFY(cache.size() > 0);
+    QVERIFY(cache.statistics().evictions > 0);
+
+    cache.setMaxCost(10);
+    QCOMPARE(cache.maxCost(), 10);
+    QVERIFY(cache.totalCost() <= 10);
+
+    cache.setMaxCost(0);
+    QVERIFY(cache.isEmpty());
+    QVERIFY(!cache.insert(1, 1));
+}
+
+void tst_QConcurrentCache::secondChance()
+{
+    QConcurrentCache<int, int> cache(4, 1);
+    for (int i = 0; i < 4; ++i)
+        cache.insert(i, i);
+
+    // The first insertion beyond the limit clears all referenced flags and
+    // evicts the oldest entry.
+    cache.insert(4, 4);
+    QVERIFY(!cache.contains(0));
+    QCOMPARE(cache.size(), 4);
+
+    // An entry used since then survives the next eviction.
+    QCOMPARE(cache.value(1), 1);
+    cache.insert(5, 5);
+    QVERIFY(cache.contains(1));
+    QVERIFY(!cache.contains(2));
+    QCOMPARE(cache.size(), 4);
+}
+
+void tst_QConcurrentCache::tooExpensive()
+{
+    QConcurrentCache<int, QString> cache(100, 4);
+    QVERIFY(cache.insert(1, "one", 25));
+    QVERIFY(!cache.insert(2, "two", 26));
+    QVERIFY(!cache.contains(2));
+
+    // a failed insertion removes the old value
+    QVERIFY(!cache.insert(1, "uno", 1000));
+    QVERIFY(!cache.contains(1));
+    QCOMPARE(cache.totalCost(), 0);
+}
+
+void tst_QConcurrentCache::smallMaxCost()
+{
+    // every key can be cached, even with fewer cost units than shards
+    QConcurrentCache<int, int> cache(5);
+    QCOMPARE(cache.shardCount(), 4);
+    for (int i = 0; i < 100; ++i) {
+        QVERIFY(cache.insert(i, i));
+        QVERIFY(cache.contains(i));
+        QVERIFY(cache.totalCost() <= 5);
+    }
+
+    // growing uses more shards and keeps the values
+    const QList<int> keys = cache.keys();
+    cache.setMaxCost(1000);
+    QCOMPARE(cache.shardCount(), 16);
+    QCOMPARE(cache.size(), keys.size());
+    for (int i = 0; i < keys.size(); ++i)
+        QCOMPARE(cache.value(keys.at(i), -1), keys.at(i));
+    for (int i = 0; i < 100; ++i)
+        QVERIFY(cache.insert(i, i));
+    QCOMPARE(cache.size(), 100);
+
+    // shrinking uses fewer shards and keeps what fits
+    cache.setMaxCost(2);
+    QCOMPARE(cache.shardCount(), 2);
+    QVERIFY(cache.size() > 0);
+    QVERIFY(cache.totalCost() <= 2);
+    for (int i = 0; i < 100; ++i) {
+        if (cache.contains(i))
+            QCOMPARE(cache.value(i), i);
+    }
+    QVERIFY(cache.insert(1000, 1000));
+    QCOMPARE(cache.value(1000), 1000);
+
+    cache.setMaxCost(1);
+    QCOMPARE(cache.shardCount(), 1);
+    QVERIFY(cache.insert(1, 1));
+    QCOMPARE(cache.size(), 1);
+}
+
+void tst_QConcurrentCache::zeroAndNegativeMaxCost()
+{
+    // like QCache, nothing that costs anything can be cached
+    {
+        QConcurrentCache<int, int> cache(0);
+        QCOMPARE(cache.maxCost(), 0);
+        QVERIFY(!cache.insert(1, 1));
+        QVERIFY(cache.isEmpty());
+        QCOMPARE(cache.totalCost(), 0);
+    }
+
+    {
+        QConcurrentCache<int, int> cache(-1);
+        QCOMPARE(cache.maxCost(), -1);
+        QVERIFY(!cache.insert(1, 1));
+        QVERIFY(!cache.insert(2, 2, 0));
+        QVERIFY(cache.isEmpty());
+    }
+
+    // lowering the limit evicts everything
+    QConcurrentCache<int, int> cache(100);
+    for (int i = 0; i < 10; ++i)
+        QVERIFY(cache.insert(i, i));
+    cache.setMaxCost(0);
+    QVERIFY(cache.isEmpty());
+    QCOMPARE(cache.totalCost(), 0);
+
+    for (int i = 0; i < 10; ++i)
+        QVERIFY(cache.insert(i, i, 0));
+    QCOMPARE(cache.size(), 10);
+    cache.setMaxCost(-1);
+    QVERIFY(cache.isEmpty());
+    QCOMPARE(cache.totalCost(), 0);
+
+    // and the cache recovers when it is raised again
+    cache.setMaxCost(100);
+    QVERIFY(cache.insert(1, 1));
+    QCOMPARE(cache.value(1), 1);
+}
+
+void tst_QConcurrentCache::removeAndTake()
+{
+    QConcurrentCache<int, QString> cache;
+    cache.insert(1, "one", 2);
+    cache.insert(2, "two", 3);
+
+    QVERIFY(cache.remove(1));
+    QVERIFY(!cache.remove(1));
+    QCOMPARE(cache.totalCost(), 3);
+
+    QCOMPARE(cache.take(2), QString("two"));
+    QCOMPARE(cache.take(2), QString());
+    QVERIFY(cache.isEmpty());
+    QCOMPARE(cache.totalCost(), 0);
+
+    // freed entries are reused
+    for (int i = 0; i < 10; ++i) {
+        cache.insert(i, QString::number(i));
+        cache.remove(i);
+    }
+    QVERIFY(cache.isEmpty());
+}
+
+void tst_QConcurrentCache::statistics()
+{
+    QConcurrentCache<int, int> cache(2, 1);
+    cache.insert(1, 1);
+    cache.insert(2, 2);
+    cache.value(1);
+    cache.value(3);
+    cache.contains(2);
+    cache.insert(3, 3);
+
+    QConcurrentCacheStatistics stats = cache.statistics();
+    QCOMPARE(stats.hits, Q_INT64_C(1));
+    QCOMPARE(stats.misses, Q_INT64_C(1));
+    QCOMPARE(stats.insertions, Q_INT64_C(3));
+    QCOMPARE(stats.evictions, Q_INT64_C(1));
+    QCOMPARE(stats.coalescedMisses, Q_INT64_C(0));
+
+    cache.resetStatistics();
+    stats = cache.statistics();
+    QCOMPARE(stats.hits, Q_INT64_C(0));
+    QCOMPARE(stats.insertions, Q_INT64_C(0));
+}
+
+static int computeCount = 0;
+
+static QString compute(const int &key)
+{
+    ++computeCount;
+    return QString::number(key);
+}
+
+void tst_QConcurrentCache::valueOrCompute()
+{
+    QConcurrentCache<int, QString> cache;
+    computeCount = 0;
+
+    QCOMPARE(cache.valueOrCompute(7, compute), QString("7"));
+    QCOMPARE(computeCount, 1);
+    QCOMPARE(cache.valueOrCompute(7, compute), QString("7"));
+    QCOMPARE(computeCount, 1);
+    QVERIFY(cache.contains(7));
+
+    // too expensive values are returned, but not cached
+    QCOMPARE(cache.valueOrCompute(8, compute, 1000), QString("8"));
+    QCOMPARE(computeCount, 2);
+    QVERIFY(!cache.contains(8));
+
+    QConcurrentCacheStatistics stats = cache.statistics();
+    QCOMPARE(stats.hits, Q_INT64_C(1));
+    QCOMPARE(stats.misses, Q_INT64_C(2));
+}
+
+struct SlowCompute
+{
+    SlowCompute(QAtomicInt *calls) : calls(calls) {}
+    QAtomicInt *calls;
+
+    int operator()(const int &key) const
+    {
+        calls->ref();
+        QThread::msleep(100);
+        return key * 2;
+    }
+};
+
+class ComputeThread : public QThread
+{
+public:
+    ComputeThread(QConcurrentCache<int, int> *cache, QAtomicInt *calls)
+        : cache(cache), calls(calls), result(0)
+    {}
+
+    QConcurrentCache<int, int> *cache;
+    QAtomicInt *calls;
+    int result;
+
+protected:
+    void run()
+    {
+        result = cache->valueOrCompute(21, SlowCompute(calls));
+    }
+};
+
+void tst_QConcurrentCache::coalescedMisses()
+{
+    QConcurrentCache<int, int> cache;
+    QAtomicInt calls;
+
+    QList<ComputeThread *> threads;
+    for (int i = 0; i < 8; ++i)
+        threads.append(new ComputeThread(&cache, &calls));
+    for (int i = 0; i < threads.size(); ++i)
+        threads.at(i)->start();
+    for (int i = 0; i < threads.size(); ++i) {
+        QVERIFY(threads.at(i)->wait());
+        QCOMPARE(threads.at(i)->result, 42);
+    }
+    qDeleteAll(threads);
+
+    // Threads starting after the value was computed hit the cache, the
+    // others wait for the one computing it.
+    QCOMPARE(calls.load(), 1);
+    QConcurrentCacheStatistics stats = cache.statistics();
+    QCOMPARE(stats.hits + stats.misses, Q_INT64_C(8));
+    QCOMPARE(stats.coalescedMisses, stats.misses - 1);
+    QCOMPARE(stats.insertions, Q_INT64_C(1));
+}
+
+#ifndef QT_NO_EXCEPTIONS
+static int failingCompute(const int &)
+{
+    throw 1;
+}
+
+void tst_QConcurrentCache::computeThrows()
+{
+    QConcurrentCache<int, int> cache;
+    bool caught = false;
+    try {
+        cache.valueOrCompute(1, failingCompute);
+    } catch (int) {
+        caught = true;
+    }
+    QVERIFY(caught);
+    QVERIFY(!cache.contains(1));
+
+    // the failed computation doesn't block later ones
+    QAtomicInt calls;
+    QCOMPARE(cache.valueOrCompute(1, SlowCompute(&calls)), 2);
+    QCOMPARE(calls.load(), 1);
+}
+#endif
+
+class StressThread : public QThread
+{
+public:
+    StressThread(QConcurrentCache<int, QString> *cache, int seed)
+        : cache(cache), seed(seed), mismatches(0)
+    {}
+
+    QConcurrentCache<int, QString> *cache;
+    int seed;
+    int mismatches;
+
+protected:
+    void run()
+    {
+        qsrand(seed);
+        for (int i = 0; i < 20000; ++i) {
+            const int key = qrand() % 500;
+            switch (qrand() % 4) {
+            case 0:
+                cache->insert(key, QString::number(key), 1 + key % 4);
+                break;
+            case 1:
+                cache->remove(key);
+                break;
+            default: {
+                QString value;
+                if (cache->lookup(key, &value) && value != QString::number(key))
+                    ++mismatches;
+                break;
+            }
+            }
+        }
+    }
+};
+
+void tst_QConcurrentCache::threads()
+{
+    QConcurrentCache<int, QString> cache(200, 8);
+
+    QList<StressThread *> threads;
+    for (int i = 0; i < 4; ++i)
+        threads.append(new StressThread(&cache, i + 1));
+    for (int i = 0; i < threads.size(); ++i)
+        threads.at(i)->start();
+    for (int i = 0; i < threads.size(); ++i) {
+        QVERIFY(threads.at(i)->wait());
+        QCOMPARE(threads.at(i)->mismatches, 0);
+    }
+    qDeleteAll(threads);
+
+    QVERIFY(cache.totalCost() <= 200);
+    int total = 0;
+    const QList<int> keys = cache.keys();
+    for (int i = 0; i < keys.size(); ++i)
+        total += 1 + keys.at(i) % 4;
+    QCOMPARE(cache.totalCost(), total);
+}
+
+class MaxCostThread : public QThread
+{
+public:
+    explicit MaxCostThread(QConcurrentCache<int, QString> *cache)
+        : cache(cache)
+    {}
+
+    QConcurrentCache<int, QString> *cache;
+
+protected:
+    void run()
+    {
+        static const int maxCosts[] = { 3, 50, 1, 0, 17, 200 };
+        for (int i = 0; i < 200; ++i) {
+            cache->setMaxCost(maxCosts[i % (sizeof(maxCosts) / sizeof(maxCosts[0]))]);
+            yieldCurrentThread();
+        }
+        cache->setMaxCost(200);
+    }
+};
+
+void tst_QConcurrentCache::setMaxCostFromThreads()
+{
+    // the keys move between shards while other threads use them
+    QConcurrentCache<int, QString> cache(200, 16);
+
+    QList<StressThread *> threads;
+    for (int i = 0; i < 4; ++i)
+        threads.append(new StressThread(&cache, i + 1));
+    MaxCostThread maxCostThread(&cache);
+    for (int i = 0; i < threads.size(); ++i)
+        threads.at(i)->start();
+    maxCostThread.start();
+    QVERIFY(maxCostThread.wait());
+    for (int i = 0; i < threads.size(); ++i) {
+        QVERIFY(threads.at(i)->wait());
+        QCOMPARE(threads.at(i)->mismatches, 0);
+    }
+    qDeleteAll(threads);
+
+    QCOMPARE(cache.maxCost(), 200);
+    QCOMPARE(cache.shardCount(), 16);
+    QVERIFY(cache.totalCost() <= 200);
+    int total = 0;
+    const QList<int> keys = cache.keys();
+    for (int i = 0; i < keys.size(); ++i) {
+        QVERIFY(cache.contains(keys.at(i)));
+        total += 1 + keys.at(i) % 4;
+    }
+    QCOMPARE(cache.totalCost(), total);
+}
+
+QTEST_APPLESS_MAIN(tst_QConcurrentCache)
+#include "tst_qconcurrentcache.moc"
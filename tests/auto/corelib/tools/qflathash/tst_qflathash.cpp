@@ -0,0 +1,469 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qflathash.h>
+#include <QtCore/qhash.h>
+
+class tst_QFlatHash : public QObject
+{
+    Q_OBJECT
+private slots:
+    void empty();
+    void insert();
+    void remove();
+    void take();
+    void operator_brackets();
+    void insertFromSelf();
+    void iterators();
+    void erase();
+    void reserveAndSqueeze();
+    void implicitSharing();
+    void setSharable();
+    void compare();
+    void customKey();
+    void complexTypes();
+    void tombstones();
+    void againstQHash();
+};
+
+struct Key
+{
+    Key(int k = 0) : k(k) { }
+    int k;
+};
+
+static bool operator==(const Key &a, const Key &b) { return a.k == b.k; }
+
+// every key collides
+static uint qHash(const Key &, uint seed = 0) { return seed; }
+
+struct Counted
+{
+    Counted(int v = 0) : v(v) { ++count; }
+    Counted(const Counted &other) : v(other.v) { ++count; }
+    ~Counted() { --count; }
+    bool operator==(const Counted &other) const { return v == other.v; }
+
+    int v;
+    static int count;
+};
+
+int Counted::count = 0;
+
+void tst_QFlatHash::empty()
+{
+    QFlatHash<int, int> hash;
+    QVERIFY(hash.isEmpty());
+    QCOMPARE(hash.size(), 0);
+    QCOMPARE(hash.capacity(), 0);
+    QVERIFY(!hash.contains(1));
+    QCOMPARE(hash.value(1), 0);
+    QCOMPARE(hash.value(1, 42), 42);
+    QCOMPARE(hash.remove(1), 0);
+    QCOMPARE(hash.take(1), 0);
+    QVERIFY(hash.constBegin() == hash.constEnd());
+    QVERIFY(hash.constFind(1) == hash.constEnd());
+    QVERIFY(hash.keys().isEmpty());
+
+    const QFlatHash<int, int> &constHash = hash;
+    QCOMPARE(constHash[1], 0);
+    QVERIFY(hash.isEmpty());
+
+    hash.clear();
+    QVERIFY(hash.isEmpty());
+}
+
+void tst_QFlatHash::insert()
+{
+    QFlatHash<int, QString> hash;
+    for (int i = 0; i < 1000; ++i) {
+        QFlatHash<int, QString>::iterator it = hash.insert(i, QString::number(i));
+        QCOMPARE(it.key(), i);
+        QCOMPARE(it.value(), QString::number(i));
+    }
+    QCOMPARE(hash.size(), 1000);
+    QVERIFY(hash.capacity() >= 1000);
+
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(hash.contains(i));
+        QCOMPARE(hash.value(i), QString::number(i));
+        QCOMPARE(hash.count(i), 1);
+    }
+    QVERIFY(!hash.contains(1000));
+    QVERIFY(!hash.contains(-1));
+
+    // replaces the value
+    hash.insert(10, QLatin1String("ten"));
+    QCOMPARE(hash.size(), 1000);
+    QCOMPARE(hash.value(10), QString("ten"));
+    QCOMPARE(hash.key(QLatin1String("ten")), 10);
+    QCOMPARE(hash.key(QLatin1String("eleven"), -1), -1);
+}
+
+void tst_QFlatHash::remove()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i * 2);
+
+    for (int i = 0; i < 100; i += 2)
+        QCOMPARE(hash.remove(i), 1);
+    QCOMPARE(hash.remove(0), 0);
+    QCOMPARE(hash.size(), 50);
+
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.contains(i), bool(i & 1));
+
+    // reinsert into the freed buckets
+    for (int i = 0; i < 100; i += 2)
+        hash.insert(i, -i);
+    QCOMPARE(hash.size(), 100);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(hash.value(i), (i & 1) ? i * 2 : -i);
+}
+
+void tst_QFlatHash::take()
+{
+    QFlatHash<QString, int> hash;
+    hash.insert(QLatin1String("one"), 1);
+    hash.insert(QLatin1String("two"), 2);
+
+    QCOMPARE(hash.take(QLatin1String("one")), 1);
+    QCOMPARE(hash.take(QLatin1String("one")), 0);
+    QCOMPARE(hash.size(), 1);
+    QCOMPARE(hash.value(QLatin1String("two")), 2);
+}
+
+void tst_QFlatHash::operator_brackets()
+{
+    QFlatHash<QString, int> hash;
+    hash[QLatin1String("a")] = 1;
+    ++hash[QLatin1String("a")];
+    ++hash[QLatin1String("b")];
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(hash.value(QLatin1String("a")), 2);
+    QCOMPARE(hash.value(QLatin1String("b")), 1);
+
+    const QFlatHash<QString, int> &constHash = hash;
+    QCOMPARE(constHash[QLatin1String("c")], 0);
+    QCOMPARE(hash.size(), 2);
+}
+
+void tst_QFlatHash::insertFromSelf()
+{
+    // keys and values that refer into the hash must survive the table
+    // growing underneath them; the large tables are freed with munmap()
+    QFlatHash<QString, QString> hash;
+    hash.insert(QLatin1String("0"), QLatin1String("v0"));
+    for (int i = 1; i < 50000; ++i) {
+        const QString previous = QString::number(i - 1);
+        const QString key = QString::number(i);
+        const int capacity = hash.capacity();
+        hash.insert(key, hash[previous]);
+        if (hash.capacity() != capacity)
+            QCOMPARE(hash.value(key), QString(QLatin1String("v0")));
+    }
+    QCOMPARE(hash.size(), 50000);
+    QCOMPARE(hash.value(QLatin1String("49999")), QString(QLatin1String("v0")));
+
+    // a key taken from a value of the same hash
+    QFlatHash<QString, QString> chain;
+    chain.insert(QLatin1String("k0"), QLatin1String("k1"));
+    for (int i = 1; i < 50000; ++i) {
+        const QString last = QLatin1Char('k') + QString::number(i - 1);
+        const QString &next = chain[last];
+        chain[next] = QLatin1Char('k') + QString::number(i + 1);
+    }
+    QCOMPARE(chain.size(), 50000);
+    QCOMPARE(chain.value(QLatin1String("k49999")), QString(QLatin1String("k50000")));
+}
+
+void tst_QFlatHash::iterators()
+{
+    QFlatHash<int, int> hash;
+    for (int i = 0; i < 500; ++i)
+        hash.insert(i, i + 1);
+
+    QSet<int> seen;
+    for (QFlatHash<int, int>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        QCOMPARE(it.value(), it.key() + 1);
+        QVERIFY(!seen.contains(it.key()));
+        seen.insert(it.key());
+    }
+    QCOMPARE(seen.size(), 500);
+
+    for (QFlatHash<int, int>::iterator it = hash.begin(); it != hash.end(); ++it)
+        *it = -it.key();
+    for (int i = 0; i < 500; ++i)
+        QCOMPARE(hash.value(i), -i);
+
+    // backwards
+    int count = 0;
+    QFlatHash<int, int>::const_iterator it = hash.constEnd();
+    while (it != hash.constBegin()) {
+        --it;
+        QCOMPARE(*it, -it.key());
+        ++count;
+    }
+    QCOMPARE(count, 500);
+
+    // keys() and values() are in the same order
+    QList<int> keys = hash.keys();
+    QList<int> values = hash.values();
+    QCOMPARE(keys.size(), 500);
+    for (int i = 0; i < keys.size(); ++i)
+        QCOMPARE(values.at(i), -keys.at(i));
+}
+
+void tst_QFlatHash::erase()
+{
+    QFlatHash<int, QString> hash;
+    for (int i = 0; i < 300; ++i)
+        hash.insert(i, QString::number(i));
+
+    QFlatHash<int, QString>::iterator it = hash.begin();
+    while (it != hash.end()) {
+        if (it.key() % 3 == 0)
+            it = hash.erase(it);
+        else
+            ++it;
+    }
+    QCOMPARE(hash.size(), 200);
+    for (int i = 0; i < 300; ++i)
+        QCOMPARE(hash.contains(i), i % 3 != 0);
+
+    it = hash.find(1);
+    QVERIFY(it != hash.end());
+    hash.erase(it);
+    QVERIFY(!hash.contains(1));
+    QVERIFY(hash.find(1) == hash.end());
+}
+
+void tst_QFlatHash::reserveAndSqueeze()
+{
+    QFlatHash<int, int> hash;
+    hash.reserve(1000);
+    const int capacity = hash.capacity();
+    QVERIFY(capacity >= 1000);
+    for (int i = 0; i < 1000; ++i)
+        hash.insert(i, i);
+    QCOMPARE(hash.capacity(), capacity);
+
+    for (int i = 10; i < 1000; ++i)
+        hash.remove(i);
+    hash.squeeze();
+    QVERIFY(hash.capacity() < capacity);
+    QVERIFY(hash.capacity() >= 10);
+    QCOMPARE(hash.size(), 10);
+    for (int i = 0; i < 10; ++i)
+        QCOMPARE(hash.value(i), i);
+
+    hash.clear();
+    hash.squeeze();
+    QCOMPARE(hash.capacity(), 0);
+}
+
+void tst_QFlatHash::implicitSharing()
+{
+    QFlatHash<int, QString> hash;
+    hash.insert(1, QLatin1String("one"));
+    hash.insert(2, QLatin1String("two"));
+
+    QFlatHash<int, QString> copy = hash;
+    QVERIFY(copy.isSharedWith(hash));
+    QVERIFY(!hash.isDetached());
+
+    copy.insert(3, QLatin1String("three"));
+    QVERIFY(!copy.isSharedWith(hash));
+    QCOMPARE(hash.size(), 2);
+    QCOMPARE(copy.size(), 3);
+    QVERIFY(!hash.contains(3));
+
+    copy = hash;
+    copy.remove(1);
+    QCOMPARE(hash.value(1), QString("one"));
+    QVERIFY(!copy.contains(1));
+
+    copy = hash;
+    copy.begin().value() = QLatin1String("changed");
+    QVERIFY(!hash.values().contains(QLatin1String("changed")));
+    QVERIFY(copy.values().contains(QLatin1String("changed")));
+
+    // removing from a shared hash with a missing key doesn't detach
+    copy = hash;
+    QCOMPARE(copy.remove(4), 0);
+    QVERIFY(copy.isSharedWith(hash));
+
+    copy.swap(hash);
+    QCOMPARE(copy.size(), 2);
+}
+
+void tst_QFlatHash::setSharable()
+{
+    QFlatHash<int, int> hash;
+    hash.setSharable(false);
+    hash.insert(1, 1);
+
+    QFlatHash<int, int> copy = hash;
+    QVERIFY(!copy.isSharedWith(hash));
+    QCOMPARE(copy.value(1), 1);
+
+    copy = hash;
+    QVERIFY(!copy.isSharedWith(hash));
+
+    // stays unsharable when growing
+    for (int i = 0; i < 100; ++i)
+        hash.insert(i, i);
+    copy = hash;
+    QVERIFY(!copy.isSharedWith(hash));
+    QCOMPARE(copy.size(), 100);
+
+    hash.setSharable(true);
+    copy = hash;
+    QVERIFY(copy.isSharedWith(hash));
+}
+
+void tst_QFlatHash::compare()
+{
+    QFlatHash<int, int> a, b;
+    QVERIFY(a == b);
+    for (int i = 0; i < 50; ++i)
+        a.insert(i, i);
+    for (int i = 49; i >= 0; --i)
+        b.insert(i, i);
+    QVERIFY(a == b);
+    b.insert(0, 1);
+    QVERIFY(a != b);
+    b.remove(0);
+    QVERIFY(a != b);
+}
+
+void tst_QFlatHash::customKey()
+{
+    QFlatHash<Key, int> hash;
+    for (int i = 0; i < 50; ++i)
+        hash.insert(Key(i), i);
+    QCOMPARE(hash.size(), 50);
+    for (int i = 0; i < 50; ++i)
+        QCOMPARE(hash.value(Key(i), -1), i);
+    QVERIFY(!hash.contains(Key(50)));
+
+    for (int i = 0; i < 50; i += 2)
+        hash.remove(Key(i));
+    for (int i = 0; i < 50; ++i)
+        QCOMPARE(hash.contains(Key(i)), bool(i & 1));
+}
+
+void tst_QFlatHash::complexTypes()
+{
+    {
+        QFlatHash<int, Counted> hash;
+        for (int i = 0; i < 100; ++i)
+            hash.insert(i, Counted(i));
+        QCOMPARE(Counted::count, 100);
+
+        QFlatHash<int, Counted> copy = hash;
+        copy.remove(0);
+        QCOMPARE(Counted::count, 199);
+
+        hash.take(1);
+        QCOMPARE(Counted::count, 198);
+
+        copy.clear();
+        QCOMPARE(Counted::count, 99);
+    }
+    QCOMPARE(Counted::count, 0);
+}
+
+void tst_QFlatHash::tombstones()
+{
+    // insert and remove many times without growing the hash
+    QFlatHash<int, int> hash;
+    hash.reserve(16);
+    const int capacity = hash.capacity();
+    for (int i = 0; i < 10000; ++i) {
+        hash.insert(i, i);
+        if (i >= 8)
+            QCOMPARE(hash.remove(i - 8), 1);
+    }
+    QCOMPARE(hash.size(), 8);
+    QCOMPARE(hash.capacity(), capacity);
+    for (int i = 10000 - 8; i < 10000; ++i)
+        QCOMPARE(hash.value(i), i);
+}
+
+void tst_QFlatHash::againstQHash()
+{
+    QFlatHash<uint, uint> flat;
+    QHash<uint, uint> hash;
+
+    uint x = 1;
+    for (int i = 0; i < 20000; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        const uint key = x % 4096;
+        switch (x >> 30) {
+        case 0:
+            QCOMPARE(flat.remove(key), hash.remove(key));
+            break;
+        case 1:
+            QCOMPARE(flat.take(key), hash.take(key));
+            break;
+        default:
+            flat.insert(key, i);
+            hash.insert(key, i);
+            break;
+        }
+        QCOMPARE(flat.size(), hash.size());
+    }
+
+    for (QHash<uint, uint>::const_iterator it = hash.constBegin(); it != hash.constEnd(); ++it)
+        QCOMPARE(flat.value(it.key(), -1), it.value());
+    int count = 0;
+    for (QFlatHash<uint, uint>::const_iterator it = flat.constBegin(); it != flat.constEnd(); ++it, ++count)
+        QCOMPARE(hash.value(it.key(), -1), it.value());
+    QCOMPARE(count, hash.size());
+}
+
+QTEST_APPLESS_MAIN(tst_QFlatHash)
+#include "tst_qflathash.moc"
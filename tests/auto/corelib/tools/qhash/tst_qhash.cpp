@@ -64,6 +64,7 @@ private slots:
     void rehash_isnt_quadratic();
     void dont_need_default_constructor();
     void qhash();
+    void stringHash();
     void qmultihash_specific();
 
     void compare();
@@ -1038,6 +1039,51 @@ void tst_QHash::qhash()
     }
 }
 
+void tst_QHash::stringHash()
+{
+    // the strings are hashed a word at a time; cover all the tail lengths
+    // and alignments
+    const QString text = QLatin1String("The quick brown fox jumps over the lazy dog, again and again.");
+    const QByteArray bytes = text.toLatin1();
+    QSet<QString> strings;
+    QSet<uint> stringHashes;
+    QSet<uint> byteArrayHashes;
+    for (int len = 1; len < 24; ++len) {
+        for (int pos = 0; pos + len <= text.size(); pos += 7) {
+            const QString str = text.mid(pos, len);
+            const QStringRef ref = text.midRef(pos, len);
+            QCOMPARE(qHash(ref), qHash(str));
+            QCOMPARE(qHash(ref, 42), qHash(str, 42));
+            QVERIFY(qHash(str, 1) != qHash(str, 2));
+            strings.insert(str);
+            stringHashes.insert(qHash(str));
+
+            const QByteArray ba = bytes.mid(pos, len);
+            QCOMPARE(qHash(QByteArray(bytes.constData() + pos, len)), qHash(ba));
+            byteArrayHashes.insert(qHash(ba));
+
+            // Latin-1 strings can be looked up among QStrings, for any seed
+            const QLatin1String latin1(bytes.constData() + pos, len);
+            QCOMPARE(qHash(latin1), qHash(str));
+            QCOMPARE(qHash(latin1, 42), qHash(str, 42));
+        }
+    }
+    // no collisions among these few hundred strings
+    QCOMPARE(stringHashes.size(), strings.size());
+    QCOMPARE(byteArrayHashes.size(), strings.size());
+
+    // a zero seed gives the same values everywhere, they may be stored
+    QCOMPARE(qHash(QString("Qt")), 2627U);
+    QCOMPARE(qHash(QLatin1String("WLAN:")), 82675384U);
+    QCOMPARE(qHash(QByteArray("Qt")), 2627U);
+    QCOMPARE(qHash(QString(QChar(0x20ac))), 0x20acU);
+
+    QCOMPARE(qHash(QString()), 0U);
+    QCOMPARE(qHash(QString(), 42), 42U);
+    QCOMPARE(qHash(QByteArray(), 42), 42U);
+    QVERIFY(qHash(QByteArray(1, '\0'), 42) != qHash(QByteArray(2, '\0'), 42));
+}
+
 void tst_QHash::qmultihash_specific()
 {
     QMultiHash<int, int> hash1;
@@ -103,6 +103,10 @@ private slots:
     void matchingLocales();
     void double_conversion_data();
     void double_conversion();
+    void double_exactConversion_data();
+    void double_exactConversion();
+    void shortestDoubleFormat_data();
+    void shortestDoubleFormat();
     void long_long_conversion_data();
     void long_long_conversion();
     void long_long_conversion_extra();
@@ -728,6 +732,77 @@ void tst_QLocale::double_conversion()
     }
 }
 
+void tst_QLocale::double_exactConversion_data()
+{
+    QTest::addColumn<QString>("num_str");
+    QTest::addColumn<quint64>("bits");
+
+    QTest::newRow("0.1")            << QString("0.1")                     << Q_UINT64_C(0x3fb999999999999a);
+    QTest::newRow("-0")             << QString("-0")                      << Q_UINT64_C(0x8000000000000000);
+    QTest::newRow("0e999")          << QString("0e999")                   << Q_UINT64_C(0x0000000000000000);
+    QTest::newRow("2^53 + 1")       << QString("9007199254740993")        << Q_UINT64_C(0x4340000000000000);
+    QTest::newRow("2^53 + 3")       << QString("9007199254740995")        << Q_UINT64_C(0x4340000000000002);
+    QTest::newRow("max")            << QString("1.7976931348623157e308")  << Q_UINT64_C(0x7fefffffffffffff);
+    QTest::newRow("min normal")     << QString("2.2250738585072014e-308") << Q_UINT64_C(0x0010000000000000);
+    QTest::newRow("max denormal")   << QString("2.2250738585072011e-308") << Q_UINT64_C(0x000fffffffffffff);
+    QTest::newRow("min denormal")   << QString("4.9406564584124654e-324") << Q_UINT64_C(0x0000000000000001);
+    QTest::newRow("19 digits")      << QString("1234567890123456789")     << Q_UINT64_C(0x43b12210f47de981);
+    QTest::newRow("20 digits")      << QString("12345678901234567890")    << Q_UINT64_C(0x43e56a95319d63e1);
+    QTest::newRow("halfway 1e23")   << QString("1e23")                    << Q_UINT64_C(0x44b52d02c7e14af6);
+    QTest::newRow("long mantissa")  << QString("0.30000000000000004440892098500626161694526672363281")
+                                    << Q_UINT64_C(0x3fd3333333333334);
+}
+
+void tst_QLocale::double_exactConversion()
+{
+    QFETCH(QString, num_str);
+    QFETCH(quint64, bits);
+
+    bool ok;
+    double d = QLocale::c().toDouble(num_str, &ok);
+    QVERIFY(ok);
+    quint64 dbits;
+    memcpy(&dbits, &d, sizeof(dbits));
+    QCOMPARE(dbits, bits);
+}
+
+void tst_QLocale::shortestDoubleFormat_data()
+{
+    QTest::addColumn<double>("num");
+    QTest::addColumn<char>("format");
+    QTest::addColumn<QString>("expected");
+
+    QTest::newRow("0.1 g")         << 0.1                     << 'g' << QString("0.1");
+    QTest::newRow("0.1 f")         << 0.1                     << 'f' << QString("0.1");
+    QTest::newRow("0.1 e")         << 0.1                     << 'e' << QString("1e-01");
+    QTest::newRow("0.1+0.2 g")     << 0.1 + 0.2               << 'g' << QString("0.30000000000000004");
+    QTest::newRow("-1.5 g")        << -1.5                    << 'g' << QString("-1.5");
+    QTest::newRow("0 g")           << 0.0                     << 'g' << QString("0");
+    QTest::newRow("100 g")         << 100.0                   << 'g' << QString("100");
+    QTest::newRow("1e16 g")        << 1e16                    << 'g' << QString("10000000000000000");
+    QTest::newRow("1e20 g")        << 1e20                    << 'g' << QString("1e+20");
+    QTest::newRow("1e20 f")        << 1e20                    << 'f' << QString("100000000000000000000");
+    QTest::newRow("1e-5 g")        << 1e-5                    << 'g' << QString("1e-05");
+    QTest::newRow("123.456 e")     << 123.456                 << 'e' << QString("1.23456e+02");
+    QTest::newRow("max g")         << 1.7976931348623157e308  << 'g' << QString("1.7976931348623157e+308");
+    QTest::newRow("min denormal")  << 4.9406564584124654e-324 << 'g' << QString("5e-324");
+    QTest::newRow("2^-1022 g")     << 2.2250738585072014e-308 << 'g' << QString("2.2250738585072014e-308");
+}
+
+void tst_QLocale::shortestDoubleFormat()
+{
+    QFETCH(double, num);
+    QFETCH(char, format);
+    QFETCH(QString, expected);
+
+    const QString str = QString::number(num, format, QLocale::FloatingPointShortest);
+    QCOMPARE(str, expected);
+
+    bool ok;
+    QCOMPARE(str.toDouble(&ok), num);
+    QVERIFY(ok);
+}
+
 void tst_QLocale::long_long_conversion_data()
 {
     QTest::addColumn<QString>("locale_name");
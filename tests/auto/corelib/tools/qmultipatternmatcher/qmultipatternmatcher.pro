@@ -0,0 +1,4 @@
+CONFIG += testcase parallel_test
+TARGET = tst_qmultipatternmatcher
+QT = core testlib
+SOURCES = tst_qmultipatternmatcher.cpp
@@ -0,0 +1,296 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qbuffer.h>
+#include <qmultipatternmatcher.h>
+
+class tst_QMultiPatternMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void empty();
+    void indexIn_data();
+    void indexIn();
+    void caseInsensitive();
+    void utf8();
+    void duplicatesAndEmptyPatterns();
+    void assignment();
+    void device();
+    void deviceBlockBoundary();
+    void compareWithStringMatcher_data();
+    void compareWithStringMatcher();
+};
+
+void tst_QMultiPatternMatcher::empty()
+{
+    QMultiPatternMatcher matcher;
+    QVERIFY(matcher.patterns().isEmpty());
+    QCOMPARE(matcher.caseSensitivity(), Qt::CaseSensitive);
+    QCOMPARE(matcher.indexIn(QString("abc")), -1);
+    QCOMPARE(matcher.indexIn(QByteArray("abc")), -1);
+    QCOMPARE(matcher.indexIn(QString()), -1);
+}
+
+void tst_QMultiPatternMatcher::indexIn_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<int>("from");
+    QTest::addColumn<int>("index");
+    QTest::addColumn<int>("pattern");
+
+    const QStringList classic = QStringList() << "he" << "she" << "his" << "hers";
+    QTest::newRow("classic") << classic << QString("ushers") << 0 << 1 << 1;
+    QTest::newRow("classic-from") << classic << QString("ushers") << 2 << 2 << 0;
+    QTest::newRow("classic-none") << classic << QString("ushers") << 3 << -1 << -1;
+    QTest::newRow("classic-negative-from") << classic << QString("ushers") << -5 << 1 << 1;
+    QTest::newRow("first-ending") << (QStringList() << "abcd" << "bc") << QString("xabcd") << 0 << 2 << 1;
+    QTest::newRow("suffix") << (QStringList() << "abcd" << "cd") << QString("xabcd") << 0 << 1 << 0;
+    QTest::newRow("failure-link") << (QStringList() << "aab" << "ab") << QString("aaab") << 0 << 1 << 0;
+    QTest::newRow("at-end") << (QStringList() << "end") << QString("the end") << 0 << 4 << 0;
+    QTest::newRow("whole") << (QStringList() << "x") << QString("x") << 0 << 0 << 0;
+    QTest::newRow("non-latin1") << (QStringList() << QString::fromUtf8("\xe2\x82\xac") << "$")
+                                << QString::fromUtf8("price: 5\xe2\x82\xac") << 0 << 8 << 0;
+    QTest::newRow("many-start-symbols") << (QStringList() << "b1" << "c2" << "d3" << "e4" << "f5" << "g6")
+                                        << QString("aaaaaaaaaaaaaaaaaaaaaaaaaag6") << 0 << 26 << 5;
+}
+
+void tst_QMultiPatternMatcher::indexIn()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(QString, haystack);
+    QFETCH(int, from);
+    QFETCH(int, index);
+    QFETCH(int, pattern);
+
+    QMultiPatternMatcher matcher(patterns);
+    QCOMPARE(matcher.patterns(), patterns);
+
+    int matchedPattern = -1;
+    int matchedLength = -1;
+    QCOMPARE(matcher.indexIn(haystack, from, &matchedPattern, &matchedLength), index);
+    if (index >= 0) {
+        QCOMPARE(matchedPattern, pattern);
+        QCOMPARE(matchedLength, patterns.at(pattern).size());
+        QCOMPARE(haystack.mid(index, matchedLength), patterns.at(pattern));
+    }
+    QCOMPARE(matcher.indexIn(haystack.constData(), haystack.size(), from), index);
+
+    // The same through UTF-8
+    const QByteArray utf8 = haystack.toUtf8();
+    const int utf8Index = index < 0 ? -1 : haystack.left(index).toUtf8().size();
+    QCOMPARE(matcher.indexIn(utf8, from < 0 ? 0 : haystack.left(from).toUtf8().size(),
+                             &matchedPattern, &matchedLength), utf8Index);
+    if (index >= 0) {
+        QCOMPARE(matchedPattern, pattern);
+        QCOMPARE(matchedLength, patterns.at(pattern).toUtf8().size());
+    }
+}
+
+void tst_QMultiPatternMatcher::caseInsensitive()
+{
+    QMultiPatternMatcher matcher(QStringList() << "ERROR" << QString::fromUtf8("\xc3\x84rger"));
+    QCOMPARE(matcher.indexIn(QString("an error")), -1);
+
+    matcher.setCaseSensitivity(Qt::CaseInsensitive);
+    QCOMPARE(matcher.caseSensitivity(), Qt::CaseInsensitive);
+    QCOMPARE(matcher.indexIn(QString("an error")), 3);
+    QCOMPARE(matcher.indexIn(QString("an ErRoR")), 3);
+    QCOMPARE(matcher.indexIn(QByteArray("an eRRor")), 3);
+
+    // Strings are folded completely, byte arrays only in the ASCII range
+    int pattern = -1;
+    QCOMPARE(matcher.indexIn(QString::fromUtf8("viel \xc3\xa4RGER"), 0, &pattern), 5);
+    QCOMPARE(pattern, 1);
+    QCOMPARE(matcher.indexIn(QByteArray("viel \xc3\x84RGER")), 5);
+    QCOMPARE(matcher.indexIn(QByteArray("viel \xc3\xa4RGER")), -1);
+
+    matcher.setCaseSensitivity(Qt::CaseSensitive);
+    QCOMPARE(matcher.indexIn(QString("an ErRoR")), -1);
+}
+
+void tst_QMultiPatternMatcher::utf8()
+{
+    const QString text = QString::fromUtf8("Gr\xc3\xbc\xc3\x9f" "e an M\xc3\xbcller");
+    QMultiPatternMatcher matcher(QStringList() << QString::fromUtf8("M\xc3\xbcller"));
+
+    int length;
+    QCOMPARE(matcher.indexIn(text, 0, 0, &length), 9);
+    QCOMPARE(length, 6);
+    QCOMPARE(matcher.indexIn(text.toUtf8(), 0, 0, &length), 11);
+    QCOMPARE(length, 7);
+    QCOMPARE(matcher.indexIn(text.toLatin1()), -1);
+}
+
+void tst_QMultiPatternMatcher::duplicatesAndEmptyPatterns()
+{
+    QMultiPatternMatcher matcher(QStringList() << QString() << "two" << "" << "two");
+    int pattern = -1;
+    QCOMPARE(matcher.indexIn(QString("one two"), 0, &pattern), 4);
+    QCOMPARE(pattern, 1);
+    QCOMPARE(matcher.indexIn(QString("one"), 0, &pattern), -1);
+}
+
+void tst_QMultiPatternMatcher::assignment()
+{
+    QMultiPatternMatcher m1(QStringList() << "foo");
+    QMultiPatternMatcher m2(m1);
+    QMultiPatternMatcher m3;
+    m3 = m1;
+    m1.setPatterns(QStringList() << "bar");
+
+    QCOMPARE(m1.indexIn(QString("foobar")), 3);
+    QCOMPARE(m2.indexIn(QString("foobar")), 0);
+    QCOMPARE(m3.indexIn(QString("foobar")), 0);
+
+    m2.swap(m1);
+    QCOMPARE(m1.patterns(), QStringList() << "foo");
+    QCOMPARE(m2.patterns(), QStringList() << "bar");
+}
+
+void tst_QMultiPatternMatcher::device()
+{
+    QByteArray data("INFO start\nWARN disk\nINFO ok\nERROR boom\nWARN again\n");
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    QMultiPatternMatcher matcher(QStringList() << "WARN" << "ERROR");
+    QList<qint64> positions;
+    QList<int> patterns;
+    qint64 base = 0;
+    forever {
+        int pattern;
+        int length;
+        const qint64 index = matcher.indexIn(&buffer, &pattern, &length);
+        if (index < 0)
+            break;
+        positions << base + index;
+        patterns << pattern;
+        base += index + length;
+        QCOMPARE(buffer.pos(), base);
+    }
+    QCOMPARE(positions, QList<qint64>() << 11 << 29 << 40);
+    QCOMPARE(patterns, QList<int>() << 0 << 1 << 0);
+    QVERIFY(buffer.atEnd());
+
+    QCOMPARE(matcher.indexIn(static_cast<QIODevice *>(0)), qint64(-1));
+}
+
+void tst_QMultiPatternMatcher::deviceBlockBoundary()
+{
+    // A match that spans the blocks in which the device is read
+    QMultiPatternMatcher matcher(QStringList() << "needle");
+    for (int offset = 16380; offset < 16390; ++offset) {
+        QByteArray data(offset, 'x');
+        data += "needle";
+        data += QByteArray(100, 'x');
+        QBuffer buffer(&data);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        QCOMPARE(matcher.indexIn(&buffer), qint64(offset));
+        QCOMPARE(buffer.pos(), qint64(offset + 6));
+        QCOMPARE(matcher.indexIn(&buffer), qint64(-1));
+    }
+}
+
+void tst_QMultiPatternMatcher::compareWithStringMatcher_data()
+{
+    QTest::addColumn<int>("patternCount");
+    QTest::addColumn<bool>("caseInsensitive");
+
+    QTest::newRow("1") << 1 << false;
+    QTest::newRow("3") << 3 << false;
+    QTest::newRow("50") << 50 << false;
+    QTest::newRow("1-ci") << 1 << true;
+    QTest::newRow("50-ci") << 50 << true;
+}
+
+void tst_QMultiPatternMatcher::compareWithStringMatcher()
+{
+    QFETCH(int, patternCount);
+    QFETCH(bool, caseInsensitive);
+    const Qt::CaseSensitivity cs = caseInsensitive ? Qt::CaseInsensitive : Qt::CaseSensitive;
+
+    // Small alphabets make for many partial matches
+    qsrand(42);
+    QStringList patterns;
+    for (int i = 0; i < patternCount; ++i) {
+        QString pattern;
+        const int length = 1 + qrand() % 6;
+        for (int j = 0; j < length; ++j)
+            pattern += QChar("abcAB"[qrand() % 5]);
+        patterns << pattern;
+    }
+    QString haystack;
+    for (int i = 0; i < 2000; ++i)
+        haystack += QChar("abcdABxy"[qrand() % 8]);
+
+    const QMultiPatternMatcher matcher(patterns, cs);
+    for (int from = 0; from < haystack.size(); from += 7) {
+        // The match that ends first, and the longest one among those
+        int expectedEnd = INT_MAX;
+        int expectedLength = 0;
+        for (int i = 0; i < patterns.size(); ++i) {
+            const int index = haystack.indexOf(patterns.at(i), from, cs);
+            if (index < 0)
+                continue;
+            const int end = index + patterns.at(i).size();
+            if (end < expectedEnd || (end == expectedEnd && patterns.at(i).size() > expectedLength)) {
+                expectedEnd = end;
+                expectedLength = patterns.at(i).size();
+            }
+        }
+        const int expected = expectedEnd == INT_MAX ? -1 : expectedEnd - expectedLength;
+
+        int pattern = -1;
+        const int index = matcher.indexIn(haystack, from, &pattern);
+        QCOMPARE(index, expected);
+        if (index >= 0)
+            QVERIFY(haystack.mid(index, patterns.at(pattern).size())
+                    .compare(patterns.at(pattern), cs) == 0);
+        QCOMPARE(matcher.indexIn(haystack.toLatin1(), from), expected);
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_QMultiPatternMatcher)
+#include "tst_qmultipatternmatcher.moc"
@@ -3933,6 +3933,12 @@ void tst_QString::arg()
              QString("alpha% %x%cbeta %dbeta-%") );
     QCOMPARE( s13.arg("alpha", "beta"), QString("alpha% %x%cbeta %dbeta-%") );
     QCOMPARE( s14.arg("a", "b", "c"), QString("abc") );
+    QCOMPARE( QString("%L1 %2 %L1").arg("a", "b"), QString("a b a") );
+    QCOMPARE( QString("%10 %2 %1 %1").arg("a", "b", "c"), QString("c b a a") );
+    QCOMPARE( QString("%1%2%1").arg(QString(), "x"), QString("x") );
+    QCOMPARE( QString("%3 %1 %%2").arg("a", "long argument"), QString("%3 a %long argument") );
+    QTest::ignoreMessage(QtWarningMsg, "QString::arg: 1 argument(s) missing in %1 %1");
+    QCOMPARE( QString("%1 %1").arg("a", "b"), QString("a a") );
     QCOMPARE( s8.arg("%1").arg("foo"), QString("[foo foo]") );
     QCOMPARE( s8.arg("%1", "foo"), QString("[%1 foo]") );
     QCOMPARE( s4.arg("foo", 2), QString("[foo]") );
@@ -220,7 +220,62 @@ void runScenario()
         QCOMPARE(str2, str2_e);
     }
 
-    //operator QByteArray  +=
+    //QStringNumber
+    {
+        static const qlonglong integers[] = {
+            0, 1, -1, 7, 42, -42, 255, 1000000, -2147483647 - 1, 2147483647,
+            Q_INT64_C(-9223372036854775807) - 1, Q_INT64_C(9223372036854775807)
+        };
+        static const int bases[] = { 10, 2, 8, 16, 36 };
+        for (uint i = 0; i < sizeof(integers) / sizeof(integers[0]); ++i) {
+            for (uint j = 0; j < sizeof(bases) / sizeof(bases[0]); ++j) {
+                const qlonglong n = integers[i];
+                const int base = bases[j];
+                QCOMPARE(QStringNumber(n, base).toString(), QString::number(n, base));
+                QCOMPARE(QStringNumber(qulonglong(n), base).toString(), QString::number(qulonglong(n), base));
+                QCOMPARE(QStringNumber(int(n), base).toString(), QString::number(int(n), base));
+                QCOMPARE(QStringNumber(uint(n), base).toString(), QString::number(uint(n), base));
+            }
+        }
+
+        static const double doubles[] = {
+            0.0, -0.0, 1.0, -1.5, 0.1, 1.0 / 3, 2.5, 0.5, 100, 123456.789, 9.9999999,
+            0.000123, 1e-5, 1e-7, 1e15, 1e21, 123456789012345678.0,
+            1.7976931348623157e308, 2.2250738585072014e-308, 4.9406564584124654e-324,
+            qInf(), -qInf(), qQNaN()
+        };
+        static const char formats[] = "eEfFgG";
+        static const int precisions[] = { -1, 0, 1, 2, 6, 10, 16, 17, 20, QLocale::FloatingPointShortest };
+        for (uint i = 0; i < sizeof(doubles) / sizeof(doubles[0]); ++i) {
+            for (uint j = 0; j < sizeof(formats) - 1; ++j) {
+                for (uint k = 0; k < sizeof(precisions) / sizeof(precisions[0]); ++k) {
+                    const QStringNumber number(doubles[i], formats[j], precisions[k]);
+                    const QString expected = QString::number(doubles[i], formats[j], precisions[k]);
+                    QCOMPARE(number.toString(), expected);
+                    QCOMPARE(number.size(), expected.size());
+                }
+            }
+        }
+
+        qsrand(42);
+        for (int i = 0; i < 1000; ++i) {
+            const double d = (qrand() - RAND_MAX / 2) * qPow(10, qrand() % 40 - 20) / qrand();
+            QCOMPARE(QStringNumber(d).toString(), QString::number(d));
+            QCOMPARE(QStringNumber(d, 'f', 3).toString(), QString::number(d, 'f', 3));
+            QCOMPARE(QStringNumber(d, 'e', 12).toString(), QString::number(d, 'e', 12));
+            QCOMPARE(QStringNumber(d, 'g', QLocale::FloatingPointShortest).toString(),
+                     QString::number(d, 'g', QLocale::FloatingPointShortest));
+        }
+
+        QString s = QLatin1String("line ") P QStringNumber(42) P QLatin1String(": ")
+                    P QStringNumber(-0.25, 'f', 2) P QLatin1Char('/') P QStringNumber(255, 16);
+        QCOMPARE(s, QString(QLatin1String("line 42: -0.25/ff")));
+        s += QLatin1Char(' ') P QStringNumber(1e100);
+        QCOMPARE(s, QString(QLatin1String("line 42: -0.25/ff 1e+100")));
+        s = QStringNumber(1e300, 'f', 6) P QLatin1Char('!');
+        QCOMPARE(s, QString(QString::number(1e300, 'f', 6) + QLatin1Char('!')));
+    }
+
     {
         QByteArray ba = UTF8_LITERAL;
         ba +=  QByteArray(LITERAL) P UTF8_LITERAL;
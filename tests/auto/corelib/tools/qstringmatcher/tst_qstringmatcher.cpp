@@ -54,6 +54,7 @@ private slots:
     void setCaseSensitivity_data();
     void setCaseSensitivity();
     void assignOperator();
+    void shortPatterns();
 };
 
 void tst_QStringMatcher::qstringmatcher()
@@ -146,6 +147,34 @@ void tst_QStringMatcher::assignOperator()
     QCOMPARE(m2.indexIn(hayStack), 3);
 }
 
+void tst_QStringMatcher::shortPatterns()
+{
+    // Place a pattern at every offset relative to an 8 character block, with
+    // partial matches (same first and last character) in front of it
+    for (int length = 1; length <= 20; ++length) {
+        QString pattern(length, QLatin1Char('x'));
+        pattern[0] = QChar(0x100);
+        pattern[length - 1] = QLatin1Char('z');
+        QString decoy = pattern;
+        decoy[length / 2] = QLatin1Char('y');
+        QStringMatcher matcher(pattern);
+
+        for (int offset = 0; offset < 20; ++offset) {
+            QString haystack(offset, QLatin1Char('.'));
+            if (length > 2)
+                haystack += decoy;
+            haystack += pattern;
+            haystack += QString(offset % 5, QLatin1Char('.'));
+            const int expected = offset + (length > 2 ? length : 0);
+
+            QCOMPARE(matcher.indexIn(haystack), expected);
+            QCOMPARE(matcher.indexIn(haystack, expected), expected);
+            QCOMPARE(matcher.indexIn(haystack, expected + 1), -1);
+            QCOMPARE(haystack.indexOf(pattern), expected);
+        }
+    }
+}
+
 QTEST_MAIN(tst_QStringMatcher)
 #include "tst_qstringmatcher.moc"
 
@@ -70,6 +70,10 @@ private slots:
     void compare_data();
     void compare();
     void operator_eqeq_nullstring();
+    void split_data();
+    void split();
+    void trimmed();
+    void toNum();
 };
 
 static QStringRef emptyRef()
@@ -844,6 +848,142 @@ void tst_QStringRef::compare()
     }
 }
 
+void tst_QStringRef::split_data()
+{
+    QTest::addColumn<QString>("str");
+    QTest::addColumn<QString>("sep");
+    QTest::addColumn<QStringList>("result");
+
+    QTest::newRow("a,b,c") << "a,b,c" << "," << (QStringList() << "a" << "b" << "c");
+    QTest::newRow("a,b,c,") << "a,b,c," << "," << (QStringList() << "a" << "b" << "c" << "");
+    QTest::newRow(",a,,b,c") << ",a,,b,c" << "," << (QStringList() << "" << "a" << "" << "b" << "c");
+    QTest::newRow("no separator") << "abc" << "," << (QStringList() << "abc");
+    QTest::newRow("empty") << "" << "," << (QStringList() << "");
+    QTest::newRow("key=value") << "key=value" << "=" << (QStringList() << "key" << "value");
+    QTest::newRow("long separator") << "a::b::c" << "::" << (QStringList() << "a" << "b" << "c");
+    QTest::newRow("empty separator") << "abc" << "" << (QStringList() << "" << "a" << "b" << "c" << "");
+}
+
+void tst_QStringRef::split()
+{
+    QFETCH(QString, str);
+    QFETCH(QString, sep);
+    QFETCH(QStringList, result);
+
+    // compare against QString::split() for both the whole string and a
+    // reference into the middle of a longer one
+    QVector<QStringRef> list = str.splitRef(sep);
+    QCOMPARE(list.size(), result.size());
+    for (int i = 0; i < list.size(); ++i) {
+        QCOMPARE(list.at(i).toString(), result.at(i));
+        QCOMPARE(list.at(i).string(), &str);
+    }
+
+    CREATE_REF(str);
+    list = ref.split(sep);
+    QCOMPARE(list.size(), result.size());
+    for (int i = 0; i < list.size(); ++i)
+        QCOMPARE(list.at(i).toString(), result.at(i));
+
+    QStringList skipped = result;
+    skipped.removeAll(QString());
+    skipped.removeAll(QLatin1String(""));
+    list = ref.split(sep, QString::SkipEmptyParts);
+    QCOMPARE(list.size(), skipped.size());
+    for (int i = 0; i < list.size(); ++i)
+        QCOMPARE(list.at(i).toString(), skipped.at(i));
+
+    if (sep.size() == 1) {
+        list = ref.split(sep.at(0));
+        QCOMPARE(list.size(), result.size());
+        for (int i = 0; i < list.size(); ++i)
+            QCOMPARE(list.at(i).toString(), result.at(i));
+
+        list = str.splitRef(sep.at(0), QString::SkipEmptyParts);
+        QCOMPARE(list.size(), skipped.size());
+        for (int i = 0; i < list.size(); ++i)
+            QCOMPARE(list.at(i).toString(), skipped.at(i));
+    }
+
+    list = str.toUpper().splitRef(sep.toLower(), QString::KeepEmptyParts, Qt::CaseInsensitive);
+    QCOMPARE(list.size(), result.size());
+}
+
+void tst_QStringRef::trimmed()
+{
+    QString a = QLatin1String("  \t hello world \n ");
+    QStringRef ref(&a);
+    QCOMPARE(ref.trimmed().toString(), QString::fromLatin1("hello world"));
+    QCOMPARE(ref.trimmed().string(), &a);
+    QCOMPARE(ref.trimmed().position(), 4);
+
+    ref = a.midRef(4, 5);
+    QCOMPARE(ref.trimmed().toString(), QString::fromLatin1("hello"));
+    QCOMPARE(ref.trimmed().position(), 4);
+
+    a = QLatin1String("   ");
+    ref = QStringRef(&a);
+    QVERIFY(ref.trimmed().isEmpty());
+    QVERIFY(QStringRef().trimmed().isEmpty());
+    QVERIFY(emptyRef().trimmed().isEmpty());
+}
+
+void tst_QStringRef::toNum()
+{
+    const QString numbers = QLatin1String("12, -34 ,0x1f,70000,abc,-1,4294967296, 1.5,1e400,");
+    const QVector<QStringRef> fields = numbers.splitRef(QLatin1Char(','));
+    QCOMPARE(fields.size(), 10);
+
+    bool ok;
+    QCOMPARE(fields.at(0).toInt(&ok), 12);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(1).toInt(&ok), -34);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(1).toLongLong(&ok), Q_INT64_C(-34));
+    QVERIFY(ok);
+    QCOMPARE(fields.at(2).toInt(&ok, 10), 0);
+    QVERIFY(!ok);
+    QCOMPARE(fields.at(2).toInt(&ok, 0), 31);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(3).toInt(&ok), 70000);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(3).toShort(&ok), short(0));
+    QVERIFY(!ok);
+    QCOMPARE(fields.at(3).toUShort(&ok), ushort(0));
+    QVERIFY(!ok);
+    QCOMPARE(fields.at(4).toInt(&ok), 0);
+    QVERIFY(!ok);
+    QCOMPARE(fields.at(4).toInt(&ok, 16), 0xabc);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(5).toUInt(&ok), 0u);
+    QVERIFY(!ok);
+    QCOMPARE(fields.at(5).toLong(&ok), -1L);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(6).toUInt(&ok), 0u);
+    QVERIFY(!ok);
+    QCOMPARE(fields.at(6).toULongLong(&ok), Q_UINT64_C(4294967296));
+    QVERIFY(ok);
+    QCOMPARE(fields.at(6).toULong(&ok), ulong(fields.at(6).toString().toULong()));
+    QCOMPARE(fields.at(7).toDouble(&ok), 1.5);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(7).toFloat(&ok), 1.5f);
+    QVERIFY(ok);
+    QCOMPARE(fields.at(7).toInt(&ok), 0);
+    QVERIFY(!ok);
+    fields.at(8).toDouble(&ok);
+    QVERIFY(!ok);
+    QCOMPARE(fields.at(8).toFloat(&ok), 0.0f);
+    QVERIFY(!ok);
+    QCOMPARE(fields.at(9).toInt(&ok), 0);
+    QVERIFY(!ok);
+    QCOMPARE(fields.at(9).toDouble(&ok), 0.0);
+    QVERIFY(!ok);
+
+    // the conversion must not look beyond the end of the reference
+    QCOMPARE(numbers.midRef(0, 1).toInt(), 1);
+    QCOMPARE(numbers.midRef(43, 1).toDouble(), 1.0);
+}
+
 QTEST_APPLESS_MAIN(tst_QStringRef)
 
 #include "tst_qstringref.moc"
@@ -2,11 +2,13 @@ TEMPLATE=subdirs
 SUBDIRS=\
     qalgorithms \
     qarraydata \
+    qarraydataarena \
     qbitarray \
     qbytearray \
     qbytearraymatcher \
     qbytedatabuffer \
     qcache \
+    qconcurrentcache \
     qchar \
     qcontiguouscache \
     qcryptographichash \
@@ -15,6 +17,7 @@ SUBDIRS=\
     qeasingcurve \
     qelapsedtimer \
     qexplicitlyshareddatapointer \
+    qflathash \
     qfreelist \
     qhash \
     qline \
@@ -22,6 +25,7 @@ SUBDIRS=\
     qlocale \
     qmap \
     qmargins \
+    qmultipatternmatcher \
     qpair \
     qpoint \
     qpointf \
@@ -1,5 +1,6 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        concurrent \
         corelib \
         gui \
         network \
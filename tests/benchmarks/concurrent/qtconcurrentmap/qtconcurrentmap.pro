@@ -0,0 +1,4 @@
+TEMPLATE = app
+TARGET = tst_bench_qtconcurrentmap
+QT = core testlib concurrent
+SOURCES += tst_qtconcurrentmap.cpp
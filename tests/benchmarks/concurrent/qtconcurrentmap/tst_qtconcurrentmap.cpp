@@ -0,0 +1,110 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtConcurrent/QtConcurrent>
+#include <QtTest/QtTest>
+
+Q_DECLARE_METATYPE(QtConcurrent::ReduceOptions)
+
+enum { BucketCount = 64 };
+
+typedef QVector<int> Histogram;
+
+// cheap map function
+static Histogram toHistogram(int value)
+{
+    Histogram histogram(BucketCount);
+    histogram[value % BucketCount] = 1;
+    return histogram;
+}
+
+// comparatively expensive, associative reduce function
+static void mergeHistograms(Histogram &result, const Histogram &histogram)
+{
+    if (result.isEmpty()) {
+        result = histogram;
+        return;
+    }
+    int *r = result.data();
+    const int *h = histogram.constData();
+    for (int i = 0; i < BucketCount; ++i)
+        r[i] += h[i];
+}
+
+class tst_QtConcurrentMap : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void mappedReduced_data();
+    void mappedReduced();
+};
+
+void tst_QtConcurrentMap::mappedReduced_data()
+{
+    QTest::addColumn<QtConcurrent::ReduceOptions>("options");
+
+    QTest::newRow("UnorderedReduce")
+        << QtConcurrent::ReduceOptions(QtConcurrent::UnorderedReduce | QtConcurrent::SequentialReduce);
+    QTest::newRow("OrderedReduce")
+        << QtConcurrent::ReduceOptions(QtConcurrent::OrderedReduce | QtConcurrent::SequentialReduce);
+    QTest::newRow("ParallelReduce")
+        << QtConcurrent::ReduceOptions(QtConcurrent::UnorderedReduce | QtConcurrent::ParallelReduce);
+}
+
+void tst_QtConcurrentMap::mappedReduced()
+{
+    QFETCH(QtConcurrent::ReduceOptions, options);
+
+    QVector<int> values(200000);
+    for (int i = 0; i < values.size(); ++i)
+        values[i] = i;
+
+    QBENCHMARK {
+        const Histogram histogram =
+            QtConcurrent::blockingMappedReduced<Histogram>(values, toHistogram, mergeHistograms, options);
+        QCOMPARE(histogram.size(), int(BucketCount));
+        QCOMPARE(histogram.at(0), values.size() / BucketCount);
+    }
+}
+
+QTEST_MAIN(tst_QtConcurrentMap)
+#include "tst_qtconcurrentmap.moc"
@@ -56,8 +56,21 @@ private slots:
     void fromUnicode() const;
     void toUnicode_data() const;
     void toUnicode() const;
+    void fromUtf8_data() const;
+    void fromUtf8() const;
+    void toUtf8_data() const;
+    void toUtf8() const;
 };
 
+// Builds a corpus of about 64 kB by repeating \a sample
+static QByteArray utf8Corpus(const char *sample)
+{
+    QByteArray result;
+    while (result.size() < 64 * 1024)
+        result += sample;
+    return result;
+}
+
 void tst_QTextCodec::codecForName() const
 {
     QFETCH(QList<QByteArray>, codecs);
@@ -176,7 +189,62 @@ void tst_QTextCodec::toUnicode() const
 }
 
 
+void tst_QTextCodec::fromUtf8_data() const
+{
+    QTest::addColumn<QByteArray>("utf8");
+
+    QTest::newRow("json") << utf8Corpus(
+        "{\"id\": 4711, \"name\": \"sensor-12\", \"enabled\": true, \"tags\": [\"temperature\", "
+        "\"outdoor\"], \"readings\": [21.5, 21.7, 21.6], \"updated\": \"2013-01-30T12:00:00Z\"}\n");
+    QTest::newRow("log") << utf8Corpus(
+        "2013-01-30 12:00:00.123 [worker-3] INFO  org.example.Server - GET /api/v1/items?page=2 200 15ms\n");
+    QTest::newRow("http-headers") << utf8Corpus(
+        "Host: www.example.com\r\nUser-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n"
+        "Accept: text/html,application/xhtml+xml\r\nAccept-Encoding: gzip, deflate\r\n");
+    QTest::newRow("german") << utf8Corpus(
+        "Zw\303\266lf Boxk\303\244mpfer jagen Viktor quer \303\274ber den gro\303\237en Sylter Deich. ");
+    QTest::newRow("russian") << utf8Corpus(
+        "\320\241\321\212\320\265\321\210\321\214 \320\266\320\265 \320\265\321\211\321\221 "
+        "\321\215\321\202\320\270\321\205 \320\274\321\217\320\263\320\272\320\270\321\205 "
+        "\321\204\321\200\320\260\320\275\321\206\321\203\320\267\321\201\320\272\320\270\321\205 "
+        "\320\261\321\203\320\273\320\276\320\272, \320\264\320\260 \320\262\321\213\320\277\320\265\320\271 "
+        "\321\207\320\260\321\216. ");
+    QTest::newRow("japanese") << utf8Corpus(
+        "\343\201\204\343\202\215\343\201\257\343\201\253\343\201\273\343\201\270\343\201\250"
+        "\343\201\241\343\202\212\343\201\254\343\202\213\343\202\222\343\200\201"
+        "\346\227\245\346\234\254\350\252\236\343\201\256\346\226\207\347\253\240\343\200\202");
+    QTest::newRow("json-mixed") << utf8Corpus(
+        "{\"id\": 4711, \"city\": \"M\303\274nchen\", \"title\": \"\346\235\261\344\272\254\", "
+        "\"note\": \"\320\237\321\200\320\270\320\262\320\265\321\202\", \"mood\": \"\360\237\230\200\"}\n");
+}
+
+void tst_QTextCodec::fromUtf8() const
+{
+    QFETCH(QByteArray, utf8);
 
+    QString result;
+    QBENCHMARK {
+        result = QString::fromUtf8(utf8.constData(), utf8.size());
+    }
+    QCOMPARE(result.toUtf8(), utf8);
+}
+
+void tst_QTextCodec::toUtf8_data() const
+{
+    fromUtf8_data();
+}
+
+void tst_QTextCodec::toUtf8() const
+{
+    QFETCH(QByteArray, utf8);
+
+    const QString string = QString::fromUtf8(utf8.constData(), utf8.size());
+    QByteArray result;
+    QBENCHMARK {
+        result = string.toUtf8();
+    }
+    QCOMPARE(result, utf8);
+}
 
 QTEST_MAIN(tst_QTextCodec)
 
@@ -4,6 +4,8 @@ SUBDIRS = \
         qdiriterator \
         qfile \
         #qfileinfo \    # FIXME: broken
+        qcompressiondevice \
+        qfilesystemwatcher \
         qiodevice \
         qprocess \
         qtemporaryfile
@@ -0,0 +1,167 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QBuffer>
+#include <QByteArray>
+#include <qcompressiondevice.h>
+
+#include <qtest.h>
+
+Q_DECLARE_METATYPE(QCompressionDevice::Format)
+
+class tst_qcompressiondevice : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void compress_data();
+    void compress();
+    void decompress_data() { compress_data(); }
+    void decompress();
+
+    void qCompress_baseline();
+    void qUncompress_baseline();
+
+private:
+    QByteArray input;
+};
+
+enum { InputSize = 8 * 1024 * 1024 };
+
+void tst_qcompressiondevice::initTestCase()
+{
+    // roughly what log files look like: repetitive text with varying numbers
+    input.reserve(InputSize);
+    qsrand(1);
+    for (int line = 0; input.size() < InputSize; ++line) {
+        input += "2012-12-19 12:00:";
+        input += QByteArray::number(line % 60);
+        input += " [worker ";
+        input += QByteArray::number(qrand() % 16);
+        input += "] request ";
+        input += QByteArray::number(qrand());
+        input += " served in ";
+        input += QByteArray::number(qrand() % 1000);
+        input += " ms\n";
+    }
+    input.truncate(InputSize);
+}
+
+void tst_qcompressiondevice::compress_data()
+{
+    QTest::addColumn<QCompressionDevice::Format>("format");
+    QTest::addColumn<int>("bufferSize");
+
+    QTest::newRow("zlib-4k") << QCompressionDevice::ZlibFormat << 4 * 1024;
+    QTest::newRow("zlib-64k") << QCompressionDevice::ZlibFormat << 64 * 1024;
+    QTest::newRow("zlib-256k") << QCompressionDevice::ZlibFormat << 256 * 1024;
+    QTest::newRow("gzip-4k") << QCompressionDevice::GzipFormat << 4 * 1024;
+    QTest::newRow("gzip-64k") << QCompressionDevice::GzipFormat << 64 * 1024;
+    QTest::newRow("gzip-256k") << QCompressionDevice::GzipFormat << 256 * 1024;
+    QTest::newRow("raw-64k") << QCompressionDevice::RawDeflateFormat << 64 * 1024;
+}
+
+void tst_qcompressiondevice::compress()
+{
+    QFETCH(QCompressionDevice::Format, format);
+    QFETCH(int, bufferSize);
+
+    QByteArray output;
+    QBENCHMARK {
+        output.clear();
+        QBuffer buffer(&output);
+        buffer.open(QIODevice::WriteOnly);
+        QCompressionDevice device(&buffer, format);
+        device.setBufferSize(bufferSize);
+        device.open(QIODevice::WriteOnly);
+        // feed it the way a logger would, in small writes
+        for (int pos = 0; pos < input.size(); pos += 4096)
+            device.write(input.constData() + pos, qMin(4096, input.size() - pos));
+        device.close();
+    }
+    QVERIFY(!output.isEmpty());
+}
+
+void tst_qcompressiondevice::decompress()
+{
+    QFETCH(QCompressionDevice::Format, format);
+    QFETCH(int, bufferSize);
+
+    const QByteArray compressed = QCompressionDevice::compressData(input, format);
+    QByteArray chunk(4096, Qt::Uninitialized);
+    qint64 total = 0;
+    QBENCHMARK {
+        QBuffer buffer;
+        buffer.setData(compressed);
+        buffer.open(QIODevice::ReadOnly);
+        QCompressionDevice device(&buffer, format);
+        device.setBufferSize(bufferSize);
+        device.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+        total = 0;
+        qint64 n;
+        while ((n = device.read(chunk.data(), chunk.size())) > 0)
+            total += n;
+    }
+    QCOMPARE(total, qint64(input.size()));
+}
+
+void tst_qcompressiondevice::qCompress_baseline()
+{
+    QByteArray output;
+    QBENCHMARK {
+        output = qCompress(input);
+    }
+    QVERIFY(!output.isEmpty());
+}
+
+void tst_qcompressiondevice::qUncompress_baseline()
+{
+    const QByteArray compressed = qCompress(input);
+    QByteArray output;
+    QBENCHMARK {
+        output = qUncompress(compressed);
+    }
+    QCOMPARE(output.size(), input.size());
+}
+
+QTEST_MAIN(tst_qcompressiondevice)
+
+#include "main.moc"
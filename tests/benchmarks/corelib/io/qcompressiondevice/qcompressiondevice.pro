@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tst_bench_qcompressiondevice
+
+QT = core testlib
+
+CONFIG += release
+
+SOURCES += main.cpp
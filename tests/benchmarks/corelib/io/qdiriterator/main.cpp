@@ -41,6 +41,8 @@
 #include <QDebug>
 #include <QDirIterator>
 #include <QString>
+#include <QTemporaryDir>
+#include <QThreadPool>
 
 #ifdef Q_OS_WIN
 #   include <qt_windows.h>
@@ -60,15 +62,39 @@ class tst_qdiriterator : public QObject
 {
     Q_OBJECT
 private slots:
+    void initTestCase();
     void posix();
     void posix_data() { data(); }
     void diriterator();
     void diriterator_data() { data(); }
+    void diriteratorParallel();
+    void diriteratorParallel_data() { data(); }
     void fsiterator();
     void fsiterator_data() { data(); }
     void data();
+
+private:
+    QTemporaryDir generatedTree;
 };
 
+void tst_qdiriterator::initTestCase()
+{
+    // a tree with many small directories, like an asset store:
+    // 16 * 16 directories holding 64 files each
+    QVERIFY(generatedTree.isValid());
+    QDir root(generatedTree.path());
+    for (int i = 0; i < 16; ++i) {
+        for (int j = 0; j < 16; ++j) {
+            const QString dir = QString("%1/%2").arg(i).arg(j);
+            QVERIFY(root.mkpath(dir));
+            for (int k = 0; k < 64; ++k) {
+                QFile file(root.filePath(dir + QString("/asset%1.bin").arg(k)));
+                QVERIFY(file.open(QIODevice::WriteOnly));
+            }
+        }
+    }
+}
+
 
 void tst_qdiriterator::data()
 {
@@ -81,17 +107,17 @@ void tst_qdiriterator::data()
 #else
     const char *qtdir = ::getenv("QTDIR");
 #endif
-    if (!qtdir) {
-        fprintf(stderr, "QTDIR not set\n");
-        exit(1);
-    }
 #endif
 
     QTest::addColumn<QByteArray>("dirpath");
-    QByteArray ba = QByteArray(qtdir) + "/src/corelib";
-    QByteArray ba1 = ba + "/io";
-    QTest::newRow(ba) << ba;
-    //QTest::newRow(ba1) << ba1;
+    const QByteArray generated = QFile::encodeName(generatedTree.path());
+    QTest::newRow("generated") << generated;
+    if (qtdir) {
+        QByteArray ba = QByteArray(qtdir) + "/src/corelib";
+        QByteArray ba1 = ba + "/io";
+        QTest::newRow(ba) << ba;
+        //QTest::newRow(ba1) << ba1;
+    }
 }
 
 #ifdef Q_OS_WIN
@@ -215,6 +241,28 @@ void tst_qdiriterator::diriterator()
     qDebug() << count;
 }
 
+void tst_qdiriterator::diriteratorParallel()
+{
+    QFETCH(QByteArray, dirpath);
+
+    int count = 0;
+
+    QBENCHMARK {
+        int c = 0;
+
+        QDirIterator dir(dirpath,
+            QDir::Files,
+            QDirIterator::Subdirectories | QDirIterator::ParallelTraversal);
+
+        while (dir.hasNext()) {
+            dir.next();
+            ++c;
+        }
+        count = c;
+    }
+    qDebug() << count << "threads:" << QThreadPool::globalInstance()->maxThreadCount();
+}
+
 void tst_qdiriterator::fsiterator()
 {
     QFETCH(QByteArray, dirpath);
@@ -116,7 +116,15 @@ private slots:
     void readBigFile_posix();
     void readBigFile_Win32();
 
+    void copy_data();
+    void copy();
+    void copy_readWrite_data() { copy_data(); }
+    void copy_readWrite();
+    void copyRange_data() { copy_data(); }
+    void copyRange();
+
 private:
+    void createCopySource(int size);
     void readBigFile_data(BenchmarkType type, QIODevice::OpenModeFlag t, QIODevice::OpenModeFlag b);
     void readBigFile();
     void readSmallFiles_data(BenchmarkType type, QIODevice::OpenModeFlag t, QIODevice::OpenModeFlag b);
@@ -716,6 +724,88 @@ void tst_qfile::readSmallFiles()
     delete[] buffer;
 }
 
+void tst_qfile::createCopySource(int size)
+{
+    createFile();
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QByteArray block(1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < block.size(); ++i)
+        block[i] = char(i * 31 + (i >> 10));
+    for (int written = 0; written < size; written += block.size())
+        QVERIFY(file.write(block.constData(), qMin(block.size(), size - written)) > 0);
+}
+
+void tst_qfile::copy_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::newRow("1MB") << 1024 * 1024;
+    QTest::newRow("16MB") << 16 * 1024 * 1024;
+    QTest::newRow("128MB") << 128 * 1024 * 1024;
+}
+
+void tst_qfile::copy()
+{
+    QFETCH(int, size);
+    createCopySource(size);
+    const QString copyName = filename + QLatin1String(".copy");
+
+    QBENCHMARK {
+        QFile::remove(copyName);
+        QVERIFY(QFile::copy(filename, copyName));
+    }
+    QCOMPARE(QFileInfo(copyName).size(), qint64(size));
+
+    QFile::remove(copyName);
+    removeFile();
+}
+
+void tst_qfile::copy_readWrite()
+{
+    // what QFile::copy() used to do, for comparison
+    QFETCH(int, size);
+    createCopySource(size);
+    const QString copyName = filename + QLatin1String(".copy");
+
+    QBENCHMARK {
+        QFile in(filename);
+        QFile out(copyName);
+        QVERIFY(in.open(QIODevice::ReadOnly));
+        QVERIFY(out.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        char block[4096];
+        qint64 n;
+        while ((n = in.read(block, sizeof(block))) > 0)
+            out.write(block, n);
+    }
+    QCOMPARE(QFileInfo(copyName).size(), qint64(size));
+
+    QFile::remove(copyName);
+    removeFile();
+}
+
+void tst_qfile::copyRange()
+{
+    QFETCH(int, size);
+    createCopySource(size);
+    const QString copyName = filename + QLatin1String(".copy");
+
+    QFile in(filename);
+    QFile out(copyName);
+    QVERIFY(in.open(QIODevice::ReadOnly));
+    QVERIFY(out.open(QIODevice::ReadWrite | QIODevice::Truncate));
+    QBENCHMARK {
+        // into the middle of an existing file, so that no reflink is possible
+        in.seek(0);
+        out.seek(4096);
+        QCOMPARE(QFile::copyRange(&in, &out, size), qint64(size));
+    }
+    in.close();
+    out.close();
+
+    QFile::remove(copyName);
+    removeFile();
+}
+
 QTEST_MAIN(tst_qfile)
 
 #include "main.moc"
@@ -0,0 +1,222 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QSet>
+#include <QTemporaryDir>
+
+#include <qtest.h>
+
+// Watches a generated tree and measures how fast the watch set is built
+// and how the watcher copes with a burst of changes all over the tree.
+class tst_qfilesystemwatcher : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+
+    void addPaths_data();
+    void addPaths();
+    void addRecursivePath_data() { addPaths_data(); }
+    void addRecursivePath();
+
+    void burst_data();
+    void burst();
+
+private slots:
+    void directoryChanged(const QString &path);
+    void directoriesChanged(const QStringList &paths);
+    void queueOverflowed();
+
+private:
+    QStringList createTree(int count);
+
+    QTemporaryDir temporaryDir;
+    QStringList watched;
+    QSet<QString> reported;
+    int directorySignals;
+    int batchSignals;
+    int overflows;
+};
+
+void tst_qfilesystemwatcher::initTestCase()
+{
+    QVERIFY(temporaryDir.isValid());
+}
+
+// Creates \a count directories, 16 per parent, below a fresh root and
+// returns them, root first.
+QStringList tst_qfilesystemwatcher::createTree(int count)
+{
+    const QString root = temporaryDir.path() + QLatin1String("/tree") + QString::number(count);
+    QDir(root).removeRecursively();
+    QDir().mkpath(root);
+
+    QStringList directories(root);
+    for (int i = 1; i < count; ++i) {
+        const QString path = directories.at((i - 1) / 16) + QLatin1Char('/') + QString::number(i);
+        QDir().mkdir(path);
+        directories.append(path);
+    }
+    return directories;
+}
+
+void tst_qfilesystemwatcher::addPaths_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("1000")  << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("40000") << 40000;
+}
+
+// The way a tree had to be watched before addRecursivePath(): list it and
+// add every directory.
+void tst_qfilesystemwatcher::addPaths()
+{
+    QFETCH(int, count);
+    const QStringList directories = createTree(count);
+
+    QBENCHMARK {
+        QStringList paths(directories.first());
+        QDirIterator it(directories.first(), QDir::Dirs | QDir::NoDotAndDotDot | QDir::NoSymLinks,
+                        QDirIterator::Subdirectories);
+        while (it.hasNext())
+            paths.append(it.next());
+
+        QFileSystemWatcher watcher;
+        QVERIFY(watcher.addPaths(paths).isEmpty());
+        QCOMPARE(watcher.directories().count(), count);
+    }
+}
+
+void tst_qfilesystemwatcher::addRecursivePath()
+{
+    QFETCH(int, count);
+    const QStringList directories = createTree(count);
+
+    QBENCHMARK {
+        QFileSystemWatcher watcher;
+        QVERIFY(watcher.addRecursivePath(directories.first()));
+        QCOMPARE(watcher.directories().count(), count);
+    }
+}
+
+void tst_qfilesystemwatcher::burst_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::addColumn<int>("latency");
+    QTest::newRow("1000-immediate")  << 1000 << 0;
+    QTest::newRow("1000-latency50")  << 1000 << 50;
+    QTest::newRow("10000-immediate") << 10000 << 0;
+    QTest::newRow("10000-latency50") << 10000 << 50;
+}
+
+// Creates and removes a file in every directory of the tree, then waits
+// until every directory has been reported. Large trees overflow the
+// kernel's event queue, after which everything counts as reported.
+void tst_qfilesystemwatcher::burst()
+{
+    QFETCH(int, count);
+    QFETCH(int, latency);
+    const QStringList directories = createTree(count);
+    watched = directories;
+
+    QFileSystemWatcher watcher;
+    watcher.setLatency(latency);
+    QVERIFY(watcher.addRecursivePath(directories.first()));
+    connect(&watcher, SIGNAL(directoryChanged(QString)), SLOT(directoryChanged(QString)));
+    connect(&watcher, SIGNAL(directoriesChanged(QStringList)), SLOT(directoriesChanged(QStringList)));
+    connect(&watcher, SIGNAL(queueOverflowed()), SLOT(queueOverflowed()));
+
+    int events = 0;
+    int batches = 0;
+    int overflowCount = 0;
+    int iterations = 0;
+    QBENCHMARK {
+        reported.clear();
+        directorySignals = 0;
+        batchSignals = 0;
+        overflows = 0;
+        foreach (const QString &directory, directories) {
+            QFile file(directory + QLatin1String("/file"));
+            file.open(QIODevice::WriteOnly);
+            file.close();
+            file.remove();
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        while (reported.size() < count && timer.elapsed() < 30000)
+            QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 100);
+        QCOMPARE(reported.size(), count);
+
+        events += directorySignals;
+        batches += batchSignals;
+        overflowCount += overflows;
+        ++iterations;
+    }
+    qDebug("%d directoryChanged(), %d directoriesChanged() and %d queueOverflowed() signals per burst",
+           events / iterations, batches / iterations, overflowCount / iterations);
+}
+
+void tst_qfilesystemwatcher::directoryChanged(const QString &path)
+{
+    reported.insert(path);
+    ++directorySignals;
+}
+
+void tst_qfilesystemwatcher::directoriesChanged(const QStringList &)
+{
+    ++batchSignals;
+}
+
+void tst_qfilesystemwatcher::queueOverflowed()
+{
+    reported = watched.toSet();
+    ++overflows;
+}
+
+QTEST_MAIN(tst_qfilesystemwatcher)
+
+#include "main.moc"
@@ -40,6 +40,7 @@
 ****************************************************************************/
 #include <QDebug>
 #include <QIODevice>
+#include <QBuffer>
 #include <QFile>
 #include <QString>
 
@@ -54,8 +55,13 @@ private slots:
     void read_old_data() { read_data(); }
     //void read_new();
     //void read_new_data() { read_data(); }
+    void scan_read();
+    void scan_read_data() { scan_data(); }
+    void scan_peekView();
+    void scan_peekView_data() { scan_data(); }
 private:
     void read_data();
+    void scan_data();
 };
 
 
@@ -99,6 +105,84 @@ void tst_qiodevice::read_old()
     }
 }
 
+void tst_qiodevice::scan_data()
+{
+    QTest::addColumn<bool>("useFile");
+    QTest::addColumn<qint64>("size");
+    QTest::newRow("buffer-1000k")  << false << qint64(1000 * 1024);
+    QTest::newRow("buffer-10000k") << false << qint64(10000 * 1024);
+    QTest::newRow("file-1000k")    << true << qint64(1000 * 1024);
+    QTest::newRow("file-10000k")   << true << qint64(10000 * 1024);
+    QTest::newRow("file-100000k")  << true << qint64(100000 * 1024);
+}
+
+static QIODevice *openScanDevice(bool useFile, qint64 size)
+{
+    QByteArray data(size, 'a');
+    for (qint64 i = 0; i < size; i += 4096)
+        data[int(i)] = char(i >> 12);
+    if (!useFile) {
+        QBuffer *buffer = new QBuffer;
+        buffer->setData(data);
+        buffer->open(QIODevice::ReadOnly);
+        return buffer;
+    }
+    QFile *file = new QFile("tmp_scan");
+    file->open(QIODevice::WriteOnly | QIODevice::Truncate);
+    file->write(data);
+    file->close();
+    file->open(QIODevice::ReadOnly);
+    return file;
+}
+
+static quint32 sumBytes(const char *data, qint64 size)
+{
+    quint32 sum = 0;
+    for (qint64 i = 0; i < size; i += 64)
+        sum += uchar(data[i]);
+    return sum;
+}
+
+// Reading the whole device in chunks, copying into a local buffer.
+void tst_qiodevice::scan_read()
+{
+    QFETCH(bool, useFile);
+    QFETCH(qint64, size);
+
+    QIODevice *device = openScanDevice(useFile, size);
+    QByteArray chunk(65536, Qt::Uninitialized);
+    quint32 sum = 0;
+    QBENCHMARK {
+        device->seek(0);
+        qint64 r;
+        while ((r = device->read(chunk.data(), chunk.size())) > 0)
+            sum += sumBytes(chunk.constData(), r);
+    }
+    QVERIFY(sum);
+    delete device;
+    QFile::remove("tmp_scan");
+}
+
+// The same scan through peekView() and skip(), without copying.
+void tst_qiodevice::scan_peekView()
+{
+    QFETCH(bool, useFile);
+    QFETCH(qint64, size);
+
+    QIODevice *device = openScanDevice(useFile, size);
+    quint32 sum = 0;
+    QBENCHMARK {
+        device->seek(0);
+        qint64 viewSize;
+        while (const char *view = device->peekView(&viewSize)) {
+            sum += sumBytes(view, viewSize);
+            device->skip(viewSize);
+        }
+    }
+    QVERIFY(sum);
+    delete device;
+    QFile::remove("tmp_scan");
+}
 
 QTEST_MAIN(tst_qiodevice)
 
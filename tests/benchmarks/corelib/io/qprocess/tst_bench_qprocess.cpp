@@ -50,6 +50,10 @@ class tst_QProcess : public QObject
 private slots:
 
     void echoTest_performance();
+#if defined(Q_OS_UNIX)
+    void launch_data();
+    void launch();
+#endif
 
 #endif // QT_NO_PROCESS
 };
@@ -103,6 +107,55 @@ void tst_QProcess::echoTest_performance()
 }
 #endif // Q_OS_WINCE
 
+#if defined(Q_OS_UNIX)
+// Reimplementing setupChildProcess() makes QProcess fork() the child, as the
+// function has to run in it.
+class ForkingProcess : public QProcess
+{
+protected:
+    void setupChildProcess() {}
+};
+
+void tst_QProcess::launch_data()
+{
+    QTest::addColumn<bool>("fork");
+    QTest::addColumn<int>("residentMegabytes");
+
+    static const int sizes[] = { 0, 256, 1024 };
+    for (uint i = 0; i < sizeof sizes / sizeof *sizes; ++i) {
+        QTest::newRow(qPrintable(QString("QProcess, %1 MB resident").arg(sizes[i])))
+                << false << sizes[i];
+        QTest::newRow(qPrintable(QString("fork, %1 MB resident").arg(sizes[i])))
+                << true << sizes[i];
+    }
+}
+
+void tst_QProcess::launch()
+{
+    QFETCH(bool, fork);
+    QFETCH(int, residentMegabytes);
+
+    // grow the resident set of this process; filling the array touches every page
+    QByteArray resident(residentMegabytes * 1024 * 1024, 'a');
+    QCOMPARE(resident.size(), residentMegabytes * 1024 * 1024);
+
+    QScopedPointer<QProcess> process(fork ? new ForkingProcess : new QProcess);
+    int launches = 0;
+    QElapsedTimer stopWatch;
+    stopWatch.start();
+    while (stopWatch.elapsed() < 1000 || launches < 5) {
+        process->start("true");
+        QVERIFY(process->waitForFinished());
+        QCOMPARE(process->exitCode(), 0);
+        ++launches;
+    }
+    const qint64 elapsed = stopWatch.elapsed();
+
+    qDebug() << "launches per second:" << launches * 1000.0 / elapsed;
+    QTest::setBenchmarkResult(qreal(elapsed) / launches, QTest::WalltimeMilliseconds);
+}
+#endif // Q_OS_UNIX
+
 #endif // QT_NO_PROCESS
 
 QTEST_MAIN(tst_QProcess)
@@ -43,6 +43,12 @@
 #include <qtest.h>
 #include <qtesteventloop.h>
 
+#ifdef Q_OS_UNIX
+#  include <unistd.h>
+#  include <sys/resource.h>
+#  include <sys/select.h>
+#endif
+
 class PingPong : public QObject
 {
 public:
@@ -96,6 +102,26 @@ int EventTester::foo(int bar)
     return bar + 1;
 }
 
+class PipeReader : public QObject
+{
+    Q_OBJECT
+public:
+    PipeReader() : activations(0) {}
+    int activations;
+
+public slots:
+    void readPipe(int fd)
+    {
+#ifdef Q_OS_UNIX
+        char c;
+        if (::read(fd, &c, 1) == 1)
+            ++activations;
+#else
+        Q_UNUSED(fd);
+#endif
+    }
+};
+
 class EventsBench : public QObject
 {
     Q_OBJECT
@@ -109,6 +135,8 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+    void socketNotifierWakeUp_data();
+    void socketNotifierWakeUp();
 };
 
 void EventsBench::initTestCase()
@@ -182,6 +210,75 @@ void EventsBench::postEvent()
     }
 }
 
+void EventsBench::socketNotifierWakeUp_data()
+{
+    QTest::addColumn<int>("notifierCount");
+    QTest::newRow("1") << 1;
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("400") << 400;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("4000") << 4000;
+}
+
+// Measures the cost of waking up for one ready descriptor while
+// notifierCount other read notifiers are idle. Run with QT_NO_EPOLL=1
+// set in the environment to compare against the select() backend.
+void EventsBench::socketNotifierWakeUp()
+{
+#ifdef Q_OS_UNIX
+    QFETCH(int, notifierCount);
+
+    if (!qgetenv("QT_NO_EPOLL").isEmpty() && 2 * notifierCount + 16 >= FD_SETSIZE)
+        QSKIP("select() cannot watch descriptors beyond FD_SETSIZE");
+
+    rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < rlim_t(2 * notifierCount + 64)) {
+        limit.rlim_cur = qMin(limit.rlim_max, rlim_t(2 * notifierCount + 64));
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    PipeReader reader;
+    QVector<int> readFds;
+    QVector<int> writeFds;
+    QList<QSocketNotifier *> notifiers;
+    for (int i = 0; i < notifierCount; ++i) {
+        int fds[2];
+        if (::pipe(fds) == -1)
+            break;
+        QSocketNotifier *notifier = new QSocketNotifier(fds[0], QSocketNotifier::Read);
+        connect(notifier, SIGNAL(activated(int)), &reader, SLOT(readPipe(int)));
+        notifiers << notifier;
+        readFds << fds[0];
+        writeFds << fds[1];
+    }
+
+    if (notifiers.size() == notifierCount) {
+        int next = 0;
+        QBENCHMARK {
+            // alternate between the lowest and the highest descriptor
+            const int fd = writeFds.at(next ? notifierCount - 1 : 0);
+            next = !next;
+            const int expected = reader.activations + 1;
+            char c = 0;
+            QCOMPARE(int(::write(fd, &c, 1)), 1);
+            while (reader.activations < expected)
+                QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+        }
+    }
+
+    qDeleteAll(notifiers);
+    for (int i = 0; i < readFds.size(); ++i) {
+        ::close(readFds.at(i));
+        ::close(writeFds.at(i));
+    }
+    if (readFds.size() != notifierCount)
+        QSKIP("Too many open files");
+#else
+    QSKIP("This benchmark requires pipes");
+#endif
+}
+
 QTEST_MAIN(EventsBench)
 
 #include "main.moc"
@@ -4,6 +4,7 @@ SUBDIRS = \
         qmetaobject \
         qmetatype \
         qobject \
+        qtimer \
         qvariant \
         qcoreapplication
 
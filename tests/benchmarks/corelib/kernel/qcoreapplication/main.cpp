@@ -42,12 +42,50 @@
 #include <qtest.h>
 #include <qcoreapplication.h>
 
+class CountingReceiver : public QObject
+{
+public:
+    CountingReceiver(int type) : type(type), received(0) {}
+
+    bool event(QEvent *e)
+    {
+        if (e->type() == type) {
+            ++received;
+            return true;
+        }
+        return QObject::event(e);
+    }
+
+    int type;
+    int received;
+};
+
+class PostingThread : public QThread
+{
+public:
+    PostingThread(QObject *receiver, int type, int count, int priority)
+        : receiver(receiver), type(type), count(count), priority(priority) {}
+
+    void run()
+    {
+        for (int i = 0; i < count; ++i)
+            QCoreApplication::postEvent(receiver, new QEvent(QEvent::Type(type)), priority);
+    }
+
+    QObject *receiver;
+    int type;
+    int count;
+    int priority;
+};
+
 class QCoreApplicationBenchmark : public QObject
 {
 Q_OBJECT
 private slots:
     void event_posting_benchmark_data();
     void event_posting_benchmark();
+    void event_posting_multiple_threads_data();
+    void event_posting_multiple_threads();
 };
 
 void QCoreApplicationBenchmark::event_posting_benchmark_data()
@@ -77,6 +115,47 @@ void QCoreApplicationBenchmark::event_posting_benchmark()
     }
 }
 
+void QCoreApplicationBenchmark::event_posting_multiple_threads_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<int>("priority");
+    // events with a priority other than normal are always posted with the
+    // receiving thread's post event mutex locked
+    QTest::newRow("1 thread") << 1 << int(Qt::NormalEventPriority);
+    QTest::newRow("1 thread, high priority") << 1 << int(Qt::HighEventPriority);
+    QTest::newRow("2 threads") << 2 << int(Qt::NormalEventPriority);
+    QTest::newRow("2 threads, high priority") << 2 << int(Qt::HighEventPriority);
+    QTest::newRow("4 threads") << 4 << int(Qt::NormalEventPriority);
+    QTest::newRow("4 threads, high priority") << 4 << int(Qt::HighEventPriority);
+    QTest::newRow("8 threads") << 8 << int(Qt::NormalEventPriority);
+    QTest::newRow("8 threads, high priority") << 8 << int(Qt::HighEventPriority);
+}
+
+void QCoreApplicationBenchmark::event_posting_multiple_threads()
+{
+    QFETCH(int, threadCount);
+    QFETCH(int, priority);
+
+    const int eventCount = 100000;
+    CountingReceiver receiver(QEvent::registerEventType());
+
+    // benchmark several threads posting to the main thread while it
+    // delivers the events
+    QBENCHMARK {
+        receiver.received = 0;
+        QList<PostingThread *> threads;
+        for (int i = 0; i < threadCount; ++i)
+            threads << new PostingThread(&receiver, receiver.type, eventCount / threadCount, priority);
+        foreach (PostingThread *thread, threads)
+            thread->start();
+        while (receiver.received < eventCount / threadCount * threadCount)
+            QCoreApplication::sendPostedEvents(&receiver, 0);
+        foreach (PostingThread *thread, threads)
+            thread->wait();
+        qDeleteAll(threads);
+    }
+}
+
 QTEST_MAIN(QCoreApplicationBenchmark)
 
 #include "main.moc"
@@ -56,6 +56,8 @@ Q_OBJECT
 private slots:
     void signal_slot_benchmark();
     void signal_slot_benchmark_data();
+    void signal_slot_multiple_threads_benchmark_data();
+    void signal_slot_multiple_threads_benchmark();
     void qproperty_benchmark_data();
     void qproperty_benchmark();
     void dynamic_property_benchmark();
@@ -140,6 +142,66 @@ void QObjectBenchmark::signal_slot_benchmark()
     }
 }
 
+class EmittingThread : public QThread
+{
+public:
+    EmittingThread(Object *sender, int count) : sender(sender), count(count) {}
+
+    void run()
+    {
+        for (int i = 0; i < count; ++i)
+            sender->emitSignal0();
+    }
+
+    Object *sender;
+    int count;
+};
+
+void QObjectBenchmark::signal_slot_multiple_threads_benchmark_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<bool>("sharedSender");
+
+    for (int threadCount = 1; threadCount <= 8; threadCount *= 2) {
+        QTest::newRow(qPrintable(QString("%1 threads, shared sender").arg(threadCount)))
+            << threadCount << true;
+        QTest::newRow(qPrintable(QString("%1 threads, one sender each").arg(threadCount)))
+            << threadCount << false;
+    }
+}
+
+void QObjectBenchmark::signal_slot_multiple_threads_benchmark()
+{
+    QFETCH(int, threadCount);
+    QFETCH(bool, sharedSender);
+
+    // every thread emits the same number of times, so the total amount of
+    // work grows with the number of threads
+    const int emissionsPerThread = SignalsAndSlotsBenchmarkConstant / 8;
+
+    Object receiver;
+    QList<Object *> senders;
+    for (int i = 0; i < (sharedSender ? 1 : threadCount); ++i) {
+        Object *sender = new Object;
+        QObject::connect(sender, SIGNAL(signal0()), &receiver, SLOT(slot0()), Qt::DirectConnection);
+        QObject::connect(sender, SIGNAL(signal0()), &receiver, SLOT(slot1()), Qt::DirectConnection);
+        senders << sender;
+    }
+
+    QBENCHMARK {
+        QList<EmittingThread *> threads;
+        for (int i = 0; i < threadCount; ++i)
+            threads << new EmittingThread(senders.at(sharedSender ? 0 : i), emissionsPerThread);
+        foreach (EmittingThread *thread, threads)
+            thread->start();
+        foreach (EmittingThread *thread, threads)
+            thread->wait();
+        qDeleteAll(threads);
+    }
+
+    qDeleteAll(senders);
+}
+
 void QObjectBenchmark::qproperty_benchmark_data()
 {
     QTest::addColumn<QByteArray>("name");
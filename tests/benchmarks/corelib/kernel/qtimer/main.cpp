@@ -0,0 +1,174 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtCore>
+
+#include <qtest.h>
+
+class TimerReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    TimerReceiver() : count(0) {}
+    int count;
+
+protected:
+    void timerEvent(QTimerEvent *)
+    {
+        ++count;
+    }
+};
+
+class tst_QTimer : public QObject
+{
+    Q_OBJECT
+private slots:
+    void registerTimers_data();
+    void registerTimers();
+    void restartTimer_data();
+    void restartTimer();
+    void activateTimers_data();
+    void activateTimers();
+
+private:
+    void startIdleTimers(int count);
+};
+
+enum {
+    // timers that stay pending for the whole benchmark
+    IdleInterval = 3600 * 1000,
+    // the benchmarks pick their own timer ids, clear of the ones the
+    // dispatcher hands out, so that ids are never used up
+    FirstTimerId = 1 << 28
+};
+
+static void addTimerCountRows()
+{
+    QTest::addColumn<int>("timerCount");
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("100000") << 100000;
+    QTest::newRow("1000000") << 1000000;
+}
+
+void tst_QTimer::startIdleTimers(int count)
+{
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance();
+    for (int i = 0; i < count; ++i)
+        dispatcher->registerTimer(FirstTimerId + i, IdleInterval + i, Qt::PreciseTimer, this);
+}
+
+void tst_QTimer::registerTimers_data()
+{
+    addTimerCountRows();
+}
+
+void tst_QTimer::registerTimers()
+{
+    QFETCH(int, timerCount);
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance();
+    TimerReceiver receiver;
+
+    qsrand(1);
+    QVector<int> intervals(timerCount);
+    for (int i = 0; i < timerCount; ++i)
+        intervals[i] = IdleInterval + qrand() % IdleInterval;
+
+    QBENCHMARK {
+        for (int i = 0; i < timerCount; ++i)
+            dispatcher->registerTimer(FirstTimerId + i, intervals.at(i), Qt::PreciseTimer, &receiver);
+        for (int i = 0; i < timerCount; ++i)
+            dispatcher->unregisterTimer(FirstTimerId + i);
+    }
+}
+
+void tst_QTimer::restartTimer_data()
+{
+    addTimerCountRows();
+}
+
+// restarting one timer among many, like resetting a per-connection timeout
+void tst_QTimer::restartTimer()
+{
+    QFETCH(int, timerCount);
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance();
+    startIdleTimers(timerCount);
+
+    qsrand(1);
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            int timerId = FirstTimerId + qrand() % timerCount;
+            dispatcher->unregisterTimer(timerId);
+            dispatcher->registerTimer(timerId, IdleInterval + qrand() % IdleInterval,
+                                      Qt::PreciseTimer, this);
+        }
+    }
+
+    dispatcher->unregisterTimers(this);
+}
+
+void tst_QTimer::activateTimers_data()
+{
+    addTimerCountRows();
+}
+
+// firing 1000 zero-interval timers while many other timers are pending
+void tst_QTimer::activateTimers()
+{
+    QFETCH(int, timerCount);
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance();
+    startIdleTimers(timerCount);
+
+    TimerReceiver receiver;
+    for (int i = 0; i < 1000; ++i)
+        dispatcher->registerTimer(FirstTimerId + timerCount + i, 0, Qt::PreciseTimer, &receiver);
+
+    QBENCHMARK {
+        receiver.count = 0;
+        dispatcher->processEvents(QEventLoop::AllEvents);
+        QCOMPARE(receiver.count, 1000);
+    }
+
+    dispatcher->unregisterTimers(&receiver);
+    dispatcher->unregisterTimers(this);
+}
+
+QTEST_MAIN(tst_QTimer)
+
+#include "main.moc"
@@ -0,0 +1,7 @@
+TEMPLATE      = lib
+CONFIG       += plugin
+QT            = core
+HEADERS       = benchplugin.h benchplugininterface.h
+SOURCES       = benchplugin.cpp
+TARGET        = $$qtLibraryTarget(benchplugin)
+DESTDIR       = ../bin
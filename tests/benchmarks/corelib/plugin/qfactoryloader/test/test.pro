@@ -0,0 +1,7 @@
+TARGET = ../tst_bench_qfactoryloader
+SOURCES += ../tst_bench_qfactoryloader.cpp
+HEADERS += ../plugin/benchplugininterface.h
+
+QT = core core-private testlib
+linux: LIBS += -ldl
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -0,0 +1,185 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qtemporarydir.h>
+#include <private/qfactoryloader_p.h>
+#include "plugin/benchplugininterface.h"
+
+#ifdef Q_OS_LINUX
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <stdarg.h>
+
+// Count the files opened by the process, by interposing the C library's
+// open functions. Only the calls made through the dynamic linker are seen,
+// which is what QFile and QLibrary use.
+static QBasicAtomicInt openedFileCount = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+typedef int (*OpenFunction)(const char *, int, ...);
+
+static int countedOpen(const char *name, const char *path, int flags, va_list args)
+{
+    static OpenFunction realOpen[2] = { 0, 0 };
+    const int which = qstrcmp(name, "open") == 0 ? 0 : 1;
+    if (!realOpen[which])
+        realOpen[which] = (OpenFunction)dlsym(RTLD_NEXT, name);
+
+    openedFileCount.ref();
+    const int mode = (flags & O_CREAT) ? va_arg(args, int) : 0;
+    return realOpen[which](path, flags, mode);
+}
+
+extern "C" Q_DECL_EXPORT int open(const char *path, int flags, ...)
+{
+    va_list args;
+    va_start(args, flags);
+    const int fd = countedOpen("open", path, flags, args);
+    va_end(args);
+    return fd;
+}
+
+extern "C" Q_DECL_EXPORT int open64(const char *path, int flags, ...)
+{
+    va_list args;
+    va_start(args, flags);
+    const int fd = countedOpen("open64", path, flags, args);
+    va_end(args);
+    return fd;
+}
+#endif
+
+class tst_QFactoryLoader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void startup_data();
+    void startup();
+    void openedFiles_data();
+    void openedFiles();
+
+private:
+    void loadPlugins(bool cached);
+
+    QTemporaryDir tempDir;
+    QString cacheFile;
+};
+
+enum { PluginCount = 200 };
+
+static const char pluginFolderC[] = "benchplugins";
+
+void tst_QFactoryLoader::initTestCase()
+{
+    const QString binFolder = QFINDTESTDATA("bin");
+    QVERIFY2(!binFolder.isEmpty(), "Unable to locate 'bin' folder");
+    const QStringList plugins = QDir(binFolder).entryList(QDir::Files);
+    QVERIFY2(!plugins.isEmpty(), "Unable to locate the benchmark plugin");
+    const QString plugin = binFolder + QLatin1Char('/') + plugins.first();
+    const QString suffix = QFileInfo(plugin).suffix();
+
+    QVERIFY(tempDir.isValid());
+    QDir dir(tempDir.path());
+    QVERIFY(dir.mkdir(QLatin1String(pluginFolderC)));
+    for (int i = 0; i < PluginCount; ++i) {
+        const QString copy = QString::fromLatin1("%1/%2/libbenchplugin%3.%4")
+            .arg(tempDir.path()).arg(QLatin1String(pluginFolderC)).arg(i).arg(suffix);
+        QVERIFY(QFile::copy(plugin, copy));
+    }
+
+    // the cache location is read when the first factory loader is created
+    cacheFile = tempDir.path() + QLatin1String("/plugincache");
+    qputenv("QT_PLUGIN_CACHE", QFile::encodeName(cacheFile));
+    QCoreApplication::setLibraryPaths(QStringList(tempDir.path()));
+}
+
+void tst_QFactoryLoader::loadPlugins(bool cached)
+{
+    if (!cached)
+        QFile::remove(cacheFile);
+    QFactoryLoader loader(BenchPluginInterface_iid, QLatin1Char('/') + QLatin1String(pluginFolderC));
+    QCOMPARE(loader.metaData().count(), int(PluginCount));
+}
+
+void tst_QFactoryLoader::startup_data()
+{
+    QTest::addColumn<bool>("cached");
+    QTest::newRow("no cache") << false;
+    QTest::newRow("cache") << true;
+}
+
+void tst_QFactoryLoader::startup()
+{
+    QFETCH(bool, cached);
+
+    loadPlugins(false);
+    QBENCHMARK {
+        loadPlugins(cached);
+    }
+}
+
+void tst_QFactoryLoader::openedFiles_data()
+{
+    startup_data();
+}
+
+void tst_QFactoryLoader::openedFiles()
+{
+#ifdef Q_OS_LINUX
+    QFETCH(bool, cached);
+
+    loadPlugins(false);
+    const int before = openedFileCount.load();
+    loadPlugins(cached);
+    QTest::setBenchmarkResult(openedFileCount.load() - before, QTest::Events);
+#else
+    QSKIP("Counting opened files is only supported on Linux");
+#endif
+}
+
+QTEST_MAIN(tst_QFactoryLoader)
+
+#include "tst_bench_qfactoryloader.moc"
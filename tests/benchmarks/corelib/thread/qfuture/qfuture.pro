@@ -0,0 +1,4 @@
+TEMPLATE = app
+TARGET = tst_bench_qfuture
+QT = core testlib
+SOURCES += tst_qfuture.cpp
@@ -0,0 +1,187 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QtCore>
+#include <QtTest/QtTest>
+
+enum {
+    StageCount = 5,
+    PipelineCount = 1000
+};
+
+static int step(int value)
+{
+    return value + 1;
+}
+
+class StageTask : public QRunnable
+{
+public:
+    explicit StageTask(int input) : input(input) { }
+
+    void run()
+    {
+        futureInterface.reportResult(step(input));
+        futureInterface.reportFinished();
+    }
+
+    QFutureInterface<int> futureInterface;
+    int input;
+};
+
+static QFuture<int> startStage(int input)
+{
+    StageTask *task = new StageTask(input);
+    task->futureInterface.reportStarted();
+    QFuture<int> future = task->futureInterface.future();
+    QThreadPool::globalInstance()->start(task);
+    return future;
+}
+
+// Starts the next stage from the main thread's event loop, once the
+// previous stage has reported its result to the watcher.
+class WatcherPipeline : public QObject
+{
+    Q_OBJECT
+public:
+    WatcherPipeline() : stage(0)
+    {
+        connect(&watcher, SIGNAL(finished()), this, SLOT(stageFinished()));
+    }
+
+    int run()
+    {
+        stage = 1;
+        watcher.setFuture(startStage(0));
+        loop.exec();
+        return watcher.result();
+    }
+
+private slots:
+    void stageFinished()
+    {
+        if (stage == StageCount) {
+            loop.quit();
+            return;
+        }
+        ++stage;
+        watcher.setFuture(startStage(watcher.result()));
+    }
+
+private:
+    QFutureWatcher<int> watcher;
+    QEventLoop loop;
+    int stage;
+};
+
+class tst_QFuture : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void pipeline_data();
+    void pipeline();
+};
+
+enum PipelineType {
+    Continuations,
+    ContextContinuations,
+    Watchers,
+    BlockingWaits
+};
+
+Q_DECLARE_METATYPE(PipelineType)
+
+void tst_QFuture::pipeline_data()
+{
+    QTest::addColumn<PipelineType>("type");
+
+    QTest::newRow("then()") << Continuations;
+    QTest::newRow("then(context)") << ContextContinuations;
+    QTest::newRow("QFutureWatcher") << Watchers;
+    QTest::newRow("waitForFinished()") << BlockingWaits;
+}
+
+// runs PipelineCount pipelines of StageCount stages one after the other, so
+// that the time measures the latency from one stage to the next
+void tst_QFuture::pipeline()
+{
+    QFETCH(PipelineType, type);
+
+    QObject context;
+    QBENCHMARK {
+        for (int i = 0; i < PipelineCount; ++i) {
+            int result = 0;
+            switch (type) {
+            case Continuations:
+                result = startStage(0).then(step).then(step).then(step).then(step).result();
+                break;
+            case ContextContinuations: {
+                QFuture<int> future = startStage(0).then(&context, step).then(&context, step)
+                                                   .then(&context, step).then(&context, step);
+                QEventLoop loop;
+                QFutureWatcher<void> watcher;
+                connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+                watcher.setFuture(future);
+                loop.exec();
+                result = future.result();
+                break;
+            }
+            case Watchers: {
+                WatcherPipeline pipeline;
+                result = pipeline.run();
+                break;
+            }
+            case BlockingWaits: {
+                QFuture<int> future = startStage(0);
+                for (int stage = 1; stage < StageCount; ++stage)
+                    future = startStage(future.result());
+                result = future.result();
+                break;
+            }
+            }
+            QCOMPARE(result, int(StageCount));
+        }
+    }
+}
+
+QTEST_MAIN(tst_QFuture)
+#include "tst_qfuture.moc"
@@ -0,0 +1,170 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QtCore>
+#include <QtTest/QtTest>
+
+enum LockType {
+    Mutex,
+    ReadWriteLock,
+    RecursiveReadWriteLock
+};
+
+Q_DECLARE_METATYPE(LockType)
+
+class SharedData
+{
+public:
+    SharedData(LockType type)
+        : type(type), lock(type == RecursiveReadWriteLock ? QReadWriteLock::Recursive
+                                                           : QReadWriteLock::NonRecursive)
+    {
+        for (int i = 0; i < 100; ++i)
+            hash.insert(i, i);
+    }
+
+    // the read-mostly work done under the lock
+    int read(int key)
+    {
+        if (type == Mutex) {
+            QMutexLocker locker(&mutex);
+            return hash.value(key);
+        }
+        QReadLocker locker(&lock);
+        return hash.value(key);
+    }
+
+    LockType type;
+    QMutex mutex;
+    QReadWriteLock lock;
+    QHash<int, int> hash;
+};
+
+class ReaderThread : public QThread
+{
+public:
+    ReaderThread(SharedData *data, int iterations)
+        : data(data), iterations(iterations), result(0)
+    { }
+
+    void run()
+    {
+        int sum = 0;
+        for (int i = 0; i < iterations; ++i)
+            sum += data->read(i % 100);
+        result = sum;
+    }
+
+    SharedData *data;
+    int iterations;
+    int result;
+};
+
+class tst_QReadWriteLock : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void uncontended_data();
+    void uncontended();
+    void readers_data();
+    void readers();
+};
+
+void tst_QReadWriteLock::uncontended_data()
+{
+    QTest::addColumn<LockType>("type");
+
+    QTest::newRow("QMutex") << Mutex;
+    QTest::newRow("QReadWriteLock") << ReadWriteLock;
+    QTest::newRow("QReadWriteLock (recursive)") << RecursiveReadWriteLock;
+}
+
+void tst_QReadWriteLock::uncontended()
+{
+    QFETCH(LockType, type);
+
+    SharedData data(type);
+    int sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 1000000; ++i)
+            sum += data.read(i % 100);
+    }
+    QVERIFY(sum >= 0);
+}
+
+void tst_QReadWriteLock::readers_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<LockType>("type");
+
+    const int threadCounts[] = { 1, 2, 4, 8, 16 };
+    for (int i = 0; i < int(sizeof(threadCounts) / sizeof(threadCounts[0])); ++i) {
+        const int threadCount = threadCounts[i];
+        const QByteArray name = QByteArray::number(threadCount) + " threads,";
+        QTest::newRow(name + " QMutex") << threadCount << Mutex;
+        QTest::newRow(name + " QReadWriteLock") << threadCount << ReadWriteLock;
+        QTest::newRow(name + " QReadWriteLock (recursive)") << threadCount << RecursiveReadWriteLock;
+    }
+}
+
+// each thread performs the same number of reads, so that perfect scaling
+// keeps the time constant
+void tst_QReadWriteLock::readers()
+{
+    QFETCH(int, threadCount);
+    QFETCH(LockType, type);
+
+    SharedData data(type);
+    QBENCHMARK {
+        QList<ReaderThread *> threads;
+        for (int i = 0; i < threadCount; ++i)
+            threads.append(new ReaderThread(&data, 1000000));
+        foreach (ReaderThread *thread, threads)
+            thread->start();
+        foreach (ReaderThread *thread, threads)
+            thread->wait();
+        qDeleteAll(threads);
+    }
+}
+
+QTEST_MAIN(tst_QReadWriteLock)
+#include "tst_qreadwritelock.moc"
@@ -0,0 +1,4 @@
+TEMPLATE = app
+TARGET = tst_bench_qthreadpool
+QT = core testlib
+SOURCES += tst_qthreadpool.cpp
@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtCore/QtCore>
+#include <QtTest/QtTest>
+
+enum { TaskCount = 1000000 };
+
+static QAtomicInt counter;
+
+class TinyTask : public QRunnable
+{
+public:
+    void run()
+    {
+        counter.ref();
+    }
+};
+
+// Covers [begin, end): starts a task for the upper half of the range and
+// keeps the lower half, until a single element is left, so that exactly
+// end - begin tasks run.
+class SplittingTask : public QRunnable
+{
+public:
+    SplittingTask(QThreadPool *pool, int begin, int end)
+        : pool(pool), begin(begin), end(end)
+    { }
+
+    void run()
+    {
+        while (end - begin > 1) {
+            const int middle = begin + (end - begin) / 2;
+            pool->start(new SplittingTask(pool, middle, end));
+            end = middle;
+        }
+        counter.ref();
+    }
+
+private:
+    QThreadPool *pool;
+    int begin;
+    int end;
+};
+
+class tst_QThreadPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void startFromMainThread();
+    void startFromPoolThreads_data();
+    void startFromPoolThreads();
+};
+
+void tst_QThreadPool::startFromMainThread()
+{
+    QBENCHMARK {
+        counter.store(0);
+        QThreadPool pool;
+        for (int i = 0; i < TaskCount; ++i)
+            pool.start(new TinyTask);
+        pool.waitForDone();
+        QCOMPARE(counter.load(), int(TaskCount));
+    }
+}
+
+void tst_QThreadPool::startFromPoolThreads_data()
+{
+    QTest::addColumn<bool>("workStealing");
+
+    QTest::newRow("shared queue") << false;
+    QTest::newRow("work stealing") << true;
+}
+
+void tst_QThreadPool::startFromPoolThreads()
+{
+    QFETCH(bool, workStealing);
+
+    QBENCHMARK {
+        counter.store(0);
+        QThreadPool pool;
+        pool.setWorkStealingEnabled(workStealing);
+        pool.start(new SplittingTask(&pool, 0, TaskCount));
+        pool.waitForDone();
+        QCOMPARE(counter.load(), int(TaskCount));
+    }
+}
+
+QTEST_MAIN(tst_QThreadPool)
+#include "tst_qthreadpool.moc"
@@ -1,4 +1,7 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        qfuture \
         qmutex \
+        qreadwritelock \
+        qthreadpool \
         qthreadstorage
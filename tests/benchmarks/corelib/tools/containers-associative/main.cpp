@@ -39,9 +39,24 @@
 **
 ****************************************************************************/
 #include <QString>
+#include <QHash>
+#include <QFlatHash>
+#include <QMap>
 
 #include <qtest.h>
 
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+enum ContainerType {
+    Hash,
+    FlatHash,
+    Map
+};
+
+Q_DECLARE_METATYPE(ContainerType)
+
 class tst_associative_containers : public QObject
 {
     Q_OBJECT
@@ -50,8 +65,27 @@ private slots:
     void insert();
     void lookup_data();
     void lookup();
+    void iterate_data();
+    void iterate();
+    void memory_data();
+    void memory();
 };
 
+static void addContainerRows()
+{
+    QTest::addColumn<ContainerType>("type");
+    QTest::addColumn<int>("size");
+
+    for (int size = 10; size < 20000; size += 100) {
+
+        const QByteArray sizeString = QByteArray::number(size);
+
+        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << Hash << size;
+        QTest::newRow(QByteArray("flathash--" + sizeString).constData()) << FlatHash << size;
+        QTest::newRow(QByteArray("map--" + sizeString).constData()) << Map << size;
+    }
+}
+
 template <typename T> 
 void testInsert(int size)
 {
@@ -65,30 +99,24 @@ void testInsert(int size)
 
 void tst_associative_containers::insert_data()
 {
-    QTest::addColumn<bool>("useHash");
-    QTest::addColumn<int>("size");
-
-    for (int size = 10; size < 20000; size += 100) {
-    
-        const QByteArray sizeString = QByteArray::number(size);
-
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
-    }
+    addContainerRows();
 }
 
 void tst_associative_containers::insert()
 {
-    QFETCH(bool, useHash);
+    QFETCH(ContainerType, type);
     QFETCH(int, size);
 
-    QHash<int, int> testHash;
-    QMap<int, int> testMap;
-
-    if (useHash) {
-        testInsert<QHash<int, int> >(size);        
-    } else {
-        testInsert<QMap<int, int> >(size);        
+    switch (type) {
+    case Hash:
+        testInsert<QHash<int, int> >(size);
+        break;
+    case FlatHash:
+        testInsert<QFlatHash<int, int> >(size);
+        break;
+    case Map:
+        testInsert<QMap<int, int> >(size);
+        break;
     }
 }
 
@@ -97,16 +125,7 @@ void tst_associative_containers::lookup_data()
 //    setReportType(LineChartReport);
 //    setChartTitle("Time to call value(), with an increasing number of items in the container");
 
-    QTest::addColumn<bool>("useHash");
-    QTest::addColumn<int>("size");
-
-    for (int size = 10; size < 20000; size += 100) {
-    
-        const QByteArray sizeString = QByteArray::number(size);
-
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
-    }
+    addContainerRows();
 }
 
 template <typename T> 
@@ -128,14 +147,119 @@ void testLookup(int size)
 
 void tst_associative_containers::lookup()
 {
-    QFETCH(bool, useHash);
+    QFETCH(ContainerType, type);
     QFETCH(int, size);
 
-    if (useHash) {
+    switch (type) {
+    case Hash:
         testLookup<QHash<int, int> >(size);
-    } else {
+        break;
+    case FlatHash:
+        testLookup<QFlatHash<int, int> >(size);
+        break;
+    case Map:
         testLookup<QMap<int, int> >(size);
+        break;
+    }
+}
+
+void tst_associative_containers::iterate_data()
+{
+    addContainerRows();
+}
+
+template <typename T>
+void testIterate(int size)
+{
+    T container;
+
+    for (int i = 0; i < size; ++i)
+        container.insert(i, i);
+
+    int sum = 0;
+
+    QBENCHMARK {
+        for (typename T::const_iterator it = container.constBegin(); it != container.constEnd(); ++it)
+            sum += it.value();
+    }
+    Q_UNUSED(sum);
+}
+
+void tst_associative_containers::iterate()
+{
+    QFETCH(ContainerType, type);
+    QFETCH(int, size);
+
+    switch (type) {
+    case Hash:
+        testIterate<QHash<int, int> >(size);
+        break;
+    case FlatHash:
+        testIterate<QFlatHash<int, int> >(size);
+        break;
+    case Map:
+        testIterate<QMap<int, int> >(size);
+        break;
+    }
+}
+
+void tst_associative_containers::memory_data()
+{
+    QTest::addColumn<ContainerType>("type");
+    QTest::addColumn<int>("size");
+
+    for (int size = 1000; size <= 1000000; size *= 10) {
+
+        const QByteArray sizeString = QByteArray::number(size);
+
+        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << Hash << size;
+        QTest::newRow(QByteArray("flathash--" + sizeString).constData()) << FlatHash << size;
+        QTest::newRow(QByteArray("map--" + sizeString).constData()) << Map << size;
+    }
+}
+
+#if defined(__GLIBC__)
+static qint64 heapInUse()
+{
+    struct mallinfo info = mallinfo();
+    return qint64(info.uordblks) + qint64(info.hblkhd);
+}
+
+template <typename T>
+void testMemory(int size)
+{
+    const qint64 before = heapInUse();
+    T container;
+    for (int i = 0; i < size; ++i)
+        container.insert(i, i);
+    const qint64 after = heapInUse();
+
+    QTest::setBenchmarkResult(after - before, QTest::BytesAllocated);
+}
+#endif
+
+// reports the heap memory held by a container of int pairs after
+// inserting size items
+void tst_associative_containers::memory()
+{
+#if defined(__GLIBC__)
+    QFETCH(ContainerType, type);
+    QFETCH(int, size);
+
+    switch (type) {
+    case Hash:
+        testMemory<QHash<int, int> >(size);
+        break;
+    case FlatHash:
+        testMemory<QFlatHash<int, int> >(size);
+        break;
+    case Map:
+        testMemory<QMap<int, int> >(size);
+        break;
     }
+#else
+    QSKIP("This test needs mallinfo()");
+#endif
 }
 
 QTEST_MAIN(tst_associative_containers)
@@ -47,6 +47,7 @@
 #include <sstream>
 #include <algorithm>
 #include <qalgorithms.h>
+#include <qtconcurrentsort.h>
 #include <QStringList>
 #include <QString>
 #include <QVector>
@@ -62,6 +63,13 @@ private slots:
 
     void sort_data();
     void sort();
+
+    void parallelSort_data();
+    void parallelSort();
+    void parallelStableSort_data();
+    void parallelStableSort();
+    void parallelMerge_data();
+    void parallelMerge();
 };
 
 template <typename DataType>
@@ -135,6 +143,80 @@ void tst_QAlgorithms::sort()
     }
 }
 
+void tst_QAlgorithms::parallelSort_data()
+{
+    const int dataSize = 2000000;
+    QTest::addColumn<QVector<int> >("unsorted");
+    QTest::addColumn<bool>("parallel");
+    const QVector<int> random = generateData<int>("Random", dataSize);
+    const QVector<int> almostSorted = generateData<int>("Almost Sorted", dataSize);
+    QTest::newRow("Random, serial") << random << false;
+    QTest::newRow("Random, parallel") << random << true;
+    QTest::newRow("Almost Sorted, serial") << almostSorted << false;
+    QTest::newRow("Almost Sorted, parallel") << almostSorted << true;
+}
+
+void tst_QAlgorithms::parallelSort()
+{
+    QFETCH(QVector<int>, unsorted);
+    QFETCH(bool, parallel);
+
+    QBENCHMARK {
+        QVector<int> sorted = unsorted;
+        if (parallel)
+            QtConcurrent::blockingSort(sorted.begin(), sorted.end());
+        else
+            qSort(sorted.begin(), sorted.end());
+    }
+}
+
+void tst_QAlgorithms::parallelStableSort_data()
+{
+    parallelSort_data();
+}
+
+void tst_QAlgorithms::parallelStableSort()
+{
+    QFETCH(QVector<int>, unsorted);
+    QFETCH(bool, parallel);
+
+    QBENCHMARK {
+        QVector<int> sorted = unsorted;
+        if (parallel)
+            QtConcurrent::blockingStableSort(sorted.begin(), sorted.end());
+        else
+            qStableSort(sorted.begin(), sorted.end());
+    }
+}
+
+void tst_QAlgorithms::parallelMerge_data()
+{
+    QTest::addColumn<bool>("parallel");
+    QTest::newRow("serial") << false;
+    QTest::newRow("parallel") << true;
+}
+
+void tst_QAlgorithms::parallelMerge()
+{
+    QFETCH(bool, parallel);
+
+    const int dataSize = 2000000;
+    QVector<int> first = generateData<int>("Random", dataSize);
+    QVector<int> second = generateData<int>("Random", dataSize);
+    qSort(first);
+    qSort(second);
+
+    QVector<int> merged(2 * dataSize);
+    QBENCHMARK {
+        if (parallel)
+            QtConcurrent::blockingMerge(first.constBegin(), first.constEnd(),
+                                        second.constBegin(), second.constEnd(),
+                                        merged.begin());
+        else
+            std::merge(first.constBegin(), first.constEnd(),
+                       second.constBegin(), second.constEnd(), merged.begin());
+    }
+}
 
 QTEST_MAIN(tst_QAlgorithms)
 #include "tst_qalgorithms.moc"
@@ -0,0 +1,177 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QArrayDataArena>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+
+#include <qtest.h>
+
+class tst_QArrayDataArena : public QObject
+{
+    Q_OBJECT
+public:
+    tst_QArrayDataArena();
+
+private slots:
+    void handleRequest_data();
+    void handleRequest();
+    void handleRequestThreaded_data();
+    void handleRequestThreaded();
+
+private:
+    QByteArray request;
+};
+
+// Something that looks like an HTTP request with a form body.
+tst_QArrayDataArena::tst_QArrayDataArena()
+{
+    request = "POST /cgi-bin/process HTTP/1.1\r\n"
+              "Host: www.example.com\r\n"
+              "User-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n"
+              "Accept: text/html,application/xhtml+xml\r\n"
+              "Accept-Language: en-us,en;q=0.5\r\n"
+              "Content-Type: application/x-www-form-urlencoded\r\n"
+              "\r\n";
+    for (int i = 0; i < 50; ++i)
+        request += "field" + QByteArray::number(i) + '=' + QByteArray::number(i * 37) + '&';
+}
+
+// Parses the request and builds a reply from many temporary strings,
+// which is the allocation pattern the arena is made for.
+static QByteArray process(const QByteArray &request)
+{
+    QList<QByteArray> lines = request.split('\n');
+    QHash<QString, QString> headers;
+    for (int i = 1; i < lines.size(); ++i) {
+        const QByteArray line = lines.at(i).trimmed();
+        const int colon = line.indexOf(':');
+        if (colon > 0)
+            headers.insert(QString::fromLatin1(line.left(colon)).toLower(),
+                           QString::fromLatin1(line.mid(colon + 1)).trimmed());
+    }
+
+    QVector<int> values;
+    const QList<QByteArray> fields = lines.last().split('&');
+    for (int i = 0; i < fields.size(); ++i) {
+        const QList<QByteArray> pair = fields.at(i).split('=');
+        if (pair.size() == 2)
+            values.append(pair.at(1).toInt());
+    }
+
+    QString reply = QLatin1String("<html><body><p>")
+            + headers.value(QLatin1String("host"))
+            + QLatin1String("</p><ul>");
+    for (int i = 0; i < values.size(); ++i)
+        reply += QLatin1String("<li>") + QString::number(values.at(i)) + QLatin1String("</li>");
+    reply += QLatin1String("</ul></body></html>");
+    return reply.toUtf8();
+}
+
+static QByteArray processInArena(const QByteArray &request)
+{
+    QArrayDataArena arena;
+    return process(request);
+}
+
+void tst_QArrayDataArena::handleRequest_data()
+{
+    QTest::addColumn<bool>("useArena");
+
+    QTest::newRow("heap") << false;
+    QTest::newRow("arena") << true;
+}
+
+void tst_QArrayDataArena::handleRequest()
+{
+    QFETCH(bool, useArena);
+
+    QByteArray reply;
+    QBENCHMARK {
+        reply = useArena ? processInArena(request) : process(request);
+    }
+    QVERIFY(reply.endsWith("</ul></body></html>"));
+}
+
+class RequestThread : public QThread
+{
+public:
+    RequestThread(const QByteArray &request, bool useArena)
+        : request(request), useArena(useArena)
+    {}
+
+    QByteArray request;
+    bool useArena;
+
+protected:
+    void run()
+    {
+        for (int i = 0; i < 200; ++i)
+            (void)(useArena ? processInArena(request) : process(request));
+    }
+};
+
+void tst_QArrayDataArena::handleRequestThreaded_data()
+{
+    handleRequest_data();
+}
+
+void tst_QArrayDataArena::handleRequestThreaded()
+{
+    QFETCH(bool, useArena);
+
+    const int threadCount = qMax(4, QThread::idealThreadCount());
+    QBENCHMARK {
+        QList<RequestThread *> threads;
+        for (int i = 0; i < threadCount; ++i) {
+            threads.append(new RequestThread(request, useArena));
+            threads.last()->start();
+        }
+        for (int i = 0; i < threadCount; ++i) {
+            threads.at(i)->wait();
+            delete threads.at(i);
+        }
+    }
+}
+
+QTEST_MAIN(tst_QArrayDataArena)
+
+#include "main.moc"
@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tst_bench_qarraydataarena
+
+QT = core testlib
+CONFIG += release
+
+SOURCES += main.cpp
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0
@@ -0,0 +1,155 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QCache>
+#include <QConcurrentCache>
+#include <QMutex>
+#include <QThread>
+
+#include <qtest.h>
+
+class tst_QConcurrentCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void lookup_data();
+    void lookup();
+};
+
+// The alternative without QConcurrentCache: one QCache behind one mutex.
+class LockedCache
+{
+public:
+    LockedCache(int maxCost) : cache(maxCost) {}
+
+    bool insert(int key, const QString &value, int cost)
+    {
+        QMutexLocker locker(&mutex);
+        return cache.insert(key, new QString(value), cost);
+    }
+
+    bool lookup(int key, QString *value)
+    {
+        QMutexLocker locker(&mutex);
+        if (QString *object = cache.object(key)) {
+            *value = *object;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    QMutex mutex;
+    QCache<int, QString> cache;
+};
+
+enum { KeyCount = 10000, OperationsPerThread = 200000 };
+
+template <typename Cache>
+class LookupThread : public QThread
+{
+public:
+    LookupThread(Cache *cache, int seed) : cache(cache), seed(seed) {}
+
+protected:
+    void run()
+    {
+        // 90% lookups, the misses inserting the value
+        quint32 state = seed;
+        QString value;
+        for (int i = 0; i < OperationsPerThread; ++i) {
+            state = state * 1103515245 + 12345;
+            const int key = (state >> 8) % KeyCount;
+            if (!cache->lookup(key, &value))
+                cache->insert(key, QString::number(key), 1);
+        }
+    }
+
+private:
+    Cache *cache;
+    int seed;
+};
+
+template <typename Cache>
+static void runThreads(Cache *cache, int threadCount)
+{
+    QList<QThread *> threads;
+    for (int i = 0; i < threadCount; ++i)
+        threads.append(new LookupThread<Cache>(cache, i + 1));
+    for (int i = 0; i < threadCount; ++i)
+        threads.at(i)->start();
+    for (int i = 0; i < threadCount; ++i)
+        threads.at(i)->wait();
+    qDeleteAll(threads);
+}
+
+void tst_QConcurrentCache::lookup_data()
+{
+    QTest::addColumn<bool>("concurrent");
+    QTest::addColumn<int>("threadCount");
+
+    const int ideal = qMax(2, QThread::idealThreadCount());
+    QTest::newRow("QCache+QMutex, 1 thread") << false << 1;
+    QTest::newRow("QConcurrentCache, 1 thread") << true << 1;
+    QTest::newRow("QCache+QMutex, all threads") << false << ideal;
+    QTest::newRow("QConcurrentCache, all threads") << true << ideal;
+}
+
+void tst_QConcurrentCache::lookup()
+{
+    QFETCH(bool, concurrent);
+    QFETCH(int, threadCount);
+
+    const int maxCost = KeyCount * 9 / 10;
+    QBENCHMARK {
+        if (concurrent) {
+            QConcurrentCache<int, QString> cache(maxCost);
+            runThreads(&cache, threadCount);
+        } else {
+            LockedCache cache(maxCost);
+            runThreads(&cache, threadCount);
+        }
+    }
+}
+
+QTEST_MAIN(tst_QConcurrentCache)
+
+#include "main.moc"
@@ -55,11 +55,16 @@ class tst_QHash : public QObject
 
 private slots:
     void initTestCase();
+    void qhash_current_data() { data(); }
+    void qhash_current();
     void qhash_qt4_data() { data(); }
     void qhash_qt4();
     void javaString_data() { data(); }
     void javaString();
 
+    void hashing_data();
+    void hashing();
+
 private:
     void data();
 
@@ -133,6 +138,20 @@ void tst_QHash::data()
     QTest::newRow("numbers") << numbers;
 }
 
+// Run with QT_NO_CPU_FEATURE=sse4.2 to measure the portable hash function,
+// and with QT_HASH_KEYED=1 to measure the keyed one.
+void tst_QHash::qhash_current()
+{
+    QFETCH(QStringList, items);
+    QHash<QString, int> hash;
+
+    QBENCHMARK {
+        for (int i = 0, n = items.size(); i != n; ++i) {
+            hash[items.at(i)] = i;
+        }
+    }
+}
+
 void tst_QHash::qhash_qt4()
 {
     QFETCH(QStringList, items);
@@ -165,6 +184,76 @@ void tst_QHash::javaString()
     }
 }
 
+enum HashFunction {
+    CurrentString,
+    CurrentByteArray,
+    Qt4,
+    Java
+};
+
+Q_DECLARE_METATYPE(HashFunction)
+
+void tst_QHash::hashing_data()
+{
+    QTest::addColumn<HashFunction>("function");
+    QTest::addColumn<int>("length");
+
+    static const int lengths[] = { 8, 32, 128, 1024 };
+    for (uint i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        const QByteArray length = QByteArray::number(lengths[i]);
+        QTest::newRow(QByteArray("QString-" + length).constData()) << CurrentString << lengths[i];
+        QTest::newRow(QByteArray("QByteArray-" + length).constData()) << CurrentByteArray << lengths[i];
+        QTest::newRow(QByteArray("qt4-" + length).constData()) << Qt4 << lengths[i];
+        QTest::newRow(QByteArray("java-" + length).constData()) << Java << lengths[i];
+    }
+}
+
+// hashes 1000 keys of the given length, like long URLs or file paths
+void tst_QHash::hashing()
+{
+    QFETCH(HashFunction, function);
+    QFETCH(int, length);
+
+    QStringList strings;
+    QList<QByteArray> byteArrays;
+    for (int i = 0; i < 1000; ++i) {
+        QString s = QString::fromLatin1("/usr/share/doc/package-%1/").arg(i);
+        while (s.length() < length)
+            s += QString::fromLatin1("subdirectory%1/").arg(s.length());
+        s.truncate(length);
+        strings.append(s);
+        byteArrays.append(s.toLatin1());
+    }
+
+    uint h = 0;
+    switch (function) {
+    case CurrentString:
+        QBENCHMARK {
+            for (int i = 0; i < strings.size(); ++i)
+                h ^= qHash(strings.at(i));
+        }
+        break;
+    case CurrentByteArray:
+        QBENCHMARK {
+            for (int i = 0; i < byteArrays.size(); ++i)
+                h ^= qHash(byteArrays.at(i));
+        }
+        break;
+    case Qt4:
+        QBENCHMARK {
+            for (int i = 0; i < strings.size(); ++i)
+                h ^= qHash(static_cast<const Qt4String &>(strings.at(i)));
+        }
+        break;
+    case Java:
+        QBENCHMARK {
+            for (int i = 0; i < strings.size(); ++i)
+                h ^= qHash(static_cast<const JavaString &>(strings.at(i)));
+        }
+        break;
+    }
+    Q_UNUSED(h);
+}
 
 QTEST_MAIN(tst_QHash)
 
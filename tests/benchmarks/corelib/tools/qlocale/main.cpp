@@ -0,0 +1,244 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QFile>
+#include <QLocale>
+#include <qnumeric.h>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <qtest.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+Q_DECLARE_METATYPE(QList<QByteArray>)
+Q_DECLARE_METATYPE(QVector<double>)
+
+class tst_QLocale : public QObject
+{
+    Q_OBJECT
+private slots:
+    void toDouble_data();
+    void toDouble();
+    void toString_data();
+    void toString();
+};
+
+// A simple deterministic generator, so that every run uses the same numbers
+static quint32 nextRandom(quint32 *state)
+{
+    *state = *state * 1103515245 + 12345;
+    return *state >> 1;
+}
+
+static double randomDouble(quint32 *state)
+{
+    const quint64 bits = (quint64(nextRandom(state)) << 33) ^ (quint64(nextRandom(state)) << 2)
+                         ^ nextRandom(state);
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return qIsNaN(d) || qIsInf(d) ? 1.0 : d;
+}
+
+// The numbers found in the JSON benchmark data, repeated
+static QList<QByteArray> jsonNumbers()
+{
+    QFile file(QFINDTESTDATA("../../json/numbers.json"));
+    QList<QByteArray> numbers;
+    if (!file.open(QIODevice::ReadOnly))
+        return numbers;
+
+    const QByteArray json = file.readAll();
+    for (int i = 0; i < json.size(); ) {
+        const char c = json.at(i);
+        if (c == '"') {
+            i = json.indexOf('"', i + 1) + 1;
+            if (i == 0)
+                break;
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            int end = i + 1;
+            while (end < json.size() && strchr("0123456789.eE+-", json.at(end)))
+                ++end;
+            numbers << json.mid(i, end - i);
+            i = end;
+        } else {
+            ++i;
+        }
+    }
+
+    QList<QByteArray> result;
+    while (!numbers.isEmpty() && result.size() < 1000)
+        result += numbers;
+    return result;
+}
+
+static QList<QByteArray> generatedNumbers(const char *format, int kind)
+{
+    quint32 state = 1;
+    QList<QByteArray> numbers;
+    char buffer[64];
+    for (int i = 0; i < 1000; ++i) {
+        double d;
+        switch (kind) {
+        case 0: // prices
+            d = (nextRandom(&state) % 10000000) / 100.0;
+            break;
+        case 1: // measurements
+            d = (nextRandom(&state) % 2000000 - 1000000) * 1e-7;
+            break;
+        default: // anything
+            d = randomDouble(&state);
+            break;
+        }
+        qsnprintf(buffer, sizeof(buffer), format, d);
+        numbers << QByteArray(buffer);
+    }
+    return numbers;
+}
+
+void tst_QLocale::toDouble_data()
+{
+    QTest::addColumn<QList<QByteArray> >("numbers");
+    QTest::addColumn<int>("method");
+
+    const QList<QByteArray> json = jsonNumbers();
+    const QList<QByteArray> prices = generatedNumbers("%.2f", 0);
+    const QList<QByteArray> measurements = generatedNumbers("%.7g", 1);
+    const QList<QByteArray> exact = generatedNumbers("%.17g", 2);
+
+    for (int method = 0; method < 3; ++method) {
+        const char *name = method == 0 ? "QByteArray" : method == 1 ? "QLocale" : "strtod";
+        if (!json.isEmpty())
+            QTest::newRow(QByteArray(name) + ": numbers.json") << json << method;
+        QTest::newRow(QByteArray(name) + ": prices") << prices << method;
+        QTest::newRow(QByteArray(name) + ": measurements") << measurements << method;
+        QTest::newRow(QByteArray(name) + ": round-trip") << exact << method;
+    }
+}
+
+void tst_QLocale::toDouble()
+{
+    QFETCH(QList<QByteArray>, numbers);
+    QFETCH(int, method);
+
+    const QLocale c = QLocale::c();
+    QStringList strings;
+    foreach (const QByteArray &number, numbers)
+        strings << QString::fromLatin1(number);
+
+    double sum = 0;
+    switch (method) {
+    case 0:
+        QBENCHMARK {
+            foreach (const QByteArray &number, numbers)
+                sum += number.toDouble();
+        }
+        break;
+    case 1:
+        QBENCHMARK {
+            foreach (const QString &string, strings)
+                sum += c.toDouble(string);
+        }
+        break;
+    default:
+        QBENCHMARK {
+            foreach (const QByteArray &number, numbers)
+                sum += strtod(number.constData(), 0);
+        }
+        break;
+    }
+    QVERIFY(sum == sum);
+}
+
+void tst_QLocale::toString_data()
+{
+    QTest::addColumn<QVector<double> >("numbers");
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+    QTest::addColumn<bool>("useSnprintf");
+
+    quint32 state = 1;
+    QVector<double> prices, anything;
+    for (int i = 0; i < 1000; ++i) {
+        prices << (nextRandom(&state) % 10000000) / 100.0;
+        anything << randomDouble(&state);
+    }
+
+    QTest::newRow("prices 'f' 2") << prices << 'f' << 2 << false;
+    QTest::newRow("prices 'g' 6") << prices << 'g' << 6 << false;
+    QTest::newRow("prices shortest") << prices << 'g' << int(QLocale::FloatingPointShortest) << false;
+    QTest::newRow("prices snprintf %.2f") << prices << 'f' << 2 << true;
+    QTest::newRow("anything 'g' 6") << anything << 'g' << 6 << false;
+    QTest::newRow("anything 'g' 17") << anything << 'g' << 17 << false;
+    QTest::newRow("anything 'e' 10") << anything << 'e' << 10 << false;
+    QTest::newRow("anything shortest") << anything << 'g' << int(QLocale::FloatingPointShortest) << false;
+    QTest::newRow("anything snprintf %.17g") << anything << 'g' << 17 << true;
+}
+
+void tst_QLocale::toString()
+{
+    QFETCH(QVector<double>, numbers);
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    QFETCH(bool, useSnprintf);
+
+    int length = 0;
+    if (useSnprintf) {
+        char spec[8] = { '%', '.', char('0' + precision / 10), char('0' + precision % 10),
+                         format, '\0' };
+        char buffer[400];
+        QBENCHMARK {
+            foreach (double d, numbers)
+                length += qsnprintf(buffer, sizeof(buffer), spec, d);
+        }
+    } else {
+        QBENCHMARK {
+            foreach (double d, numbers)
+                length += QString::number(d, format, precision).length();
+        }
+    }
+    QVERIFY(length > 0);
+}
+
+QTEST_MAIN(tst_QLocale)
+
+#include "main.moc"
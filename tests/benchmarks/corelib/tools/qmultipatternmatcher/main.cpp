@@ -0,0 +1,193 @@
+/****************************************************************************
+**
+** Copyright (C) 2012 Digia Plc and/or its subsidiary(-ies).
+** Contact: http://www.qt-project.org/legal
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and Digia.  For licensing terms and
+** conditions see http://qt.digia.com/licensing.  For further information
+** use the contact form at http://qt.digia.com/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 2.1 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU Lesser General Public License version 2.1 requirements
+** will be met: http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Digia gives you certain additional
+** rights.  These rights are described in the Digia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3.0 as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL included in the
+** packaging of this file.  Please review the following information to
+** ensure the GNU General Public License version 3.0 requirements will be
+** met: http://www.gnu.org/copyleft/gpl.html.
+**
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QByteArrayMatcher>
+#include <QMultiPatternMatcher>
+#include <QStringList>
+#include <QStringMatcher>
+
+#include <qtest.h>
+
+class tst_QMultiPatternMatcher : public QObject
+{
+    Q_OBJECT
+public:
+    tst_QMultiPatternMatcher();
+
+private slots:
+    void findAll_data();
+    void findAll();
+    void singlePattern_data();
+    void singlePattern();
+
+private:
+    QByteArray log;
+    QStringList keywords;
+};
+
+// Made up words of 4 to 11 letters
+static QString randomWord()
+{
+    QString word;
+    const int length = 4 + qrand() % 8;
+    for (int i = 0; i < length; ++i)
+        word += QChar('a' + qrand() % 26);
+    return word;
+}
+
+tst_QMultiPatternMatcher::tst_QMultiPatternMatcher()
+{
+    qsrand(1);
+    for (int i = 0; i < 500; ++i)
+        keywords << randomWord();
+
+    // About 1 MB of log lines, a few of them containing a keyword
+    QStringList words;
+    for (int i = 0; i < 2000; ++i)
+        words << randomWord();
+    int line = 0;
+    while (log.size() < 1024 * 1024) {
+        log += "2013-01-01 12:00:00.000 [worker-" + QByteArray::number(line % 8) + "] ";
+        const int wordCount = 5 + qrand() % 10;
+        for (int i = 0; i < wordCount; ++i) {
+            if (qrand() % 200 == 0)
+                log += keywords.at(qrand() % keywords.size()).toLatin1();
+            else
+                log += words.at(qrand() % words.size()).toLatin1();
+            log += ' ';
+        }
+        log += '\n';
+        ++line;
+    }
+}
+
+void tst_QMultiPatternMatcher::findAll_data()
+{
+    QTest::addColumn<int>("patternCount");
+    QTest::addColumn<int>("method");
+
+    const int counts[] = { 1, 10, 100, 500 };
+    for (uint i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+        const QByteArray count = QByteArray::number(counts[i]);
+        QTest::newRow(count + " patterns, QByteArrayMatcher") << counts[i] << 0;
+        QTest::newRow(count + " patterns, QMultiPatternMatcher") << counts[i] << 1;
+        QTest::newRow(count + " patterns, QMultiPatternMatcher, QString") << counts[i] << 2;
+        QTest::newRow(count + " patterns, QMultiPatternMatcher, case insensitive") << counts[i] << 3;
+    }
+}
+
+void tst_QMultiPatternMatcher::findAll()
+{
+    QFETCH(int, patternCount);
+    QFETCH(int, method);
+
+    const QStringList patterns = keywords.mid(0, patternCount);
+    int found = 0;
+
+    if (method == 0) {
+        QList<QByteArrayMatcher> matchers;
+        foreach (const QString &pattern, patterns)
+            matchers << QByteArrayMatcher(pattern.toLatin1());
+        QBENCHMARK {
+            found = 0;
+            foreach (const QByteArrayMatcher &matcher, matchers) {
+                for (int i = matcher.indexIn(log); i >= 0; i = matcher.indexIn(log, i + 1))
+                    ++found;
+            }
+        }
+    } else if (method == 1 || method == 3) {
+        const QMultiPatternMatcher matcher(patterns, method == 3 ? Qt::CaseInsensitive
+                                                                 : Qt::CaseSensitive);
+        QBENCHMARK {
+            found = 0;
+            for (int i = matcher.indexIn(log); i >= 0; i = matcher.indexIn(log, i + 1))
+                ++found;
+        }
+    } else {
+        const QMultiPatternMatcher matcher(patterns);
+        const QString text = QString::fromLatin1(log);
+        QBENCHMARK {
+            found = 0;
+            for (int i = matcher.indexIn(text); i >= 0; i = matcher.indexIn(text, i + 1))
+                ++found;
+        }
+    }
+    QVERIFY(found > 0);
+}
+
+void tst_QMultiPatternMatcher::singlePattern_data()
+{
+    QTest::addColumn<QByteArray>("pattern");
+    QTest::addColumn<bool>("useString");
+
+    const char *patterns[] = { "[worker-9]", "ZQ", "ZQX", "ZQXJKVWB", "ZQXJKVWBZQXJKVWB",
+                               "ZQXJKVWBZQXJKVWBZQXJKVWBZQXJKVWB" };
+    for (uint i = 0; i < sizeof(patterns) / sizeof(patterns[0]); ++i) {
+        const QByteArray pattern(patterns[i]);
+        QTest::newRow("QByteArrayMatcher " + pattern) << pattern << false;
+        QTest::newRow("QStringMatcher " + pattern) << pattern << true;
+    }
+}
+
+// Patterns that don't occur, so the whole log is searched
+void tst_QMultiPatternMatcher::singlePattern()
+{
+    QFETCH(QByteArray, pattern);
+    QFETCH(bool, useString);
+
+    int index = 0;
+    if (useString) {
+        const QStringMatcher matcher(QString::fromLatin1(pattern));
+        const QString text = QString::fromLatin1(log);
+        QBENCHMARK {
+            index = matcher.indexIn(text);
+        }
+    } else {
+        const QByteArrayMatcher matcher(pattern);
+        QBENCHMARK {
+            index = matcher.indexIn(log);
+        }
+    }
+    QCOMPARE(index, -1);
+}
+
+QTEST_MAIN(tst_QMultiPatternMatcher)
+
+#include "main.moc"
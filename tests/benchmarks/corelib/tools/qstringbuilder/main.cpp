@@ -413,6 +413,54 @@ private slots:
         COMPARE(r, r4);
     }
 
+
+    void separator_10() { SEP("arg() with several arguments, and numbers"); }
+
+    void q_chained_arg() {
+        const QString pattern = QLatin1String("%1: %2 [%3] %4");
+        QBENCHMARK { r = pattern.arg(string).arg(l1string).arg(string).arg(l1string); }
+        COMPARE(r, QString(string P QLatin1String(": ") P string P QLatin1String(" [") P string
+                           P QLatin1String("] ") P string));
+    }
+
+    void q_multi_arg() {
+        const QString pattern = QLatin1String("%1: %2 [%3] %4");
+        const QString l1 = l1string;
+        QBENCHMARK { r = pattern.arg(string, l1, string, l1); }
+        COMPARE(r, QString(string P QLatin1String(": ") P string P QLatin1String(" [") P string
+                           P QLatin1String("] ") P string));
+    }
+
+    void q_chained_arg_numbers() {
+        const QString pattern = QLatin1String("%1:%2 took %3 ms");
+        QBENCHMARK { r = pattern.arg(string).arg(1234).arg(0.125, 0, 'f', 3); }
+        COMPARE(r, QString(string P QLatin1String(":1234 took 0.125 ms")));
+    }
+
+    void q_multi_arg_numbers() {
+        const QString pattern = QLatin1String("%1:%2 took %3 ms");
+        QBENCHMARK {
+            r = pattern.arg(string, QString::number(1234), QString::number(0.125, 'f', 3));
+        }
+        COMPARE(r, QString(string P QLatin1String(":1234 took 0.125 ms")));
+    }
+
+    void q_numbers() {
+        QBENCHMARK {
+            r = string + QLatin1Char(':') + QString::number(1234) + QLatin1String(" took ")
+                + QString::number(0.125, 'f', 3) + QLatin1String(" ms");
+        }
+        COMPARE(r, QString(string P QLatin1String(":1234 took 0.125 ms")));
+    }
+
+    void b_numbers() {
+        QBENCHMARK {
+            r = string P QLatin1Char(':') P QStringNumber(1234) P QLatin1String(" took ")
+                P QStringNumber(0.125, 'f', 3) P QLatin1String(" ms");
+        }
+        COMPARE(r, QString(string P QLatin1String(":1234 took 0.125 ms")));
+    }
+
 private:
     const QLatin1Literal l1literal;
     const QLatin1String l1string;
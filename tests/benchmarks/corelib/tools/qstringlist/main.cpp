@@ -61,6 +61,9 @@ private slots:
     void split_qlist_qstring() const;
     void split_qlist_qstring_data() const { return split_data(); }
 
+    void split_qvector_qstringref() const;
+    void split_qvector_qstringref_data() const { return split_data(); }
+
     void split_stdvector_stdstring() const;
     void split_stdvector_stdstring_data() const { return split_data(); }
 
@@ -70,6 +73,12 @@ private slots:
     void split_stdlist_stdstring() const;
     void split_stdlist_stdstring_data() const { return split_data(); }
 
+    void parseCsv_data() const;
+    void parseCsv_qstring() const;
+    void parseCsv_qstring_data() const { return parseCsv_data(); }
+    void parseCsv_qstringref() const;
+    void parseCsv_qstringref_data() const { return parseCsv_data(); }
+
 private:
     static QStringList populateList(const int count, const QString &unit);
     static QString populateString(const int count, const QString &unit);
@@ -161,6 +170,16 @@ void tst_QStringList::split_qlist_qstring() const
     }
 }
 
+void tst_QStringList::split_qvector_qstringref() const
+{
+    QFETCH(QString, input);
+    const QChar splitChar = ':';
+
+    QBENCHMARK {
+        input.splitRef(splitChar);
+    }
+}
+
 void tst_QStringList::split_stdvector_stdstring() const
 {
     QFETCH(QString, input);
@@ -209,6 +228,58 @@ void tst_QStringList::split_stdlist_stdstring() const
     }
 }
 
+void tst_QStringList::parseCsv_data() const
+{
+    QTest::addColumn<QStringList>("lines");
+    QTest::addColumn<qlonglong>("expected");
+
+    QStringList lines;
+    qlonglong expected = 0;
+    for (int i = 0; i < 1000; ++i) {
+        QString line = QLatin1String("sensor-") + QString::number(i % 17);
+        for (int j = 0; j < 8; ++j) {
+            line += QLatin1String(", ") + QString::number(i * j);
+            expected += i * j;
+        }
+        lines.append(line);
+    }
+    QTest::newRow("1000 lines") << lines << expected;
+}
+
+void tst_QStringList::parseCsv_qstring() const
+{
+    QFETCH(QStringList, lines);
+    QFETCH(qlonglong, expected);
+
+    qlonglong sum = 0;
+    QBENCHMARK {
+        sum = 0;
+        foreach (const QString &line, lines) {
+            const QStringList fields = line.split(QLatin1Char(','));
+            for (int i = 1; i < fields.size(); ++i)
+                sum += fields.at(i).trimmed().toInt();
+        }
+    }
+    QCOMPARE(sum, expected);
+}
+
+void tst_QStringList::parseCsv_qstringref() const
+{
+    QFETCH(QStringList, lines);
+    QFETCH(qlonglong, expected);
+
+    qlonglong sum = 0;
+    QBENCHMARK {
+        sum = 0;
+        foreach (const QString &line, lines) {
+            const QVector<QStringRef> fields = line.splitRef(QLatin1Char(','));
+            for (int i = 1; i < fields.size(); ++i)
+                sum += fields.at(i).trimmed().toInt();
+        }
+    }
+    QCOMPARE(sum, expected);
+}
+
 QTEST_MAIN(tst_QStringList)
 
 #include "main.moc"
@@ -12,6 +12,10 @@ SUBDIRS = \
         qstringbuilder \
         qstringlist \
         qvector \
-        qalgorithms
+        qalgorithms \
+        qlocale \
+        qmultipatternmatcher \
+        qarraydataarena \
+        qconcurrentcache
 
 !*g++*: SUBDIRS -= qstring